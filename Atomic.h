@@ -0,0 +1,171 @@
+/********************************************************************************
+* Name: Atomic.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: ISR safe shared state for mobile robot.
+*							 - Seqlock: one writer (an ISR) publishes several words, readers
+*								 retry until they copy them without a write in between.
+*							 - LDREX/STREX add, OR and AND on RAM words shared with ISRs.
+*							 - Critical sections that restore the previous PRIMASK.
+*							 - Single bit peripheral writes through bit-band.
+*							 Bench_Run() measures the cost of each.
+********************************************************************************/
+
+#ifndef __Atomic_H
+#define __Atomic_H
+
+#include "stm32f303xe.h"
+#include "Utility.h"
+
+
+/******************************************************************
+*														SEQLOCK																*
+******************************************************************/
+
+// Sequence count, odd while a write is in progress. Loaded and stored with the
+// relaxed __atomic builtins (plain LDR/STR on the M4) so ThreadSanitizer sees them.
+typedef struct {
+	volatile uint32_t seq;
+} Seqlock;
+
+/*************************************************************
+* Seqlock_WriteBegin() - Start updating the protected data.
+* lock		- Seqlock (only one writer context per lock).
+* No return value.
+*************************************************************/
+static inline void Seqlock_WriteBegin(Seqlock *lock){
+	__atomic_store_n(&lock->seq, lock->seq + 1, __ATOMIC_RELAXED);
+	__DMB();
+}
+
+/*************************************************************
+* Seqlock_WriteEnd() - Publish the protected data.
+* lock		- Seqlock.
+* No return value.
+*************************************************************/
+static inline void Seqlock_WriteEnd(Seqlock *lock){
+	__DMB();
+	__atomic_store_n(&lock->seq, lock->seq + 1, __ATOMIC_RELAXED);
+}
+
+/*************************************************************
+* Seqlock_ReadBegin() - Start copying the protected data.
+* lock		- Seqlock.
+* Returns the sequence to pass to Seqlock_ReadRetry().
+*************************************************************/
+static inline uint32_t Seqlock_ReadBegin(const Seqlock *lock){
+	uint32_t seq;
+
+	// Only spins if the reader preempted the writer (reader at a higher priority)
+	do{
+		seq = __atomic_load_n(&lock->seq, __ATOMIC_RELAXED);
+	} while(seq & 1UL);
+	__DMB();
+	return(seq);
+}
+
+/*************************************************************
+* Seqlock_ReadRetry() - Check the copy against a concurrent write.
+* lock		- Seqlock.
+* seq			- Sequence from Seqlock_ReadBegin().
+* Returns 1 if the copy may be torn and must be taken again.
+*************************************************************/
+static inline uint8_t Seqlock_ReadRetry(const Seqlock *lock, uint32_t seq){
+	__DMB();
+	return(__atomic_load_n(&lock->seq, __ATOMIC_RELAXED) != seq);
+}
+
+
+/******************************************************************
+*												ATOMIC RAM WORDS																*
+******************************************************************/
+
+/*************************************************************
+* Atomic_Add() - Atomically add to a word shared with an ISR.
+* word		- Word in SRAM (not CCM RAM or a peripheral).
+* value		- Amount to add.
+* Returns the new value.
+*************************************************************/
+static inline uint32_t Atomic_Add(volatile uint32_t *word, uint32_t value){
+	uint32_t result;
+
+	// An exception between LDREX and STREX clears the monitor and STREX fails
+	do{
+		result = __LDREXW(word) + value;
+	} while(__STREXW(result, word) != 0);
+	return(result);
+}
+
+/*************************************************************
+* Atomic_Or() - Atomically set bits of a word shared with an ISR.
+* word		- Word in SRAM.
+* bits		- Bits to set.
+* Returns the new value.
+*************************************************************/
+static inline uint32_t Atomic_Or(volatile uint32_t *word, uint32_t bits){
+	uint32_t result;
+
+	do{
+		result = __LDREXW(word) | bits;
+	} while(__STREXW(result, word) != 0);
+	return(result);
+}
+
+/*************************************************************
+* Atomic_And() - Atomically clear bits of a word shared with an ISR.
+* word		- Word in SRAM.
+* bits		- Bits to keep.
+* Returns the new value.
+*************************************************************/
+static inline uint32_t Atomic_And(volatile uint32_t *word, uint32_t bits){
+	uint32_t result;
+
+	do{
+		result = __LDREXW(word) & bits;
+	} while(__STREXW(result, word) != 0);
+	return(result);
+}
+
+
+/******************************************************************
+*												CRITICAL SECTIONS																*
+******************************************************************/
+
+/*************************************************************
+* Atomic_Enter() - Mask interrupts.
+* No inputs.
+* Returns the previous PRIMASK for Atomic_Exit() (nests safely).
+*************************************************************/
+static inline uint32_t Atomic_Enter(void){
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return(primask);
+}
+
+/*************************************************************
+* Atomic_Exit() - Restore the interrupt mask.
+* primask		- Value returned by Atomic_Enter().
+* No return value.
+*************************************************************/
+static inline void Atomic_Exit(uint32_t primask){
+	__set_PRIMASK(primask);
+}
+
+
+/******************************************************************
+*												PERIPHERAL BITS																*
+******************************************************************/
+
+// GPIO pins: GPIO_PINS_SET(), GPIO_PINS_CLEAR() and GPIO_PORT_WRITE() in Utility.h
+
+// Bit-band alias of one bit of an APB/AHB1 register (0x40000000-0x400FFFFF, e.g. TIMx->DIER).
+// GPIO ports sit on AHB2 (0x48000000) outside the bit-band region, so they use BSRR/BRR.
+#define BITBAND_PERIPH(reg, bit) \
+	(*(volatile uint32_t *)(PERIPH_BB_BASE + (((uint32_t)&(reg) - PERIPH_BASE) * 32UL) + ((bit) * 4UL)))
+
+// Bit-band alias of one bit of an SRAM word (0x20000000-0x200FFFFF, not CCM RAM)
+#define BITBAND_SRAM(word, bit) \
+	(*(volatile uint32_t *)(SRAM_BB_BASE + (((uint32_t)&(word) - SRAM_BASE) * 32UL) + ((bit) * 4UL)))
+
+#endif
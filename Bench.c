@@ -0,0 +1,179 @@
+/********************************************************************************
+* Name: Bench.c (implementation)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: On-target benchmarks of driver hot paths for mobile robot.
+*							 Results are printed over UART as one JSON object per line. Paste the
+*							 cycles_min of a known good build into the benchCases baseline column
+*							 to compare against. host/BenchMain.c runs the same cases on the
+*							 simulator against host/bench_baseline.json.
+*							 Running the benchmarks stops the stepper and writes to the LCD, so
+*							 the robot task is locked out of its drivers meanwhile.
+********************************************************************************/
+
+#include <stddef.h>
+#include "Bench.h"
+#include "UART.h"
+#include "LCD.h"
+#include "KeyPad.h"
+#include "Stepper.h"
+#include "Encoder.h"
+#include "Atomic.h"
+#include "Kernel.h"
+#include "Robot.h"
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/	
+
+static void Bench_LcdPutc(void);
+static void Bench_KeyPadScan(void);
+static void Bench_StepperStep(void);
+static void Bench_UartFormat(void);
+static void Bench_EncoderSpeed(void);
+static void Bench_Critical(void);
+static void Bench_AtomicAdd(void);
+static void Bench_KernelSwitch(void);
+
+typedef struct {
+	const char *name;
+	void (*run)(void);
+	uint32_t baseline;		// Known good cycles_min (0 = no baseline)
+} Bench_Case;
+
+static const Bench_Case benchCases[] = {
+	{"LCD_putc",								Bench_LcdPutc,				0},
+	{"KeyPad_MatrixScan",				Bench_KeyPadScan,			0},
+	{"Stepper_Step",						Bench_StepperStep,		0},
+	{"UART_printf_format",			Bench_UartFormat,			0},
+	{"Encoder_CalculateSpeed",	Bench_EncoderSpeed,		0},
+	{"Atomic_Enter_Exit",				Bench_Critical,				0},
+	{"Atomic_Add",							Bench_AtomicAdd,			0},
+	{"Kernel_SemGive_2_switches",	Bench_KernelSwitch,	0},
+};
+
+#define BENCH_COUNT (sizeof(benchCases) / sizeof(benchCases[0]))
+
+static volatile uint32_t benchCounter;		// Atomic_Add() target
+static Encoder_Speed benchSpeed;					// Encoder_CalculateSpeed() state of its own
+
+// Highest priority task that only takes benchPing, so each give switches to it and back
+static Kernel_Task benchTask;
+static uint32_t benchStack[BENCH_TASK_STACK];
+static Kernel_Sem benchPing = KERNEL_SEM_INIT(0, 1);
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+static void Bench_LcdPutc(void){
+	LCD_putc(' ');
+}
+
+static void Bench_KeyPadScan(void){
+	(void)KeyPad_MatrixScan();
+}
+
+static void Bench_StepperStep(void){
+	Stepper_Step(0);		// Re-outputs the current pattern without moving
+}
+
+static void Bench_UartFormat(void){
+	UART_printf("%s", "");		// Formatting only, nothing to transmit
+}
+
+static void Bench_EncoderSpeed(void){
+	Encoder_CalculateSpeed(&benchSpeed);		// Data bus read of both wheels
+}
+
+static void Bench_Critical(void){
+	Atomic_Exit(Atomic_Enter());
+}
+
+static void Bench_AtomicAdd(void){
+	(void)Atomic_Add(&benchCounter, 1);
+}
+
+static void Bench_KernelSwitch(void){
+	Kernel_SemGive(&benchPing);		// Switch to benchTask, which blocks again and switches back
+}
+
+static void Bench_Task(void *arg){
+	while(1){
+		Kernel_SemTake(&benchPing, KERNEL_FOREVER);
+	}
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Bench_Init() - Create the context switch benchmark task (after Kernel_Init).
+* No inputs.
+* No return value.
+*************************************************************/
+void Bench_Init(void){
+	Kernel_TaskCreate(&benchTask, "bench", Bench_Task, NULL, benchStack, BENCH_TASK_STACK, BENCH_TASK_PRIORITY);
+}
+
+/*************************************************************
+* Bench_Count() - Number of benchmarks.
+* No inputs.
+* Returns the count.
+*************************************************************/
+uint32_t Bench_Count(void){
+	return(BENCH_COUNT);
+}
+
+/*************************************************************
+* Bench_Measure() - Run one benchmark BENCH_ITERATIONS times.
+* index		- Benchmark, 0 to Bench_Count() - 1.
+* result	- Returns its cycles and how they compare to the baseline.
+* No return value.
+*************************************************************/
+void Bench_Measure(uint32_t index, Bench_Result *result){
+	const Bench_Case *bench = &benchCases[index];
+	uint32_t start, cycles, min = 0xFFFFFFFFUL, total = 0;
+	
+	for(int run = 0; run < BENCH_ITERATIONS; run++){
+		start = DWT->CYCCNT;
+		bench->run();
+		cycles = DWT->CYCCNT - start;
+		
+		total += cycles;
+		if(cycles < min){
+			min = cycles;
+		}
+	}
+	
+	result->name = bench->name;
+	result->cyclesMin = min;
+	result->cyclesMean = total / BENCH_ITERATIONS;
+	result->baseline = bench->baseline;
+	result->regression = (bench->baseline != 0) &&
+		((uint64_t)min * 100 > (uint64_t)bench->baseline * (100 + BENCH_THRESHOLD_PCT));
+}
+
+/*************************************************************
+* Bench_Run() - Run every benchmark and print the results over UART.
+* No inputs.
+* No return value.
+*************************************************************/
+void Bench_Run(void){
+	Bench_Result result;
+	uint32_t cyclesPerUs = SystemCoreClock / 1000000UL;
+	
+	Robot_Lock();
+	for(uint32_t i = 0; i < BENCH_COUNT; i++){
+		Bench_Measure(i, &result);
+		UART_printf("{\"name\":\"%s\",\"cycles_min\":%lu,\"cycles_mean\":%lu,\"ns_per_op\":%lu,\"baseline\":%lu,\"regression\":%s}\n",
+			result.name, (unsigned long)result.cyclesMin, (unsigned long)result.cyclesMean,
+			(unsigned long)((result.cyclesMin * 1000UL) / cyclesPerUs), (unsigned long)result.baseline,
+			result.regression ? "true" : "false");
+	}
+	Robot_Unlock();
+}
@@ -0,0 +1,32 @@
+/********************************************************************************
+* Name: Bench.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: On-target benchmarks of driver hot paths for mobile robot.
+********************************************************************************/
+
+#ifndef __Bench_H
+#define __Bench_H
+
+#include "stm32f303xe.h"
+
+#define BENCH_ITERATIONS		16			// Runs of each benchmark
+#define BENCH_THRESHOLD_PCT	10			// Flag a regression when slower than baseline by more than this
+#define BENCH_TASK_PRIORITY	7				// Context switch partner task, above every other task
+#define BENCH_TASK_STACK		96			// Words
+
+// One benchmark's result
+typedef struct {
+	const char *name;
+	uint32_t cyclesMin;
+	uint32_t cyclesMean;
+	uint32_t baseline;			// Known good cycles_min (0 = no baseline)
+	uint8_t regression;			// Slower than baseline by more than BENCH_THRESHOLD_PCT
+} Bench_Result;
+
+void Bench_Init(void);
+uint32_t Bench_Count(void);
+void Bench_Measure(uint32_t index, Bench_Result *result);
+void Bench_Run(void);
+
+#endif
@@ -0,0 +1,288 @@
+/********************************************************************************
+* Name: Board.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Pin and timer allocation for the mobile robot (Nucleo-64 F303RE).
+*							 Every pin and timer channel a driver uses is assigned here, and
+*							 the build fails if one is assigned twice. board_report.py prints
+*							 the resulting pinout. No DMA streams are in use.
+********************************************************************************/
+
+#ifndef __Board_H
+#define __Board_H
+
+#include "stm32f303xe.h"
+
+// PC13 is the Nucleo B1 button but drives the left motor in reverse on this robot.
+// Set to 1 (and free PC13) before calling PushButton_Init().
+#define BOARD_USE_PUSHBUTTON 0
+
+
+/******************************************************************
+*														PINS																	*
+******************************************************************/
+
+#define BOARD_GPIO		16		// Plain GPIO (no alternate function)
+
+// UART2 (ST-LINK virtual COM port)
+#define BOARD_UART_TX_PORT					A
+#define BOARD_UART_TX_PIN						2
+#define BOARD_UART_TX_AF						7
+#define BOARD_UART_RX_PORT					A
+#define BOARD_UART_RX_PIN						3
+#define BOARD_UART_RX_AF						7
+
+// User LED (LD2)
+#define BOARD_LED_PORT							A
+#define BOARD_LED_PIN								5
+#define BOARD_LED_AF								BOARD_GPIO
+
+// Push button (B1)
+#define BOARD_PUSHBUTTON_PORT				C
+#define BOARD_PUSHBUTTON_PIN				13
+#define BOARD_PUSHBUTTON_AF					BOARD_GPIO
+
+// LCD (4-bit bus on consecutive pins)
+#define BOARD_LCD_RS_PORT						A
+#define BOARD_LCD_RS_PIN						6
+#define BOARD_LCD_RS_AF							BOARD_GPIO
+#define BOARD_LCD_E_PORT						A
+#define BOARD_LCD_E_PIN							7
+#define BOARD_LCD_E_AF							BOARD_GPIO
+#define BOARD_LCD_D4_PORT						A
+#define BOARD_LCD_D4_PIN						8
+#define BOARD_LCD_D4_AF							BOARD_GPIO
+#define BOARD_LCD_D5_PORT						A
+#define BOARD_LCD_D5_PIN						9
+#define BOARD_LCD_D5_AF							BOARD_GPIO
+#define BOARD_LCD_D6_PORT						A
+#define BOARD_LCD_D6_PIN						10
+#define BOARD_LCD_D6_AF							BOARD_GPIO
+#define BOARD_LCD_D7_PORT						A
+#define BOARD_LCD_D7_PIN						11
+#define BOARD_LCD_D7_AF							BOARD_GPIO
+
+// Wheel encoders (TIM2 CH1 and CH2 input capture)
+#define BOARD_ENCODER_LEFT_PORT			A
+#define BOARD_ENCODER_LEFT_PIN			0
+#define BOARD_ENCODER_LEFT_AF				1
+#define BOARD_ENCODER_RIGHT_PORT		A
+#define BOARD_ENCODER_RIGHT_PIN			1
+#define BOARD_ENCODER_RIGHT_AF			1
+
+// Ultrasonic sensor (TIM16 CH1 trigger, TIM3 CH2 echo)
+#define BOARD_ULTRA_TRIGGER_PORT		A
+#define BOARD_ULTRA_TRIGGER_PIN			12
+#define BOARD_ULTRA_TRIGGER_AF			1
+#define BOARD_ULTRA_ECHO_PORT				C
+#define BOARD_ULTRA_ECHO_PIN				7
+#define BOARD_ULTRA_ECHO_AF					2
+
+// Keypad (open-drain rows, columns pulled up on the keypad board)
+#define BOARD_KEYPAD_ROW1_PORT			B
+#define BOARD_KEYPAD_ROW1_PIN				0
+#define BOARD_KEYPAD_ROW1_AF				BOARD_GPIO
+#define BOARD_KEYPAD_ROW2_PORT			B
+#define BOARD_KEYPAD_ROW2_PIN				1
+#define BOARD_KEYPAD_ROW2_AF				BOARD_GPIO
+#define BOARD_KEYPAD_ROW3_PORT			B
+#define BOARD_KEYPAD_ROW3_PIN				2
+#define BOARD_KEYPAD_ROW3_AF				BOARD_GPIO
+#define BOARD_KEYPAD_ROW4_PORT			B
+#define BOARD_KEYPAD_ROW4_PIN				3
+#define BOARD_KEYPAD_ROW4_AF				BOARD_GPIO
+#define BOARD_KEYPAD_COL1_PORT			B
+#define BOARD_KEYPAD_COL1_PIN				4
+#define BOARD_KEYPAD_COL1_AF				BOARD_GPIO
+#define BOARD_KEYPAD_COL2_PORT			B
+#define BOARD_KEYPAD_COL2_PIN				5
+#define BOARD_KEYPAD_COL2_AF				BOARD_GPIO
+#define BOARD_KEYPAD_COL3_PORT			B
+#define BOARD_KEYPAD_COL3_PIN				6
+#define BOARD_KEYPAD_COL3_AF				BOARD_GPIO
+#define BOARD_KEYPAD_COL4_PORT			B
+#define BOARD_KEYPAD_COL4_PIN				7
+#define BOARD_KEYPAD_COL4_AF				BOARD_GPIO
+
+// RC servos (TIM15 CH1/CH2, TIM17 CH1)
+#define BOARD_SERVO_PAN_PORT				B
+#define BOARD_SERVO_PAN_PIN					15
+#define BOARD_SERVO_PAN_AF					1
+#define BOARD_SERVO_TILT_PORT				B
+#define BOARD_SERVO_TILT_PIN				14
+#define BOARD_SERVO_TILT_AF					1
+#define BOARD_SERVO_GRIPPER_PORT		B
+#define BOARD_SERVO_GRIPPER_PIN			9
+#define BOARD_SERVO_GRIPPER_AF			1
+
+// Stepper coils (GPIO, or TIM1 CH1-CH4 on AF2 when microstepping)
+#define BOARD_STEPPER_A_PORT				C
+#define BOARD_STEPPER_A_PIN					0
+#define BOARD_STEPPER_A_AF					2
+#define BOARD_STEPPER_B_PORT				C
+#define BOARD_STEPPER_B_PIN					1
+#define BOARD_STEPPER_B_AF					2
+#define BOARD_STEPPER_C_PORT				C
+#define BOARD_STEPPER_C_PIN					2
+#define BOARD_STEPPER_C_AF					2
+#define BOARD_STEPPER_D_PORT				C
+#define BOARD_STEPPER_D_PIN					3
+#define BOARD_STEPPER_D_AF					2
+
+// DC motors (direction GPIO, TIM8 CH1N/CH2N speed)
+#define BOARD_DCMOTOR_RIGHT_FWD_PORT	C
+#define BOARD_DCMOTOR_RIGHT_FWD_PIN		8
+#define BOARD_DCMOTOR_RIGHT_FWD_AF		BOARD_GPIO
+#define BOARD_DCMOTOR_RIGHT_BWD_PORT	C
+#define BOARD_DCMOTOR_RIGHT_BWD_PIN		9
+#define BOARD_DCMOTOR_RIGHT_BWD_AF		BOARD_GPIO
+#define BOARD_DCMOTOR_LEFT_PWM_PORT		C
+#define BOARD_DCMOTOR_LEFT_PWM_PIN		10
+#define BOARD_DCMOTOR_LEFT_PWM_AF			4
+#define BOARD_DCMOTOR_RIGHT_PWM_PORT	C
+#define BOARD_DCMOTOR_RIGHT_PWM_PIN		11
+#define BOARD_DCMOTOR_RIGHT_PWM_AF		4
+#define BOARD_DCMOTOR_LEFT_FWD_PORT		C
+#define BOARD_DCMOTOR_LEFT_FWD_PIN		12
+#define BOARD_DCMOTOR_LEFT_FWD_AF			BOARD_GPIO
+#define BOARD_DCMOTOR_LEFT_BWD_PORT		C
+#define BOARD_DCMOTOR_LEFT_BWD_PIN		13
+#define BOARD_DCMOTOR_LEFT_BWD_AF			BOARD_GPIO
+
+// Every assigned pin
+#if BOARD_USE_PUSHBUTTON
+#define BOARD_PINS_OPTIONAL(X)	X(PUSHBUTTON)
+#else
+#define BOARD_PINS_OPTIONAL(X)
+#endif
+
+#define BOARD_PINS(X) \
+	X(UART_TX) X(UART_RX) X(LED) \
+	X(LCD_RS) X(LCD_E) X(LCD_D4) X(LCD_D5) X(LCD_D6) X(LCD_D7) \
+	X(ENCODER_LEFT) X(ENCODER_RIGHT) X(ULTRA_TRIGGER) X(ULTRA_ECHO) \
+	X(KEYPAD_ROW1) X(KEYPAD_ROW2) X(KEYPAD_ROW3) X(KEYPAD_ROW4) \
+	X(KEYPAD_COL1) X(KEYPAD_COL2) X(KEYPAD_COL3) X(KEYPAD_COL4) \
+	X(SERVO_PAN) X(SERVO_TILT) X(SERVO_GRIPPER) \
+	X(STEPPER_A) X(STEPPER_B) X(STEPPER_C) X(STEPPER_D) \
+	X(DCMOTOR_RIGHT_FWD) X(DCMOTOR_RIGHT_BWD) X(DCMOTOR_LEFT_PWM) \
+	X(DCMOTOR_RIGHT_PWM) X(DCMOTOR_LEFT_FWD) X(DCMOTOR_LEFT_BWD) \
+	BOARD_PINS_OPTIONAL(X)
+
+
+/******************************************************************
+*														TIMERS																*
+******************************************************************/
+
+// Timer channel 0 is the counter itself (prescaler, period and update interrupt)
+#define BOARD_STEPPER_PWM_TIMER			1			// CH1-CH4 coil PWM
+#define BOARD_ENCODER_TIMER					2			// CH1/CH2 capture, CH3 kernel wake-up, free running 1us timebase
+#define BOARD_ULTRA_ECHO_TIMER			3			// CH1/CH2 pulse width capture
+#define BOARD_STEPPER_TIMER					6			// Step engine
+#define BOARD_LOOP_TIMER						7			// Main loop tick
+#define BOARD_DCMOTOR_TIMER					8			// CH1N/CH2N motor PWM
+#define BOARD_SERVO_TIMER						15		// CH1/CH2 servo PWM and frame interrupt
+#define BOARD_ULTRA_TRIGGER_TIMER		16		// CH1 trigger pulse
+#define BOARD_SERVO_GRIPPER_TIMER		17		// CH1 servo PWM
+
+#define BOARD_TIM(n)	BOARD_TIMx(n)
+#define BOARD_TIMx(n)	TIM ## n
+
+// Clock enable of each timer: SET_BITS(BOARD_TIM_ENR(n), BOARD_TIM_EN(n))
+#define BOARD_TIM_ENR(n)		BOARD_TIM_ENRx(n)
+#define BOARD_TIM_ENRx(n)		BOARD_TIM_ENR_ ## n
+#define BOARD_TIM_EN(n)			BOARD_TIM_ENx(n)
+#define BOARD_TIM_ENx(n)		BOARD_TIM_EN_ ## n
+
+#define BOARD_TIM_ENR_1			RCC->APB2ENR
+#define BOARD_TIM_EN_1			RCC_APB2ENR_TIM1EN
+#define BOARD_TIM_ENR_2			RCC->APB1ENR
+#define BOARD_TIM_EN_2			RCC_APB1ENR_TIM2EN
+#define BOARD_TIM_ENR_3			RCC->APB1ENR
+#define BOARD_TIM_EN_3			RCC_APB1ENR_TIM3EN
+#define BOARD_TIM_ENR_4			RCC->APB1ENR
+#define BOARD_TIM_EN_4			RCC_APB1ENR_TIM4EN
+#define BOARD_TIM_ENR_6			RCC->APB1ENR
+#define BOARD_TIM_EN_6			RCC_APB1ENR_TIM6EN
+#define BOARD_TIM_ENR_7			RCC->APB1ENR
+#define BOARD_TIM_EN_7			RCC_APB1ENR_TIM7EN
+#define BOARD_TIM_ENR_8			RCC->APB2ENR
+#define BOARD_TIM_EN_8			RCC_APB2ENR_TIM8EN
+#define BOARD_TIM_ENR_15		RCC->APB2ENR
+#define BOARD_TIM_EN_15			RCC_APB2ENR_TIM15EN
+#define BOARD_TIM_ENR_16		RCC->APB2ENR
+#define BOARD_TIM_EN_16			RCC_APB2ENR_TIM16EN
+#define BOARD_TIM_ENR_17		RCC->APB2ENR
+#define BOARD_TIM_EN_17			RCC_APB2ENR_TIM17EN
+#define BOARD_TIM_ENR_20		RCC->APB2ENR
+#define BOARD_TIM_EN_20			RCC_APB2ENR_TIM20EN
+
+// Update and capture/compare interrupt of each general purpose or basic timer.
+// The handler names are fixed by the vector table, so each driver asserts its timer number.
+#define BOARD_TIM_IRQ(n)		BOARD_TIM_IRQx(n)
+#define BOARD_TIM_IRQx(n)		BOARD_TIM_IRQ_ ## n
+
+#define BOARD_TIM_IRQ_2			TIM2_IRQn
+#define BOARD_TIM_IRQ_3			TIM3_IRQn
+#define BOARD_TIM_IRQ_4			TIM4_IRQn
+#define BOARD_TIM_IRQ_6			TIM6_DAC_IRQn
+#define BOARD_TIM_IRQ_7			TIM7_IRQn
+#define BOARD_TIM_IRQ_15		TIM1_BRK_TIM15_IRQn
+#define BOARD_TIM_IRQ_16		TIM1_UP_TIM16_IRQn
+#define BOARD_TIM_IRQ_17		TIM1_TRG_COM_TIM17_IRQn
+
+// Every assigned timer channel: X(timer, channel)
+#define BOARD_TIMER_CHANNELS(X) \
+	X(BOARD_STEPPER_PWM_TIMER, 0) X(BOARD_STEPPER_PWM_TIMER, 1) X(BOARD_STEPPER_PWM_TIMER, 2) \
+	X(BOARD_STEPPER_PWM_TIMER, 3) X(BOARD_STEPPER_PWM_TIMER, 4) \
+	X(BOARD_ENCODER_TIMER, 0) X(BOARD_ENCODER_TIMER, 1) X(BOARD_ENCODER_TIMER, 2) X(BOARD_ENCODER_TIMER, 3) \
+	X(BOARD_ULTRA_ECHO_TIMER, 0) X(BOARD_ULTRA_ECHO_TIMER, 1) X(BOARD_ULTRA_ECHO_TIMER, 2) \
+	X(BOARD_STEPPER_TIMER, 0) \
+	X(BOARD_LOOP_TIMER, 0) \
+	X(BOARD_DCMOTOR_TIMER, 0) X(BOARD_DCMOTOR_TIMER, 1) X(BOARD_DCMOTOR_TIMER, 2) \
+	X(BOARD_SERVO_TIMER, 0) X(BOARD_SERVO_TIMER, 1) X(BOARD_SERVO_TIMER, 2) \
+	X(BOARD_ULTRA_TRIGGER_TIMER, 0) X(BOARD_ULTRA_TRIGGER_TIMER, 1) \
+	X(BOARD_SERVO_GRIPPER_TIMER, 0) X(BOARD_SERVO_GRIPPER_TIMER, 1)
+
+
+/******************************************************************
+*											CONFLICT DETECTION															*
+******************************************************************/
+
+// A set of distinct bits sums to the same value as their OR, a repeated bit does not
+#define BOARD_PORT_A	0
+#define BOARD_PORT_B	1
+#define BOARD_PORT_C	2
+#define BOARD_PORT_D	3
+#define BOARD_PORT_NUM(port)		BOARD_PORT_NUMx(port)
+#define BOARD_PORT_NUMx(port)		BOARD_PORT_ ## port
+
+#define BOARD_PIN_BIT(name, port) \
+	((BOARD_PORT_NUM(BOARD_ ## name ## _PORT) == (port)) ? (1UL << BOARD_ ## name ## _PIN) : 0UL)
+
+#define BOARD_PIN_SUM_A(name)	+ BOARD_PIN_BIT(name, BOARD_PORT_A)
+#define BOARD_PIN_OR_A(name)	| BOARD_PIN_BIT(name, BOARD_PORT_A)
+#define BOARD_PIN_SUM_B(name)	+ BOARD_PIN_BIT(name, BOARD_PORT_B)
+#define BOARD_PIN_OR_B(name)	| BOARD_PIN_BIT(name, BOARD_PORT_B)
+#define BOARD_PIN_SUM_C(name)	+ BOARD_PIN_BIT(name, BOARD_PORT_C)
+#define BOARD_PIN_OR_C(name)	| BOARD_PIN_BIT(name, BOARD_PORT_C)
+#define BOARD_PIN_SUM_D(name)	+ BOARD_PIN_BIT(name, BOARD_PORT_D)
+#define BOARD_PIN_OR_D(name)	| BOARD_PIN_BIT(name, BOARD_PORT_D)
+
+_Static_assert((0UL BOARD_PINS(BOARD_PIN_SUM_A)) == (0UL BOARD_PINS(BOARD_PIN_OR_A)), "Board.h: a port A pin is assigned twice");
+_Static_assert((0UL BOARD_PINS(BOARD_PIN_SUM_B)) == (0UL BOARD_PINS(BOARD_PIN_OR_B)), "Board.h: a port B pin is assigned twice");
+_Static_assert((0UL BOARD_PINS(BOARD_PIN_SUM_C)) == (0UL BOARD_PINS(BOARD_PIN_OR_C)), "Board.h: a port C pin is assigned twice");
+_Static_assert((0UL BOARD_PINS(BOARD_PIN_SUM_D)) == (0UL BOARD_PINS(BOARD_PIN_OR_D)), "Board.h: a port D pin is assigned twice");
+
+// Timer channels: bit (timer * 5 + channel) split over two words (timers 1-8, timers 15-17)
+#define BOARD_CH_BIT(timer, ch, word) \
+	((((timer) >= 15) == (word)) ? (1ULL << (((timer) - ((word) ? 15 : 0)) * 5 + (ch))) : 0ULL)
+
+#define BOARD_CH_SUM_0(timer, ch)	+ BOARD_CH_BIT(timer, ch, 0)
+#define BOARD_CH_OR_0(timer, ch)	| BOARD_CH_BIT(timer, ch, 0)
+#define BOARD_CH_SUM_1(timer, ch)	+ BOARD_CH_BIT(timer, ch, 1)
+#define BOARD_CH_OR_1(timer, ch)	| BOARD_CH_BIT(timer, ch, 1)
+
+_Static_assert((0ULL BOARD_TIMER_CHANNELS(BOARD_CH_SUM_0)) == (0ULL BOARD_TIMER_CHANNELS(BOARD_CH_OR_0)), "Board.h: a TIM1-TIM8 channel is assigned twice");
+_Static_assert((0ULL BOARD_TIMER_CHANNELS(BOARD_CH_SUM_1)) == (0ULL BOARD_TIMER_CHANNELS(BOARD_CH_OR_1)), "Board.h: a TIM15-TIM17 channel is assigned twice");
+
+#endif
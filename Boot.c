@@ -0,0 +1,126 @@
+/********************************************************************************
+* Name: Boot.c (implementation)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Cooperative driver initialisation for mobile robot.
+*							 Each driver provides an init step that does one stage of its
+*							 start-up and returns BOOT_BUSY to wait (Boot_Delay() or a ready
+*							 flag). Boot_Run() round-robins the tasks in table order, so the
+*							 slow waits (LCD power-on, HSE/PLL lock) overlap and tasks at the
+*							 top of the table (motors) come up first. Time is kept with the
+*							 DWT cycle counter, so Profile_Init() must be called first.
+********************************************************************************/
+
+#include "Boot.h"
+#include "UART.h"
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/	
+
+static const Boot_Task *bootTasks;
+static uint8_t bootCount;
+static uint8_t bootCurrent;											// Task being stepped
+static uint32_t bootReadyAt[BOOT_MAX_TASKS];		// Earliest time to step each task (us)
+static uint32_t bootDoneAt[BOOT_MAX_TASKS];		// Time each task finished (us)
+
+// Boot clock (the core clock changes part way through boot)
+static uint32_t bootUs;
+static uint32_t bootLastCycles;
+static uint32_t bootCycles;
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Boot_Run() - Run init tasks until all have finished.
+* tasks	- Task table, highest priority first.
+* count	- Number of tasks (up to BOOT_MAX_TASKS).
+* No return value.
+*************************************************************/
+void Boot_Run(const Boot_Task *tasks, uint8_t count){
+	uint32_t done = 0;
+	uint32_t started = 0;				// init() has been called
+	uint32_t all = (1UL << count) - 1;
+	
+	bootTasks = tasks;
+	bootCount = count;
+	bootUs = 0;
+	bootCycles = 0;
+	bootLastCycles = DWT->CYCCNT;
+	
+	for(uint8_t i = 0; i < count; i++){
+		bootReadyAt[i] = 0;
+		bootDoneAt[i] = 0;
+	}
+	
+	while(done != all){
+		for(bootCurrent = 0; bootCurrent < count; bootCurrent++){
+			// Finished, waiting on another task, or delaying
+			if((done & (1UL << bootCurrent)) ||
+				(tasks[bootCurrent].needs & ~done) ||
+				(int32_t)(Boot_Micros() - bootReadyAt[bootCurrent]) < 0){
+				continue;
+			}
+			
+			if(!(started & (1UL << bootCurrent))){
+				started |= 1UL << bootCurrent;
+				if(tasks[bootCurrent].init){
+					tasks[bootCurrent].init();
+				}
+			}
+			if(!tasks[bootCurrent].step || tasks[bootCurrent].step() == BOOT_DONE){
+				done |= 1UL << bootCurrent;
+				bootDoneAt[bootCurrent] = Boot_Micros();
+			}
+		}
+	}
+}
+
+/*************************************************************
+* Boot_Delay() - Wait before stepping the current task again.
+* us		- Delay in us.
+* No return value.
+*************************************************************/
+void Boot_Delay(uint32_t us){
+	bootReadyAt[bootCurrent] = Boot_Micros() + us;
+}
+
+/*************************************************************
+* Boot_Micros() - Get the time since Boot_Run() started.
+* No inputs.
+* Returns the time in us.
+*************************************************************/
+uint32_t Boot_Micros(void){
+	uint32_t now = DWT->CYCCNT;
+	uint32_t cyclesPerUs = SystemCoreClock / 1000000UL;
+	
+	// Convert at the current core clock so a clock switch doesn't skew earlier time
+	bootCycles += now - bootLastCycles;
+	bootLastCycles = now;
+	bootUs += bootCycles / cyclesPerUs;
+	bootCycles %= cyclesPerUs;
+	
+	return(bootUs);
+}
+
+/*************************************************************
+* Boot_Report() - Print when each init task finished over UART.
+* No inputs.
+* No return value.
+*************************************************************/
+void Boot_Report(void){
+	uint32_t last = 0;
+	
+	UART_printf("task          done(us)\n");
+	for(uint8_t i = 0; i < bootCount; i++){
+		UART_printf("%-12s %9lu\n", bootTasks[i].name, bootDoneAt[i]);
+		if(bootDoneAt[i] > last){
+			last = bootDoneAt[i];
+		}
+	}
+	UART_printf("Boot: %lu us\n", last);
+}
@@ -0,0 +1,39 @@
+/********************************************************************************
+* Name: Boot.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Cooperative driver initialisation for mobile robot.
+********************************************************************************/
+
+#ifndef __Boot_H
+#define __Boot_H
+
+#include <stddef.h>
+#include "stm32f303xe.h"
+
+// Init step results
+#define BOOT_DONE		0		// Task finished
+#define BOOT_BUSY		1		// Call again once the task is ready
+
+#define BOOT_MAX_TASKS	16
+
+#define BOOT_NEEDS(task)	(1UL << (task))		// Dependency on the task at this table index (use named indices)
+
+// Called repeatedly until it returns BOOT_DONE
+typedef uint8_t (*Boot_Step)(void);
+
+// Set init for a driver that starts in one call, or step for an init state machine.
+// With both, init is called once before the first step.
+typedef struct {
+	const char *name;
+	void (*init)(void);
+	Boot_Step step;
+	uint32_t needs;			// BOOT_NEEDS() of tasks that must finish first
+} Boot_Task;
+
+void Boot_Run(const Boot_Task *tasks, uint8_t count);
+void Boot_Delay(uint32_t us);
+uint32_t Boot_Micros(void);
+void Boot_Report(void);
+
+#endif
@@ -0,0 +1,142 @@
+/********************************************************************************
+* Name: Bus.c (implementation)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Latest-value sensor data bus for mobile robot.
+********************************************************************************/
+
+#include "Bus.h"
+#include "Atomic.h"
+#include "Encoder.h"
+#include "UART.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+// Largest sample of any topic
+typedef union {
+	Bus_Encoder encoder;
+	Bus_Ultra ultra;
+	Bus_Servo servo;
+} Bus_Sample;
+
+// The seqlock count is odd while the back slot is being filled. Sample k (the
+// version) lives in slot k & 1 and is reused by the claim for sample k + 2.
+typedef struct {
+	Seqlock lock;
+	Bus_Sample slots[2];
+	Bus_Stats stats;
+} Bus_Topic;
+
+static const char *topicNames[BUS_TOPIC_COUNT] = {"encoder", "ultrasonic", "servo"};
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static Bus_Topic topics[BUS_TOPIC_COUNT];
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+/*************************************************************
+* Bus_Claim() - Start a new sample (topic publisher only).
+* topic		- BUS_TOPIC_*.
+* Returns the back slot to fill, then call Bus_Publish().
+*************************************************************/
+CCM_FUNC void *Bus_Claim(uint8_t topic){
+	Bus_Topic *t = &topics[topic];
+
+	Seqlock_WriteBegin(&t->lock);
+	return(&t->slots[((t->lock.seq + 1) >> 1) & 1]);
+}
+
+/*************************************************************
+* Bus_Publish() - Make the claimed sample the latest.
+* topic		- BUS_TOPIC_*.
+* No return value.
+*************************************************************/
+CCM_FUNC void Bus_Publish(uint8_t topic){
+	Bus_Topic *t = &topics[topic];
+	uint32_t now = ENCODER_TIMER->CNT;
+	uint32_t interval = now - t->stats.last;
+
+	Seqlock_WriteEnd(&t->lock);
+
+	if(t->stats.count == 0){
+		t->stats.first = now;
+		t->stats.minInterval = 0xFFFFFFFFUL;
+	}
+	else{
+		if(interval < t->stats.minInterval){
+			t->stats.minInterval = interval;
+		}
+		if(interval > t->stats.maxInterval){
+			t->stats.maxInterval = interval;
+		}
+	}
+	t->stats.last = now;
+	t->stats.count++;
+}
+
+/*************************************************************
+* Bus_Latest() - Get the latest sample of a topic (no copy).
+* topic		- BUS_TOPIC_*.
+* version	- Set to the sample number (0 = nothing published yet).
+* Returns the sample, read it in place then check Bus_Valid().
+*************************************************************/
+const void *Bus_Latest(uint8_t topic, uint32_t *version){
+	Bus_Topic *t = &topics[topic];
+	uint32_t seq = t->lock.seq;
+
+	__DMB();
+	*version = seq >> 1;
+	return(&t->slots[*version & 1]);
+}
+
+/*************************************************************
+* Bus_Valid() - Check a sample was not reused while being read.
+* topic		- BUS_TOPIC_*.
+* version	- Version from Bus_Latest().
+* Returns 1 if everything read since Bus_Latest() is consistent, 0 to retry.
+*************************************************************/
+uint8_t Bus_Valid(uint8_t topic, uint32_t version){
+	__DMB();
+	return((topics[topic].lock.seq - (version << 1)) <= 2);
+}
+
+/*************************************************************
+* Bus_GetStats() - Publish rate statistics of a topic.
+* topic		- BUS_TOPIC_*.
+* stats		- Filled with the statistics.
+* No return value.
+*************************************************************/
+void Bus_GetStats(uint8_t topic, Bus_Stats *stats){
+	uint32_t primask = Atomic_Enter();
+
+	*stats = topics[topic].stats;
+	Atomic_Exit(primask);
+}
+
+/*************************************************************
+* Bus_Report() - Print every topic's publish rate over UART.
+* No inputs.
+* No return value.
+*************************************************************/
+void Bus_Report(void){
+	Bus_Stats stats;
+
+	for(uint8_t topic = 0; topic < BUS_TOPIC_COUNT; topic++){
+		Bus_GetStats(topic, &stats);
+		if(stats.count < 2){
+			UART_printf("%s: %lu samples\n", topicNames[topic], stats.count);
+			continue;
+		}
+		UART_printf("%s: %lu samples, interval mean %lu us, min %lu us, max %lu us\n", topicNames[topic],
+			stats.count, (stats.last - stats.first) / (stats.count - 1), stats.minInterval, stats.maxInterval);
+	}
+}
@@ -0,0 +1,63 @@
+/********************************************************************************
+* Name: Bus.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Latest-value sensor data bus for mobile robot.
+*							 Each topic has one publisher context and a pair of sample slots.
+*							 The publisher fills the back slot with Bus_Claim() and swaps it
+*							 in with Bus_Publish(). Any number of subscribers read the front
+*							 slot in place through Bus_Latest() and confirm with Bus_Valid()
+*							 that it was not reused while they read it.
+********************************************************************************/
+
+#ifndef __Bus_H
+#define __Bus_H
+
+#include "stm32f303xe.h"
+#include "RCServo.h"
+
+// Topics
+#define BUS_TOPIC_ENCODER		0		// Bus_Encoder, TIM2_IRQHandler on every capture
+#define BUS_TOPIC_ULTRA			1		// Bus_Ultra, Ultra_EchoRx() on every echo
+#define BUS_TOPIC_SERVO			2		// Bus_Servo, TIM1_BRK_TIM15_IRQHandler every 20ms frame
+#define BUS_TOPIC_COUNT			3
+
+// Wheel encoders, indexed by LEFT_ENC/RIGHT_ENC
+typedef struct {
+	uint32_t period[2];			// Time between the last two captures (us)
+	uint32_t edges[2];			// Captures so far
+} Bus_Encoder;
+
+// Ultrasonic sensor
+typedef struct {
+	uint32_t echo;					// Echo pulse width (us)
+	uint32_t distance;			// Distance (cm)
+} Bus_Ultra;
+
+// RC servos, indexed by servo number
+typedef struct {
+	int16_t angle[SERVO_COUNT];		// Trajectory angle (0.1 degrees)
+	uint8_t moving;								// Bit per servo following a trajectory
+} Bus_Servo;
+
+// Publish rate statistics (TIM2 us), written by the publisher only
+typedef struct {
+	uint32_t count;					// Samples published
+	uint32_t first;					// Time of the first sample
+	uint32_t last;					// Time of the latest sample
+	uint32_t minInterval;
+	uint32_t maxInterval;
+} Bus_Stats;
+
+// Publisher
+void *Bus_Claim(uint8_t topic);
+void Bus_Publish(uint8_t topic);
+
+// Subscribers
+const void *Bus_Latest(uint8_t topic, uint32_t *version);
+uint8_t Bus_Valid(uint8_t topic, uint32_t version);
+
+void Bus_GetStats(uint8_t topic, Bus_Stats *stats);
+void Bus_Report(void);
+
+#endif
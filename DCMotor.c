@@ -7,8 +7,15 @@
 
 #include "DCMotor.h"
 #include "Utility.h"
+#include "Trace.h"
+#include "Board.h"
+#include "Gpio.h"
+#include "RegInit.h"
 #include "stm32f303xe.h"
 
+_Static_assert(BOARD_DCMOTOR_TIMER == 1 || BOARD_DCMOTOR_TIMER == 8 || BOARD_DCMOTOR_TIMER == 20,
+	"DCMotor.c: CH1N/CH2N outputs need an advanced timer (TIM1, TIM8 or TIM20)");
+
 // Drive Motor Configuration Parameters
 // - Motor Speed Control Pins:
 //    Left Motor	PC10
@@ -24,92 +31,67 @@
 // (A)  0      1     0      1     
 // (B)  0      0     1      1
 
+// Direction pins (Board.h), written together through BSRR so they must share a port
+#define DIR_PORT			BOARD_DCMOTOR_LEFT_FWD_PORT
+#define LEFT_FWD			(1UL << BOARD_DCMOTOR_LEFT_FWD_PIN)
+#define LEFT_BWD			(1UL << BOARD_DCMOTOR_LEFT_BWD_PIN)
+#define RIGHT_FWD			(1UL << BOARD_DCMOTOR_RIGHT_FWD_PIN)
+#define RIGHT_BWD			(1UL << BOARD_DCMOTOR_RIGHT_BWD_PIN)
+
+// GPIO_CONFIGURE() fails the build if a list spans ports
+#define DCMOTOR_DIR_PINS(X) \
+	X(DCMOTOR_RIGHT_FWD, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(DCMOTOR_RIGHT_BWD, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(DCMOTOR_LEFT_FWD, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(DCMOTOR_LEFT_BWD, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO)
+
+#define DCMOTOR_PWM_PINS(X) \
+	X(DCMOTOR_LEFT_PWM, GPIO_MODE_AF, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(DCMOTOR_RIGHT_PWM, GPIO_MODE_AF, GPIO_OTYPE_PP, GPIO_PUPD_NO)
+
+#define DCMOTOR_CHANNELS(X) \
+	X(1, TIMER_OC_PWM1, TIMER_CC_OUTN) \
+	X(2, TIMER_OC_PWM1, TIMER_CC_OUTN)
+
+// TIM8 counting in 1us with a 1ms PWM period, outputs at 0us ON-time
+// Timer Period = (Prescaler + 1) / SystemClockFreq, 1us = (71 + 1) / 72MHz
+static const RegInit_Write dcMotorTimer[] = {
+	REG_SET(BOARD_TIM_ENR(BOARD_DCMOTOR_TIMER), BOARD_TIM_EN(BOARD_DCMOTOR_TIMER)),		// Turn on the motor timer
+	REG_FORCE(DCMOTOR_TIMER->PSC, 0xFFFFUL, 71UL),						// Set PSC so it counts in 1us
+	REG_CLEAR(DCMOTOR_TIMER->CR1, TIM_CR1_DIR),							// Upcounting
+	REG_FORCE(DCMOTOR_TIMER->ARR, 0xFFFFUL, 999UL),					// ARR = 1000us - 1
+	REG_SET(DCMOTOR_TIMER->CR1, TIM_CR1_ARPE),								// Enable ARR preload (ARPE) in CR1
+	REG_SET(DCMOTOR_TIMER->BDTR, TIM_BDTR_MOE),							// Set main output enabled (MOE) in BDTR
+	REG_WRITE(DCMOTOR_TIMER->CCR1, 0UL),											// CH1N (left) initial ON-time of 0us
+	REG_WRITE(DCMOTOR_TIMER->CCR2, 0UL),											// CH2N (right) initial ON-time of 0us
+};
+
 /*************************************************************
 * DCMotor_Init() - Initiate and configure DC motors.
 * No inputs.
 * No return value.
 *************************************************************/	
 void DCMotor_Init(void){
-	ENABLE_GPIO_CLOCK(C);		// Enable GPIO Clock
-	
-	// Configure Pins 
-	// Mode = Output
-	GPIO_MODER_SET(C, 8, GPIO_MODE_OUT);
-	GPIO_MODER_SET(C, 9, GPIO_MODE_OUT);
-	GPIO_MODER_SET(C, 12, GPIO_MODE_OUT);
-	GPIO_MODER_SET(C, 13, GPIO_MODE_OUT);
-	
-	// Output Type = Push Pull
-	GPIO_OTYPER_SET(C, 8, GPIO_OTYPE_PP);
-	GPIO_OTYPER_SET(C, 9, GPIO_OTYPE_PP);
-	GPIO_OTYPER_SET(C, 12, GPIO_OTYPE_PP);
-	GPIO_OTYPER_SET(C, 13, GPIO_OTYPE_PP);
-	
-	// Pull-up / Pull-down = No Pull
-	GPIO_PUPDR_SET(C, 8, GPIO_PUPD_NO);
-	GPIO_PUPDR_SET(C, 9, GPIO_PUPD_NO);
-	GPIO_PUPDR_SET(C, 12, GPIO_PUPD_NO);
-	GPIO_PUPDR_SET(C, 13, GPIO_PUPD_NO);
+	// Direction pins: output, push-pull, no pull
+	GPIO_CONFIGURE(DIR_PORT, DCMOTOR_DIR_PINS);
 	
 	// Initial Output Value should be set to 0 (STOP by default)
-	CLEAR_BITS(GPIOC->ODR, GPIO_ODR_8);
-	CLEAR_BITS(GPIOC->ODR, GPIO_ODR_9);
-	CLEAR_BITS(GPIOC->ODR, GPIO_ODR_12);
-	CLEAR_BITS(GPIOC->ODR, GPIO_ODR_13);
-	
-	
-	// Speed Control
-	// Mode = Alternative Function 4
-	GPIO_MODER_SET(C, 10, GPIO_MODE_AF);
-	GPIO_MODER_SET(C, 11, GPIO_MODE_AF);
-	
-	GPIO_AFR_SET(C, 10, 4);
-	GPIO_AFR_SET(C, 11, 4);
+	GPIO_PORT_WRITE(DIR_PORT, RIGHT_FWD | RIGHT_BWD | LEFT_FWD | LEFT_BWD, 0UL);
 	
-	// Output Type = Push Pull
-	GPIO_OTYPER_SET(C, 10, GPIO_OTYPE_PP);
-	GPIO_OTYPER_SET(C, 11, GPIO_OTYPE_PP);
-	
-	// Pull-up / Pull-down = No Pull
-	GPIO_PUPDR_SET(C, 10, GPIO_PUPD_NO);
-	GPIO_PUPDR_SET(C, 11, GPIO_PUPD_NO);
+	// Speed pins: TIM8 CH1N/CH2N alternate function, push-pull, no pull
+	GPIO_CONFIGURE(BOARD_DCMOTOR_LEFT_PWM_PORT, DCMOTOR_PWM_PINS);
 	
 	
 	// Configure TIM8 for CH1N and CH2N
-	SET_BITS(RCC->APB2ENR, RCC_APB2ENR_TIM8EN);		// Turn on Timer 8
-	SET_BITS(TIM8->PSC, 71UL);										// Set PSC so it counts in 1us
-		// Timer Period = (Prescaler + 1) / SystemClockFreq
-		// 1us = (Prescaler + 1) / 72MHz
-		// (Prescaler + 1) = 72
-		// Prescaler = 71
-	CLEAR_BITS(TIM8->CR1, TIM_CR1_DIR);						// Set TIM8 counting direction to upcounting
-	FORCE_BITS(TIM8->ARR, 0xFFFFUL, 999UL);				// Set ARR to 999us
-		// ARR = Repeating Counter Period - 1
-		// ARR = 1000us - 1
-		// ARR = 999us
-	SET_BITS(TIM8->CR1, TIM_CR1_ARPE);						// Enable ARR preload (ARPE) in CR1
-	SET_BITS(TIM8->BDTR, TIM_BDTR_MOE);						// Set main output enabled (MOE) in BDTR
-	
-	
-	// Configure CH1N of TIM8 for Left Wheel PWM output compare mode
-	FORCE_BITS(TIM8->CCMR1, TIM_CCMR1_OC1M_Msk, 0x6UL << TIM_CCMR1_OC1M_Pos);				// Set TIM8 to PWM mode
-	SET_BITS(TIM8->CCMR1, TIM_CCMR1_OC1PE); 																				// Enable output compare preload on channel 1
-	SET_BITS(TIM8->CCER, TIM_CCER_CC1NE);																						// Enable the COMPLEMENTARY output channel (CH1N)
-	CLEAR_BITS(TIM8->CCER, TIM_CCER_CC1NP);																					// Make CH1N active HI
-	CLEAR_BITS(TIM8->CCR1, TIM_CCR1_CCR1);																					// Set the CH1N initial PWM ON-time to 0us
+	RegInit_Apply(dcMotorTimer, REG_TABLE_SIZE(dcMotorTimer));
 	
-	
-	// Configure CH2N of TIM8 for Right Wheel PWM output compare mode
-	FORCE_BITS(TIM8->CCMR1, TIM_CCMR1_OC2M_Msk, 0x6UL << TIM_CCMR1_OC2M_Pos);				// Set TIM8 to PWM mode
-	SET_BITS(TIM8->CCMR1, TIM_CCMR1_OC2PE); 																				// Enable output compare preload on channel 2
-	SET_BITS(TIM8->CCER, TIM_CCER_CC2NE);																						// Enable the COMPLEMENTARY output channel (CH2N)
-	CLEAR_BITS(TIM8->CCER, TIM_CCER_CC2NP);																					// Make CH2N active HI
-	CLEAR_BITS(TIM8->CCR1, TIM_CCR1_CCR1);																					// Set the CH2N initial PWM ON-time to 0us
+	// CH1N (left) and CH2N (right) in PWM mode 1 with preload, active HI
+	TIMER_OC_CONFIGURE(DCMOTOR_TIMER, DCMOTOR_CHANNELS);
 	
 	
 	// Start TIM8 CH1N and CH2N Outputs
-	SET_BITS(TIM8->EGR, TIM_EGR_UG);				// Force an update event to preload all the registers
-	SET_BITS(TIM8->CR1, TIM_CR1_CEN);				// Enable TIM8 to start counting
+	SET_BITS(DCMOTOR_TIMER->EGR, TIM_EGR_UG);				// Force an update event to preload all the registers
+	SET_BITS(DCMOTOR_TIMER->CR1, TIM_CR1_CEN);				// Enable TIM8 to start counting
 }
 
 /*************************************************************
@@ -130,12 +112,14 @@ void DCMotor_SetSpeed(uint8_t motor, uint16_t dutyCycle){
 	// Convert to ms ON-time
 	dutyCycle *= 10;	// dutyCycle = (dutyCycle * 1000) / 100
 	
+	TRACE(TRACE_MOTOR_SPEED, (motor << 8) | (dutyCycle / 10));
+	
 	// Output PW duty cycle
 	if(motor == DCMOTOR_LEFT){
-		FORCE_BITS(TIM8->CCR1, 0xFFFFUL, dutyCycle);
+		FORCE_BITS(DCMOTOR_TIMER->CCR1, 0xFFFFUL, dutyCycle);
 	}
 	else if(motor == DCMOTOR_RIGHT){
-		FORCE_BITS(TIM8->CCR2, 0xFFFFUL, dutyCycle);
+		FORCE_BITS(DCMOTOR_TIMER->CCR2, 0xFFFFUL, dutyCycle);
 	}
 }	
 
@@ -163,41 +147,37 @@ void DCMotor_SetDir(uint8_t motor, uint8_t dir){
 	// dir:			0 - stop
 	//					1 - forward
 	//					2 - backwards
+	
+	TRACE(TRACE_MOTOR_DIR, (motor << 8) | dir);
 
 	// Left motor
 	if(motor == DCMOTOR_LEFT){
 		// Left motor stop
-		CLEAR_BITS(GPIOC->ODR, GPIO_ODR_12);
-		CLEAR_BITS(GPIOC->ODR, GPIO_ODR_13);
+		GPIO_PORT_WRITE(DIR_PORT, LEFT_FWD | LEFT_BWD, 0UL);
 		Delay_ms(5);
 
 		// Left motor fwd
 		if(dir == DCMOTOR_FWD){
-			SET_BITS(GPIOC->ODR, GPIO_ODR_12);
-			CLEAR_BITS(GPIOC->ODR, GPIO_ODR_13);
+			GPIO_PORT_WRITE(DIR_PORT, LEFT_FWD | LEFT_BWD, LEFT_FWD);
 		}
 		// Left motor bwd
 		else if(dir == DCMOTOR_BWD){
-			CLEAR_BITS(GPIOC->ODR, GPIO_ODR_12);
-			SET_BITS(GPIOC->ODR, GPIO_ODR_13);
+			GPIO_PORT_WRITE(DIR_PORT, LEFT_FWD | LEFT_BWD, LEFT_BWD);
 		}
 	}
 	// Right motor
 	else if (motor == DCMOTOR_RIGHT){
 		// Right motor stop
-		CLEAR_BITS(GPIOC->ODR, GPIO_ODR_8);
-		CLEAR_BITS(GPIOC->ODR, GPIO_ODR_9);
+		GPIO_PORT_WRITE(DIR_PORT, RIGHT_FWD | RIGHT_BWD, 0UL);
 		Delay_ms(5);
 		
 		// Right motor fwd
 		if(dir == DCMOTOR_FWD){
-			SET_BITS(GPIOC->ODR, GPIO_ODR_8);
-			CLEAR_BITS(GPIOC->ODR, GPIO_ODR_9);
+			GPIO_PORT_WRITE(DIR_PORT, RIGHT_FWD | RIGHT_BWD, RIGHT_FWD);
 		}
 		// Right motor bwd
 		else if(dir == DCMOTOR_BWD){
-			CLEAR_BITS(GPIOC->ODR, GPIO_ODR_8);
-			SET_BITS(GPIOC->ODR, GPIO_ODR_9);
+			GPIO_PORT_WRITE(DIR_PORT, RIGHT_FWD | RIGHT_BWD, RIGHT_BWD);
 		}
 	}
 }
@@ -235,6 +215,15 @@ void DCMotor_Stop(void){
 	DCMotor_SetMotors(DCMOTOR_STOP, 0, DCMOTOR_STOP, 0);
 }
 
+/*******************************************************************
+* DCMotor_IsRunning() - Check if either motor is driven.
+* No inputs.
+* Returns 1 if a motor direction is set, otherwise 0.
+*******************************************************************/	
+uint8_t DCMotor_IsRunning(void){
+	return((GPIO(DIR_PORT)->ODR & (RIGHT_FWD | RIGHT_BWD | LEFT_FWD | LEFT_BWD)) != 0);
+}
+
 /*******************************************************************
 * DCMotor_Forward() - Both motors spin forwards.
 * dutyCycle		- The desired % of duty cycle for ON-time.
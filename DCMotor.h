@@ -9,6 +9,9 @@
 #define	 DCMOTOR_H
 
 #include "stm32f303xe.h"
+#include "Board.h"
+
+#define DCMOTOR_TIMER		BOARD_TIM(BOARD_DCMOTOR_TIMER)		// CH1N (left) and CH2N (right) PWM
 
 #define DCMOTOR_LEFT 0UL
 #define DCMOTOR_RIGHT	1UL
@@ -23,6 +26,7 @@ void DCMotor_SetMotor(uint8_t motor, uint8_t dir, uint16_t dutyCycle);
 void DCMotor_SetMotors(uint8_t leftDir, uint16_t leftDutyCycle, uint8_t rightDir, uint16_t rightDutyCycle);
 
 void DCMotor_Stop(void);
+uint8_t DCMotor_IsRunning(void);
 void DCMotor_Forward(uint16_t dutyCycle);
 void DCMotor_Backward(uint16_t dutyCycle);
 
@@ -6,22 +6,67 @@
 ********************************************************************************/
 
 #include "Encoder.h"
+#include "Profile.h"
+#include "IsrMonitor.h"
+#include "Trace.h"
+#include "Gpio.h"
+#include "RegInit.h"
+#include "Bus.h"
+#include "Kernel.h"
+
+_Static_assert(BOARD_ENCODER_TIMER == 2, "Encoder.c: TIM2_IRQHandler serves the encoder timer");
 
 
 /******************************************************************
-*												GLOBAL VARIABLES									  			*
+*												STATIC VARIABLES									  			*
 ******************************************************************/	
 
-uint32_t Global_LeftEncoderPeriod = 0;
-uint32_t Global_RightEncoderPeriod = 0;
+// Written only by TIM2_IRQHandler, published to BUS_TOPIC_ENCODER
+typedef struct {
+	uint32_t capture;		// Last capture (us)
+	uint32_t period;		// Time between the last two captures (us)
+	uint32_t edges;			// Captures so far
+} Encoder_Wheel;
 
+static Encoder_Wheel wheels[2];				// LEFT_ENC, RIGHT_ENC
 
-/******************************************************************
-*												STATIC VARIABLES									  			*
-******************************************************************/	
 
-static uint32_t leftEncoder[2] = {0, 0};		// [0] = current, [1] = previous
-static uint32_t rightEncoder[2] = {0, 0};		// [0] = current, [1] = previous
+// Capture inputs (Board.h)
+#define ENCODER_PINS(X) \
+	X(ENCODER_LEFT, GPIO_MODE_AF, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(ENCODER_RIGHT, GPIO_MODE_AF, GPIO_OTYPE_PP, GPIO_PUPD_NO)
+
+
+// TIM2 counting in 1us, CH1 (left) and CH2 (right) capturing rising edges
+// Timer Period = (Prescaler + 1) / SystemClockFreq, 1us = (71 + 1) / 72MHz
+static const RegInit_Write encoderTimer[] = {
+	REG_SET(BOARD_TIM_ENR(BOARD_ENCODER_TIMER), BOARD_TIM_EN(BOARD_ENCODER_TIMER)),												// Enable TIM2 on APB1
+	REG_FORCE(ENCODER_TIMER->PSC, 0xFFFFUL, 71UL),															// Set prescaler counts in 1us
+	REG_CLEAR(ENCODER_TIMER->CR1, TIM_CR1_DIR),																// Set counting direction to upcounting
+	REG_FORCE(ENCODER_TIMER->CCMR1, TIM_CCMR1_CC1S | TIM_CCMR1_CC2S,
+		TIM_CCMR1_CC1S_0 | TIM_CCMR1_CC2S_0),														// CH1 on TI1, CH2 on TI2 (normal mode 0%01)
+	REG_FORCE(ENCODER_TIMER->CCER, TIM_CCER_CC1E | TIM_CCER_CC1P | TIM_CCER_CC1NP | TIM_CCER_CC2E | TIM_CCER_CC2P | TIM_CCER_CC2NP,
+		TIM_CCER_CC1E | TIM_CCER_CC2E),																	// Enable both captures on rising edges
+	REG_WRITE(ENCODER_TIMER->CCR1, 0UL),																				// Clear garbage values from CCR1
+	REG_WRITE(ENCODER_TIMER->CCR2, 0UL),																				// Clear garbage values from CCR2
+	REG_SET(ENCODER_TIMER->DIER, TIM_DIER_CC1IE | TIM_DIER_CC2IE),							// Enable encoder CH1 and CH2 to trigger IRQ
+};
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+/*********************************************************
+* Encoder_Capture() - Record a capture (TIM2_IRQHandler only).
+* wheel		- Wheel state.
+* capture	- Capture register value (us).
+* No return value.
+*********************************************************/
+CCM_FUNC static void Encoder_Capture(Encoder_Wheel *wheel, uint32_t capture){
+	wheel->period = capture - wheel->capture;
+	wheel->capture = capture;
+	wheel->edges++;
+}
 
 
 /******************************************************************
@@ -38,49 +83,18 @@ void Encoder_Init(void){
 
 	
 	// Configure GPIOA P0 and P1
-	ENABLE_GPIO_CLOCK(A);									// Enable GPIO Port A	
-	GPIO_MODER_SET(A, 0, GPIO_MODE_AF);
-	GPIO_MODER_SET(A, 1, GPIO_MODE_AF);
-	GPIO_PUPDR_SET(A, 0, GPIO_PUPD_NO);		// ?? Scott says this should be Pull-up
-	GPIO_PUPDR_SET(A, 1, GPIO_PUPD_NO);
-	GPIO_AFR_SET(A, 0, 1);								// TIM2 CH1
-	GPIO_AFR_SET(A, 1, 1);								// TIM2 CH2
-	
+	GPIO_CONFIGURE(BOARD_ENCODER_LEFT_PORT, ENCODER_PINS);		// TIM2 CH1 and CH2, ?? Scott says this should be Pull-up
 	
-	// Configure TIM2 for Both CH1 and CH2 inputs
-	SET_BITS(RCC->APB1ENR, RCC_APB1ENR_TIM2EN);		// Enable TIM2 on APB1
-	SET_BITS(TIM2->PSC, 71UL);										// Set prescaler counts in 1us
-		// Timer Period = (Prescaler + 1) / SystemClockFreq
-		// 1us = (Prescaler + 1) / 72MHz
-		// (Prescaler + 1) = 72
-		// Prescaler = 71
-	CLEAR_BITS(TIM2->CR1, TIM_CR1_DIR);						// Set counting direction to upcounting
 	
-	
-	// Configure TIM2 CH1 for input capture on Left Encoder
-	SET_BITS(TIM2->CCMR1, TIM_CCMR1_CC1S_0);										// Input capture mode for CH1 (normal mode  0%01)
-	SET_BITS(TIM2->CCER, TIM_CCER_CC1E);												// ENABLE_GPIO_CLOCK input capture for CH1
-	CLEAR_BITS(TIM2->CCER, TIM_CCER_CC1P & TIM_CCER_CC1NP);			// Detect rising edges (by clearing both input capture mode bits)
-	CLEAR_BITS(TIM2->CCR1, TIM_CCR1_CCR1);											// Clear garbage values from CCR1
-	
-	
-	// Configure TIM2 CH2 for input capture on Right Encoder
-	SET_BITS(TIM2->CCMR1, TIM_CCMR1_CC2S_0);										// Input capture mode for CH2 (normal mode  0%01)
-	SET_BITS(TIM2->CCER, TIM_CCER_CC2E);												// ENABLE_GPIO_CLOCK input capture for CH2
-	CLEAR_BITS(TIM2->CCER, TIM_CCER_CC2P & TIM_CCER_CC2NP);			// Detect rising edges (by clearing both input capture mode bits)
-	CLEAR_BITS(TIM2->CCR2, TIM_CCR2_CCR2);											// Clear garbage values from CCR2
-
-	
-	// Configure TIM2 to generate interrupts and configure NVIC to respond
-	SET_BITS(TIM2->DIER, TIM_DIER_CC1IE);						// Enable encoder CH1 to trigger IRQ
-	SET_BITS(TIM2->DIER, TIM_DIER_CC2IE);						// Enable encoder CH2 to trigger IRQ
-	NVIC_EnableIRQ(TIM2_IRQn);											// Enable TIM2 IRQ (TIM2_IRQn) in NVIC
-	NVIC_SetPriority(TIM2_IRQn, ENCODER_PRIORITY);	// Set NVIC priority
+	// Configure TIM2 for input capture on both encoders, with CC1/CC2 interrupts
+	RegInit_Apply(encoderTimer, REG_TABLE_SIZE(encoderTimer));
+	NVIC_EnableIRQ(ENCODER_TIMER_INT);											// Enable TIM2 IRQ (TIM2_IRQn) in NVIC
+	NVIC_SetPriority(ENCODER_TIMER_INT, ENCODER_PRIORITY);	// Set NVIC priority
 	 
 	 
 	// Start TIM2 CH1 and CH2 Input Captures
-	SET_BITS(TIM2->EGR, TIM_EGR_UG);						// Force an update event to preload all the registers
-	SET_BITS(TIM2->CR1, TIM_CR1_CEN);						// Enable TIM2 to start counting
+	SET_BITS(ENCODER_TIMER->EGR, TIM_EGR_UG);						// Force an update event to preload all the registers
+	SET_BITS(ENCODER_TIMER->CR1, TIM_CR1_CEN);						// Enable TIM2 to start counting
 }
 
 /*********************************************************
@@ -88,30 +102,68 @@ void Encoder_Init(void){
 * No inputs.
 * No return value.
 *********************************************************/
-void TIM2_IRQHandler(void){
+CCM_FUNC void TIM2_IRQHandler(void){
+	uint8_t captured = 0;
+	
+	ISR_ENTER(ISR_ENCODER, ENCODER_TIMER);
+	PROF_BEGIN(PROF_ENCODER_ISR);
+	
+	// Kernel wake-up compare on CH3
+	if(IS_BIT_SET(ENCODER_TIMER->DIER, TIM_DIER_CC3IE) && IS_BIT_SET(ENCODER_TIMER->SR, TIM_SR_CC3IF)){
+		Kernel_TimerIrq();
+	}
+	
 	// Left wheel interrupt
-	if(IS_BIT_SET(TIM2->SR, TIM_SR_CC1IF)){
-		leftEncoder[1] = leftEncoder[0];
-		leftEncoder[0] = TIM2->CCR1;
+	if(IS_BIT_SET(ENCODER_TIMER->SR, TIM_SR_CC1IF)){
+		Encoder_Capture(&wheels[LEFT_ENC], ENCODER_TIMER->CCR1);
+		captured = 1;
+		ISR_LATENCY(ISR_ENCODER, wheels[LEFT_ENC].capture);
+		TRACE(TRACE_ENCODER_LEFT, (wheels[LEFT_ENC].period > 0xFFFFUL) ? 0xFFFFUL : wheels[LEFT_ENC].period);
 	}
 	
 	// Right wheel interrupt
-	if(IS_BIT_SET(TIM2->SR, TIM_SR_CC2IF)){
-		rightEncoder[1] = rightEncoder[0];
-		rightEncoder[0] = TIM2->CCR2;
-	}	
+	if(IS_BIT_SET(ENCODER_TIMER->SR, TIM_SR_CC2IF)){
+		Encoder_Capture(&wheels[RIGHT_ENC], ENCODER_TIMER->CCR2);
+		captured = 1;
+		ISR_LATENCY(ISR_ENCODER, wheels[RIGHT_ENC].capture);
+		TRACE(TRACE_ENCODER_RIGHT, (wheels[RIGHT_ENC].period > 0xFFFFUL) ? 0xFFFFUL : wheels[RIGHT_ENC].period);
+	}
+	
+	// Publish both wheels as one sample
+	if(captured){
+		Bus_Encoder *sample = Bus_Claim(BUS_TOPIC_ENCODER);
+		sample->period[LEFT_ENC] = wheels[LEFT_ENC].period;
+		sample->period[RIGHT_ENC] = wheels[RIGHT_ENC].period;
+		sample->edges[LEFT_ENC] = wheels[LEFT_ENC].edges;
+		sample->edges[RIGHT_ENC] = wheels[RIGHT_ENC].edges;
+		Bus_Publish(BUS_TOPIC_ENCODER);
+	}
+	
+	PROF_END(PROF_ENCODER_ISR);
+	ISR_EXIT(ISR_ENCODER);
 }
 
 /****************************************************************************
 * Encoder_CalculateSpeed() - Calculates the speed of each encoder in us/vane
-* No inputs.
+* speed		- Caller's speeds, updated (zero initialize before the first call).
 * No return value.
 ****************************************************************************/
-void Encoder_CalculateSpeed(void){
-	Global_LeftEncoderPeriod = leftEncoder[0] - leftEncoder[1];				// Calculate encoder period (current - previous)
-	leftEncoder[1] = leftEncoder[0] = 0;															// Update previous measurement to current measurement
+void Encoder_CalculateSpeed(Encoder_Speed *speed){
+	const Bus_Encoder *sample;
+	uint32_t version, period[2], edges[2];
 	
-	Global_RightEncoderPeriod = rightEncoder[0] - rightEncoder[1];		// Calculate encoder period
-	rightEncoder[1] = rightEncoder[0] = 0;														// Update previous measurement to current measurement
-
+	// Read both wheels from one ISR sample (retry if the slot is reused mid-read)
+	do{
+		sample = Bus_Latest(BUS_TOPIC_ENCODER, &version);
+		period[LEFT_ENC] = sample->period[LEFT_ENC];
+		period[RIGHT_ENC] = sample->period[RIGHT_ENC];
+		edges[LEFT_ENC] = sample->edges[LEFT_ENC];
+		edges[RIGHT_ENC] = sample->edges[RIGHT_ENC];
+	} while(!Bus_Valid(BUS_TOPIC_ENCODER, version));
+	
+	// A wheel with no captures since this caller's last call is stopped
+	speed->period[LEFT_ENC] = (edges[LEFT_ENC] != speed->edges[LEFT_ENC]) ? period[LEFT_ENC] : 0;
+	speed->period[RIGHT_ENC] = (edges[RIGHT_ENC] != speed->edges[RIGHT_ENC]) ? period[RIGHT_ENC] : 0;
+	speed->edges[LEFT_ENC] = edges[LEFT_ENC];
+	speed->edges[RIGHT_ENC] = edges[RIGHT_ENC];
 }
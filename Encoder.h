@@ -10,28 +10,32 @@
 
 #include "stm32f303xe.h"
 #include "Utility.h"
+#include "Board.h"
 
-#define ENCODER_PORT A
+#define ENCODER_PORT BOARD_ENCODER_LEFT_PORT
 
-#define ENCODER_TIMER				TIM2
-#define ENCODER_TIMER_INT		TIM2_IRQn
+#define ENCODER_TIMER				BOARD_TIM(BOARD_ENCODER_TIMER)
+#define ENCODER_TIMER_INT		BOARD_TIM_IRQ(BOARD_ENCODER_TIMER)
 
 #define LEFT_ENCODER_CH			CCR1
-#define LEFT_ENCODER_PIN 		0  				//PA0
+#define LEFT_ENCODER_PIN 		BOARD_ENCODER_LEFT_PIN
 
 #define RIGHT_ENCODER_CH		CCR2
-#define RIGHT_ENCODER_PIN		1  				//PA1
+#define RIGHT_ENCODER_PIN		BOARD_ENCODER_RIGHT_PIN
 
 #define ENCODER_PRIORITY 9
 
 #define LEFT_ENC	0
 #define RIGHT_ENC 1
 
+// Wheel speeds, one per caller of Encoder_CalculateSpeed() (it keeps the edge counts between calls)
+typedef struct {
+	uint32_t period[2];			// us per vane, 0 if stopped (LEFT_ENC, RIGHT_ENC)
+	uint32_t edges[2];			// Capture counts at the last call
+} Encoder_Speed;
+
 void Encoder_Init(void);
 void TIM2_IRQHandler(void);
-void Encoder_CalculateSpeed(void);
-
-extern uint32_t Global_LeftEncoderPeriod;
-extern uint32_t Global_RightEncoderPeriod;
+void Encoder_CalculateSpeed(Encoder_Speed *speed);
 
 #endif
@@ -0,0 +1,230 @@
+/********************************************************************************
+* Name: Format.c (implementation)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Small integer-only printf shared by the UART and LCD drivers.
+*							 Characters go straight to the sink so no line buffer is needed,
+*							 and all state lives on the stack so it is safe to re-enter.
+********************************************************************************/
+
+#include <stddef.h>
+#include "Format.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define FORMAT_LEFT			0x01		// '-' flag
+#define FORMAT_ZERO			0x02		// '0' flag
+
+#define FORMAT_DIGITS		12			// Enough for a 32-bit value, sign and decimal point
+
+#define FORMAT_Q_DEFAULT	1			// Default %q decimals
+
+static const char hexLower[] = "0123456789abcdef";
+static const char hexUpper[] = "0123456789ABCDEF";
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Format_Pad() - Output a fill character repeatedly.
+* sink	- Output function.
+* c			- Fill character.
+* count	- Number of characters to output.
+* No return value.
+*************************************************************/
+static void Format_Pad(Format_Sink sink, char c, int32_t count){
+	while(count-- > 0){
+		sink(c);
+	}
+}
+
+/*************************************************************
+* Format_Field() - Output a field padded to the requested width.
+* sink		- Output function.
+* sign		- Sign character ('\0' for none).
+* str			- Field text (digits are printed after the sign).
+* len			- Length of str.
+* width		- Minimum field width.
+* flags		- FORMAT_LEFT and FORMAT_ZERO.
+* Returns the number of characters output.
+*************************************************************/
+static uint32_t Format_Field(Format_Sink sink, char sign, const char *str, uint32_t len, int32_t width, uint8_t flags){
+	int32_t pad = width - (int32_t)len - (sign ? 1 : 0);
+	
+	if(pad < 0){
+		pad = 0;
+	}
+	
+	if(!(flags & (FORMAT_LEFT | FORMAT_ZERO))){
+		Format_Pad(sink, ' ', pad);
+	}
+	if(sign){
+		sink(sign);
+	}
+	if(!(flags & FORMAT_LEFT) && (flags & FORMAT_ZERO)){
+		Format_Pad(sink, '0', pad);
+	}
+	for(uint32_t i = 0; i < len; i++){
+		sink(str[i]);
+	}
+	if(flags & FORMAT_LEFT){
+		Format_Pad(sink, ' ', pad);
+	}
+	
+	return(len + (sign ? 1 : 0) + (uint32_t)pad);
+}
+
+/*************************************************************
+* Format_Number() - Convert an unsigned value to text.
+* buff			- Buffer of FORMAT_DIGITS chars, filled from the end.
+* value			- Value to convert.
+* base			- 10 or 16.
+* digits		- Digit characters for the base.
+* decimals	- Digits after the decimal point (0 for none).
+* Returns a pointer to the first character in buff.
+*************************************************************/
+static char *Format_Number(char *buff, uint32_t value, uint32_t base, const char *digits, uint8_t decimals){
+	char *p = buff + FORMAT_DIGITS;
+	uint8_t count = 0;
+	
+	do{
+		if(decimals && count == decimals){
+			*--p = '.';
+		}
+		*--p = digits[value % base];
+		value /= base;
+		count++;
+	} while(value || (decimals && count <= decimals));
+	
+	return(p);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Format_vprintf() - Format a string into a sink.
+* sink	- Output function called once per character.
+* fmt		- Format string.
+* args	- Format arguments.
+* Returns the number of characters output.
+*************************************************************/
+uint32_t Format_vprintf(Format_Sink sink, const char *fmt, va_list args){
+	char buff[FORMAT_DIGITS];
+	uint32_t count = 0;
+	
+	while(*fmt){
+		uint8_t flags = 0;
+		int32_t width = 0;
+		int32_t precision = -1;
+		char sign = '\0';
+		const char *str;
+		uint32_t len;
+		
+		if(*fmt != '%'){
+			sink(*fmt++);
+			count++;
+			continue;
+		}
+		fmt++;
+		
+		// Flags
+		while(*fmt == '-' || *fmt == '0'){
+			flags |= (*fmt == '-') ? FORMAT_LEFT : FORMAT_ZERO;
+			fmt++;
+		}
+		
+		// Width and precision
+		while(*fmt >= '0' && *fmt <= '9'){
+			width = width * 10 + (*fmt++ - '0');
+		}
+		if(*fmt == '.'){
+			fmt++;
+			precision = 0;
+			while(*fmt >= '0' && *fmt <= '9'){
+				precision = precision * 10 + (*fmt++ - '0');
+			}
+		}
+		
+		// Length modifier (long is 32 bits)
+		while(*fmt == 'l' || *fmt == 'h'){
+			fmt++;
+		}
+		
+		switch(*fmt){
+			case 'd':
+			case 'i':
+			case 'q':{
+				int32_t value = va_arg(args, int32_t);
+				uint8_t decimals = 0;
+				
+				if(*fmt == 'q'){
+					decimals = (precision < 0) ? FORMAT_Q_DEFAULT : (uint8_t)precision;
+					if(decimals > 9){
+						decimals = 9;
+					}
+				}
+				if(value < 0){
+					sign = '-';
+				}
+				str = Format_Number(buff, (value < 0) ? 0UL - (uint32_t)value : (uint32_t)value, 10, hexLower, decimals);
+				len = (uint32_t)(buff + FORMAT_DIGITS - str);
+				count += Format_Field(sink, sign, str, len, width, flags);
+				break;
+			}
+			case 'u':
+			case 'x':
+			case 'X':{
+				uint32_t value = va_arg(args, uint32_t);
+				
+				if(*fmt == 'u'){
+					str = Format_Number(buff, value, 10, hexLower, 0);
+				}
+				else{
+					str = Format_Number(buff, value, 16, (*fmt == 'x') ? hexLower : hexUpper, 0);
+				}
+				len = (uint32_t)(buff + FORMAT_DIGITS - str);
+				count += Format_Field(sink, sign, str, len, width, flags);
+				break;
+			}
+			case 's':{
+				str = va_arg(args, const char *);
+				if(str == NULL){
+					str = "(null)";
+				}
+				for(len = 0; str[len] && (precision < 0 || len < (uint32_t)precision); len++);
+				count += Format_Field(sink, sign, str, len, width, flags & FORMAT_LEFT);
+				break;
+			}
+			case 'c':{
+				buff[0] = (char)va_arg(args, int);
+				count += Format_Field(sink, sign, buff, 1, width, flags & FORMAT_LEFT);
+				break;
+			}
+			case '%':{
+				sink('%');
+				count++;
+				break;
+			}
+			// Unknown conversion or end of string
+			default:{
+				if(*fmt == '\0'){
+					return(count);
+				}
+				sink(*fmt);
+				count++;
+				break;
+			}
+		}
+		fmt++;
+	}
+	
+	return(count);
+}
@@ -0,0 +1,24 @@
+/********************************************************************************
+* Name: Format.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Small integer-only printf shared by the UART and LCD drivers.
+*
+* Supports %d %i %u %x %X %s %c %q and %%, with the '-' and '0' flags, a field
+* width and the 'l' modifier (ints and longs are both 32 bits).
+* %q prints a fixed-point integer: %.Nq prints value / 10^N with N decimals
+* (default N = 1, matching the 0.1 unit values used across the robot).
+********************************************************************************/
+
+#ifndef __Format_H
+#define __Format_H
+
+#include <stdarg.h>
+#include "stm32f303xe.h"
+
+// Output one formatted character
+typedef void (*Format_Sink)(char c);
+
+uint32_t Format_vprintf(Format_Sink sink, const char *fmt, va_list args);
+
+#endif
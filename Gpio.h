@@ -0,0 +1,154 @@
+/********************************************************************************
+* Name: Gpio.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Merged pin and timer channel configuration for the mobile robot.
+*							 A driver lists its pins (by Board.h name) or timer channels
+*							 once, the masks and values are folded into a const initializer
+*							 at compile time, and each register is then written with a
+*							 single read-modify-write instead of one per pin.
+********************************************************************************/
+
+#ifndef __Gpio_H
+#define __Gpio_H
+
+#include "stm32f303xe.h"
+#include "Board.h"
+#include "Utility.h"
+
+
+/******************************************************************
+*														GPIO																	*
+******************************************************************/
+
+// Port configuration, every field is built from a pin list at compile time
+typedef struct {
+	uint32_t mask1;				// 1 bit per pin (OTYPER)
+	uint32_t mask2;				// 2 bits per pin (MODER, PUPDR, OSPEEDR)
+	uint32_t moder;
+	uint32_t otyper;
+	uint32_t pupdr;
+	uint32_t afrMask[2];	// AFRL/AFRH, 0 for plain GPIO pins
+	uint32_t afr[2];
+} Gpio_PortConfig;
+
+// Pin list entry: X(name, mode, otype, pupd), with name a Board.h pin (e.g. DCMOTOR_LEFT_PWM).
+// Every callback pastes the name straight away, before it can be expanded as a driver macro (e.g. SERVO_PAN).
+#define GPIO_X_PORTS(name, mode, otype, pupd)		| (1UL << BOARD_PORT_NUM(BOARD_ ## name ## _PORT))
+#define GPIO_X_MASK1(name, mode, otype, pupd)		| (1UL << BOARD_ ## name ## _PIN)
+#define GPIO_X_MASK2(name, mode, otype, pupd)		| (3UL << (BOARD_ ## name ## _PIN * 2))
+#define GPIO_X_MODER(name, mode, otype, pupd)		| ((uint32_t)(mode) << (BOARD_ ## name ## _PIN * 2))
+#define GPIO_X_OTYPER(name, mode, otype, pupd)	| ((uint32_t)(otype) << BOARD_ ## name ## _PIN)
+#define GPIO_X_PUPDR(name, mode, otype, pupd)		| ((uint32_t)(pupd) << (BOARD_ ## name ## _PIN * 2))
+#define GPIO_X_AFRM0(name, mode, otype, pupd)		GPIO_AFR_MASK(BOARD_ ## name ## _PIN, BOARD_ ## name ## _AF, 0)
+#define GPIO_X_AFRM1(name, mode, otype, pupd)		GPIO_AFR_MASK(BOARD_ ## name ## _PIN, BOARD_ ## name ## _AF, 1)
+#define GPIO_X_AFR0(name, mode, otype, pupd)		GPIO_AFR_VALUE(BOARD_ ## name ## _PIN, BOARD_ ## name ## _AF, 0)
+#define GPIO_X_AFR1(name, mode, otype, pupd)		GPIO_AFR_VALUE(BOARD_ ## name ## _PIN, BOARD_ ## name ## _AF, 1)
+
+#define GPIO_AFR_USED(pin, af, word)		((af) != BOARD_GPIO && ((pin) >> 3) == (word))
+#define GPIO_AFR_MASK(pin, af, word)		| (GPIO_AFR_USED(pin, af, word) ? (15UL << (((pin) & 7) * 4)) : 0UL)
+#define GPIO_AFR_VALUE(pin, af, word)		| (GPIO_AFR_USED(pin, af, word) ? ((uint32_t)(af) << (((pin) & 7) * 4)) : 0UL)
+
+#define GPIO_PORT_CONFIG(list) { \
+	.mask1 = 0UL list(GPIO_X_MASK1), \
+	.mask2 = 0UL list(GPIO_X_MASK2), \
+	.moder = 0UL list(GPIO_X_MODER), \
+	.otyper = 0UL list(GPIO_X_OTYPER), \
+	.pupdr = 0UL list(GPIO_X_PUPDR), \
+	.afrMask = {0UL list(GPIO_X_AFRM0), 0UL list(GPIO_X_AFRM1)}, \
+	.afr = {0UL list(GPIO_X_AFR0), 0UL list(GPIO_X_AFR1)}, \
+}
+
+// Enable the port clock and configure every pin in the list (all on the given port)
+#define GPIO_CONFIGURE(port, list) do{ \
+	_Static_assert((0UL list(GPIO_X_PORTS)) == (1UL << BOARD_PORT_NUM(port)), "GPIO_CONFIGURE: pin list spans ports"); \
+	static const Gpio_PortConfig gpioConfig = GPIO_PORT_CONFIG(list); \
+	ENABLE_GPIO_CLOCK(port); \
+	Gpio_Configure(GPIO(port), &gpioConfig); \
+} while(0)
+
+/*************************************************************
+* Gpio_Configure() - Apply a merged port configuration.
+* port		- GPIO port.
+* cfg			- Configuration from GPIO_PORT_CONFIG().
+* No return value.
+*************************************************************/
+static inline void Gpio_Configure(GPIO_TypeDef *port, const Gpio_PortConfig *cfg){
+	// Alternate function, type and pull are set before MODER so the pin never drives a stale setting
+	if(cfg->afrMask[0]){
+		FORCE_BITS(port->AFR[0], cfg->afrMask[0], cfg->afr[0]);
+	}
+	if(cfg->afrMask[1]){
+		FORCE_BITS(port->AFR[1], cfg->afrMask[1], cfg->afr[1]);
+	}
+	FORCE_BITS(port->OTYPER, cfg->mask1, cfg->otyper);
+	FORCE_BITS(port->PUPDR, cfg->mask2, cfg->pupdr);
+	FORCE_BITS(port->MODER, cfg->mask2, cfg->moder);
+}
+
+
+/******************************************************************
+*												TIMER CHANNELS																*
+******************************************************************/
+
+#define TIMER_OC_FROZEN		0UL		// Output compare modes (OCxM)
+#define TIMER_OC_PWM1			6UL
+#define TIMER_OC_PWM2			7UL
+
+#define TIMER_CC_OUT			TIM_CCER_CC1E		// Enable CHx, active high
+#define TIMER_CC_OUTN			TIM_CCER_CC1NE	// Enable CHxN, active high
+#define TIMER_CC_LOW			TIM_CCER_CC1P		// CHx active low
+#define TIMER_CC_LOWN			TIM_CCER_CC1NP	// CHxN active low
+
+// Output compare configuration of one timer, built from a channel list at compile time
+typedef struct {
+	uint32_t ccmrMask[2];	// CCMR1 (CH1/CH2), CCMR2 (CH3/CH4)
+	uint32_t ccmr[2];
+	uint32_t ccerMask;
+	uint32_t ccer;
+} Timer_OcConfig;
+
+// Channel list entry: X(ch, mode, ccer), ch 1-4, mode TIMER_OC_*, ccer TIMER_CC_* bits
+#define TIMER_OC_SHIFT(ch)		((((ch) - 1) & 1) * 8)
+#define TIMER_CC_SHIFT(ch)		(((ch) - 1) * 4)
+#define TIMER_X_CCMRM(ch, word) \
+	| ((((ch) - 1) >> 1 == (word)) ? ((TIM_CCMR1_OC1M_Msk | TIM_CCMR1_OC1PE | TIM_CCMR1_CC1S_Msk) << TIMER_OC_SHIFT(ch)) : 0UL)
+#define TIMER_X_CCMRV(ch, mode, word) \
+	| ((((ch) - 1) >> 1 == (word)) ? ((((mode) & 7UL) << TIM_CCMR1_OC1M_Pos | TIM_CCMR1_OC1PE) << TIMER_OC_SHIFT(ch)) : 0UL)
+#define TIMER_X_CCMRM0(ch, mode, ccer)	TIMER_X_CCMRM(ch, 0)
+#define TIMER_X_CCMRM1(ch, mode, ccer)	TIMER_X_CCMRM(ch, 1)
+#define TIMER_X_CCMR0(ch, mode, ccer)		TIMER_X_CCMRV(ch, mode, 0)
+#define TIMER_X_CCMR1(ch, mode, ccer)		TIMER_X_CCMRV(ch, mode, 1)
+#define TIMER_X_CCERM(ch, mode, ccer)		| (15UL << TIMER_CC_SHIFT(ch))
+#define TIMER_X_CCER(ch, mode, ccer)		| ((uint32_t)(ccer) << TIMER_CC_SHIFT(ch))
+
+#define TIMER_OC_CONFIG(list) { \
+	.ccmrMask = {0UL list(TIMER_X_CCMRM0), 0UL list(TIMER_X_CCMRM1)}, \
+	.ccmr = {0UL list(TIMER_X_CCMR0), 0UL list(TIMER_X_CCMR1)}, \
+	.ccerMask = 0UL list(TIMER_X_CCERM), \
+	.ccer = 0UL list(TIMER_X_CCER), \
+}
+
+// Configure every output compare channel in the list with preload on
+#define TIMER_OC_CONFIGURE(timer, list) do{ \
+	static const Timer_OcConfig ocConfig = TIMER_OC_CONFIG(list); \
+	Timer_OcConfigure((timer), &ocConfig); \
+} while(0)
+
+/*************************************************************
+* Timer_OcConfigure() - Apply a merged output compare configuration.
+* timer		- Timer.
+* cfg			- Configuration from TIMER_OC_CONFIG().
+* No return value.
+*************************************************************/
+static inline void Timer_OcConfigure(TIM_TypeDef *timer, const Timer_OcConfig *cfg){
+	if(cfg->ccmrMask[0]){
+		FORCE_BITS(timer->CCMR1, cfg->ccmrMask[0], cfg->ccmr[0]);
+	}
+	if(cfg->ccmrMask[1]){
+		FORCE_BITS(timer->CCMR2, cfg->ccmrMask[1], cfg->ccmr[1]);
+	}
+	FORCE_BITS(timer->CCER, cfg->ccerMask, cfg->ccer);
+}
+
+#endif
@@ -0,0 +1,241 @@
+/********************************************************************************
+* Name: Hsm.c (implementation)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Event driven hierarchical state machines for mobile robot.
+*							 A transition exits from the current state up to the deepest state
+*							 containing both ends, enters down to the target, then follows the
+*							 initial children. A transition to the current state or one of
+*							 its parents exits and re-enters that state.
+********************************************************************************/
+
+#include <stddef.h>
+#include "Hsm.h"
+#include "Encoder.h"
+#include "UART.h"
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Hsm_CommonParent() - Deepest state containing two states.
+* hsm		- State machine.
+* a			- State (or HSM_NONE).
+* b			- State.
+* Returns the state, or HSM_NONE if they share no parent.
+*************************************************************/
+static uint8_t Hsm_CommonParent(const Hsm_Machine *hsm, uint8_t a, uint8_t b){
+	for(; a != HSM_NONE; a = hsm->states[a].parent){
+		for(uint8_t s = b; s != HSM_NONE; s = hsm->states[s].parent){
+			if(s == a){
+				return(a);
+			}
+		}
+	}
+	return(HSM_NONE);
+}
+
+/*************************************************************
+* Hsm_Change() - Exit and enter states to make target current.
+* hsm			- State machine.
+* target	- State to move to.
+* No return value.
+*************************************************************/
+static void Hsm_Change(Hsm_Machine *hsm, uint8_t target){
+	const Hsm_State *states = hsm->states;
+	uint8_t path[HSM_MAX_DEPTH];
+	uint8_t depth = 0;
+	uint8_t top = Hsm_CommonParent(hsm, hsm->current, target);
+
+	// Leaving and re-entering target itself
+	if(top == target){
+		top = states[target].parent;
+	}
+
+	// Exit innermost first
+	while(hsm->current != top){
+		if(states[hsm->current].exit != NULL){
+			states[hsm->current].exit(hsm);
+		}
+		hsm->current = states[hsm->current].parent;
+	}
+
+	// Enter outermost first
+	for(uint8_t s = target; s != top; s = states[s].parent){
+		path[depth++] = s;
+	}
+	while(depth != 0){
+		hsm->current = path[--depth];
+		if(states[hsm->current].entry != NULL){
+			states[hsm->current].entry(hsm);
+		}
+	}
+
+	// Then drill down through the initial children
+	while(states[hsm->current].initial != HSM_NONE){
+		hsm->current = states[hsm->current].initial;
+		if(states[hsm->current].entry != NULL){
+			states[hsm->current].entry(hsm);
+		}
+	}
+	hsm->stats.transitions++;
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Hsm_Init() - Set up a state machine and enter its initial state.
+* hsm					- State machine.
+* name				- Name for Hsm_Report().
+* states			- State table, indexed by state number.
+* stateCount	- States in the table.
+* initial			- First state (its parents and initial children are entered too).
+* No return value.
+*************************************************************/
+void Hsm_Init(Hsm_Machine *hsm, const char *name, const Hsm_State *states, uint8_t stateCount, uint8_t initial){
+	hsm->name = name;
+	hsm->states = states;
+	hsm->stateCount = stateCount;
+	hsm->current = HSM_NONE;
+	hsm->target = HSM_NONE;
+	hsm->stats.events = hsm->stats.unhandled = hsm->stats.transitions = 0;
+	hsm->stats.minCycles = 0xFFFFFFFFUL;
+	hsm->stats.maxCycles = 0;
+	hsm->stats.totalCycles = 0;
+	Kernel_QueueInit(&hsm->queue, hsm->events, sizeof(Hsm_Event), HSM_QUEUE_SIZE);
+
+	Hsm_Change(hsm, initial);
+	hsm->stats.transitions = 0;
+}
+
+/*************************************************************
+* Hsm_Post() - Queue an event, from any task or ISR.
+* hsm			- State machine.
+* signal	- HSM_SIG_USER or above.
+* param		- Signal specific value.
+* Returns 1 if queued or 0 if the queue was full.
+*************************************************************/
+uint8_t Hsm_Post(Hsm_Machine *hsm, uint8_t signal, uint8_t param){
+	Hsm_Event event = {signal, param};
+
+	return(Kernel_QueueSend(&hsm->queue, &event));
+}
+
+/*************************************************************
+* Hsm_Transition() - Request a transition (event handlers only).
+* hsm			- State machine.
+* target	- State to move to once the handler returns HSM_HANDLED.
+* No return value.
+*************************************************************/
+void Hsm_Transition(Hsm_Machine *hsm, uint8_t target){
+	hsm->target = target;
+}
+
+/*************************************************************
+* Hsm_Dispatch() - Handle one event, innermost state first.
+* hsm			- State machine.
+* event		- Event.
+* No return value.
+*************************************************************/
+void Hsm_Dispatch(Hsm_Machine *hsm, const Hsm_Event *event){
+	uint32_t start = DWT->CYCCNT;
+	uint32_t cycles;
+	uint8_t state;
+
+	hsm->target = HSM_NONE;
+	for(state = hsm->current; state != HSM_NONE; state = hsm->states[state].parent){
+		if(hsm->states[state].handle != NULL && hsm->states[state].handle(hsm, event) == HSM_HANDLED){
+			break;
+		}
+	}
+	if(state == HSM_NONE){
+		hsm->stats.unhandled++;
+	}
+	if(hsm->target != HSM_NONE){
+		Hsm_Change(hsm, hsm->target);
+		hsm->target = HSM_NONE;
+	}
+
+	cycles = DWT->CYCCNT - start;
+	hsm->stats.events++;
+	hsm->stats.totalCycles += cycles;
+	if(cycles < hsm->stats.minCycles){
+		hsm->stats.minCycles = cycles;
+	}
+	if(cycles > hsm->stats.maxCycles){
+		hsm->stats.maxCycles = cycles;
+	}
+}
+
+/*************************************************************
+* Hsm_Run() - Dispatch queued events and ticks forever (the machine's task).
+* hsm			- State machine.
+* tickUs	- HSM_SIG_TICK period (us).
+* lock		- Binary semaphore held while dispatching, or NULL.
+* No return value.
+*************************************************************/
+void Hsm_Run(Hsm_Machine *hsm, uint32_t tickUs, Kernel_Sem *lock){
+	static const Hsm_Event tick = {HSM_SIG_TICK, 0};
+	uint32_t nextTick = ENCODER_TIMER->CNT + tickUs;
+	uint32_t remaining;
+	Hsm_Event event;
+
+	while(1){
+		remaining = nextTick - ENCODER_TIMER->CNT;
+		if((int32_t)remaining <= 0){
+			event = tick;
+			nextTick += tickUs;
+		}
+		else if(!Kernel_QueueReceive(&hsm->queue, &event, remaining)){
+			continue;
+		}
+
+		if(lock != NULL){
+			Kernel_SemTake(lock, KERNEL_FOREVER);
+		}
+		Hsm_Dispatch(hsm, &event);
+		if(lock != NULL){
+			Kernel_SemGive(lock);
+		}
+	}
+}
+
+/*************************************************************
+* Hsm_IsIn() - Check whether a state is active.
+* hsm			- State machine.
+* state		- State.
+* Returns TRUE if state is the current state or one of its parents.
+*************************************************************/
+uint8_t Hsm_IsIn(const Hsm_Machine *hsm, uint8_t state){
+	for(uint8_t s = hsm->current; s != HSM_NONE; s = hsm->states[s].parent){
+		if(s == state){
+			return(1);
+		}
+	}
+	return(0);
+}
+
+/*************************************************************
+* Hsm_Report() - Print the active states and dispatch times over UART.
+* hsm			- State machine.
+* No return value.
+*************************************************************/
+void Hsm_Report(const Hsm_Machine *hsm){
+	Hsm_Stats stats = hsm->stats;
+
+	UART_printf("%s:", hsm->name);
+	for(uint8_t s = hsm->current; s != HSM_NONE; s = hsm->states[s].parent){
+		UART_printf(" %s", hsm->states[s].name);
+	}
+	UART_printf("\n  %lu events (%lu unhandled), %lu transitions, %lu queue drops\n", stats.events,
+		stats.unhandled, stats.transitions, hsm->queue.drops);
+	if(stats.events != 0){
+		UART_printf("  dispatch cycles min %lu, mean %lu, max %lu\n", stats.minCycles,
+			(uint32_t)(stats.totalCycles / stats.events), stats.maxCycles);
+	}
+}
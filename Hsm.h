@@ -0,0 +1,78 @@
+/********************************************************************************
+* Name: Hsm.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Event driven hierarchical state machines for mobile robot.
+*							 States are a const table indexed by state number, each naming its
+*							 parent, its initial child and its entry, exit and event handlers.
+*							 An event unhandled by a state is offered to its parents. Events
+*							 are queued from any task or ISR and dispatched one at a time by
+*							 the machine's own kernel task.
+********************************************************************************/
+
+#ifndef __Hsm_H
+#define __Hsm_H
+
+#include "stm32f303xe.h"
+#include "Kernel.h"
+
+#define HSM_NONE				0xFF		// No parent or no initial child
+#define HSM_QUEUE_SIZE	8				// Events waiting per machine
+#define HSM_MAX_DEPTH		8				// Deepest nesting of states
+
+// Handler results
+#define HSM_UNHANDLED		0				// Offer the event to the parent state
+#define HSM_HANDLED			1
+
+// Signals below HSM_SIG_USER are reserved
+#define HSM_SIG_TICK		0				// Posted by Hsm_Run() every tick
+#define HSM_SIG_USER		1
+
+typedef struct {
+	uint8_t signal;
+	uint8_t param;
+} Hsm_Event;
+
+typedef struct Hsm_Machine Hsm_Machine;
+
+typedef struct {
+	const char *name;
+	uint8_t parent;														// HSM_NONE for a top state
+	uint8_t initial;													// Child entered after this state, or HSM_NONE
+	void (*entry)(Hsm_Machine *hsm);					// NULL for none
+	void (*exit)(Hsm_Machine *hsm);						// NULL for none
+	uint8_t (*handle)(Hsm_Machine *hsm, const Hsm_Event *event);		// NULL passes every event up
+} Hsm_State;
+
+// Dispatch statistics (DWT cycles from dequeue to the end of any transition)
+typedef struct {
+	uint32_t events;
+	uint32_t unhandled;				// Events no state handled
+	uint32_t transitions;
+	uint32_t minCycles;
+	uint32_t maxCycles;
+	uint64_t totalCycles;
+} Hsm_Stats;
+
+struct Hsm_Machine {
+	const char *name;
+	const Hsm_State *states;
+	uint8_t stateCount;
+	uint8_t current;					// Innermost active state
+	uint8_t target;						// Transition requested by the running handler
+	Kernel_Queue queue;
+	Hsm_Event events[HSM_QUEUE_SIZE];
+	Hsm_Stats stats;
+};
+
+#define HSM_TABLE_SIZE(table)		((uint8_t)(sizeof(table) / sizeof((table)[0])))
+
+void Hsm_Init(Hsm_Machine *hsm, const char *name, const Hsm_State *states, uint8_t stateCount, uint8_t initial);
+uint8_t Hsm_Post(Hsm_Machine *hsm, uint8_t signal, uint8_t param);
+void Hsm_Transition(Hsm_Machine *hsm, uint8_t target);
+void Hsm_Dispatch(Hsm_Machine *hsm, const Hsm_Event *event);
+void Hsm_Run(Hsm_Machine *hsm, uint32_t tickUs, Kernel_Sem *lock);
+uint8_t Hsm_IsIn(const Hsm_Machine *hsm, uint8_t state);
+void Hsm_Report(const Hsm_Machine *hsm);
+
+#endif
@@ -0,0 +1,150 @@
+/********************************************************************************
+* Name: IsrMonitor.c (implementation)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Interrupt latency and load measurement for mobile robot.
+*							 ISR run times use the DWT cycle counter started by Profile_Init(), the
+*							 window uses the free running 1us TIM2 counter as the core may sleep.
+********************************************************************************/
+
+#include "IsrMonitor.h"
+#include "UART.h"
+#include "Utility.h"
+#include "Encoder.h"
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/	
+
+static IsrMonitor_Stats isrStats[ISR_COUNT];
+static volatile uint8_t isrNesting = 0;			// ISRs currently active
+static volatile uint8_t maxNesting = 0;			// Deepest nesting this window
+static uint32_t windowStart = 0;						// TIM2 count at start of the window (us)
+
+static const char *isrNames[ISR_COUNT] = {
+	"TIM2 (encoder)",
+	"TIM6 (stepper)",
+	"TIM15 (servo)",
+	"USART2 (uart)"
+};
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* IsrMonitor_ResetWindow() - Clears the statistics and starts a new window.
+* No inputs.
+* No return value.
+*************************************************************/
+static void IsrMonitor_ResetWindow(void){
+	for(int i = 0; i < ISR_COUNT; i++){
+		isrStats[i].count = 0;
+		isrStats[i].busyCycles = 0;
+		isrStats[i].maxCycles = 0;
+		isrStats[i].latencySum = 0;
+		isrStats[i].maxLatency = 0;
+	}
+	maxNesting = isrNesting;
+	windowStart = ENCODER_TIMER->CNT;
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* IsrMonitor_Init() - Start the first measurement window.
+* No inputs.
+* No return value.
+*************************************************************/
+void IsrMonitor_Init(void){
+	IsrMonitor_ResetWindow();
+}
+
+/*************************************************************
+* IsrMonitor_Enter() - Timestamp ISR entry.
+* No inputs.
+* Returns the entry cycle count.
+*************************************************************/
+CCM_FUNC uint32_t IsrMonitor_Enter(void){
+	uint32_t now = DWT->CYCCNT;
+	
+	// Higher priority ISRs return before this one resumes, so ++/-- stay balanced
+	isrNesting++;
+	if(isrNesting > maxNesting){
+		maxNesting = isrNesting;
+	}
+	return(now);
+}
+
+/*************************************************************
+* IsrMonitor_Latency() - Record the delay from the hardware event to ISR entry.
+* id			- ISR ID.
+* ticks		- Timer ticks from the capture/update event to entry.
+* No return value.
+*************************************************************/
+CCM_FUNC void IsrMonitor_Latency(uint8_t id, uint32_t ticks){
+	isrStats[id].latencySum += ticks;
+	if(ticks > isrStats[id].maxLatency){
+		isrStats[id].maxLatency = ticks;
+	}
+}
+
+/*************************************************************
+* IsrMonitor_Exit() - Timestamp ISR exit and add its run time to the window.
+* id			- ISR ID.
+* start		- Entry cycle count from IsrMonitor_Enter().
+* No return value.
+*************************************************************/
+CCM_FUNC void IsrMonitor_Exit(uint8_t id, uint32_t start){
+	uint32_t cycles = DWT->CYCCNT - start;
+	
+	isrStats[id].count++;
+	isrStats[id].busyCycles += cycles;
+	if(cycles > isrStats[id].maxCycles){
+		isrStats[id].maxCycles = cycles;
+	}
+	isrNesting--;
+}
+
+/*************************************************************
+* IsrMonitor_Report() - Print per-ISR load and latency for the window over UART and start a new window.
+* No inputs.
+* No return value.
+*************************************************************/
+void IsrMonitor_Report(void){
+	IsrMonitor_Stats stats[ISR_COUNT];
+	uint32_t window;		// Window length (us)
+	uint64_t windowCycles;
+	uint8_t nesting;
+	uint32_t primask = __get_PRIMASK();
+	
+	// Snapshot and restart the window with interrupts off
+	__disable_irq();
+	window = ENCODER_TIMER->CNT - windowStart;
+	nesting = maxNesting;
+	for(int i = 0; i < ISR_COUNT; i++){
+		stats[i] = isrStats[i];
+	}
+	IsrMonitor_ResetWindow();
+	__set_PRIMASK(primask);
+	
+	if(window == 0){
+		return;
+	}
+	windowCycles = (uint64_t)window * (SystemCoreClock / 1000000UL);
+	
+	UART_printf("window: %lu us, max nesting: %u\n", (unsigned long)window, nesting);
+	UART_printf("isr               count  load(0.01%%)  max(cyc)  lat avg(us)  lat max(us)\n");
+	for(int i = 0; i < ISR_COUNT; i++){
+		UART_printf("%-15s %7lu %12lu %9lu %12lu %12lu\n", isrNames[i], (unsigned long)stats[i].count,
+			(unsigned long)(((uint64_t)stats[i].busyCycles * 10000UL) / windowCycles),
+			(unsigned long)stats[i].maxCycles,
+			(unsigned long)(stats[i].count ? stats[i].latencySum / stats[i].count : 0),
+			(unsigned long)stats[i].maxLatency);
+	}
+}
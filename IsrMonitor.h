@@ -0,0 +1,53 @@
+/********************************************************************************
+* Name: IsrMonitor.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Interrupt latency and load measurement for mobile robot.
+********************************************************************************/
+
+#ifndef __IsrMonitor_H
+#define __IsrMonitor_H
+
+#include "stm32f303xe.h"
+
+// Set to 0 to compile all ISR instrumentation out
+#define ISR_MONITOR_ENABLE 1
+
+// Monitored ISRs
+#define ISR_ENCODER		0		// TIM2_IRQHandler
+#define ISR_STEPPER		1		// TIM6_DAC_IRQHandler
+#define ISR_SERVO			2		// TIM1_BRK_TIM15_IRQHandler
+#define ISR_UART			3		// USART2_IRQHandler
+#define ISR_COUNT			4
+
+// ISR statistics over the current window
+typedef struct {
+	uint32_t count;					// Interrupts serviced
+	uint32_t busyCycles;		// Cycles spent in the ISR (including nested ISRs)
+	uint32_t maxCycles;			// Longest single ISR run
+	uint32_t latencySum;		// Sum of entry latencies (timer ticks)
+	uint32_t maxLatency;		// Worst entry latency (timer ticks)
+} IsrMonitor_Stats;
+
+#if ISR_MONITOR_ENABLE
+// timer			- Timer that raised the interrupt, its count is latched on entry
+// eventTicks	- Timer count of the hardware event (capture value, or 0 for an update event)
+#define ISR_ENTER(id, timer)					uint32_t isrTicks_##id = (timer)->CNT; uint32_t isrStart_##id = IsrMonitor_Enter()
+#define ISR_LATENCY(id, eventTicks)		IsrMonitor_Latency((id), (uint32_t)(isrTicks_##id - (eventTicks)))
+#define ISR_EXIT(id)									IsrMonitor_Exit((id), isrStart_##id)
+// For interrupts with no timer event to measure the entry latency from
+#define ISR_ENTER_NO_LATENCY(id)			uint32_t isrStart_##id = IsrMonitor_Enter()
+#else
+#define ISR_ENTER(id, timer)
+#define ISR_ENTER_NO_LATENCY(id)
+#define ISR_LATENCY(id, eventTicks)
+#define ISR_EXIT(id)
+#endif
+
+void IsrMonitor_Init(void);
+uint32_t IsrMonitor_Enter(void);
+void IsrMonitor_Latency(uint8_t id, uint32_t ticks);
+void IsrMonitor_Exit(uint8_t id, uint32_t start);
+void IsrMonitor_Report(void);
+
+#endif
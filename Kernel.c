@@ -0,0 +1,522 @@
+/********************************************************************************
+* Name: Kernel.c (implementation)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Preemptive fixed priority kernel for mobile robot.
+*							 Kernel state is only changed with interrupts masked. Any change
+*							 that readies a higher priority task pends PendSV, which runs
+*							 once nothing else is executing and switches to that task.
+********************************************************************************/
+
+#include <string.h>
+#include "Kernel.h"
+#include "KernelPort.h"
+#include "Atomic.h"
+#include "Encoder.h"
+#include "UART.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define KERNEL_PENDSV_PRIORITY	15						// Lowest, switch after every ISR has finished
+
+#define KERNEL_TIMER						ENCODER_TIMER
+
+static const char *stateNames[] = {"ready", "delayed", "blocked"};
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static Kernel_Task *tasks[KERNEL_MAX_TASKS];		// Indexed by priority
+static uint32_t readyMask = 0;									// Bit per ready priority
+static uint32_t delayedMask = 0;								// Bit per priority with a wake time
+static uint32_t switches = 0;
+static volatile uint32_t idleUs = 0;						// Time slept by the idle task
+static uint8_t running = 0;
+
+static Kernel_Task *kernelCurrent = NULL;			// Running task
+
+static Kernel_Task idleTask;
+static uint32_t idleStack[KERNEL_IDLE_STACK];
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Kernel_Now() - Current time.
+* No inputs.
+* Returns the TIM2 count (us).
+*************************************************************/
+static inline uint32_t Kernel_Now(void){
+	return(KERNEL_TIMER->CNT);
+}
+
+/*************************************************************
+* Kernel_Schedule() - Switch to the highest ready task (interrupts masked).
+* No inputs.
+* No return value.
+*************************************************************/
+CCM_FUNC static void Kernel_Schedule(void){
+	if(!running){
+		return;
+	}
+
+	// The idle task is always ready, so readyMask is never 0. A switch pended
+	// earlier is withdrawn if the current task became the highest again
+	// (e.g. blocked, then given by an ISR before PendSV ran).
+	if(tasks[31 - __CLZ(readyMask)] != kernelCurrent){
+		SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+	}
+	else{
+		SCB->ICSR = SCB_ICSR_PENDSVCLR_Msk;
+	}
+}
+
+/*************************************************************
+* Kernel_ArmTimer() - Compare on the earliest wake time (interrupts masked).
+* No inputs.
+* No return value.
+*************************************************************/
+CCM_FUNC static void Kernel_ArmTimer(void){
+	uint32_t now = Kernel_Now();
+	uint32_t earliest = 0xFFFFFFFFUL;
+	uint32_t mask = delayedMask;
+	uint32_t priority, remaining;
+
+	if(mask == 0){
+		BITBAND_PERIPH(KERNEL_TIMER->DIER, TIM_DIER_CC3IE_Pos) = 0;
+		return;
+	}
+
+	while(mask != 0){
+		priority = 31 - __CLZ(mask);
+		mask &= ~(1UL << priority);
+		remaining = tasks[priority]->wake - now;
+		if((int32_t)remaining <= 0){
+			remaining = 0;
+		}
+		if(remaining < earliest){
+			earliest = remaining;
+		}
+	}
+
+	KERNEL_TIMER->CCR3 = now + earliest;
+	KERNEL_TIMER->SR = ~TIM_SR_CC3IF;
+	BITBAND_PERIPH(KERNEL_TIMER->DIER, TIM_DIER_CC3IE_Pos) = 1;
+
+	// Already due (or passed while arming), raise the compare event by hand
+	if((int32_t)(now + earliest - Kernel_Now()) <= 0){
+		KERNEL_TIMER->EGR = TIM_EGR_CC3G;
+	}
+}
+
+/*************************************************************
+* Kernel_Wait() - Take the current task off the ready list (interrupts masked).
+* state			- KERNEL_DELAYED or KERNEL_BLOCKED.
+* timeoutUs	- Time to wake up (KERNEL_FOREVER = never).
+* No return value.
+*************************************************************/
+static void Kernel_Wait(uint8_t state, uint32_t timeoutUs){
+	Kernel_Task *task = kernelCurrent;
+	uint32_t bit = 1UL << task->priority;
+
+	task->state = state;
+	task->timedOut = 0;
+	readyMask &= ~bit;
+	if(timeoutUs != KERNEL_FOREVER){
+		task->wake = Kernel_Now() + timeoutUs;
+		delayedMask |= bit;
+		Kernel_ArmTimer();
+	}
+	Kernel_Schedule();
+}
+
+/*************************************************************
+* Kernel_Ready() - Put a waiting task back on the ready list (interrupts masked).
+* task		- Task to wake.
+* No return value.
+*************************************************************/
+CCM_FUNC static void Kernel_Ready(Kernel_Task *task){
+	uint32_t bit = 1UL << task->priority;
+
+	if(task->sem != NULL){
+		task->sem->waiting &= ~bit;
+		task->sem = NULL;
+	}
+	delayedMask &= ~bit;
+	readyMask |= bit;
+	task->state = KERNEL_READY;
+}
+
+/*************************************************************
+* Kernel_Switch() - Swap to the highest ready task (PendSV_Handler only, see KernelPort.h).
+* sp		- Current task's stack after saving its registers.
+* Returns the next task's saved stack.
+*************************************************************/
+CCM_FUNC __attribute__((used)) uint32_t *Kernel_Switch(uint32_t *sp){
+	Kernel_Task *next = tasks[31 - __CLZ(readyMask)];		// Chosen now, not when PendSV was pended
+
+	if(kernelCurrent != NULL){
+		kernelCurrent->sp = sp;
+	}
+	if(next != kernelCurrent){
+		next->switches++;
+		switches++;
+	}
+	kernelCurrent = next;
+	return(kernelCurrent->sp);
+}
+
+/*************************************************************
+* Kernel_TaskExit() - Parks a task whose entry function returned (see KernelPort.h).
+* No inputs.
+* No return value.
+*************************************************************/
+void Kernel_TaskExit(void){
+	Atomic_Enter();
+	Kernel_Wait(KERNEL_BLOCKED, KERNEL_FOREVER);
+	__enable_irq();
+	while(1);
+}
+
+/*************************************************************
+* Kernel_Idle() - Lowest priority task, sleeps until an interrupt and counts the time asleep.
+* arg		- Unused.
+* No return value.
+*************************************************************/
+static void Kernel_Idle(void *arg){
+	uint32_t start;
+
+	while(1){
+		// WFI still wakes with interrupts masked, the interrupt runs once the sleep is counted
+		__disable_irq();
+		start = Kernel_Now();
+		__WFI();
+		idleUs += Kernel_Now() - start;
+		__enable_irq();
+	}
+}
+
+/*************************************************************
+* Kernel_StackUsed() - Stack high-water mark of a task.
+* task		- Task.
+* Returns the most words used.
+*************************************************************/
+static uint32_t Kernel_StackUsed(const Kernel_Task *task){
+	uint32_t unused = 0;
+
+	while(unused < task->stackWords && task->stack[unused] == KERNEL_STACK_PAINT){
+		unused++;
+	}
+	return(task->stackWords - unused);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Kernel_Init() - Create the idle task (Encoder_Init must run first for TIM2).
+* No inputs.
+* No return value.
+*************************************************************/
+void Kernel_Init(void){
+	Kernel_TaskCreate(&idleTask, "idle", Kernel_Idle, NULL, idleStack, KERNEL_IDLE_STACK, 0);
+	NVIC_SetPriority(PendSV_IRQn, KERNEL_PENDSV_PRIORITY);
+}
+
+/*************************************************************
+* Kernel_TaskCreate() - Add a ready task.
+* task				- Task control block.
+* name				- Name for Kernel_Report().
+* entry				- Task function, entry(arg).
+* arg					- Argument passed to entry.
+* stack				- Stack memory.
+* stackWords	- Stack size (words).
+* priority		- 1 to KERNEL_MAX_TASKS - 1, unique per task (higher runs first).
+* No return value.
+*************************************************************/
+void Kernel_TaskCreate(Kernel_Task *task, const char *name, void (*entry)(void *), void *arg,
+	uint32_t *stack, uint32_t stackWords, uint8_t priority){
+	uint32_t primask;
+
+	for(uint32_t i = 0; i < stackWords; i++){
+		stack[i] = KERNEL_STACK_PAINT;
+	}
+
+	task->name = name;
+	task->stack = stack;
+	task->stackWords = stackWords;
+	task->sp = KernelPort_InitStack(task, entry, arg);
+	task->sem = NULL;
+	task->switches = 0;
+	task->priority = priority;
+	task->state = KERNEL_READY;
+	task->timedOut = 0;
+
+	primask = Atomic_Enter();
+	tasks[priority] = task;
+	readyMask |= 1UL << priority;
+	Kernel_Schedule();
+	Atomic_Exit(primask);
+}
+
+/*************************************************************
+* Kernel_Start() - Switch from main() to the highest priority task.
+* No inputs.
+* Never returns, main()'s stack becomes the ISR stack.
+*************************************************************/
+void Kernel_Start(void){
+	__disable_irq();
+	KernelPort_Start();
+	running = 1;
+	Kernel_Schedule();
+	__enable_irq();
+
+	while(1);		// PendSV switches away before this is reached
+}
+
+/*************************************************************
+* Kernel_Delay() - Sleep the current task.
+* us		- Time to sleep (us).
+* No return value.
+*************************************************************/
+void Kernel_Delay(uint32_t us){
+	uint32_t primask;
+
+	if(us == 0){
+		return;
+	}
+	primask = Atomic_Enter();
+	Kernel_Wait(KERNEL_DELAYED, us);
+	Atomic_Exit(primask);
+}
+
+/*************************************************************
+* Kernel_DelayUntil() - Sleep until the next period of a periodic task.
+* last		- Start of the current period (us), advanced by period.
+* period	- Task period (us).
+* No return value.
+*************************************************************/
+void Kernel_DelayUntil(uint32_t *last, uint32_t period){
+	uint32_t primask = Atomic_Enter();
+	uint32_t remaining;
+
+	*last += period;
+	remaining = *last - Kernel_Now();
+
+	// Overran the period, start the next one straight away
+	if((int32_t)remaining > 0){
+		Kernel_Wait(KERNEL_DELAYED, remaining);
+	}
+	Atomic_Exit(primask);
+}
+
+/*************************************************************
+* Kernel_SemInit() - Set up a semaphore.
+* sem			- Semaphore.
+* count		- Initial count.
+* limit		- Highest count (1 for a binary semaphore).
+* No return value.
+*************************************************************/
+void Kernel_SemInit(Kernel_Sem *sem, uint32_t count, uint32_t limit){
+	sem->count = count;
+	sem->limit = limit;
+	sem->waiting = 0;
+}
+
+/*************************************************************
+* Kernel_SemGive() - Wake the highest priority waiter, or add a count.
+* sem		- Semaphore.
+* No return value.
+*************************************************************/
+CCM_FUNC void Kernel_SemGive(Kernel_Sem *sem){
+	uint32_t primask = Atomic_Enter();
+
+	// Hand the count straight to a waiter
+	if(sem->waiting != 0){
+		Kernel_Ready(tasks[31 - __CLZ(sem->waiting)]);
+		Kernel_ArmTimer();
+		Kernel_Schedule();
+	}
+	else if(sem->count < sem->limit){
+		sem->count++;
+	}
+	Atomic_Exit(primask);
+}
+
+/*************************************************************
+* Kernel_SemTake() - Take a count, waiting for one if needed.
+* sem				- Semaphore.
+* timeoutUs	- Longest wait (us), 0 to poll or KERNEL_FOREVER.
+* Returns 1 if taken or 0 if the timeout expired.
+*************************************************************/
+uint8_t Kernel_SemTake(Kernel_Sem *sem, uint32_t timeoutUs){
+	uint32_t primask = Atomic_Enter();
+	Kernel_Task *task = kernelCurrent;
+
+	if(sem->count != 0){
+		sem->count--;
+		Atomic_Exit(primask);
+		return(1);
+	}
+	if(timeoutUs == 0){
+		Atomic_Exit(primask);
+		return(0);
+	}
+
+	task->sem = sem;
+	sem->waiting |= 1UL << task->priority;
+	Kernel_Wait(KERNEL_BLOCKED, timeoutUs);
+	Atomic_Exit(primask);
+
+	// Runs again once given or timed out
+	return(!task->timedOut);
+}
+
+/*************************************************************
+* Kernel_QueueInit() - Set up a message queue.
+* queue			- Queue.
+* items			- Buffer of length * itemSize bytes.
+* itemSize	- Bytes per item.
+* length		- Items the buffer holds.
+* No return value.
+*************************************************************/
+void Kernel_QueueInit(Kernel_Queue *queue, void *items, uint16_t itemSize, uint16_t length){
+	queue->items = items;
+	queue->itemSize = itemSize;
+	queue->length = length;
+	queue->head = 0;
+	queue->used = 0;
+	queue->drops = 0;
+	Kernel_SemInit(&queue->filled, 0, length);
+}
+
+/*************************************************************
+* Kernel_QueueSend() - Copy an item to the back of a queue, never waits.
+* queue		- Queue.
+* item		- itemSize bytes.
+* Returns 1 if queued or 0 if full (counted as a drop).
+*************************************************************/
+uint8_t Kernel_QueueSend(Kernel_Queue *queue, const void *item){
+	uint32_t primask = Atomic_Enter();
+	uint16_t slot;
+
+	if(queue->used >= queue->length){
+		queue->drops++;
+		Atomic_Exit(primask);
+		return(0);
+	}
+	slot = queue->head + queue->used;
+	if(slot >= queue->length){
+		slot -= queue->length;
+	}
+	memcpy(&queue->items[slot * queue->itemSize], item, queue->itemSize);
+	queue->used++;
+	Kernel_SemGive(&queue->filled);
+	Atomic_Exit(primask);
+	return(1);
+}
+
+/*************************************************************
+* Kernel_QueueReceive() - Copy out the oldest item, waiting for one if needed.
+* queue			- Queue.
+* item			- Receives itemSize bytes.
+* timeoutUs	- Longest wait (us), 0 to poll or KERNEL_FOREVER.
+* Returns 1 if an item was copied or 0 if the timeout expired.
+*************************************************************/
+uint8_t Kernel_QueueReceive(Kernel_Queue *queue, void *item, uint32_t timeoutUs){
+	uint32_t primask;
+
+	if(!Kernel_SemTake(&queue->filled, timeoutUs)){
+		return(0);
+	}
+
+	primask = Atomic_Enter();
+	memcpy(item, &queue->items[queue->head * queue->itemSize], queue->itemSize);
+	if(++queue->head >= queue->length){
+		queue->head = 0;
+	}
+	queue->used--;
+	Atomic_Exit(primask);
+	return(1);
+}
+
+/*************************************************************
+* Kernel_TimerIrq() - Wake every task whose delay or timeout is due.
+* No inputs.
+* No return value.
+*************************************************************/
+CCM_FUNC void Kernel_TimerIrq(void){
+	uint32_t primask = Atomic_Enter();
+	uint32_t now = Kernel_Now();
+	uint32_t mask = delayedMask;
+	uint32_t priority;
+	Kernel_Task *task;
+
+	KERNEL_TIMER->SR = ~TIM_SR_CC3IF;
+	while(mask != 0){
+		priority = 31 - __CLZ(mask);
+		mask &= ~(1UL << priority);
+		task = tasks[priority];
+		if((int32_t)(task->wake - now) <= 0){
+			task->timedOut = (task->state == KERNEL_BLOCKED);
+			Kernel_Ready(task);
+		}
+	}
+	Kernel_ArmTimer();
+	Kernel_Schedule();
+	Atomic_Exit(primask);
+}
+
+/*************************************************************
+* Kernel_IsRunning() - Check whether tasks have started.
+* No inputs.
+* Returns 1 after Kernel_Start(), otherwise 0.
+*************************************************************/
+uint8_t Kernel_IsRunning(void){
+	return(running);
+}
+
+/*************************************************************
+* Kernel_GetIdleUs() - Total time the idle task has slept.
+* No inputs.
+* Returns the time (us, wraps every ~71 minutes).
+*************************************************************/
+uint32_t Kernel_GetIdleUs(void){
+	return(idleUs);
+}
+
+/*************************************************************
+* Kernel_GetSwitches() - Context switches since Kernel_Start().
+* No inputs.
+* Returns the switch count.
+*************************************************************/
+uint32_t Kernel_GetSwitches(void){
+	return(switches);
+}
+
+/*************************************************************
+* Kernel_Report() - Print every task's state and stack use over UART.
+* No inputs.
+* No return value.
+*************************************************************/
+void Kernel_Report(void){
+	UART_printf("kernel: %lu context switches\n", switches);
+	for(int priority = KERNEL_MAX_TASKS - 1; priority >= 0; priority--){
+		Kernel_Task *task = tasks[priority];
+
+		if(task == NULL){
+			continue;
+		}
+		UART_printf("  %u %-8s %-7s switches %lu, stack %lu of %lu words\n", priority, task->name,
+			stateNames[task->state], task->switches, Kernel_StackUsed(task), task->stackWords);
+	}
+}
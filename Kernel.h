@@ -0,0 +1,94 @@
+/********************************************************************************
+* Name: Kernel.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Preemptive fixed priority kernel for mobile robot.
+*							 One task per priority, the highest ready task always runs and
+*							 PendSV switches tasks on the process stack (PSP). Delays and
+*							 timeouts are tickless: TIM2 CH3 compares against the free
+*							 running 1us count and only interrupts at the next wake-up.
+*							 Semaphores and message queues may be given or sent from ISRs.
+********************************************************************************/
+
+#ifndef __Kernel_H
+#define __Kernel_H
+
+#include "stm32f303xe.h"
+
+#define KERNEL_MAX_TASKS			8						// Priorities 0 (idle, lowest) to 7
+#define KERNEL_IDLE_STACK			96					// Idle task stack (words)
+#define KERNEL_FOREVER				0xFFFFFFFFUL	// Timeout that never expires
+#define KERNEL_STACK_PAINT		0xA5A5A5A5UL	// Fill pattern for unused task stack
+
+// Task states
+#define KERNEL_READY					0
+#define KERNEL_DELAYED				1						// Kernel_Delay() or Kernel_DelayUntil()
+#define KERNEL_BLOCKED				2						// Waiting on a semaphore or queue
+
+typedef struct Kernel_Sem Kernel_Sem;
+
+// Task control block, sp must stay first (PendSV_Handler saves it at offset 0)
+typedef struct {
+	uint32_t *sp;						// Saved process stack pointer
+	const char *name;
+	uint32_t *stack;				// Lowest word of the stack
+	uint32_t stackWords;
+	uint32_t wake;					// TIM2 time to wake when delayed or timing out (us)
+	Kernel_Sem *sem;				// Semaphore being waited on
+	uint32_t switches;			// Times switched in
+	uint8_t priority;
+	uint8_t state;
+	uint8_t timedOut;				// Last wait ended by its timeout
+} Kernel_Task;
+
+// Counting semaphore, waiting has a bit per task priority
+struct Kernel_Sem {
+	volatile uint32_t count;
+	uint32_t limit;					// Gives above this count are dropped (1 = binary)
+	volatile uint32_t waiting;
+};
+
+#define KERNEL_SEM_INIT(count, limit)		{(count), (limit), 0}
+
+// Fixed size message queue copying items in and out of a caller supplied buffer
+typedef struct {
+	uint8_t *items;					// length * itemSize bytes
+	uint16_t itemSize;
+	uint16_t length;
+	uint16_t head;					// Next item to receive
+	uint16_t used;					// Items queued
+	uint32_t drops;					// Sends refused because the queue was full
+	Kernel_Sem filled;			// One count per queued item
+} Kernel_Queue;
+
+// Setup
+void Kernel_Init(void);
+void Kernel_TaskCreate(Kernel_Task *task, const char *name, void (*entry)(void *), void *arg,
+	uint32_t *stack, uint32_t stackWords, uint8_t priority);
+void Kernel_Start(void);
+
+// Tasks
+void Kernel_Delay(uint32_t us);
+void Kernel_DelayUntil(uint32_t *last, uint32_t period);
+
+// Semaphores (give from tasks or ISRs, take from tasks)
+void Kernel_SemInit(Kernel_Sem *sem, uint32_t count, uint32_t limit);
+void Kernel_SemGive(Kernel_Sem *sem);
+uint8_t Kernel_SemTake(Kernel_Sem *sem, uint32_t timeoutUs);
+
+// Message queues (send from tasks or ISRs, receive from tasks)
+void Kernel_QueueInit(Kernel_Queue *queue, void *items, uint16_t itemSize, uint16_t length);
+uint8_t Kernel_QueueSend(Kernel_Queue *queue, const void *item);
+uint8_t Kernel_QueueReceive(Kernel_Queue *queue, void *item, uint32_t timeoutUs);
+
+// Wake-up compare, called from TIM2_IRQHandler
+void Kernel_TimerIrq(void);
+
+uint8_t Kernel_IsRunning(void);
+uint32_t Kernel_GetIdleUs(void);
+uint32_t Kernel_GetSwitches(void);
+void Kernel_Report(void);
+
+void PendSV_Handler(void);
+
+#endif
@@ -0,0 +1,87 @@
+/********************************************************************************
+* Name: KernelPort.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Cortex-M4 port of the kernel. Each task's registers are saved on
+*							 its own process stack (PSP) by PendSV_Handler, main() and every
+*							 ISR keep the main stack (MSP).
+********************************************************************************/
+
+#include "KernelPort.h"
+#include "Utility.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define KERNEL_EXC_RETURN				0xFFFFFFFDUL	// Return to thread mode on PSP, no FPU frame
+#define KERNEL_XPSR							0x01000000UL	// Thumb state
+
+static uint32_t startFrame[32];								// PSP for saving main()'s registers on the first switch
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* KernelPort_InitStack() - Build the frame the first switch to a task pops.
+* task		- Task control block (stack and stackWords set).
+* entry		- Task function, entry(arg).
+* arg			- Argument passed to entry.
+* Returns the task's saved stack pointer.
+*************************************************************/
+uint32_t *KernelPort_InitStack(Kernel_Task *task, void (*entry)(void *), void *arg){
+	uint32_t *sp = (uint32_t *)((uint32_t)&task->stack[task->stackWords] & ~7UL);		// AAPCS 8 byte alignment
+
+	// Exception frame popped by the first return to the task
+	*--sp = KERNEL_XPSR;
+	*--sp = (uint32_t)entry;										// PC
+	*--sp = (uint32_t)Kernel_TaskExit;					// LR
+	*--sp = 0;																	// R12
+	*--sp = 0;																	// R3
+	*--sp = 0;																	// R2
+	*--sp = 0;																	// R1
+	*--sp = (uint32_t)arg;											// R0
+
+	// Registers restored by PendSV_Handler (R4-R11 then EXC_RETURN)
+	*--sp = KERNEL_EXC_RETURN;
+	for(int reg = 11; reg >= 4; reg--){
+		*--sp = 0;
+	}
+	return(sp);
+}
+
+/*************************************************************
+* KernelPort_Start() - Give main() a process stack to be saved on (interrupts masked).
+* No inputs.
+* No return value, the pended switch runs once interrupts are enabled.
+*************************************************************/
+void KernelPort_Start(void){
+	__set_PSP((uint32_t)&startFrame[32]);
+}
+
+/*************************************************************
+* PendSV_Handler() - Save the current task and resume the highest ready task.
+* No inputs.
+* No return value.
+*************************************************************/
+CCM_FUNC __attribute__((naked)) void PendSV_Handler(void){
+	__asm volatile(
+		"	cpsid		i									\n"
+		"	mrs			r0, psp						\n"
+		"	tst			lr, #0x10					\n"		// Task used the FPU, save S16-S31 too
+		"	it			eq								\n"
+		"	vstmdbeq	r0!, {s16-s31}		\n"
+		"	stmdb		r0!, {r4-r11, lr}	\n"
+		"	bl			Kernel_Switch			\n"		// r0 = next task's saved stack
+		"	ldmia		r0!, {r4-r11, lr}	\n"
+		"	tst			lr, #0x10					\n"
+		"	it			eq								\n"
+		"	vldmiaeq	r0!, {s16-s31}		\n"
+		"	msr			psp, r0						\n"
+		"	cpsie		i									\n"
+		"	bx			lr								\n"
+	);
+}
@@ -0,0 +1,24 @@
+/********************************************************************************
+* Name: KernelPort.h (interface)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Processor specific half of the kernel. KernelPort.c switches tasks
+*							 on the Cortex-M4 process stack, host/KernelPort.c runs each task
+*							 on its own POSIX thread for the host build. Only Kernel.c and
+*							 the ports include this.
+********************************************************************************/
+
+#ifndef __KernelPort_H
+#define __KernelPort_H
+
+#include "Kernel.h"
+
+// Provided by Kernel.c
+uint32_t *Kernel_Switch(uint32_t *sp);
+void Kernel_TaskExit(void);
+
+// Provided by the port
+uint32_t *KernelPort_InitStack(Kernel_Task *task, void (*entry)(void *), void *arg);
+void KernelPort_Start(void);
+
+#endif
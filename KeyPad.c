@@ -23,6 +23,21 @@ R4	|	*		|	0		|	#		|	D		|
 
 #include "KeyPad.h"
 #include "Utility.h"
+#include "Profile.h"
+#include "Board.h"
+
+// The matrix scan assumes rows on PB0-PB3 and columns on PB4-PB7
+_Static_assert(BOARD_PORT_NUM(BOARD_KEYPAD_ROW1_PORT) == BOARD_PORT_B && BOARD_KEYPAD_ROW1_PIN == 0 &&
+	BOARD_PORT_NUM(BOARD_KEYPAD_ROW2_PORT) == BOARD_PORT_B && BOARD_KEYPAD_ROW2_PIN == 1 &&
+	BOARD_PORT_NUM(BOARD_KEYPAD_ROW3_PORT) == BOARD_PORT_B && BOARD_KEYPAD_ROW3_PIN == 2 &&
+	BOARD_PORT_NUM(BOARD_KEYPAD_ROW4_PORT) == BOARD_PORT_B && BOARD_KEYPAD_ROW4_PIN == 3 &&
+	BOARD_PORT_NUM(BOARD_KEYPAD_COL1_PORT) == BOARD_PORT_B && BOARD_KEYPAD_COL1_PIN == 4 &&
+	BOARD_PORT_NUM(BOARD_KEYPAD_COL2_PORT) == BOARD_PORT_B && BOARD_KEYPAD_COL2_PIN == 5 &&
+	BOARD_PORT_NUM(BOARD_KEYPAD_COL3_PORT) == BOARD_PORT_B && BOARD_KEYPAD_COL3_PIN == 6 &&
+	BOARD_PORT_NUM(BOARD_KEYPAD_COL4_PORT) == BOARD_PORT_B && BOARD_KEYPAD_COL4_PIN == 7,
+	"KeyPad.c expects rows on PB0-PB3 and columns on PB4-PB7");
+
+#define KEYPAD_ROWS		0xFUL		// PB0-PB3
 
 /******************************************************************
 *												PUBLIC FUNCTIONS													*
@@ -83,10 +98,7 @@ uint8_t KeyPad_MatrixScan(void){
 	//		3. repeate step 2 for the remaining three rows
 	//	if yes no buttons are pressed, exit the scanner
 
-	GPIOB -> ODR &= ~(1UL << (1*0));
-	GPIOB -> ODR &= ~(1UL << (1*1));
-	GPIOB -> ODR &= ~(1UL << (1*2));
-	GPIOB -> ODR &= ~(1UL << (1*3));
+	GPIO_PORT_WRITE(B, KEYPAD_ROWS, 0x0UL);		// Rows PB0-PB3 in one BSRR store
 	
 	//debounce
 	// check for 5 0s in a row
@@ -98,10 +110,7 @@ uint8_t KeyPad_MatrixScan(void){
 	}
 	
 	// CHECKING WHAT BUTTON IS PRESSED
-	GPIOB -> ODR &= ~(1UL << (1*0));
-	GPIOB -> ODR |= (1UL << (1*1));
-	GPIOB -> ODR |= (1UL << (1*2));
-	GPIOB -> ODR |= (1UL << (1*3));
+	GPIO_PORT_WRITE(B, KEYPAD_ROWS, 0xEUL);
 	if(!(IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_4) & IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_5) & IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_6) & IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_7))){
 		if(!IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_4)){
 			return('1');
@@ -119,10 +128,7 @@ uint8_t KeyPad_MatrixScan(void){
 		//return something
 	}
 	
-	GPIOB -> ODR |= (1UL << (1*0));
-	GPIOB -> ODR &= ~(1UL << (1*1));
-	GPIOB -> ODR |= (1UL << (1*2));
-	GPIOB -> ODR |= (1UL << (1*3));
+	GPIO_PORT_WRITE(B, KEYPAD_ROWS, 0xDUL);
 	if(!(IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_4) & IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_5) & IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_6) & IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_7))){
 		//button in this row is pressed
 		//return something
@@ -142,10 +148,7 @@ uint8_t KeyPad_MatrixScan(void){
 		//return something
 	}
 	
-	GPIOB -> ODR |= (1UL << (1*0));
-	GPIOB -> ODR |= (1UL << (1*1));
-	GPIOB -> ODR &= ~(1UL << (1*2));
-	GPIOB -> ODR |= (1UL << (1*3));
+	GPIO_PORT_WRITE(B, KEYPAD_ROWS, 0xBUL);
 	if(!(IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_4) & IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_5) & IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_6) & IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_7))){
 		//button in this row is pressed
 		//return something
@@ -165,10 +168,7 @@ uint8_t KeyPad_MatrixScan(void){
 		//return something
 	}
 	
-	GPIOB -> ODR |= (1UL << (1*0));
-	GPIOB -> ODR |= (1UL << (1*1));
-	GPIOB -> ODR |= (1UL << (1*2));
-	GPIOB -> ODR &= ~(1UL << (1*3));
+	GPIO_PORT_WRITE(B, KEYPAD_ROWS, 0x7UL);
 	if(!(IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_4) & IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_5) & IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_6) & IS_BIT_SET(GPIOB -> IDR, GPIO_IDR_7))){
 		//button in this row is pressed
 		//return something
@@ -199,7 +199,10 @@ uint8_t KeyPad_GetKey(void){
 		uint8_t pressedKey = '\0';
 		static uint8_t lastKey = 'f';
 	
+		PROF_BEGIN(PROF_KEYPAD_SCAN);
 		pressedKey = KeyPad_MatrixScan();
+		PROF_END(PROF_KEYPAD_SCAN);
+		
 		if(pressedKey != 'f' && lastKey == 'f'){
 			lastKey = pressedKey;	
 			return(pressedKey);
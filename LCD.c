@@ -5,16 +5,28 @@
 * Description: LCD functions for mobile robot.
 ********************************************************************************/
 
-#include <stdio.h>
 #include <stdarg.h>
 #include "LCD.h"
+#include "Format.h"
+#include "Boot.h"
 #include "Utility.h"
+#include "Gpio.h"
+#include "Profile.h"
 
 
 /******************************************************************
 *												STATIC VARIABLES									  			*
 ******************************************************************/	
 
+// RS, E and D4-D7 as push-pull outputs, no pull
+#define LCD_PINS(X) \
+	X(LCD_RS, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(LCD_E, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(LCD_D4, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(LCD_D5, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(LCD_D6, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(LCD_D7, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO)
+
 static char customChar[8] = {'<', '>', '|', '}', '{', ']', '[', '^'};		// Default custom character replacements
 
 
@@ -22,19 +34,50 @@ static char customChar[8] = {'<', '>', '|', '}', '{', ']', '[', '^'};		// Defaul
 *												PRIVATE FUNCTIONS													*
 ******************************************************************/
 /*************************************************
-* LCD_GPIO_Init() - Initialize GPIO PA6-11 pins for LCD.
+* LCD_GPIO_Init() - Initialize the LCD GPIO pins (Board.h).
 * No inputs.
 * No return value.
 *************************************************/
 static void LCD_GPIO_Init(void){
-	ENABLE_GPIO_CLOCK(A);
+	GPIO_CONFIGURE(LCD_GPIO_PORT, LCD_PINS);
+}
+
+/*************************************************
+* LCD_WriteCmd() - Clock a command out to the LCD.
+* cmd		- Command.
+* No return value.
+*************************************************/
+static void LCD_WriteCmd(uint8_t cmd){
+	LCD_E_LO;
+	LCD_RS_IR;
 	
-	// Initialize GPIO PA6-11 pins one at a time
-	for(int i=6; i<=11; i++){
-		GPIO_MODER_SET(A, i, GPIO_MODE_OUT);
-		GPIO_OTYPER_SET(A, i, GPIO_OTYPE_PP);
-		GPIO_PUPDR_SET(A, i, GPIO_PUPD_NO);
-	}
+	LCD_E_HI;
+	LCD_BUS(HI_NYBBLE(cmd));
+	LCD_E_LO;
+	
+	LCD_E_HI;
+	LCD_BUS(LO_NYBBLE(cmd));
+	LCD_E_LO;
+}
+
+/*************************************************
+* LCD_Sync() - Send a sync nybble to the LCD.
+* value		- Nybble on the data bus.
+* No return value.
+*************************************************/
+static void LCD_Sync(uint8_t value){
+	LCD_E_HI;
+	LCD_BUS((uint32_t)value);
+	LCD_E_LO;
+}
+
+/*************************************************
+* LCD_Sink() - Format_vprintf() output to LCD.
+* c		- Character to output.
+* No return value.
+*************************************************/
+static void LCD_Sink(char c){
+	LCD_putc((unsigned char)c);
 }
 
 
@@ -50,7 +93,7 @@ void LCD_Init(void){
 	LCD_GPIO_Init();
 	
 	// Get ready for LCD communication
-	CLEAR_BITS(LCD_PORT, LCD_PORT_BITS);		// Clear all bits on the LCD port
+	GPIO_PINS_CLEAR(LCD_GPIO_PORT, LCD_PORT_BITS);		// Clear all bits on the LCD port
 	LCD_E_LO;																// Set E LOW
 	LCD_RS_IR;															// Set RS to instruction
 	Delay_ms(10);														// Wait 10ms
@@ -97,6 +140,65 @@ void LCD_Init(void){
 	LCD_cmd(LCD_CMD_DISPLAY | LCD_DISPLAY_ON | LCD_DISPLAY_NOBLINK | LCD_DISPLAY_NOCURSOR);
 }
 
+/*************************************************
+* LCD_InitStep() - LCD_Init() as a Boot_Run() state machine.
+* No inputs.
+* Returns BOOT_BUSY until the LCD is ready, then BOOT_DONE.
+*************************************************/
+uint8_t LCD_InitStep(void){
+	static const uint8_t initCmds[] = {
+		LCD_CMD_FUNCTION | LCD_FUNCTION_5X8FONT | LCD_FUNCTION_2LINES | LCD_FUNCTION_4BITBUS,
+		LCD_CMD_DISPLAY | LCD_DISPLAY_OFF,
+		LCD_CMD_CLEAR,
+		LCD_CMD_ENTRY | LCD_ENTRY_MOVE_CURSOR,
+		LCD_CMD_DISPLAY | LCD_DISPLAY_ON | LCD_DISPLAY_NOBLINK | LCD_DISPLAY_NOCURSOR,
+	};
+	static uint8_t state = 0;
+	
+	switch(state){
+		// Get ready for LCD communication, then wait 10ms for power-on
+		case 0:{
+			LCD_GPIO_Init();
+			GPIO_PINS_CLEAR(LCD_GPIO_PORT, LCD_PORT_BITS);
+			LCD_E_LO;
+			LCD_RS_IR;
+			Boot_Delay(10000);
+			break;
+		}
+		// Syncing sequence 1, wait 5ms
+		case 1:{
+			LCD_Sync(0x03);
+			Boot_Delay(5000);
+			break;
+		}
+		// Syncing sequence 2, wait 1ms
+		case 2:{
+			LCD_Sync(0x03);
+			Boot_Delay(1000);
+			break;
+		}
+		// Syncing sequences 3 and 4, no wait
+		case 3:{
+			LCD_Sync(0x03);
+			LCD_Sync(0x02);
+			break;
+		}
+		// Setup commands, 2ms apart
+		default:{
+			LCD_WriteCmd(initCmds[state - 4]);
+			Boot_Delay(LCD_STD_CMD_DELAY * 1000UL);
+			if(state - 4 == sizeof(initCmds) - 1){
+				state = 0;
+				return(BOOT_DONE);
+			}
+			break;
+		}
+	}
+	
+	state++;
+	return(BOOT_BUSY);
+}
+
 /*************************************************
 * LCD_Clear() - Clear LCD screen.
 * No inputs.
@@ -124,18 +226,12 @@ void LCD_HomeCursor(void){
 * No return value.
 *************************************************/
 void LCD_cmd(uint8_t cmd){
-	Delay_ms(LCD_STD_CMD_DELAY);
-	
-	LCD_E_LO;
-	LCD_RS_IR;
+	PROF_BEGIN(PROF_LCD_CMD);
 	
-	LCD_E_HI;
-	LCD_BUS(HI_NYBBLE(cmd));
-	LCD_E_LO;
+	Delay_ms(LCD_STD_CMD_DELAY);
+	LCD_WriteCmd(cmd);
 	
-	LCD_E_HI;
-	LCD_BUS(LO_NYBBLE(cmd));
-	LCD_E_LO;
+	PROF_END(PROF_LCD_CMD);
 }
 
 /*************************************************
@@ -217,12 +313,10 @@ void LCD_puts(char* str){
 *************************************************/
 void LCD_printf(char* str, ... ){
 	va_list args;
-	char buffer[MAX_LCD_BUFSIZE];
 	
 	va_start(args, str);
-	(void)vsnprintf(buffer, MAX_LCD_BUFSIZE, str, args);
+	(void)Format_vprintf(LCD_Sink, str, args);
 	va_end(args);
-	LCD_puts(buffer);
 }
 
 /***********************************************************
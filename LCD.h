@@ -9,6 +9,7 @@
 #define LCD_H
 
 #include "stm32f303xe.h"
+#include "Board.h"
 
 // Command to LCD module
 #define LCD_CMD_CLEAR				0x01			// Clear screen and set DDRAM address to 0
@@ -57,27 +58,36 @@
 #define LCD_DDRAM_ADDR_LINE2		0x40
 
 // GPIO Port Constants
-#define LCD_GPIO_PORT						A
-#define LCD_PORT								GPIOA->ODR
-#define LCD_RS_BIT							(1UL << 6)				//PA6
-#define LCD_E_BIT								(1UL << 7)				//PA7
-#define LCD_BUS_BIT							(0xFUL << 8)		//PA8, 9, 10, and 11
-#define LCD_BUS_BIT_POS					8
+#define LCD_GPIO_PORT						BOARD_LCD_RS_PORT
+#define LCD_PORT								GPIO(LCD_GPIO_PORT)->ODR
+#define LCD_RS_BIT							(1UL << BOARD_LCD_RS_PIN)
+#define LCD_E_BIT								(1UL << BOARD_LCD_E_PIN)
+#define LCD_BUS_BIT							(0xFUL << BOARD_LCD_D4_PIN)
+#define LCD_BUS_BIT_POS					BOARD_LCD_D4_PIN
+
+// The whole LCD is written through one ODR, with D4-D7 on consecutive pins
+_Static_assert(BOARD_PORT_NUM(BOARD_LCD_RS_PORT) == BOARD_PORT_NUM(BOARD_LCD_E_PORT) &&
+	BOARD_PORT_NUM(BOARD_LCD_RS_PORT) == BOARD_PORT_NUM(BOARD_LCD_D4_PORT) &&
+	BOARD_PORT_NUM(BOARD_LCD_RS_PORT) == BOARD_PORT_NUM(BOARD_LCD_D7_PORT) &&
+	BOARD_LCD_D5_PIN == BOARD_LCD_D4_PIN + 1 && BOARD_LCD_D6_PIN == BOARD_LCD_D4_PIN + 2 &&
+	BOARD_LCD_D7_PIN == BOARD_LCD_D4_PIN + 3, "LCD pins must share a port with D4-D7 consecutive");
 
 #define LCD_PORT_BITS						(LCD_RS_BIT | LCD_E_BIT | LCD_BUS_BIT)	//0x07E0	// bit 6, 7, 8, 9, and 11
 
 // LCD Operation Helper Macros
-#define LCD_E_LO					CLEAR_BITS(LCD_PORT, LCD_E_BIT)
-#define LCD_E_HI					SET_BITS(LCD_PORT, LCD_E_BIT)
-#define LCD_RS_IR					CLEAR_BITS( LCD_PORT, LCD_RS_BIT)
-#define LCD_RS_DR					SET_BITS(LCD_PORT, LCD_RS_BIT)
-#define LCD_BUS(value)		FORCE_BITS(LCD_PORT, LCD_BUS_BIT, (value) << LCD_BUS_BIT_POS)
+// (single BSRR/BRR stores, so the LED and other GPIOA pins are never rewritten from a stale ODR read)
+#define LCD_E_LO					GPIO_PINS_CLEAR(LCD_GPIO_PORT, LCD_E_BIT)
+#define LCD_E_HI					GPIO_PINS_SET(LCD_GPIO_PORT, LCD_E_BIT)
+#define LCD_RS_IR					GPIO_PINS_CLEAR(LCD_GPIO_PORT, LCD_RS_BIT)
+#define LCD_RS_DR					GPIO_PINS_SET(LCD_GPIO_PORT, LCD_RS_BIT)
+#define LCD_BUS(value)		GPIO_PORT_WRITE(LCD_GPIO_PORT, LCD_BUS_BIT, (uint32_t)(value) << LCD_BUS_BIT_POS)
 
 // Other Constants
 #define MAX_LCD_BUFSIZE		81	//80 characters + 1 null char
 
 // LCD functions
 void LCD_Init(void);
+uint8_t LCD_InitStep(void);
 void LCD_Clear(void);
 void LCD_HomeCursor(void);
 
@@ -8,6 +8,11 @@
 #include "stm32f303xe.h"
 #include "LED.h"
 #include "Utility.h"
+#include "Board.h"
+
+// LED_Init() configures PA5
+_Static_assert(BOARD_PORT_NUM(BOARD_LED_PORT) == BOARD_PORT_A && BOARD_LED_PIN == 5,
+	"LED.c expects the LED on PA5");
 
 
 /******************************************************************
@@ -48,7 +53,7 @@ void LED_Init(void){
 * No return value.
 ******************************************/
 void LED_Toggle(void){
-	GPIOA->ODR ^= (1UL << (1*5));	// XOR to flip bit
+	GPIO_PORT_WRITE(A, 1UL << 5, ~GPIOA->ODR);	// Flip PA5 in one BSRR store
 }
 
 /******************************************
@@ -0,0 +1,178 @@
+/********************************************************************************
+* Name: LoopMonitor.c (implementation)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Main loop pacing and CPU load accounting. The main loop task
+*							 blocks on the TIM7 tick and the kernel idle task sleeps meanwhile.
+*							 CPU load is the time the idle task did not sleep, so it covers
+*							 every task and ISR, the loop histogram only the main loop.
+*							 Time is read from the free running 1us TIM2 counter (see Encoder.c),
+*							 because the DWT cycle counter is not guaranteed to run while the core sleeps.
+********************************************************************************/
+
+#include "LoopMonitor.h"
+#include "UART.h"
+#include "Utility.h"
+#include "Kernel.h"
+#include "Encoder.h"
+
+_Static_assert(BOARD_LOOP_TIMER == 7, "LoopMonitor.c: TIM7_IRQHandler serves the loop timer");
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/	
+
+// Upper limit (us) of each histogram bin, the last bin takes everything longer
+static const uint32_t loopHistLimits[LOOP_HIST_BINS] = {100, 500, 1000, 5000, 10000, 20000, 50000, 0xFFFFFFFFUL};
+
+static Kernel_Sem loopTick = KERNEL_SEM_INIT(0, 1);		// Given by TIM7 every LOOP_PERIOD_US
+
+static uint32_t loopStart = 0;						// Time the current loop woke up (us)
+static uint32_t secondStart = 0;					// Start of the current accounting second (us)
+static uint32_t secondIdle = 0;						// Kernel idle time at the start of the second (us)
+static uint32_t loops = 0;								// Loops this second
+static LoopMonitor_Stats current;					// Accumulating this second
+static LoopMonitor_Stats lastSecond;			// Last full second
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* LoopMonitor_Now() - Current time.
+* No inputs.
+* Returns the TIM2 count (us).
+*************************************************************/
+static uint32_t LoopMonitor_Now(void){
+	return(ENCODER_TIMER->CNT);
+}
+
+/*************************************************************
+* LoopMonitor_Account() - Adds one loop to the statistics.
+* loopUs		- Busy time of the loop (us).
+* No return value.
+*************************************************************/
+static void LoopMonitor_Account(uint32_t loopUs){
+	uint8_t bin = 0;
+	
+	loops++;
+	if(loopUs > current.maxLoopUs){
+		current.maxLoopUs = loopUs;
+	}
+	while(loopUs > loopHistLimits[bin]){
+		bin++;
+	}
+	current.histogram[bin]++;
+}
+
+/*************************************************************
+* LoopMonitor_Rollover() - Closes the accounting second once it has elapsed.
+* now		- Current time (us).
+* No return value.
+*************************************************************/
+static void LoopMonitor_Rollover(uint32_t now){
+	uint32_t elapsed = now - secondStart;
+	uint32_t idleNow, idle;
+	
+	if(elapsed < 1000000UL){
+		return;
+	}
+	
+	idleNow = Kernel_GetIdleUs();
+	idle = idleNow - secondIdle;
+	if(idle > elapsed){
+		idle = elapsed;
+	}
+	current.loadX100 = (uint16_t)(((uint64_t)(elapsed - idle) * 10000UL) / elapsed);
+	current.loopsPerSec = (uint16_t)((loops * 1000000ULL) / elapsed);
+	lastSecond = current;
+	
+	for(int i = 0; i < LOOP_HIST_BINS; i++){
+		current.histogram[i] = 0;
+	}
+	current.maxLoopUs = 0;
+	loops = 0;
+	secondStart = now;
+	secondIdle = idleNow;
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* LoopMonitor_Init() - Start the TIM7 main loop tick (Encoder_Init must run first for TIM2).
+* No inputs.
+* No return value.
+*************************************************************/
+void LoopMonitor_Init(void){
+	SET_BITS(BOARD_TIM_ENR(BOARD_LOOP_TIMER), BOARD_TIM_EN(BOARD_LOOP_TIMER));		// Enable the loop timer
+	SET_BITS(LOOP_TIMER->PSC, 71UL);							// Set prescaler counts in 1us
+		// Timer Period = (Prescaler + 1) / SystemClockFreq
+		// 1us = (Prescaler + 1) / 72MHz
+		// (Prescaler + 1) = 72
+		// Prescaler = 71
+	FORCE_BITS(LOOP_TIMER->ARR, 0xFFFFUL, LOOP_PERIOD_US - 1);
+	SET_BITS(LOOP_TIMER->CR1, TIM_CR1_URS);				// Only counter overflow generates an update interrupt
+	SET_BITS(LOOP_TIMER->EGR, TIM_EGR_UG);				// Force an update event to preload the registers
+	SET_BITS(LOOP_TIMER->DIER, TIM_DIER_UIE);			// Enable update interrupt
+	NVIC_SetPriority(LOOP_TIMER_INT, LOOP_PRIORITY);
+	NVIC_EnableIRQ(LOOP_TIMER_INT);
+	SET_BITS(LOOP_TIMER->CR1, TIM_CR1_CEN);
+	
+	loopStart = secondStart = LoopMonitor_Now();
+	secondIdle = Kernel_GetIdleUs();
+}
+
+/*************************************************************
+* LoopMonitor_Sleep() - End of a main loop pass, blocks until the next loop tick.
+* No inputs.
+* No return value.
+*************************************************************/
+void LoopMonitor_Sleep(void){
+	LoopMonitor_Account(LoopMonitor_Now() - loopStart);
+	
+	Kernel_SemTake(&loopTick, KERNEL_FOREVER);
+	
+	loopStart = LoopMonitor_Now();
+	LoopMonitor_Rollover(loopStart);
+}
+
+/*************************************************************
+* LoopMonitor_Get() - Loop statistics of the last full second.
+* stats		- Returns the statistics.
+* No return value.
+*************************************************************/
+void LoopMonitor_Get(LoopMonitor_Stats *stats){
+	*stats = lastSecond;
+}
+
+/*************************************************************
+* LoopMonitor_Report() - Print the last second's loop statistics over UART.
+* No inputs.
+* No return value.
+*************************************************************/
+void LoopMonitor_Report(void){
+	UART_printf("cpu load: %u.%02u%%, loop rate: %u/s, max loop: %lu us\n", lastSecond.loadX100 / 100,
+		lastSecond.loadX100 % 100, lastSecond.loopsPerSec, (unsigned long)lastSecond.maxLoopUs);
+	UART_printf("loop time histogram (<= us: count)\n");
+	for(int i = 0; i < LOOP_HIST_BINS - 1; i++){
+		UART_printf("  %6lu: %lu\n", (unsigned long)loopHistLimits[i], (unsigned long)lastSecond.histogram[i]);
+	}
+	UART_printf("  longer: %lu\n", (unsigned long)lastSecond.histogram[LOOP_HIST_BINS - 1]);
+}
+
+/*************************************************************
+* TIM7_IRQHandler() - Main loop tick.
+* No inputs.
+* No return value.
+*************************************************************/
+CCM_FUNC void TIM7_IRQHandler(void){
+	if(IS_BIT_SET(LOOP_TIMER->SR, TIM_SR_UIF)){
+		LOOP_TIMER->SR = ~TIM_SR_UIF;
+		Kernel_SemGive(&loopTick);
+	}
+}
@@ -0,0 +1,36 @@
+/********************************************************************************
+* Name: LoopMonitor.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Main loop pacing and CPU load accounting (from the kernel idle time).
+********************************************************************************/
+
+#ifndef __LoopMonitor_H
+#define __LoopMonitor_H
+
+#include "stm32f303xe.h"
+#include "Board.h"
+
+#define LOOP_TIMER					BOARD_TIM(BOARD_LOOP_TIMER)
+#define LOOP_TIMER_INT			BOARD_TIM_IRQ(BOARD_LOOP_TIMER)
+
+#define LOOP_PRIORITY 12
+
+#define LOOP_PERIOD_US		10000UL		// Main loop tick (100Hz)
+#define LOOP_HIST_BINS		8					// Loop time histogram bins
+
+// Loop statistics for the last full second
+typedef struct {
+	uint16_t loadX100;							// CPU load of all tasks and ISRs (0.01%)
+	uint16_t loopsPerSec;						// Main loop rate
+	uint32_t maxLoopUs;							// Longest busy time of one loop
+	uint32_t histogram[LOOP_HIST_BINS];		// Loop busy time counts, see loopHistLimits
+} LoopMonitor_Stats;
+
+void LoopMonitor_Init(void);
+void LoopMonitor_Sleep(void);
+void LoopMonitor_Get(LoopMonitor_Stats *stats);
+void LoopMonitor_Report(void);
+void TIM7_IRQHandler(void);
+
+#endif
@@ -0,0 +1,81 @@
+/********************************************************************************
+* Name: Pool.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Fixed block memory pool for mobile robot. POOL_DEFINE(Name, Type,
+*							 Count) declares a pool type Name of Count blocks of Type, and its
+*							 functions Name_Init(), Name_Alloc() and Name_Free(). Alloc and
+*							 free are O(1) pops and pushes of a free list inside a short
+*							 critical section, so any context may call them. No malloc.
+********************************************************************************/
+
+#ifndef __Pool_H
+#define __Pool_H
+
+#include <stddef.h>
+#include "stm32f303xe.h"
+#include "Atomic.h"
+
+// Pool statistics (same meaning as StackMonitor_Heap)
+typedef struct {
+	uint32_t inUse;				// Blocks currently allocated
+	uint32_t peak;				// Most blocks allocated at once
+	uint32_t allocs;			// Successful allocations
+	uint32_t failures;		// Allocations refused because the pool was empty
+} Pool_Stats;
+
+// Free blocks hold the free list link in place of their data
+#define POOL_DEFINE(Name, Type, Count) \
+	typedef union Name ## _Block { \
+		Type data; \
+		union Name ## _Block *next; \
+	} Name ## _Block; \
+	\
+	typedef struct { \
+		Name ## _Block *free;		/* Free list head */ \
+		Pool_Stats stats; \
+		Name ## _Block blocks[Count]; \
+	} Name; \
+	\
+	/* Name_Init() - Put every block on the free list. */ \
+	static inline void Name ## _Init(Name *pool){ \
+		pool->free = NULL; \
+		for(uint32_t i = (Count); i != 0; i--){ \
+			pool->blocks[i - 1].next = pool->free; \
+			pool->free = &pool->blocks[i - 1]; \
+		} \
+		pool->stats.inUse = pool->stats.peak = pool->stats.allocs = pool->stats.failures = 0; \
+	} \
+	\
+	/* Name_Alloc() - Take a block. Returns NULL if the pool is empty. */ \
+	static inline Type *Name ## _Alloc(Name *pool){ \
+		uint32_t primask = Atomic_Enter(); \
+		Name ## _Block *block = pool->free; \
+		if(block == NULL){ \
+			pool->stats.failures++; \
+		} \
+		else{ \
+			pool->free = block->next; \
+			pool->stats.allocs++; \
+			if(++pool->stats.inUse > pool->stats.peak){ \
+				pool->stats.peak = pool->stats.inUse; \
+			} \
+		} \
+		Atomic_Exit(primask); \
+		return((Type *)block); \
+	} \
+	\
+	/* Name_Free() - Return a block from Name_Alloc() (NULL is ignored). */ \
+	static inline void Name ## _Free(Name *pool, Type *data){ \
+		Name ## _Block *block = (Name ## _Block *)data; \
+		if(block == NULL){ \
+			return; \
+		} \
+		uint32_t primask = Atomic_Enter(); \
+		block->next = pool->free; \
+		pool->free = block; \
+		pool->stats.inUse--; \
+		Atomic_Exit(primask); \
+	}
+
+#endif
@@ -0,0 +1,335 @@
+/********************************************************************************
+* Name: Power.c (implementation)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Clock profiles and low-power modes for mobile robot.
+*							 Both clock profiles run APB2 undivided and APB1 at up to 36MHz,
+*							 so every timer is clocked at SYSCLK and USART2 is clocked from
+*							 SYSCLK. After a clock change the 1us timer prescalers and the
+*							 UART baud rate are recomputed. TIM1 (stepper coil PWM) counts at
+*							 the core clock, so its PWM frequency drops in POWER_IDLE while
+*							 the duty cycle is unchanged.
+*							 Oscillator and PLL start-up is waited for with interrupts enabled
+*							 and a timeout. Only the switch itself and the retiming are masked.
+*							 If HSE or the PLL fails, the clock stays where it is (HSE, or HSI
+*							 after stop mode, both 8MHz) and the profile reads POWER_IDLE.
+********************************************************************************/
+
+#include "Power.h"
+#include "UART.h"
+#include "Utility.h"
+#include "Atomic.h"
+#include "Board.h"
+#include "Encoder.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define KEYPAD_COLUMNS		(EXTI_IMR_MR4 | EXTI_IMR_MR5 | EXTI_IMR_MR6 | EXTI_IMR_MR7)		// PB4-PB7
+#define KEYPAD_ROWS				(GPIO_ODR_0 | GPIO_ODR_1 | GPIO_ODR_2 | GPIO_ODR_3)					// PB0-PB3
+#define UART_RX_LINE			EXTI_IMR_MR3																							// PA3 (USART2 RX) start bit
+
+// Timers set to count in 1us (PSC = timer clock in MHz - 1)
+static TIM_TypeDef * const usTimers[] = {
+	BOARD_TIM(BOARD_ENCODER_TIMER), BOARD_TIM(BOARD_ULTRA_ECHO_TIMER), BOARD_TIM(BOARD_STEPPER_TIMER),
+	BOARD_TIM(BOARD_LOOP_TIMER), BOARD_TIM(BOARD_DCMOTOR_TIMER), BOARD_TIM(BOARD_SERVO_TIMER),
+	BOARD_TIM(BOARD_ULTRA_TRIGGER_TIMER), BOARD_TIM(BOARD_SERVO_GRIPPER_TIMER)
+};
+
+#define US_TIMER_COUNT (sizeof(usTimers) / sizeof(usTimers[0]))
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/	
+
+static uint8_t powerProfile = POWER_RUN;
+static uint32_t lastActivity = 0;				// TIM2 count of the last activity (us)
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Power_SetPrescaler() - Change a timer prescaler without losing its count.
+* timer	- Timer to change.
+* psc		- New prescaler.
+* No return value.
+*************************************************************/
+static void Power_SetPrescaler(TIM_TypeDef *timer, uint16_t psc){
+	uint32_t cnt = timer->CNT;
+	uint32_t cr1 = timer->CR1;
+	
+	// PSC is preloaded, an update event loads it now (URS stops it raising an interrupt)
+	timer->PSC = psc;
+	SET_BITS(timer->CR1, TIM_CR1_URS);
+	timer->EGR = TIM_EGR_UG;
+	timer->CR1 = cr1;
+	timer->CNT = cnt;
+}
+
+/*************************************************************
+* Power_Retime() - Recompute clock dependent settings for SystemCoreClock.
+* No inputs.
+* No return value.
+*************************************************************/
+static void Power_Retime(void){
+	uint16_t psc;
+	
+	SystemCoreClockUpdate();
+	psc = Power_TimerPrescaler(SystemCoreClock);
+	
+	for(uint32_t i = 0; i < US_TIMER_COUNT; i++){
+		Power_SetPrescaler(usTimers[i], psc);
+	}
+	
+	UART2_SetBaud();
+}
+
+/*************************************************************
+* Power_WaitFlag() - Wait for register bits with a timeout.
+* reg				- Register to poll.
+* mask			- Bits to check.
+* value			- Wanted value of those bits.
+* Returns 1 once the bits match or 0 after POWER_CLOCK_TIMEOUT_US.
+*************************************************************/
+static uint8_t Power_WaitFlag(volatile uint32_t *reg, uint32_t mask, uint32_t value){
+	uint32_t start = DWT->CYCCNT;
+	uint32_t limit = (SystemCoreClock / 1000000UL) * POWER_CLOCK_TIMEOUT_US;
+	
+	while((*reg & mask) != value){
+		if(DWT->CYCCNT - start > limit){
+			return(0);
+		}
+	}
+	return(1);
+}
+
+/*************************************************************
+* Power_StartHse() - Start the 8MHz HSE.
+* No inputs.
+* Returns 1 once it is ready or 0 if it failed to start.
+*************************************************************/
+static uint8_t Power_StartHse(void){
+	RCC->CR |= RCC_CR_HSEON;
+	return(Power_WaitFlag(&RCC->CR, RCC_CR_HSERDY, RCC_CR_HSERDY));
+}
+
+/*************************************************************
+* Power_ClockHse() - Run from the 8MHz HSE with the PLL off.
+* No inputs.
+* Returns 1 if switched or 0 if HSE failed (clock unchanged).
+*************************************************************/
+static uint8_t Power_ClockHse(void){
+	uint32_t primask;
+	uint8_t switched;
+	
+	if(!Power_StartHse()){
+		return(0);
+	}
+	
+	// Switch to HSE, then slow down the busses and flash
+	primask = Atomic_Enter();
+	RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW) | RCC_CFGR_SW_HSE;
+	switched = Power_WaitFlag(&RCC->CFGR, RCC_CFGR_SWS, RCC_CFGR_SWS_HSE);
+	if(switched){
+		RCC->CR &= ~RCC_CR_PLLON;
+		RCC->CFGR &= ~(RCC_CFGR_HPRE | RCC_CFGR_PPRE1 | RCC_CFGR_PPRE2);
+		FORCE_BITS(FLASH->ACR, FLASH_ACR_LATENCY, 0UL);			// 0 wait states up to 24MHz
+	}
+	Power_Retime();
+	Atomic_Exit(primask);
+	return(switched);
+}
+
+/*************************************************************
+* Power_ClockPll() - Run at 72MHz from HSE x9 (System_Clock_Init() with timeouts).
+* No inputs.
+* Returns 1 if switched or 0 if HSE or the PLL failed (clock unchanged).
+*************************************************************/
+static uint8_t Power_ClockPll(void){
+	uint32_t primask;
+	uint8_t switched;
+	
+	if(!Power_StartHse()){
+		return(0);
+	}
+	
+	// Restart the PLL on HSE x 9, the core keeps running from HSE or HSI meanwhile
+	RCC->CR &= ~RCC_CR_PLLON;
+	if(!Power_WaitFlag(&RCC->CR, RCC_CR_PLLRDY, 0)){
+		return(0);
+	}
+	RCC->CFGR = (RCC->CFGR & ~(RCC_CFGR_PLLSRC_Msk | RCC_CFGR_PLLMUL)) | RCC_CFGR_PLLSRC_HSE_PREDIV |
+		RCC_CFGR_PLLNODIV | RCC_CFGR_PLLMUL9;
+	RCC->CR |= RCC_CR_PLLON;
+	if(!Power_WaitFlag(&RCC->CR, RCC_CR_PLLRDY, RCC_CR_PLLRDY)){
+		RCC->CR &= ~RCC_CR_PLLON;
+		return(0);
+	}
+	
+	// Flash wait states before speeding up, APB1 36MHz max
+	primask = Atomic_Enter();
+	FORCE_BITS(FLASH->ACR, FLASH_ACR_LATENCY, FLASH_ACR_LATENCY_2);
+	SET_BITS(FLASH->ACR, FLASH_ACR_PRFTBE);
+	RCC->CFGR = (RCC->CFGR & ~(RCC_CFGR_HPRE | RCC_CFGR_PPRE2 | RCC_CFGR_PPRE1)) | RCC_CFGR_PPRE1_DIV2;
+	RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW) | RCC_CFGR_SW_PLL;
+	switched = Power_WaitFlag(&RCC->CFGR, RCC_CFGR_SWS, RCC_CFGR_SWS_PLL);
+	Power_Retime();
+	Atomic_Exit(primask);
+	return(switched);
+}
+
+/*************************************************************
+* Power_Stop() - Enter stop mode until a key is pressed or a byte arrives.
+* No inputs.
+* No return value.
+*************************************************************/
+static void Power_Stop(void){
+	// Drive all keypad rows low so any key pulls its column low
+	GPIO_PINS_CLEAR(B, KEYPAD_ROWS);
+	if((GPIOB->IDR & (GPIO_IDR_4 | GPIO_IDR_5 | GPIO_IDR_6 | GPIO_IDR_7)) != (GPIO_IDR_4 | GPIO_IDR_5 | GPIO_IDR_6 | GPIO_IDR_7)){
+		return;		// Key already down, no edge to wake on
+	}
+	
+	// Keypad columns PB4-PB7 and the USART2 RX start bit on PA3 wake on a falling
+	// edge event (no interrupt needed). USART2 is stopped too, so the byte that
+	// wakes the robot is lost: send any byte, then the command.
+	SET_BITS(RCC->APB2ENR, RCC_APB2ENR_SYSCFGEN);
+	FORCE_BITS(SYSCFG->EXTICR[1], 0xFFFFUL, 0x1111UL);		// EXTI4-7 from port B
+	FORCE_BITS(SYSCFG->EXTICR[0], SYSCFG_EXTICR1_EXTI3, SYSCFG_EXTICR1_EXTI3_PA);
+	SET_BITS(EXTI->FTSR, KEYPAD_COLUMNS | UART_RX_LINE);
+	SET_BITS(EXTI->EMR, KEYPAD_COLUMNS | UART_RX_LINE);
+	
+	// Stop mode with the regulator in low-power mode
+	SET_BITS(RCC->APB1ENR, RCC_APB1ENR_PWREN);
+	FORCE_BITS(PWR->CR, PWR_CR_PDDS | PWR_CR_LPDS, PWR_CR_LPDS);
+	SET_BITS(SCB->SCR, SCB_SCR_SLEEPDEEP_Msk);
+	
+	// Clear any pending event, then wait for a key
+	__SEV();
+	__WFE();
+	__WFE();
+	
+	CLEAR_BITS(SCB->SCR, SCB_SCR_SLEEPDEEP_Msk);
+	CLEAR_BITS(EXTI->EMR, KEYPAD_COLUMNS | UART_RX_LINE);
+	CLEAR_BITS(EXTI->FTSR, KEYPAD_COLUMNS | UART_RX_LINE);
+	
+	// Woken on HSI (8MHz)
+	SystemCoreClockUpdate();
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Power_Init() - Start in POWER_RUN. Call after the drivers are initialized.
+* No inputs.
+* No return value.
+*************************************************************/
+void Power_Init(void){
+	powerProfile = POWER_RUN;
+	lastActivity = ENCODER_TIMER->CNT;
+}
+
+/*************************************************************
+* Power_SetProfile() - Change the clock profile.
+* profile	- POWER_RUN, POWER_IDLE or POWER_STOP.
+* No return value.
+*************************************************************/
+void Power_SetProfile(uint8_t profile){
+	uint32_t start = DWT->CYCCNT;
+	uint32_t limit = (SystemCoreClock / 1000000UL) * POWER_CLOCK_TIMEOUT_US;
+	
+	if(profile == powerProfile){
+		return;
+	}
+	
+	// Let the UART finish sending at the old baud rate
+	while(!UART_TxDone() && DWT->CYCCNT - start < limit);
+	
+	switch(profile){
+		case POWER_IDLE:{
+			(void)Power_ClockHse();
+			break;
+		}
+		case POWER_STOP:{
+			// Wakes on HSI, so restart HSE and the PLL. The timers were counting at
+			// 8MHz with 72MHz prescalers until Power_ClockPll() retimes them.
+			Power_Stop();
+			if(!Power_ClockPll()){
+				Power_Retime();
+			}
+			break;
+		}
+		default:{
+			(void)Power_ClockPll();
+			break;
+		}
+	}
+	
+	// Whatever the clock ended up at (a failed start leaves HSE or HSI, both 8MHz)
+	powerProfile = (SystemCoreClock == POWER_RUN_HZ) ? POWER_RUN : POWER_IDLE;
+	lastActivity = ENCODER_TIMER->CNT;
+}
+
+/*************************************************************
+* Power_GetProfile() - Get the current clock profile.
+* No inputs.
+* Returns POWER_RUN or POWER_IDLE.
+*************************************************************/
+uint8_t Power_GetProfile(void){
+	return(powerProfile);
+}
+
+/*************************************************************
+* Power_Activity() - Note user activity, returning to POWER_RUN.
+* No inputs.
+* No return value.
+*************************************************************/
+void Power_Activity(void){
+	lastActivity = ENCODER_TIMER->CNT;
+	if(powerProfile != POWER_RUN){
+		Power_SetProfile(POWER_RUN);
+	}
+}
+
+/*************************************************************
+* Power_Update() - Drop to a lower profile after a period without activity.
+* busy	- Non-zero while anything is moving (counts as activity).
+* No return value.
+*************************************************************/
+void Power_Update(uint8_t busy){
+	uint32_t idleMs;
+	
+	if(busy){
+		Power_Activity();
+		return;
+	}
+	
+	idleMs = (ENCODER_TIMER->CNT - lastActivity) / 1000UL;
+	if(idleMs >= POWER_STOP_TIMEOUT_MS){
+		Power_SetProfile(POWER_STOP);
+	}
+	else if(idleMs >= POWER_IDLE_TIMEOUT_MS && powerProfile == POWER_RUN){
+		// Stop timeout counts on from here
+		uint32_t activity = lastActivity;
+		
+		Power_SetProfile(POWER_IDLE);
+		lastActivity = activity;
+	}
+}
+
+/*************************************************************
+* Power_TimerPrescaler() - Get the prescaler for a 1us timer tick.
+* timerHz	- Timer input clock (Hz).
+* Returns the PSC value.
+*************************************************************/
+uint16_t Power_TimerPrescaler(uint32_t timerHz){
+	return((uint16_t)(timerHz / 1000000UL - 1));
+}
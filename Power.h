@@ -0,0 +1,35 @@
+/********************************************************************************
+* Name: Power.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Clock profiles and low-power modes for mobile robot.
+********************************************************************************/
+
+#ifndef __Power_H
+#define __Power_H
+
+#include "stm32f303xe.h"
+
+// Run profiles
+#define POWER_RUN		0		// 72MHz (HSE x9 PLL)
+#define POWER_IDLE	1		// 8MHz (HSE, PLL off)
+#define POWER_STOP	2		// Stop mode until a key or UART byte, then back to POWER_RUN
+
+#define POWER_RUN_HZ		72000000UL
+#define POWER_IDLE_HZ		8000000UL
+
+// Time without activity before dropping a profile (nothing may be moving)
+#define POWER_IDLE_TIMEOUT_MS		5000UL
+#define POWER_STOP_TIMEOUT_MS		60000UL
+
+// Longest wait for an oscillator, PLL lock or clock switch before giving up
+#define POWER_CLOCK_TIMEOUT_US	100000UL
+
+void Power_Init(void);
+void Power_SetProfile(uint8_t profile);
+uint8_t Power_GetProfile(void);
+void Power_Activity(void);
+void Power_Update(uint8_t busy);
+uint16_t Power_TimerPrescaler(uint32_t timerHz);
+
+#endif
@@ -0,0 +1,118 @@
+/********************************************************************************
+* Name: Profile.c (implementation)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: DWT cycle counter profiling probes for mobile robot.
+********************************************************************************/
+
+#include "Profile.h"
+#include "UART.h"
+#include "Utility.h"
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/	
+
+static Profile_Stats probes[PROF_COUNT];
+
+static const char *probeNames[PROF_COUNT] = {
+	"LCD_cmd",
+	"KeyPad_MatrixScan",
+	"TIM2_IRQHandler",
+	"UART_printf",
+	"Stepper_Step",
+	"Stepper_MicroOutput"
+};
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Profile_Init() - Start the DWT cycle counter and clear all probes.
+* No inputs.
+* No return value.
+*************************************************************/
+void Profile_Init(void){
+	SET_BITS(CoreDebug->DEMCR, CoreDebug_DEMCR_TRCENA_Msk);	// Enable trace so the DWT runs
+	DWT->CYCCNT = 0;
+	SET_BITS(DWT->CTRL, DWT_CTRL_CYCCNTENA_Msk);						// Start counting core cycles
+	Profile_Reset();
+}
+
+/*************************************************************
+* Profile_Reset() - Clear the statistics of all probes.
+* No inputs.
+* No return value.
+*************************************************************/
+void Profile_Reset(void){
+	uint32_t primask = __get_PRIMASK();
+	
+	__disable_irq();
+	for(int i = 0; i < PROF_COUNT; i++){
+		probes[i].count = 0;
+		probes[i].min = 0xFFFFFFFFUL;
+		probes[i].max = 0;
+		probes[i].total = 0;
+	}
+	__set_PRIMASK(primask);
+}
+
+/*************************************************************
+* Profile_Record() - Add one measurement to a probe.
+* id			- Probe ID.
+* cycles	- Cycles spent between PROF_BEGIN and PROF_END.
+* No return value.
+*************************************************************/
+CCM_FUNC void Profile_Record(uint8_t id, uint32_t cycles){
+	Profile_Stats *probe = &probes[id];
+	
+	probe->count++;
+	probe->total += cycles;
+	if(cycles < probe->min){
+		probe->min = cycles;
+	}
+	if(cycles > probe->max){
+		probe->max = cycles;
+	}
+}
+
+/*************************************************************
+* Profile_Get() - Take a consistent copy of a probe.
+* id			- Probe ID.
+* stats		- Returns the probe statistics.
+* No return value.
+*************************************************************/
+void Profile_Get(uint8_t id, Profile_Stats *stats){
+	uint32_t primask = __get_PRIMASK();
+	
+	// ISR probes can update while copying
+	__disable_irq();
+	*stats = probes[id];
+	__set_PRIMASK(primask);
+}
+
+/*************************************************************
+* Profile_Dump() - Print all probes over UART (cycles and us).
+* No inputs.
+* No return value.
+*************************************************************/
+void Profile_Dump(void){
+	Profile_Stats stats;
+	uint32_t cyclesPerUs = SystemCoreClock / 1000000UL;
+	uint32_t mean;
+	
+	UART_printf("probe                count       min       max      mean   mean(us)\n");
+	for(int i = 0; i < PROF_COUNT; i++){
+		Profile_Get(i, &stats);
+		if(stats.count == 0){
+			UART_printf("%-18s %7u         -         -         -          -\n", probeNames[i], 0);
+			continue;
+		}
+		mean = (uint32_t)(stats.total / stats.count);
+		UART_printf("%-18s %7lu %9lu %9lu %9lu %10lu\n", probeNames[i], (unsigned long)stats.count,
+			(unsigned long)stats.min, (unsigned long)stats.max, (unsigned long)mean, (unsigned long)(mean / cyclesPerUs));
+	}
+}
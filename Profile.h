@@ -0,0 +1,47 @@
+/********************************************************************************
+* Name: Profile.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: DWT cycle counter profiling probes for mobile robot.
+********************************************************************************/
+
+#ifndef __Profile_H
+#define __Profile_H
+
+#include "stm32f303xe.h"
+
+// Set to 0 to compile all probes out
+#define PROFILE_ENABLE 1
+
+// Probe IDs
+#define PROF_LCD_CMD				0
+#define PROF_KEYPAD_SCAN		1
+#define PROF_ENCODER_ISR		2
+#define PROF_UART_PRINTF		3
+#define PROF_STEPPER_STEP		4
+#define PROF_STEPPER_MICRO	5		// One microstep's coil duty update
+#define PROF_COUNT					6
+
+// Probe statistics (CPU cycles)
+typedef struct {
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;
+} Profile_Stats;
+
+#if PROFILE_ENABLE
+#define PROF_BEGIN(id)	uint32_t profStart_##id = DWT->CYCCNT
+#define PROF_END(id)		Profile_Record((id), DWT->CYCCNT - profStart_##id)
+#else
+#define PROF_BEGIN(id)
+#define PROF_END(id)
+#endif
+
+void Profile_Init(void);
+void Profile_Reset(void);
+void Profile_Record(uint8_t id, uint32_t cycles);
+void Profile_Get(uint8_t id, Profile_Stats *stats);
+void Profile_Dump(void);
+
+#endif
@@ -7,6 +7,7 @@
 
 #include "PushButton.h"
 #include "Utility.h"
+#include "Board.h"
 #include "stm32f303xe.h"
 
 
@@ -15,19 +16,22 @@
 ******************************************************************/
 
 /********************************************************
-* PushButton_Init() - Initialize push button setting.
+* PushButton_Init() - Initialize push button setting (does nothing
+*											unless BOARD_USE_PUSHBUTTON is set).
 * No inputs.
 * No return value.
 ********************************************************/
 void PushButton_Init(void){
-	// Enable GPIO Port C
-	ENABLE_GPIO_CLOCK(C);
+#if BOARD_USE_PUSHBUTTON
+	// Enable GPIO Port
+	ENABLE_GPIO_CLOCK(BOARD_PUSHBUTTON_PORT);
 	
-	//Set PC13 to INPUT mode (00)
-	GPIO_MODER_SET(C, 13, GPIO_MODE_IN);
+	//Set the button pin to INPUT mode (00)
+	GPIO_MODER_SET(BOARD_PUSHBUTTON_PORT, BOARD_PUSHBUTTON_PIN, GPIO_MODE_IN);
 	
-	// Set PUPD to no-pull (00 for pin 13)
-	GPIO_PUPDR_SET(C, 13, GPIO_PUPD_NO);
+	// Set PUPD to no-pull (00)
+	GPIO_PUPDR_SET(BOARD_PUSHBUTTON_PORT, BOARD_PUSHBUTTON_PIN, GPIO_PUPD_NO);
+#endif
 }
 
 /**********************************************************************
@@ -36,8 +40,8 @@ void PushButton_Init(void){
 * No return value.
 **********************************************************************/
 uint8_t PushButton_PressCheck(void){
-	// Check if ODR of PC13 is set
-	if(IS_BIT_SET(GPIOC->IDR, GPIO_IDR_13)){
+	// Check if IDR of the button pin is set
+	if(IS_BIT_SET(GPIO(BOARD_PUSHBUTTON_PORT)->IDR, 1UL << BOARD_PUSHBUTTON_PIN)){
 		// If set, button is not pressed because of ACTIVE-LOW.
 		return(0);
 	}
@@ -0,0 +1,68 @@
+/********************************************************************************
+* Name: Queue.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Lock-free single producer, single consumer ring queue for mobile
+*							 robot. QUEUE_DEFINE(Name, Type, Size) declares a queue type Name
+*							 holding Size (power of 2) items of Type, and its functions
+*							 Name_Put(), Name_Get() and Name_Count(). One context (e.g. an
+*							 ISR) may put and one other context may get, with no locking.
+********************************************************************************/
+
+#ifndef __Queue_H
+#define __Queue_H
+
+#include "stm32f303xe.h"
+
+// Queue statistics, written by the producer only
+typedef struct {
+	uint32_t highWater;		// Most items queued at once
+	uint32_t drops;				// Puts refused because the queue was full
+} Queue_Stats;
+
+// head and tail run freely and wrap at 2^32, head - tail is the item count. Each side
+// publishes its index with a release store and reads the other's with an acquire load
+// (a DMB on the M4), which ThreadSanitizer also understands.
+#define QUEUE_DEFINE(Name, Type, Size) \
+	_Static_assert((Size) != 0 && ((Size) & ((Size) - 1)) == 0, #Name ": queue size must be a power of 2"); \
+	\
+	typedef struct { \
+		volatile uint32_t head;		/* Next slot to put, producer only */ \
+		volatile uint32_t tail;		/* Next slot to get, consumer only */ \
+		Queue_Stats stats; \
+		Type items[Size]; \
+	} Name; \
+	\
+	/* Name_Put() - Add an item (producer). Returns 1 if queued, 0 if full (counted as a drop). */ \
+	static inline uint8_t Name ## _Put(Name *q, const Type *item){ \
+		uint32_t head = q->head; \
+		uint32_t count = head - __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);	/* Slot was read before the tail */ \
+		if(count >= (Size)){ \
+			q->stats.drops++; \
+			return(0); \
+		} \
+		q->items[head & ((Size) - 1)] = *item; \
+		__atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE);		/* Item is visible before the new head */ \
+		if(count + 1 > q->stats.highWater){ \
+			q->stats.highWater = count + 1; \
+		} \
+		return(1); \
+	} \
+	\
+	/* Name_Get() - Remove the oldest item (consumer). Returns 1 if an item was copied, 0 if empty. */ \
+	static inline uint8_t Name ## _Get(Name *q, Type *item){ \
+		uint32_t tail = q->tail; \
+		if(__atomic_load_n(&q->head, __ATOMIC_ACQUIRE) == tail){		/* Item is read after the head that published it */ \
+			return(0); \
+		} \
+		*item = q->items[tail & ((Size) - 1)]; \
+		__atomic_store_n(&q->tail, tail + 1, __ATOMIC_RELEASE);		/* Slot is free only after it has been read */ \
+		return(1); \
+	} \
+	\
+	/* Name_Count() - Items waiting (a snapshot, either side may be moving). */ \
+	static inline uint32_t Name ## _Count(const Name *q){ \
+		return(__atomic_load_n(&q->head, __ATOMIC_RELAXED) - __atomic_load_n(&q->tail, __ATOMIC_RELAXED)); \
+	}
+
+#endif
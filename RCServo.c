@@ -8,125 +8,131 @@
 #include "RCServo.h"
 #include "stm32f303xe.h"
 #include "Utility.h"
+#include "Gpio.h"
+#include "IsrMonitor.h"
+#include "Trace.h"
+#include "Bus.h"
+
+_Static_assert(BOARD_SERVO_TIMER == 15, "RCServo.c: TIM1_BRK_TIM15_IRQHandler serves the servo timer");
 
 
 /******************************************************************
 *									LOCAL CONSTANTS AND VARIABLES									  *
 ******************************************************************/
 
-#define SERVO_CENTRE 1500			// Servo centre pulse width (us)
+#define SERVO_CENTRE 1500			// Servo centre pulse width (us) until calibration mode trims it
 #define SERVO_NEG_LMT 1050		// Servo negative mechanical limit pulse width (us)
 #define SERVO_POS_LMT 1950		// Servo positive mechanical limit pulse width (us)
 #define US_PER_DEGREE 10			// Servo us/degree pulse width ratio
 
+#define SERVO_IDLE		0			// Holding position
+#define SERVO_MOVE		1			// Slewing to the target
+#define SERVO_SWEEP		2			// Slewing back and forth between two angles
+
+// Servo output channel
+typedef struct {
+	TIM_TypeDef *timer;			// 50Hz PWM timer
+	uint8_t channel;				// Timer channel (1 or 2)
+	GPIO_TypeDef *port;			// Output pin
+	Gpio_PortConfig pin;		// Output pin as AF, PP, no pull
+	Timer_OcConfig oc;			// Channel in PWM mode 1, active high, with output compare preload
+} RCServo_Channel;
+
+#define SERVO_PAN_PIN(X)			X(SERVO_PAN, GPIO_MODE_AF, GPIO_OTYPE_PP, GPIO_PUPD_NO)
+#define SERVO_TILT_PIN(X)			X(SERVO_TILT, GPIO_MODE_AF, GPIO_OTYPE_PP, GPIO_PUPD_NO)
+#define SERVO_GRIPPER_PIN(X)	X(SERVO_GRIPPER, GPIO_MODE_AF, GPIO_OTYPE_PP, GPIO_PUPD_NO)
+#define SERVO_CH1(X)					X(1, TIMER_OC_PWM1, TIMER_CC_OUT)
+#define SERVO_CH2(X)					X(2, TIMER_OC_PWM1, TIMER_CC_OUT)
+
+// Servo calibration and trajectory, angles in 0.1 degrees << 8
+typedef struct {
+	RCServo_Calibration cal;
+	volatile uint8_t motion;
+	volatile int32_t angle;		// Current angle
+	int32_t target;						// Angle being slewed to
+	int32_t sweepFrom;				// Sweep end points
+	int32_t sweepTo;
+	int32_t slew;							// Angle change per frame
+} RCServo_State;
+
+static const RCServo_Channel servoChannels[SERVO_COUNT] = {
+	{BOARD_TIM(BOARD_SERVO_TIMER), 2, GPIO(BOARD_SERVO_PAN_PORT), GPIO_PORT_CONFIG(SERVO_PAN_PIN), TIMER_OC_CONFIG(SERVO_CH2)},							// SERVO_PAN
+	{BOARD_TIM(BOARD_SERVO_TIMER), 1, GPIO(BOARD_SERVO_TILT_PORT), GPIO_PORT_CONFIG(SERVO_TILT_PIN), TIMER_OC_CONFIG(SERVO_CH1)},						// SERVO_TILT
+	{BOARD_TIM(BOARD_SERVO_GRIPPER_TIMER), 1, GPIO(BOARD_SERVO_GRIPPER_PORT), GPIO_PORT_CONFIG(SERVO_GRIPPER_PIN), TIMER_OC_CONFIG(SERVO_CH1)},	// SERVO_GRIPPER
+};
+
+static RCServo_State servos[SERVO_COUNT];
+
+
 /******************************************************************
-*												PUBLIC FUNCTIONS													*
+*												PRIVATE FUNCTIONS													*
 ******************************************************************/
 
-/****************************************************
-* RCServo_init() - Configure setting for servo motor.
-* No inputs.
+/*********************************************************************************
+* RCServo_TimerInit() - Configure a timer for 20ms servo frames counting in 1us.
+* timer		- TIM15 or TIM17.
 * No return value.
-****************************************************/
-void RCServo_Init(void){
-	// Set up PB15 to Output, AF1, PP, no Pull
-	// 1. Enable clock to Port B
-	RCC->AHBENR |= RCC_AHBENR_GPIOBEN;
-	
-	// 2. Set the MODER to AF
-	// 00: Input mode (reset state)
-	// 01: General purpose output mode
-	// 10: Alternate function mode
-	// 11: Analog mode
-	GPIO_MODER_SET(B, 15, 2UL);
-	
-	// 3. Set the AFR to AF1 for PB15
-	// AFRL is 0-7 and AFRH is 8-15
-	// Need AFRH which is AFR[1] since using pin 15 (PB15)
-	SET_BITS(GPIOB->AFR[1], 1UL << (4*7));
-	
-	// 4. Set the OTYPER to Push-Pull
-	// 0: Output push-pull (reset state)
-	// 1: Output open-drain
-	GPIO_OTYPER_SET(B, 15, 0UL);
-	
-	// 5. Set the PUPDR to no pull-up
-	// 00: No pull-up, pull-down
-	// 01: Pull-up
-	// 10: Pull-down
-	// 11: Reserved
-	GPIO_PUPDR_SET(B, 15, 0UL);
-	
-	
-	// Configure TIM15
-	// 1. Turn on TIM15 by feeding in the APB clock.  (RCC_APB2ENR_TIM15EN)
-	SET_BITS(RCC->APB2ENR, RCC_APB2ENR_TIM15EN);
-	
-	// 2. Program the prescaler (PSC) to ensure TIM15 counts at 1us
+**********************************************************************************/
+static void RCServo_TimerInit(TIM_TypeDef *timer){
+	// 1. Program the prescaler (PSC) to ensure the timer counts at 1us
 	// Timer Period = (Prescaler + 1) / SystemClockFreq
 	// 1us = (Prescaler + 1) / 72MHz
 	// (Prescaler + 1) = 72
 	// Prescaler = 71
-	SET_BITS(TIM15->PSC, 71UL);
+	FORCE_BITS(timer->PSC, 0xFFFFUL, 71UL);
 	
-	// 3. Set TIM15 to Upcounting 
-	// (no need to do it, because TIM15 only knows upcounting...)
+	// 2. Set the timer to Upcounting 
+	// (no need to do it, because TIM15 and TIM17 only know upcounting...)
 	
-	// 4. Set the ARR to 20000us period
+	// 3. Set the ARR to 20000us period
 	//    Repeating Counter Period = ARR + 1
-	//    Then, what is ARR?
-	FORCE_BITS(TIM15->ARR, 0xFFFFUL, 20001UL);
-	
-	// 5. Enable TIM15 ARR Preload (ARPE flag on CR1)
-	SET_BITS(TIM15->CR1, TIM_CR1_ARPE);
-	
-	// 6. Enable TIM15 main output, so to make it avaiable to the PWM OC (MOE flag on BDTR)
-	SET_BITS(TIM15->BDTR, TIM_BDTR_MOE);
-	
+	//    ARR = 20000us - 1
+	FORCE_BITS(timer->ARR, 0xFFFFUL, 19999UL);
 	
-	// Configure CH2 of TIM15 for PWM OC mode
-	// 1. Select PWM mode 1 (low-count mode) for TIM15 CH2 (OC2M flags - 2 bits - on CCMR1)
-	//    ** PAY VERY CLOSE ATTENTION ON THIS ITEM **
-	SET_BITS(TIM15->CCMR1, TIM_CCMR1_OC2M);
-	
-	// 2. Enable the Output Compare Preload on CH2 (OC2PE flag on CCMR1)
-	SET_BITS(TIM15->CCMR1, TIM_CCMR1_OC2PE);
-	
-	// 3. Enable output channel 2 (CH2 with no negate) - (CC2E flag on CCER)
-	SET_BITS(TIM15->CCER, TIM_CCER_CC2E);
-	
-	// 4. Make CH2 Active High (no negate) - (CC2P flag on CCER)
-	SET_BITS(TIM15->CCER, TIM_CCER_CC2P);
-	
-	// 5. Set CH2 PWM initial on-time to 0, so PWM will not output anything before preload is done (writing 0 into CCR2)
-	CLEAR_BITS(TIM15->CCR2, TIM_CCR2_CCR2);
+	// 4. Enable ARR Preload (ARPE flag on CR1)
+	SET_BITS(timer->CR1, TIM_CR1_ARPE);
 	
+	// 5. Enable main output, so to make it avaiable to the PWM OC (MOE flag on BDTR)
+	SET_BITS(timer->BDTR, TIM_BDTR_MOE);
+}
+
+/*********************************************************************************
+* RCServo_ChannelInit() - Configure a servo pin and timer channel for PWM output.
+* servo		- Servo number.
+* No return value.
+**********************************************************************************/
+static void RCServo_ChannelInit(uint8_t servo){
+	const RCServo_Channel *ch = &servoChannels[servo];
 	
-	// Set TIM15 off!
-	// 1. Force and Update Event to ensure all preload operations are done in sync! (UG flag on EGR)
-	SET_BITS(TIM15->EGR, TIM_EGR_UG);
+	Gpio_Configure(ch->port, &ch->pin);
 	
-	// 2. Enable TIM15 Counting! (CEN flag on CR1)
-	SET_BITS(TIM15->CR1, TIM_CR1_CEN);
+	// Configure the channel for PWM OC mode, with an initial on-time of 0
+	// so PWM will not output anything before preload is done
+	Timer_OcConfigure(ch->timer, &ch->oc);
+	if(ch->channel == 1){
+		CLEAR_BITS(ch->timer->CCR1, TIM_CCR1_CCR1);
+	}
+	else{
+		CLEAR_BITS(ch->timer->CCR2, TIM_CCR2_CCR2);
+	}
 }
 
 /*********************************************************************************
-* RCServo_setAngle() - Sets angle of the servo motor by updating the pulse width.
-* angle		- Servo motor angle.
-* Returns pulse width based on input angle.
+* RCServo_AngleToPW() - Converts an angle to a pulse width using the calibration.
+* servo		- Servo number.
+* angle		- Servo motor angle (0.1 degrees).
+* Returns the pulse width (us) capped at the mechanical limits.
 **********************************************************************************/
-int16_t RCServo_SetAngle(int16_t angle){
-	int16_t PW = 0;	// Pulse width
-	
-	// Pulse width is position set point
-	// Pulse train needs to repeat every 20us
+CCM_FUNC static uint16_t RCServo_AngleToPW(uint8_t servo, int32_t angle){
+	const RCServo_Calibration *cal = &servos[servo].cal;
+	int32_t PW = 0;	// Pulse width
 	
 	// 1. Convert the target angle to the corresponding target Pulse Width
 		// According to angle vs PW graph from slides: 1 degree = 10us
 			// m = (y2 - y1) / (x2 - x1)
 			// m = (90 - 0) / (2400 - 1500)
 			// m = 0.1 degree/us (10us/degree)
-	PW = SERVO_CENTRE + angle * US_PER_DEGREE;
+	PW = cal->centre + (angle * cal->usPerDegreeX10) / 100;
 	
 	// 2. Check whether the PW has exceeded the mechanical (+45 ~ -45 degrees) & motor limit (+/- 90 degrees) and cap the target PW at the limits!
 		// 600us 		-90 degrees		(motor limit)
@@ -136,16 +142,299 @@ int16_t RCServo_SetAngle(int16_t angle){
 		// 1950us 	+45 degrees		(mechanical limit)
 		// 2100us 	+60 degrees
 		// 2400us 	+90 degrees		(motor limit)
-	if(PW > SERVO_POS_LMT){
-		PW = SERVO_POS_LMT;
+	if(PW > cal->posLimit){
+		PW = cal->posLimit;
 	}
-	else if(PW < SERVO_NEG_LMT){
-		PW = SERVO_NEG_LMT;
+	else if(PW < cal->negLimit){
+		PW = cal->negLimit;
 	}
+	return((uint16_t)PW);
+}
+
+/*********************************************************************************
+* RCServo_Output() - Writes the current trajectory angle into the channel CCR.
+* servo		- Servo number.
+* Returns the pulse width written.
+**********************************************************************************/
+CCM_FUNC static uint16_t RCServo_Output(uint8_t servo){
+	const RCServo_Channel *ch = &servoChannels[servo];
+	uint16_t PW = RCServo_AngleToPW(servo, servos[servo].angle / 256);
 	
-	// 3. Write the new target PW into TIM15 CR2 
-	FORCE_BITS(TIM15->CCR2, 0xFFFFUL, (uint16_t)PW);
-	
-	// 4. return the calculated PW for printout in main()
+	// CCR is preloaded, so the new PW starts on the next 20ms frame
+	if(ch->channel == 1){
+		FORCE_BITS(ch->timer->CCR1, 0xFFFFUL, PW);
+	}
+	else{
+		FORCE_BITS(ch->timer->CCR2, 0xFFFFUL, PW);
+	}
 	return(PW);
 }
+
+/*********************************************************************************
+* RCServo_SlewPerFrame() - Converts a slew rate to an angle change per frame.
+* degPerSec		- Slew rate (degrees/s).
+* Returns the angle change per frame (0.1 degrees << 8).
+**********************************************************************************/
+static int32_t RCServo_SlewPerFrame(uint16_t degPerSec){
+	return(((int32_t)degPerSec * 10 * 256) / SERVO_FRAME_RATE);
+}
+
+/*********************************************************************************
+* RCServo_Update() - Advances one servo trajectory by one frame.
+* servo		- Servo number.
+* No return value.
+**********************************************************************************/
+CCM_FUNC static void RCServo_Update(uint8_t servo){
+	RCServo_State *s = &servos[servo];
+	
+	if(s->motion == SERVO_IDLE){
+		return;
+	}
+	
+	// Step towards the target, at most one slew increment per frame
+	if(s->angle < s->target){
+		s->angle = (s->target - s->angle > s->slew) ? s->angle + s->slew : s->target;
+	}
+	else if(s->angle > s->target){
+		s->angle = (s->angle - s->target > s->slew) ? s->angle - s->slew : s->target;
+	}
+	
+	// Target reached
+	if(s->angle == s->target){
+		if(s->motion == SERVO_SWEEP){
+			s->target = (s->target == s->sweepFrom) ? s->sweepTo : s->sweepFrom;
+		}
+		else{
+			s->motion = SERVO_IDLE;
+		}
+	}
+	
+	RCServo_Output(servo);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/****************************************************
+* RCServo_init() - Configure setting for servo motors.
+* No inputs.
+* No return value.
+****************************************************/
+void RCServo_Init(void){
+	const RCServo_Calibration defaultCal = {SERVO_CENTRE, SERVO_NEG_LMT, SERVO_POS_LMT, US_PER_DEGREE * 10};
+	uint8_t servo;
+	
+	// Enable clocks to Port B and both servo timers
+	RCC->AHBENR |= RCC_AHBENR_GPIOBEN;
+	SET_BITS(BOARD_TIM_ENR(BOARD_SERVO_TIMER), BOARD_TIM_EN(BOARD_SERVO_TIMER));
+	SET_BITS(BOARD_TIM_ENR(BOARD_SERVO_GRIPPER_TIMER), BOARD_TIM_EN(BOARD_SERVO_GRIPPER_TIMER));
+	
+	RCServo_TimerInit(SERVO_TIMER);
+	RCServo_TimerInit(SERVO_GRIPPER_TIMER);
+	
+	for(servo = 0; servo < SERVO_COUNT; servo++){
+		servos[servo].cal = defaultCal;
+		servos[servo].motion = SERVO_IDLE;
+		servos[servo].angle = 0;
+		RCServo_ChannelInit(servo);
+		RCServo_Output(servo);
+	}
+	
+	// Update all trajectories together on the TIM15 frame boundary
+	SET_BITS(SERVO_TIMER->CR1, TIM_CR1_URS);					// Only counter overflow generates an update interrupt
+	SET_BITS(SERVO_TIMER->DIER, TIM_DIER_UIE);				// Enable update interrupt
+	NVIC_SetPriority(SERVO_TIMER_INT, SERVO_PRIORITY);
+	NVIC_EnableIRQ(SERVO_TIMER_INT);
+	
+	
+	// Set the timers off!
+	// 1. Force and Update Event to ensure all preload operations are done in sync! (UG flag on EGR)
+	SET_BITS(SERVO_TIMER->EGR, TIM_EGR_UG);
+	SET_BITS(SERVO_GRIPPER_TIMER->EGR, TIM_EGR_UG);
+	
+	// 2. Enable Counting! (CEN flag on CR1)
+	SET_BITS(SERVO_TIMER->CR1, TIM_CR1_CEN);
+	SET_BITS(SERVO_GRIPPER_TIMER->CR1, TIM_CR1_CEN);
+}
+
+/*********************************************************************************
+* RCServo_setAngle() - Sets angle of a servo motor by updating the pulse width.
+* servo		- Servo number.
+* angle		- Servo motor angle.
+* Returns pulse width based on input angle.
+**********************************************************************************/
+int16_t RCServo_SetAngle(uint8_t servo, int16_t angle){
+	// Return the calculated PW for printout in main()
+	return(RCServo_SetAngleFine(servo, angle * 10));
+}
+
+/*********************************************************************************
+* RCServo_SetCalibration() - Sets a servo centre, limits and us/degree ratio.
+* servo		- Servo number.
+* cal			- Servo calibration.
+* No return value.
+**********************************************************************************/
+void RCServo_SetCalibration(uint8_t servo, const RCServo_Calibration *cal){
+	if(servo >= SERVO_COUNT){
+		return;
+	}
+	
+	NVIC_DisableIRQ(SERVO_TIMER_INT);
+	servos[servo].cal = *cal;
+	RCServo_Output(servo);
+	NVIC_EnableIRQ(SERVO_TIMER_INT);
+}
+
+/*********************************************************************************
+* RCServo_GetCalibration() - Gets a servo centre, limits and us/degree ratio.
+* servo		- Servo number.
+* cal			- Filled with the servo calibration.
+* No return value.
+**********************************************************************************/
+void RCServo_GetCalibration(uint8_t servo, RCServo_Calibration *cal){
+	if(servo < SERVO_COUNT){
+		*cal = servos[servo].cal;
+	}
+}
+
+/*********************************************************************************
+* RCServo_SetAngleFine() - Jumps a servo to an angle, cancelling any trajectory.
+* servo		- Servo number.
+* angle		- Servo motor angle (0.1 degrees).
+* Returns pulse width based on input angle.
+**********************************************************************************/
+int16_t RCServo_SetAngleFine(uint8_t servo, int16_t angle){
+	uint16_t PW;
+	
+	if(servo >= SERVO_COUNT){
+		return(0);
+	}
+	
+	TRACE(TRACE_SERVO_CMD + servo, angle);
+	
+	NVIC_DisableIRQ(SERVO_TIMER_INT);
+	servos[servo].motion = SERVO_IDLE;
+	servos[servo].angle = (int32_t)angle * 256;
+	PW = RCServo_Output(servo);
+	NVIC_EnableIRQ(SERVO_TIMER_INT);
+	
+	return((int16_t)PW);
+}
+
+/*********************************************************************************
+* RCServo_MoveTo() - Slews a servo to an angle without blocking.
+* servo				- Servo number.
+* angle				- Target angle (0.1 degrees).
+* degPerSec		- Slew rate (degrees/s), 0 jumps straight to the angle.
+* No return value.
+**********************************************************************************/
+void RCServo_MoveTo(uint8_t servo, int16_t angle, uint16_t degPerSec){
+	if(servo >= SERVO_COUNT){
+		return;
+	}
+	if(degPerSec == 0){
+		RCServo_SetAngleFine(servo, angle);
+		return;
+	}
+	
+	TRACE(TRACE_SERVO_CMD + servo, angle);
+	
+	NVIC_DisableIRQ(SERVO_TIMER_INT);
+	servos[servo].slew = RCServo_SlewPerFrame(degPerSec);
+	servos[servo].target = (int32_t)angle * 256;
+	servos[servo].motion = SERVO_MOVE;
+	NVIC_EnableIRQ(SERVO_TIMER_INT);
+}
+
+/*********************************************************************************
+* RCServo_Sweep() - Slews a servo back and forth between two angles until stopped.
+* servo				- Servo number.
+* fromAngle		- First sweep end point (0.1 degrees).
+* toAngle			- Second sweep end point (0.1 degrees).
+* degPerSec		- Slew rate (degrees/s).
+* No return value.
+**********************************************************************************/
+void RCServo_Sweep(uint8_t servo, int16_t fromAngle, int16_t toAngle, uint16_t degPerSec){
+	if(servo >= SERVO_COUNT){
+		return;
+	}
+	if(degPerSec == 0){
+		degPerSec = 1;
+	}
+	
+	NVIC_DisableIRQ(SERVO_TIMER_INT);
+	servos[servo].slew = RCServo_SlewPerFrame(degPerSec);
+	servos[servo].sweepFrom = (int32_t)fromAngle * 256;
+	servos[servo].sweepTo = (int32_t)toAngle * 256;
+	servos[servo].target = servos[servo].sweepFrom;
+	servos[servo].motion = SERVO_SWEEP;
+	NVIC_EnableIRQ(SERVO_TIMER_INT);
+}
+
+/*********************************************************************************
+* RCServo_Hold() - Stops any trajectory and holds the current angle.
+* servo		- Servo number.
+* No return value.
+**********************************************************************************/
+void RCServo_Hold(uint8_t servo){
+	if(servo < SERVO_COUNT){
+		servos[servo].motion = SERVO_IDLE;
+	}
+}
+
+/*********************************************************************************
+* RCServo_GetAngle() - Gets the current trajectory angle.
+* servo		- Servo number.
+* Returns the angle (0.1 degrees).
+**********************************************************************************/
+CCM_FUNC int16_t RCServo_GetAngle(uint8_t servo){
+	if(servo >= SERVO_COUNT){
+		return(0);
+	}
+	return((int16_t)(servos[servo].angle / 256));
+}
+
+/*********************************************************************************
+* RCServo_IsMoving() - Checks whether a servo is following a trajectory.
+* servo		- Servo number.
+* Returns TRUE if moving or FALSE if holding position.
+**********************************************************************************/
+CCM_FUNC uint8_t RCServo_IsMoving(uint8_t servo){
+	if(servo >= SERVO_COUNT){
+		return(0);
+	}
+	return(servos[servo].motion != SERVO_IDLE);
+}
+
+/*********************************************************************************
+* TIM1_BRK_TIM15_IRQHandler() - Advances all servo trajectories once per 20ms frame.
+* No inputs.
+* No return value.
+**********************************************************************************/
+CCM_FUNC void TIM1_BRK_TIM15_IRQHandler(void){
+	uint8_t servo;
+	Bus_Servo *sample;
+	
+	if(!IS_BIT_SET(SERVO_TIMER->SR, TIM_SR_UIF)){
+		return;
+	}
+	SERVO_TIMER->SR = ~TIM_SR_UIF;
+	
+	ISR_ENTER(ISR_SERVO, SERVO_TIMER);
+	ISR_LATENCY(ISR_SERVO, 0);
+	
+	sample = Bus_Claim(BUS_TOPIC_SERVO);
+	sample->moving = 0;
+	for(servo = 0; servo < SERVO_COUNT; servo++){
+		RCServo_Update(servo);
+		sample->angle[servo] = RCServo_GetAngle(servo);
+		if(RCServo_IsMoving(servo)){
+			SET_BITS(sample->moving, 1U << servo);
+		}
+	}
+	Bus_Publish(BUS_TOPIC_SERVO);
+	
+	ISR_EXIT(ISR_SERVO);
+}
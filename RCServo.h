@@ -6,11 +6,46 @@
 ******************************************************************************/
 
 #include "stm32f303xe.h"
+#include "Board.h"
 
 #ifndef __SERVO_H
 #define __SERVO_H
 
+#define SERVO_TIMER					BOARD_TIM(BOARD_SERVO_TIMER)
+#define SERVO_TIMER_INT			BOARD_TIM_IRQ(BOARD_SERVO_TIMER)
+#define SERVO_GRIPPER_TIMER	BOARD_TIM(BOARD_SERVO_GRIPPER_TIMER)
+
+#define SERVO_PRIORITY 10
+
+// Servo outputs
+#define SERVO_PAN				0		// PB15 (TIM15 CH2)
+#define SERVO_TILT			1		// PB14 (TIM15 CH1)
+#define SERVO_GRIPPER		2		// PB9 (TIM17 CH1)
+#define SERVO_COUNT			3
+
+#define SERVO_FRAME_RATE		50		// Pulse frames per second (20ms period)
+#define SERVO_DEFAULT_SLEW	90		// Default slew rate (degrees/s)
+
+// Servo calibration (pulse widths in us)
+typedef struct {
+	uint16_t centre;						// Pulse width at 0 degrees
+	uint16_t negLimit;					// Negative mechanical limit pulse width
+	uint16_t posLimit;					// Positive mechanical limit pulse width
+	uint16_t usPerDegreeX10;		// Pulse width per degree (0.1us)
+} RCServo_Calibration;
+
 void RCServo_Init(void);
-int16_t RCServo_SetAngle(int16_t angle);
+int16_t RCServo_SetAngle(uint8_t servo, int16_t angle);
+
+// Calibration and trajectories (angles in 0.1 degrees)
+void RCServo_SetCalibration(uint8_t servo, const RCServo_Calibration *cal);
+void RCServo_GetCalibration(uint8_t servo, RCServo_Calibration *cal);
+int16_t RCServo_SetAngleFine(uint8_t servo, int16_t angle);
+void RCServo_MoveTo(uint8_t servo, int16_t angle, uint16_t degPerSec);
+void RCServo_Sweep(uint8_t servo, int16_t fromAngle, int16_t toAngle, uint16_t degPerSec);
+void RCServo_Hold(uint8_t servo);
+int16_t RCServo_GetAngle(uint8_t servo);
+uint8_t RCServo_IsMoving(uint8_t servo);
+void TIM1_BRK_TIM15_IRQHandler(void);
 
 #endif
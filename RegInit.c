@@ -0,0 +1,74 @@
+/********************************************************************************
+* Name: RegInit.c (implementation)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Table driven peripheral initialization for mobile robot.
+********************************************************************************/
+
+#include "RegInit.h"
+#include "Utility.h"
+#include "UART.h"
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+#if REGINIT_TRACE_ENABLE
+// Register address and the value read back after the write
+static struct {
+	uint32_t address;
+	uint32_t value;
+} traceLog[REGINIT_TRACE_SIZE];
+
+static uint32_t traceCount = 0;		// Writes applied (may exceed REGINIT_TRACE_SIZE)
+#endif
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+/*************************************************************
+* RegInit_Apply() - Apply a table of register writes in order.
+* table		- Register writes.
+* count		- Number of entries in the table.
+* No return value.
+*************************************************************/
+void RegInit_Apply(const RegInit_Write *table, uint32_t count){
+	for(; count != 0; count--, table++){
+		if(table->mask == REG_ALL){
+			*table->reg = table->value;
+		}
+		else{
+			FORCE_BITS(*table->reg, table->mask, table->value);
+		}
+
+#if REGINIT_TRACE_ENABLE
+		if(traceCount < REGINIT_TRACE_SIZE){
+			traceLog[traceCount].address = (uint32_t)table->reg;
+			traceLog[traceCount].value = *table->reg;
+		}
+		traceCount++;
+#endif
+	}
+}
+
+/*************************************************************
+* RegInit_Report() - Print the register write log over UART.
+* No inputs.
+* No return value.
+*************************************************************/
+void RegInit_Report(void){
+#if REGINIT_TRACE_ENABLE
+	uint32_t count = (traceCount < REGINIT_TRACE_SIZE) ? traceCount : REGINIT_TRACE_SIZE;
+
+	// address value, in the order written
+	UART_printf("REGINIT BEGIN %lu\n", traceCount);
+	for(uint32_t i = 0; i < count; i++){
+		UART_printf("%08lX %08lX\n", traceLog[i].address, traceLog[i].value);
+	}
+	UART_printf("REGINIT END\n");
+#else
+	UART_printf("Register write log disabled (REGINIT_TRACE_ENABLE)\n");
+#endif
+}
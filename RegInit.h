@@ -0,0 +1,42 @@
+/********************************************************************************
+* Name: RegInit.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Table driven peripheral initialization for mobile robot.
+*							 A driver describes its fixed setup as a const table of register
+*							 writes (kept in flash) and applies it with RegInit_Apply().
+*							 With REGINIT_TRACE_ENABLE every write is logged with the value
+*							 read back, so two captures can be diffed to audit a change.
+********************************************************************************/
+
+#ifndef __RegInit_H
+#define __RegInit_H
+
+#include "stm32f303xe.h"
+
+// Set to 1 to log every table write for RegInit_Report()
+#define REGINIT_TRACE_ENABLE 0
+
+#define REGINIT_TRACE_SIZE	128		// Writes kept in the log
+
+#define REG_ALL		0xFFFFFFFFUL		// Whole register mask, written without a read
+
+// One register write: reg = (reg & ~mask) | (value & mask)
+typedef struct {
+	volatile uint32_t *reg;
+	uint32_t mask;
+	uint32_t value;
+} RegInit_Write;
+
+// Table entries, same meaning as the Utility.h bit macros
+#define REG_FORCE(reg, mask, value)		{(volatile uint32_t *)&(reg), (mask), (value)}
+#define REG_SET(reg, bits)						{(volatile uint32_t *)&(reg), (bits), (bits)}
+#define REG_CLEAR(reg, bits)					{(volatile uint32_t *)&(reg), (bits), 0UL}
+#define REG_WRITE(reg, value)					{(volatile uint32_t *)&(reg), REG_ALL, (value)}
+
+#define REG_TABLE_SIZE(table)	(sizeof(table) / sizeof((table)[0]))
+
+void RegInit_Apply(const RegInit_Write *table, uint32_t count);
+void RegInit_Report(void);
+
+#endif
@@ -0,0 +1,592 @@
+/********************************************************************************
+* Name: Robot.c (implementation)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Robot operating modes for mobile robot.
+*
+*							 ROOT
+*							 +- OPERATING		(mode requests, fault, common keys)
+*							 |  +- MANUAL		(servo, DC motor and stepper mode keys)
+*							 |  |  +- MANUAL_STEP
+*							 |  |  +- MANUAL_RUN
+*							 |  +- AUTO			(any key returns to manual)
+*							 |  |  +- AUTO_CRUISE
+*							 |  |  +- AUTO_AVOID
+*							 |  +- CALIBRATION
+*							 +- FAULT
+********************************************************************************/
+
+#include <stddef.h>
+#include "Robot.h"
+#include "Bus.h"
+#include "DCMotor.h"
+#include "Encoder.h"
+#include "LCD.h"
+#include "LED.h"
+#include "RCServo.h"
+#include "Stepper.h"
+#include "Ultrasonic.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+static void Robot_ManualEntry(Hsm_Machine *hsm);
+static void Robot_RunEntry(Hsm_Machine *hsm);
+static void Robot_RunExit(Hsm_Machine *hsm);
+static void Robot_AutoEntry(Hsm_Machine *hsm);
+static void Robot_AutoExit(Hsm_Machine *hsm);
+static void Robot_CruiseEntry(Hsm_Machine *hsm);
+static void Robot_AvoidEntry(Hsm_Machine *hsm);
+static void Robot_CalibrationEntry(Hsm_Machine *hsm);
+static void Robot_FaultEntry(Hsm_Machine *hsm);
+
+static uint8_t Robot_Root(Hsm_Machine *hsm, const Hsm_Event *event);
+static uint8_t Robot_Operating(Hsm_Machine *hsm, const Hsm_Event *event);
+static uint8_t Robot_Manual(Hsm_Machine *hsm, const Hsm_Event *event);
+static uint8_t Robot_ManualStep(Hsm_Machine *hsm, const Hsm_Event *event);
+static uint8_t Robot_ManualRun(Hsm_Machine *hsm, const Hsm_Event *event);
+static uint8_t Robot_Auto(Hsm_Machine *hsm, const Hsm_Event *event);
+static uint8_t Robot_Cruise(Hsm_Machine *hsm, const Hsm_Event *event);
+static uint8_t Robot_Avoid(Hsm_Machine *hsm, const Hsm_Event *event);
+static uint8_t Robot_Calibration(Hsm_Machine *hsm, const Hsm_Event *event);
+static uint8_t Robot_Fault(Hsm_Machine *hsm, const Hsm_Event *event);
+
+static const Hsm_State robotStates[] = {
+	//															name					parent							initial							entry										exit							handle
+	[ROBOT_ROOT] =							{"root",			HSM_NONE,						ROBOT_OPERATING,		NULL,										NULL,							Robot_Root},
+	[ROBOT_OPERATING] =					{"operating",	ROBOT_ROOT,					ROBOT_MANUAL,				NULL,										NULL,							Robot_Operating},
+	[ROBOT_MANUAL] =						{"manual",		ROBOT_OPERATING,		ROBOT_MANUAL_STEP,	Robot_ManualEntry,			NULL,							Robot_Manual},
+	[ROBOT_MANUAL_STEP] =				{"step",			ROBOT_MANUAL,				HSM_NONE,						NULL,										NULL,							Robot_ManualStep},
+	[ROBOT_MANUAL_RUN] =				{"run",				ROBOT_MANUAL,				HSM_NONE,						Robot_RunEntry,					Robot_RunExit,		Robot_ManualRun},
+	[ROBOT_AUTO] =							{"auto",			ROBOT_OPERATING,		ROBOT_AUTO_CRUISE,	Robot_AutoEntry,				Robot_AutoExit,		Robot_Auto},
+	[ROBOT_AUTO_CRUISE] =				{"cruise",		ROBOT_AUTO,					HSM_NONE,						Robot_CruiseEntry,			NULL,							Robot_Cruise},
+	[ROBOT_AUTO_AVOID] =				{"avoid",			ROBOT_AUTO,					HSM_NONE,						Robot_AvoidEntry,				NULL,							Robot_Avoid},
+	[ROBOT_CALIBRATION] =				{"calibrate",	ROBOT_OPERATING,		HSM_NONE,						Robot_CalibrationEntry,	NULL,							Robot_Calibration},
+	[ROBOT_FAULT] =							{"fault",			ROBOT_ROOT,					HSM_NONE,						Robot_FaultEntry,				NULL,							Robot_Fault},
+};
+
+_Static_assert(HSM_TABLE_SIZE(robotStates) == ROBOT_STATE_COUNT, "Robot.c: robotStates must have an entry for every state");
+
+// Stepper keys '0' to '4'
+static const char *stepNames[] = {"Stepper Off", "Full Step CW", "Full Step CCW", "Half Step CW", "Half Step CCW"};
+
+// ROBOT_EV_MICROSTEP cycles through these, continuous stepping keys then jog in microsteps
+static const uint8_t microModes[] = {STEPPER_FULL_STEP, STEPPER_MICRO_4, STEPPER_MICRO_8, STEPPER_MICRO_16};
+static const char *microNames[] = {"Microstep Off", "Microstep 1/4", "Microstep 1/8", "Microstep 1/16"};
+
+// Servo names shown while calibrating, by servo number
+static const char *servoNames[SERVO_COUNT] = {"Pan", "Tilt", "Gripper"};
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static Hsm_Machine robot;
+static Kernel_Task robotTask;
+static uint32_t robotStack[ROBOT_TASK_STACK];
+
+// Held by the robot task while it dispatches an event. Delay_ms() blocks the
+// holder, so without it a lower task could run mid LCD command or motor change.
+static Kernel_Sem robotDrivers = KERNEL_SEM_INIT(1, 1);
+
+static uint8_t lastStep = 0;				// Last stepper key, resumed by MANUAL_RUN
+static uint8_t microIndex = 0;			// microModes entry used by MANUAL_RUN
+static int8_t panAngle = 0;					// Pan servo angle (degrees)
+static Encoder_Speed wheelSpeed;		// Key 'D' wheel speeds
+static uint8_t calServo;						// Servo trimmed by CALIBRATION keys
+static uint8_t calTicks;						// CALIBRATION ticks left before manual
+static uint8_t weaveTicks;					// AUTO_CRUISE ticks into the swing
+static int8_t weaveSide;						// AUTO_CRUISE swing, 1 left or -1 right
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Robot_Show() - Show a key and what it did on the LCD.
+* key		- Key pressed.
+* text	- Second line.
+* No return value.
+*************************************************************/
+static void Robot_Show(uint8_t key, const char *text){
+	LCD_Clear();
+	LCD_HomeCursor();
+	LCD_printf("User Input: %c", key);
+	LCD_printf("\n%s", text);
+}
+
+/*************************************************************
+* Robot_ShowMode() - Show the operating mode on the LCD.
+* mode	- Mode name.
+* No return value.
+*************************************************************/
+static void Robot_ShowMode(const char *mode){
+	LCD_Clear();
+	LCD_HomeCursor();
+	LCD_printf("Mode: %s", mode);
+}
+
+/*************************************************************
+* Robot_StepperRun() - Continuous stepping for a stepper key, microstepped if selected.
+* step	- Stepper key value (0 off, 1/3 clockwise, 2/4 counter clockwise).
+* No return value.
+*************************************************************/
+static void Robot_StepperRun(uint8_t step){
+	if(microModes[microIndex] == STEPPER_FULL_STEP || step == 0){
+		Stepper_Run(step);
+		return;
+	}
+	Stepper_SetStepMode(microModes[microIndex]);
+	Stepper_Jog((step & 1) ? STEPPER_CW : STEPPER_CCW);
+}
+
+/*************************************************************
+* Robot_Range() - Latest ultrasonic range, then ping again.
+* No inputs.
+* Returns the distance (cm), or 0xFFFFFFFF before the first echo.
+*************************************************************/
+static uint32_t Robot_Range(void){
+	const Bus_Ultra *sample;
+	uint32_t version, distance;
+
+	(void)Ultra_EchoRx();		// Publishes the echo of the last ping, if it came back
+	do{
+		sample = Bus_Latest(BUS_TOPIC_ULTRA, &version);
+		distance = sample->distance;
+	} while(!Bus_Valid(BUS_TOPIC_ULTRA, version));
+	Ultra_StartTrigger();
+
+	return((version == 0) ? 0xFFFFFFFFUL : distance);
+}
+
+/*************************************************************
+* Robot_Weave() - Curve to one side while driving forwards.
+* side	- 1 left or -1 right.
+* No return value.
+* Speeds only: DCMotor_SetDir() coasts each wheel for 5ms.
+*************************************************************/
+static void Robot_Weave(int8_t side){
+	weaveSide = side;
+	DCMotor_SetSpeed(DCMOTOR_LEFT, ROBOT_AUTO_SPEED - side * ROBOT_WEAVE_DUTY);
+	DCMotor_SetSpeed(DCMOTOR_RIGHT, ROBOT_AUTO_SPEED + side * ROBOT_WEAVE_DUTY);
+}
+
+/*************************************************************
+* Robot_Trim() - Move the calibrated centre of the selected servo.
+* key		- Key pressed.
+* us		- Centre change (us).
+* No return value.
+* The servo is centring or centred, so its output follows the trim.
+*************************************************************/
+static void Robot_Trim(uint8_t key, int16_t us){
+	RCServo_Calibration cal;
+	int32_t centre;
+
+	RCServo_GetCalibration(calServo, &cal);
+	centre = (int32_t)cal.centre + us;
+	if(centre >= cal.negLimit && centre <= cal.posLimit){
+		cal.centre = (uint16_t)centre;
+		RCServo_SetCalibration(calServo, &cal);
+	}
+	LCD_Clear();
+	LCD_HomeCursor();
+	LCD_printf("User Input: %c", key);
+	LCD_printf("\n%s: %uus", servoNames[calServo], cal.centre);
+}
+
+/*************************************************************
+* Robot_Task() - Runs the robot state machine.
+* arg		- Unused.
+* No return value.
+*************************************************************/
+static void Robot_Task(void *arg){
+	Hsm_Init(&robot, "robot", robotStates, ROBOT_STATE_COUNT, ROBOT_ROOT);
+	Hsm_Run(&robot, ROBOT_TICK_US, &robotDrivers);
+}
+
+
+/******************************************************************
+*												ENTRY AND EXIT ACTIONS										*
+******************************************************************/
+
+static void Robot_ManualEntry(Hsm_Machine *hsm){
+	Robot_ShowMode("Manual");
+}
+
+static void Robot_RunEntry(Hsm_Machine *hsm){
+	Robot_StepperRun(lastStep);
+}
+
+static void Robot_RunExit(Hsm_Machine *hsm){
+	Stepper_Stop();
+}
+
+static void Robot_AutoEntry(Hsm_Machine *hsm){
+	Robot_ShowMode("Autonomous");
+	Ultra_StartTrigger();
+}
+
+static void Robot_AutoExit(Hsm_Machine *hsm){
+	DCMotor_Stop();
+}
+
+static void Robot_CruiseEntry(Hsm_Machine *hsm){
+	// The beam only covers the middle of the footprint. Swinging the heading
+	// either side of the entry heading sweeps it past the edges, which a
+	// straight run grazes posts with.
+	DCMotor_Forward(ROBOT_AUTO_SPEED);
+	weaveTicks = ROBOT_WEAVE_TICKS / 2;
+	Robot_Weave(1);
+}
+
+static void Robot_AvoidEntry(Hsm_Machine *hsm){
+	// Turn left on the spot
+	DCMotor_SetMotors(DCMOTOR_BWD, ROBOT_AUTO_SPEED, DCMOTOR_FWD, ROBOT_AUTO_SPEED);
+}
+
+static void Robot_CalibrationEntry(Hsm_Machine *hsm){
+	Robot_ShowMode("Calibration");
+	DCMotor_Stop();
+	Stepper_Stop();
+	for(uint8_t servo = 0; servo < SERVO_COUNT; servo++){
+		RCServo_MoveTo(servo, 0, SERVO_DEFAULT_SLEW);
+	}
+	panAngle = 0;
+	calServo = SERVO_PAN;
+	calTicks = ROBOT_CAL_TICKS;
+}
+
+static void Robot_FaultEntry(Hsm_Machine *hsm){
+	DCMotor_Stop();
+	Stepper_Halt();
+	for(uint8_t servo = 0; servo < SERVO_COUNT; servo++){
+		RCServo_Hold(servo);
+	}
+	Robot_ShowMode("FAULT");
+	LCD_printf("\nSend m to clear");
+}
+
+
+/******************************************************************
+*												EVENT HANDLERS														*
+******************************************************************/
+
+static uint8_t Robot_Root(Hsm_Machine *hsm, const Hsm_Event *event){
+	// Ticks only matter to the modes that use them
+	return((event->signal == HSM_SIG_TICK) ? HSM_HANDLED : HSM_UNHANDLED);
+}
+
+static uint8_t Robot_Operating(Hsm_Machine *hsm, const Hsm_Event *event){
+	switch(event->signal){
+		case ROBOT_EV_MANUAL:{
+			Hsm_Transition(hsm, ROBOT_MANUAL);
+			return(HSM_HANDLED);
+		}
+		case ROBOT_EV_AUTO:{
+			Hsm_Transition(hsm, ROBOT_AUTO);
+			return(HSM_HANDLED);
+		}
+		case ROBOT_EV_CALIBRATE:{
+			Hsm_Transition(hsm, ROBOT_CALIBRATION);
+			return(HSM_HANDLED);
+		}
+		case ROBOT_EV_FAULT:{
+			Hsm_Transition(hsm, ROBOT_FAULT);
+			return(HSM_HANDLED);
+		}
+		case ROBOT_EV_KEY:{
+			break;
+		}
+		default:{
+			return(HSM_UNHANDLED);
+		}
+	}
+
+	switch(event->param){
+		// Ping ultrasonic, sleeping between echo checks so lower tasks keep running
+		case '5':{
+			uint32_t waited = 0;
+			uint8_t echo;
+
+			Ultra_StartTrigger();
+			while(!(echo = Ultra_EchoRx()) && waited < ROBOT_ECHO_TIMEOUT_US){
+				Kernel_Delay(ROBOT_ECHO_POLL_US);
+				waited += ROBOT_ECHO_POLL_US;
+			}
+			if(echo){
+				LCD_Clear();
+				LCD_HomeCursor();
+				LCD_printf("User Input: 5");
+				LCD_printf("\nUltrasonic: %dcm", Ultra_ReadSensor());
+			}
+			else{
+				Robot_Show('5', "No echo");
+			}
+			return(HSM_HANDLED);
+		}
+		case '6':{
+			Robot_Show('6', "It's a button.");
+			return(HSM_HANDLED);
+		}
+		// LED
+		case '*':{
+			Robot_Show('*', "Toggle LED");
+			LED_Toggle();
+			return(HSM_HANDLED);
+		}
+		// Check encoder values
+		case 'D':{
+			Encoder_CalculateSpeed(&wheelSpeed);
+			LCD_Clear();
+			LCD_HomeCursor();
+			LCD_printf("User Input: D");
+			LCD_printf("\nL: %d R: %d", wheelSpeed.period[LEFT_ENC], wheelSpeed.period[RIGHT_ENC]);
+			return(HSM_HANDLED);
+		}
+	}
+	return(HSM_UNHANDLED);
+}
+
+static uint8_t Robot_Manual(Hsm_Machine *hsm, const Hsm_Event *event){
+	// Continuous step size, applied straight away if already stepping
+	if(event->signal == ROBOT_EV_MICROSTEP){
+		microIndex = (microIndex + 1) % (sizeof(microModes) / sizeof(microModes[0]));
+		Robot_ShowMode(microNames[microIndex]);
+		if(Hsm_IsIn(hsm, ROBOT_MANUAL_RUN)){
+			Robot_StepperRun(lastStep);
+		}
+		return(HSM_HANDLED);
+	}
+	if(event->signal != ROBOT_EV_KEY){
+		return(HSM_UNHANDLED);
+	}
+
+	switch(event->param){
+		// SERVO
+		// Decrease servo angle
+		case '7':{
+			Robot_Show('7', "Dec Servo Angle");
+			panAngle -= 5;
+			RCServo_MoveTo(SERVO_PAN, panAngle * 10, SERVO_DEFAULT_SLEW);
+			return(HSM_HANDLED);
+		}
+		// Centre servo
+		case '8':{
+			Robot_Show('8', "Centre Servo");
+			panAngle = 0;
+			RCServo_MoveTo(SERVO_PAN, panAngle * 10, SERVO_DEFAULT_SLEW);
+			return(HSM_HANDLED);
+		}
+		// Increase servo angle
+		case '9':{
+			Robot_Show('9', "Inc Servo Angle");
+			panAngle += 5;
+			RCServo_MoveTo(SERVO_PAN, panAngle * 10, SERVO_DEFAULT_SLEW);
+			return(HSM_HANDLED);
+		}
+		// DC motors forward
+		case 'A':{
+			Robot_Show('A', "DC Forward");
+			DCMotor_Forward(100);
+			return(HSM_HANDLED);
+		}
+		// DC motors off
+		case 'B':{
+			Robot_Show('B', "DC Stop");
+			DCMotor_Stop();
+			return(HSM_HANDLED);
+		}
+		// DC motors backwards
+		case 'C':{
+			Robot_Show('C', "DC Backward");
+			DCMotor_Backward(100);
+			return(HSM_HANDLED);
+		}
+	}
+	return(HSM_UNHANDLED);
+}
+
+static uint8_t Robot_ManualStep(Hsm_Machine *hsm, const Hsm_Event *event){
+	if(event->signal != ROBOT_EV_KEY){
+		return(HSM_UNHANDLED);
+	}
+
+	// Stepper keys take one step
+	if(event->param >= '0' && event->param <= '4'){
+		lastStep = event->param - '0';
+		Robot_Show(event->param, stepNames[lastStep]);
+		Stepper_Step(lastStep);
+		return(HSM_HANDLED);
+	}
+	// Toggle to continuous output mode
+	if(event->param == '#'){
+		Robot_Show('#', "Toggle Mode");
+		Hsm_Transition(hsm, ROBOT_MANUAL_RUN);
+		return(HSM_HANDLED);
+	}
+	return(HSM_UNHANDLED);
+}
+
+static uint8_t Robot_ManualRun(Hsm_Machine *hsm, const Hsm_Event *event){
+	if(event->signal != ROBOT_EV_KEY){
+		return(HSM_UNHANDLED);
+	}
+
+	// Stepper keys change the continuous step
+	if(event->param >= '0' && event->param <= '4'){
+		lastStep = event->param - '0';
+		Robot_Show(event->param, stepNames[lastStep]);
+		Robot_StepperRun(lastStep);
+		return(HSM_HANDLED);
+	}
+	// Toggle to single output mode
+	if(event->param == '#'){
+		Robot_Show('#', "Toggle Mode");
+		Hsm_Transition(hsm, ROBOT_MANUAL_STEP);
+		return(HSM_HANDLED);
+	}
+	return(HSM_UNHANDLED);
+}
+
+static uint8_t Robot_Auto(Hsm_Machine *hsm, const Hsm_Event *event){
+	// Any key takes back manual control
+	if(event->signal == ROBOT_EV_KEY){
+		Hsm_Transition(hsm, ROBOT_MANUAL);
+		return(HSM_HANDLED);
+	}
+	return(HSM_UNHANDLED);
+}
+
+static uint8_t Robot_Cruise(Hsm_Machine *hsm, const Hsm_Event *event){
+	if(event->signal == HSM_SIG_TICK){
+		if(Robot_Range() < ROBOT_OBSTACLE_CM){
+			Hsm_Transition(hsm, ROBOT_AUTO_AVOID);
+		}
+		else if(++weaveTicks == ROBOT_WEAVE_TICKS){
+			weaveTicks = 0;
+			Robot_Weave(-weaveSide);
+		}
+		return(HSM_HANDLED);
+	}
+	return(HSM_UNHANDLED);
+}
+
+static uint8_t Robot_Avoid(Hsm_Machine *hsm, const Hsm_Event *event){
+	if(event->signal == HSM_SIG_TICK){
+		if(Robot_Range() > ROBOT_CLEAR_CM){
+			Hsm_Transition(hsm, ROBOT_AUTO_CRUISE);
+		}
+		return(HSM_HANDLED);
+	}
+	return(HSM_UNHANDLED);
+}
+
+static uint8_t Robot_Calibration(Hsm_Machine *hsm, const Hsm_Event *event){
+	uint8_t moving = 0;
+
+	// Done once every servo has reached centre and the keys have been left alone
+	if(event->signal == HSM_SIG_TICK){
+		for(uint8_t servo = 0; servo < SERVO_COUNT; servo++){
+			moving |= RCServo_IsMoving(servo);
+		}
+		if(moving){
+			calTicks = ROBOT_CAL_TICKS;
+		}
+		else if(calTicks == 0 || --calTicks == 0){
+			Hsm_Transition(hsm, ROBOT_MANUAL);
+		}
+		return(HSM_HANDLED);
+	}
+	if(event->signal != ROBOT_EV_KEY){
+		return(HSM_UNHANDLED);
+	}
+
+	switch(event->param){
+		// Trim the selected servo centre
+		case '7':{
+			Robot_Trim('7', -ROBOT_TRIM_US);
+			break;
+		}
+		case '9':{
+			Robot_Trim('9', ROBOT_TRIM_US);
+			break;
+		}
+		// Select the next servo
+		case '8':{
+			calServo = (calServo + 1) % SERVO_COUNT;
+			Robot_Trim('8', 0);
+			break;
+		}
+		default:{
+			return(HSM_UNHANDLED);
+		}
+	}
+	calTicks = ROBOT_CAL_TICKS;
+	return(HSM_HANDLED);
+}
+
+static uint8_t Robot_Fault(Hsm_Machine *hsm, const Hsm_Event *event){
+	// Only an explicit request to manual mode clears a fault, everything else is ignored
+	if(event->signal == ROBOT_EV_MANUAL){
+		Hsm_Transition(hsm, ROBOT_MANUAL);
+	}
+	return(HSM_HANDLED);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Robot_Init() - Create the robot task (after Kernel_Init).
+* No inputs.
+* No return value.
+*************************************************************/
+void Robot_Init(void){
+	Kernel_TaskCreate(&robotTask, "robot", Robot_Task, NULL, robotStack, ROBOT_TASK_STACK, ROBOT_TASK_PRIORITY);
+}
+
+/*************************************************************
+* Robot_Post() - Queue an event for the robot state machine.
+* event		- ROBOT_EV_*.
+* param		- Key for ROBOT_EV_KEY, otherwise 0.
+* Returns 1 if queued or 0 if the queue was full.
+*************************************************************/
+uint8_t Robot_Post(uint8_t event, uint8_t param){
+	return(Hsm_Post(&robot, event, param));
+}
+
+/*************************************************************
+* Robot_Lock() - Take the LCD, DC motor and stepper drivers from the robot task.
+* No inputs.
+* No return value.
+* The robot task waits for Robot_Unlock() before its next event. Only the
+* main task may lock, there is no priority inheritance and nothing runs
+* between the two priorities.
+*************************************************************/
+void Robot_Lock(void){
+	Kernel_SemTake(&robotDrivers, KERNEL_FOREVER);
+}
+
+/*************************************************************
+* Robot_Unlock() - Hand the drivers back to the robot task.
+* No inputs.
+* No return value.
+*************************************************************/
+void Robot_Unlock(void){
+	Kernel_SemGive(&robotDrivers);
+}
+
+/*************************************************************
+* Robot_Report() - Print the robot mode and dispatch times over UART.
+* No inputs.
+* No return value.
+*************************************************************/
+void Robot_Report(void){
+	Hsm_Report(&robot);
+}
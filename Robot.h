@@ -0,0 +1,65 @@
+/********************************************************************************
+* Name: Robot.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Robot operating modes for mobile robot, as a state machine run
+*							 by its own kernel task.
+*							 - Manual: keypad drives the stepper (single step or continuous,
+*								 optionally microstepped), pan servo, DC motors and LED.
+*							 - Autonomous: drive forwards, turn on the spot away from obstacles.
+*							 - Calibration: centre the servos, keys '7'/'9' trim the centre of
+*								 the selected servo and '8' selects the next one. Back to manual
+*								 once the servos are centred and the keys are left alone.
+*							 - Fault: everything stopped until manual mode is requested.
+*							 The robot task owns the LCD, DC motor and stepper drivers. Any other
+*							 task holds Robot_Lock() while it uses them.
+********************************************************************************/
+
+#ifndef __Robot_H
+#define __Robot_H
+
+#include "stm32f303xe.h"
+#include "Hsm.h"
+
+#define ROBOT_TASK_PRIORITY		2					// Above the main loop task
+#define ROBOT_TASK_STACK			384				// Words
+#define ROBOT_TICK_US					100000UL	// Autonomous and calibration update period
+
+#define ROBOT_AUTO_SPEED			60				// Autonomous drive duty cycle (%)
+#define ROBOT_OBSTACLE_CM			40				// Turn away below this range (the beam sees the footprint's edge from ~39cm)
+#define ROBOT_CLEAR_CM				60				// Drive on again above this range
+#define ROBOT_WEAVE_DUTY			10				// Cruise swings the beam past the sides: duty cycle (%) moved between the wheels
+#define ROBOT_WEAVE_TICKS			4					// and ticks per swing
+#define ROBOT_TRIM_US					5					// Calibration centre trim per key (us)
+#define ROBOT_CAL_TICKS				20				// Calibration ends this many ticks after the servos centre or the last key
+#define ROBOT_ECHO_POLL_US		1000UL		// Key '5' echo check period
+#define ROBOT_ECHO_TIMEOUT_US	50000UL		// Key '5' gives up without an echo (out of range is ~38ms)
+
+// Events
+#define ROBOT_EV_KEY					(HSM_SIG_USER + 0)		// Keypad key, param is the key
+#define ROBOT_EV_MANUAL				(HSM_SIG_USER + 1)
+#define ROBOT_EV_AUTO					(HSM_SIG_USER + 2)
+#define ROBOT_EV_CALIBRATE		(HSM_SIG_USER + 3)
+#define ROBOT_EV_FAULT				(HSM_SIG_USER + 4)
+#define ROBOT_EV_MICROSTEP		(HSM_SIG_USER + 5)		// Next continuous step size (off, 1/4, 1/8, 1/16)
+
+// States
+#define ROBOT_ROOT						0
+#define ROBOT_OPERATING				1					// Every mode except fault
+#define ROBOT_MANUAL					2
+#define ROBOT_MANUAL_STEP			3					// Stepper keys take single steps
+#define ROBOT_MANUAL_RUN			4					// Stepper keys set continuous stepping
+#define ROBOT_AUTO						5
+#define ROBOT_AUTO_CRUISE			6
+#define ROBOT_AUTO_AVOID			7
+#define ROBOT_CALIBRATION			8
+#define ROBOT_FAULT						9
+#define ROBOT_STATE_COUNT			10
+
+void Robot_Init(void);
+uint8_t Robot_Post(uint8_t event, uint8_t param);
+void Robot_Lock(void);
+void Robot_Unlock(void);
+void Robot_Report(void);
+
+#endif
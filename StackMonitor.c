@@ -0,0 +1,200 @@
+/********************************************************************************
+* Name: StackMonitor.c (implementation)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Stack high-water mark and heap usage for mobile robot.
+*							 The unused part of the STACK area from startup_stm32f303xe.s is
+*							 painted at boot. The deepest word no longer holding the paint
+*							 pattern gives the most stack ever used (main and all ISRs share
+*							 the MSP). Use stack_check.py for the static worst case.
+********************************************************************************/
+
+#include <stddef.h>
+#include "StackMonitor.h"
+#include "UART.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+// Linker generated bounds of the STACK and HEAP areas in startup_stm32f303xe.s
+extern uint32_t STACK$$Base;
+extern uint32_t STACK$$Limit;
+extern uint32_t HEAP$$Base;
+extern uint32_t HEAP$$Limit;
+
+#define STACK_BASE		(&STACK$$Base)
+#define STACK_LIMIT		(&STACK$$Limit)
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/	
+
+#if HEAP_MONITOR_ENABLE
+static volatile StackMonitor_Heap heapStats;
+#endif
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+#if HEAP_MONITOR_ENABLE
+// Every block carries its size in front of the caller's memory (8 bytes keeps alignment)
+#define HEAP_HEADER 8UL
+
+// armlink patches $Sub$$ over the library function, GNU ld does the same with --wrap
+#if defined(__ARMCC_VERSION)
+#define HEAP_SUB(fn)		$Sub$$##fn
+#define HEAP_SUPER(fn)	$Super$$##fn
+#else
+#define HEAP_SUB(fn)		__wrap_##fn
+#define HEAP_SUPER(fn)	__real_##fn
+#endif
+
+extern void *HEAP_SUPER(malloc)(size_t size);
+extern void HEAP_SUPER(free)(void *ptr);
+
+/*************************************************************
+* HEAP_SUB(malloc)() - Counting wrapper the linker patches over malloc().
+* size	- Bytes requested.
+* Returns the block or NULL.
+*************************************************************/
+void *HEAP_SUB(malloc)(size_t size){
+	uint8_t *block = HEAP_SUPER(malloc)(size + HEAP_HEADER);
+	uint32_t primask = __get_PRIMASK();
+	
+	__disable_irq();
+	if(block == NULL){
+		heapStats.failures++;
+	}
+	else{
+		*(uint32_t *)block = size;
+		heapStats.allocs++;
+		heapStats.inUse += size;
+		if(heapStats.inUse > heapStats.peak){
+			heapStats.peak = heapStats.inUse;
+		}
+		block += HEAP_HEADER;
+	}
+	__set_PRIMASK(primask);
+	
+	return(block);
+}
+
+/*************************************************************
+* HEAP_SUB(free)() - Counting wrapper the linker patches over free().
+* ptr		- Block from malloc() or NULL.
+* No return value.
+*************************************************************/
+void HEAP_SUB(free)(void *ptr){
+	uint8_t *block = (uint8_t *)ptr - HEAP_HEADER;
+	uint32_t primask;
+	
+	if(ptr == NULL){
+		return;
+	}
+	
+	primask = __get_PRIMASK();
+	__disable_irq();
+	heapStats.inUse -= *(uint32_t *)block;
+	__set_PRIMASK(primask);
+	
+	HEAP_SUPER(free)(block);
+}
+#endif
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* StackMonitor_Init() - Paint the unused stack. Call first in main().
+* No inputs.
+* No return value.
+*************************************************************/
+void StackMonitor_Init(void){
+	uint32_t *p = STACK_BASE;
+	uint32_t *end = (uint32_t *)(__get_MSP() - STACK_PAINT_MARGIN);
+	
+	while(p < end){
+		*p++ = STACK_PAINT;
+	}
+}
+
+/*************************************************************
+* StackMonitor_GetSize() - Get the size of the stack.
+* No inputs.
+* Returns the stack size in bytes.
+*************************************************************/
+uint32_t StackMonitor_GetSize(void){
+	return((uint32_t)STACK_LIMIT - (uint32_t)STACK_BASE);
+}
+
+/*************************************************************
+* StackMonitor_GetHighWater() - Get the most stack used since boot.
+* No inputs.
+* Returns the high-water mark in bytes.
+*************************************************************/
+uint32_t StackMonitor_GetHighWater(void){
+	uint32_t *p = STACK_BASE;
+	
+	// The stack grows down, so scan up from the base to the first used word
+	while(p < STACK_LIMIT && *p == STACK_PAINT){
+		p++;
+	}
+	
+	return((uint32_t)STACK_LIMIT - (uint32_t)p);
+}
+
+/*************************************************************
+* StackMonitor_GetHeap() - Get the heap usage counters.
+* heap	- Filled with the counters (all zero unless HEAP_MONITOR_ENABLE).
+* No return value.
+*************************************************************/
+void StackMonitor_GetHeap(StackMonitor_Heap *heap){
+#if HEAP_MONITOR_ENABLE
+	uint32_t primask = __get_PRIMASK();
+	
+	__disable_irq();
+	*heap = heapStats;
+	__set_PRIMASK(primask);
+#else
+	heap->inUse = 0;
+	heap->peak = 0;
+	heap->allocs = 0;
+	heap->failures = 0;
+#endif
+}
+
+/*************************************************************
+* StackMonitor_Report() - Print stack and heap usage over UART.
+* No inputs.
+* No return value.
+*************************************************************/
+void StackMonitor_Report(void){
+	uint32_t size = StackMonitor_GetSize();
+	uint32_t used = StackMonitor_GetHighWater();
+	uint32_t heapSize = (uint32_t)&HEAP$$Limit - (uint32_t)&HEAP$$Base;
+	Queue_Stats rx;
+	Pool_Stats tx;
+	
+	UART_printf("Stack: %lu of %lu bytes used (%lu%%)\n", used, size, (used * 100UL) / size);
+#if HEAP_MONITOR_ENABLE
+	StackMonitor_Heap heap;
+	
+	StackMonitor_GetHeap(&heap);
+	UART_printf("Heap: %lu bytes in use, peak %lu of %lu, %lu allocs, %lu failed\n",
+		heap.inUse, heap.peak, heapSize, heap.allocs, heap.failures);
+#else
+	UART_printf("Heap: %lu bytes reserved, not monitored\n", heapSize);
+#endif
+	
+	UART_GetRxStats(&rx);
+	UART_printf("UART RX queue: peak %lu of %u, %lu dropped\n", rx.highWater, UART_RX_QUEUE_SIZE, rx.drops);
+	UART_GetTxStats(&tx);
+	UART_printf("UART TX blocks: peak %lu of %u, %lu waits\n", tx.peak, UART_TX_BLOCKS, tx.failures);
+}
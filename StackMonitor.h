@@ -0,0 +1,36 @@
+/********************************************************************************
+* Name: StackMonitor.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Stack high-water mark and heap usage for mobile robot.
+********************************************************************************/
+
+#ifndef __StackMonitor_H
+#define __StackMonitor_H
+
+#include "stm32f303xe.h"
+
+// Set to 1 if malloc is ever linked to count heap usage (wraps malloc and free).
+// The CMake build sets it with -DHEAP_MONITOR=ON, which also passes --wrap to GNU ld.
+#ifndef HEAP_MONITOR_ENABLE
+#define HEAP_MONITOR_ENABLE 0
+#endif
+
+#define STACK_PAINT					0xA5A5A5A5UL		// Fill pattern for unused stack
+#define STACK_PAINT_MARGIN	64UL						// Bytes below the SP left unpainted at boot
+
+// Heap usage
+typedef struct {
+	uint32_t inUse;				// Bytes currently allocated
+	uint32_t peak;				// Most bytes allocated at once
+	uint32_t allocs;			// Successful malloc calls
+	uint32_t failures;		// malloc calls that returned NULL
+} StackMonitor_Heap;
+
+void StackMonitor_Init(void);
+uint32_t StackMonitor_GetSize(void);
+uint32_t StackMonitor_GetHighWater(void);
+void StackMonitor_GetHeap(StackMonitor_Heap *heap);
+void StackMonitor_Report(void);
+
+#endif
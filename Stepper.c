@@ -9,55 +9,257 @@
 #include "Stepper.h"
 #include "Utility.h"
 #include "UART.h"
+#include "Profile.h"
+#include "IsrMonitor.h"
+#include "Trace.h"
+#include "Board.h"
+#include "Gpio.h"
+#include "Atomic.h"
+
+// The step patterns and coil setup assume the coils are PC0-PC3
+_Static_assert(BOARD_PORT_NUM(BOARD_STEPPER_A_PORT) == BOARD_PORT_C && BOARD_STEPPER_A_PIN == 0 &&
+	BOARD_PORT_NUM(BOARD_STEPPER_B_PORT) == BOARD_PORT_C && BOARD_STEPPER_B_PIN == 1 &&
+	BOARD_PORT_NUM(BOARD_STEPPER_C_PORT) == BOARD_PORT_C && BOARD_STEPPER_C_PIN == 2 &&
+	BOARD_PORT_NUM(BOARD_STEPPER_D_PORT) == BOARD_PORT_C && BOARD_STEPPER_D_PIN == 3,
+	"Stepper.c expects the coils on PC0-PC3");
+_Static_assert(BOARD_STEPPER_TIMER == 6, "Stepper.c: TIM6_DAC_IRQHandler serves the step timer");
+
+// Coils start as GPIO outputs with TIM1 already selected in AFR, so microstepping only switches MODER
+#define STEPPER_COIL_PINS(X) \
+	X(STEPPER_A, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(STEPPER_B, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(STEPPER_C, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(STEPPER_D, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO)
+
+#define STEPPER_PWM_CHANNELS(X) \
+	X(1, TIMER_OC_PWM1, TIMER_CC_OUT) \
+	X(2, TIMER_OC_PWM1, TIMER_CC_OUT) \
+	X(3, TIMER_OC_PWM1, TIMER_CC_OUT) \
+	X(4, TIMER_OC_PWM1, TIMER_CC_OUT)
 
 
 /******************************************************************
 *									LOCAL CONSTANTS AND VARIABLES									  *
 ******************************************************************/
 
-static uint8_t stepCounter = 0xFF;		// Stepper motor pattern counter (only care about the 3 LSBs)
+#define STEPPER_ENGINE_IDLE		0
+#define STEPPER_ENGINE_MOVE		1
+#define STEPPER_ENGINE_JOG		2
+
+#define STEPPER_C0_SCALE		956008UL		// 0.676 * sqrt(2) * 1000000us (first step delay = STEPPER_C0_SCALE / sqrt(accel))
+#define STEPPER_MAX_ACCEL		0xFFFFUL		// Keeps (accel << 8) in range for Stepper_Sqrt()
+
+#define STEPPER_PINS		0xFUL		// PC0-PC3
+
+// Map a binary step pattern (A, A/, B, B/) onto PC0-PC3
+#define STEP_PATTERN_PINS(pattern)	((((pattern) >> 3) & 0x1UL) | (((pattern) >> 1) & 0x2UL) | (((pattern) << 1) & 0x4UL) | (((pattern) << 3) & 0x8UL))
+#define STEP_PATTERN_BSRR(pattern)	GPIO_BSRR_VALUE(STEPPER_PINS, STEP_PATTERN_PINS(pattern))
+
+// BSRR words for the different possible binary step patterns {0x8, 0xA, 0x2, 0x6, 0x4, 0x5, 0x1, 0x9}
+static const uint32_t stepPatterns[] = {
+	STEP_PATTERN_BSRR(0x8), STEP_PATTERN_BSRR(0xA), STEP_PATTERN_BSRR(0x2), STEP_PATTERN_BSRR(0x6),
+	STEP_PATTERN_BSRR(0x4), STEP_PATTERN_BSRR(0x5), STEP_PATTERN_BSRR(0x1), STEP_PATTERN_BSRR(0x9)
+};
+
+#define STEP_FULL		STEPPER_MICROSTEPS				// Microsteps per full step
+#define STEP_HALF		(STEPPER_MICROSTEPS / 2)	// Microsteps per half step
+
+// Quarter sine wave of coil PWM duty, 16 microsteps per 90 electrical degrees (one full step)
+static const uint16_t microstepDuty[] = {
+	0, 353, 702, 1045, 1378, 1697, 2000, 2284, 2546,
+	2783, 2993, 3175, 3326, 3445, 3531, 3583, 3600
+};
+
+static uint8_t stepCounter = 0xF8;		// Stepper motor phase counter in microsteps (bits 3-5 select the step pattern)
 static int8_t lastStep = 0;						// Last valid step incrament
 static uint8_t lastStepType = 0;			// Last valid step type
+static uint8_t microstepping = 0;			// Coils are PWM driven by TIM1
+
+// Step engine state (position is counted in microsteps, STEPPER_MICROSTEPS per full step)
+static volatile int32_t stepPosition = 0;					// Absolute position
+static volatile int32_t targetPosition = 0;				// Move target position
+static volatile uint8_t engineState = STEPPER_ENGINE_IDLE;
+static volatile int8_t engineDir = STEPPER_CW;		// Direction of the step in progress
+static volatile int8_t jogDir = STEPPER_CW;				// Requested jog direction
+static uint8_t stepIncrement = STEP_FULL;					// Microsteps per step
+static uint32_t rampStep = 0;											// Steps taken on the acceleration ramp
+static uint32_t stepDelay = 0;										// Current step period (us << 8)
+static uint32_t minDelay = 0;											// Step period at max rate (us << 8)
+static uint32_t firstDelay = 0;										// First step period from standstill (us << 8)
 
 
 /******************************************************************
 *												PRIVATE FUNCTIONS													*
 ******************************************************************/
 
+/*************************************************************
+* Stepper_Sine() - Looks up the sine of an electrical angle.
+* phase		- Electrical angle in microsteps (64 per cycle).
+* Returns the signed coil PWM duty.
+*************************************************************/
+CCM_FUNC static int32_t Stepper_Sine(uint8_t phase){
+	uint8_t index = phase & 0xF;	// Position within the quadrant
+	
+	switch((phase >> 4) & 0x3){
+		case 0: return(microstepDuty[index]);
+		case 1: return(microstepDuty[16 - index]);
+		case 2: return(-(int32_t)microstepDuty[index]);
+		default: return(-(int32_t)microstepDuty[16 - index]);
+	}
+}
+
+/*************************************************************
+* Stepper_MicroOutput() - Updates the TIM1 PWM duty of coils A and B.
+* step		- Step counter (electrical angle in microsteps).
+* No return value.
+*************************************************************/
+CCM_FUNC static void Stepper_MicroOutput(uint8_t step){
+	PROF_BEGIN(PROF_STEPPER_MICRO);
+	int32_t coilA = Stepper_Sine(step + 16);	// cos
+	int32_t coilB = Stepper_Sine(step);				// sin
+	
+	// CCR preload makes all four duties change together at the next PWM period
+	STEPPER_PWM_TIMER->CCR1 = (coilA > 0) ? coilA : 0;			// PC0 - A
+	STEPPER_PWM_TIMER->CCR2 = (coilA < 0) ? -coilA : 0;		// PC1 - A/
+	STEPPER_PWM_TIMER->CCR3 = (coilB > 0) ? coilB : 0;			// PC2 - B
+	STEPPER_PWM_TIMER->CCR4 = (coilB < 0) ? -coilB : 0;		// PC3 - B/
+	
+	PROF_END(PROF_STEPPER_MICRO);
+}
+
 /*************************************************************
 * stepper_output() - Updates the output of GPIOC pins PC0-PC3.
-* stepPattern		- Binary step pattern to ouput.
+* step		- Step counter (bits 3-5 select the pattern).
 * No return value.
 *************************************************************/
-static void Stepper_Ouput(uint8_t stepPattern){
-	// PC0 - A
-	if (stepPattern & 0x8){
-		GPIOC->ODR |= (1UL << (1*0));
+CCM_FUNC static void Stepper_Ouput(uint8_t step){
+	if(microstepping){
+		Stepper_MicroOutput(step);
 	}
 	else{
-		GPIOC->ODR &= ~(1UL << (1*0));
+		// Single BSRR write so all four coils change together and other GPIOC pins are untouched
+		GPIOC->BSRR = stepPatterns[0x7 & (step >> 3)];
 	}
-	// PC1 - A/
-	if (stepPattern & 0x4){
-		GPIOC->ODR |= (1UL << (1*1));
+}
+
+/*************************************************************
+* Stepper_PwmInit() - Configure TIM1 CH1-CH4 for microstepping PWM.
+* No inputs.
+* No return value.
+*************************************************************/
+static void Stepper_PwmInit(void){
+	SET_BITS(BOARD_TIM_ENR(BOARD_STEPPER_PWM_TIMER), BOARD_TIM_EN(BOARD_STEPPER_PWM_TIMER));																			// Turn on TIM1
+	CLEAR_BITS(STEPPER_PWM_TIMER->PSC, 0xFFFFUL);																		// Count at 72MHz
+	FORCE_BITS(STEPPER_PWM_TIMER->ARR, 0xFFFFUL, STEPPER_PWM_PERIOD - 1);						// 20kHz PWM
+	SET_BITS(STEPPER_PWM_TIMER->CR1, TIM_CR1_ARPE);																	// Enable ARR preload (ARPE) in CR1
+	SET_BITS(STEPPER_PWM_TIMER->BDTR, TIM_BDTR_MOE);																// Set main output enabled (MOE) in BDTR
+	
+	// CH1-CH4 PWM mode 1 with output compare preload, active HI outputs, initial ON-time of 0
+	TIMER_OC_CONFIGURE(STEPPER_PWM_TIMER, STEPPER_PWM_CHANNELS);
+	STEPPER_PWM_TIMER->CCR1 = 0;
+	STEPPER_PWM_TIMER->CCR2 = 0;
+	STEPPER_PWM_TIMER->CCR3 = 0;
+	STEPPER_PWM_TIMER->CCR4 = 0;
+	
+	SET_BITS(STEPPER_PWM_TIMER->EGR, TIM_EGR_UG);		// Force an update event to preload all the registers
+	SET_BITS(STEPPER_PWM_TIMER->CR1, TIM_CR1_CEN);	// Enable TIM1 to start counting
+}
+
+/*************************************************************
+* Stepper_Sqrt() - Integer square root.
+* value		- Value to take the square root of.
+* Returns floor(sqrt(value)).
+*************************************************************/
+static uint32_t Stepper_Sqrt(uint32_t value){
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;
+	
+	while(bit > value){
+		bit >>= 2;
 	}
-	else{
-		GPIOC->ODR &= ~(1UL << (1*1));
+	while(bit != 0){
+		if(value >= root + bit){
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else{
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+	return(root);
+}
+
+/*************************************************************
+* Stepper_LoadDelay() - Loads the current step period into TIM6.
+* No inputs.
+* No return value.
+*************************************************************/
+CCM_FUNC static void Stepper_LoadDelay(void){
+	uint32_t period = stepDelay >> 8;		// Step period in us
+	
+	// TIM6 ARR is 16 bits
+	if(period > 0x10000UL){
+		period = 0x10000UL;
 	}
-	// PC2 - B
-	if (stepPattern & 0x2){
-		GPIOC->ODR |= (1UL << (1*2));
+	else if(period < 2){
+		period = 2;
 	}
-	else{
-		GPIOC->ODR &= ~(1UL << (1*2));
+	FORCE_BITS(STEPPER_TIMER->ARR, 0xFFFFUL, period - 1);
+}
+
+/*************************************************************
+* Stepper_StepsToGo() - Number of steps left in the current motion.
+* dir		- Returns the direction the engine needs to move in.
+* Returns the number of whole steps to the target (0xFFFFFFFF while jogging).
+*************************************************************/
+CCM_FUNC static uint32_t Stepper_StepsToGo(int8_t *dir){
+	int32_t delta = targetPosition - stepPosition;
+	
+	if(engineState == STEPPER_ENGINE_JOG){
+		*dir = jogDir;
+		return(0xFFFFFFFFUL);
 	}
-	// PC3 - B/
-	if (stepPattern & 0x1){
-		GPIOC->ODR |= (1UL << (1*3));
+	
+	if(delta < 0){
+		*dir = STEPPER_CCW;
+		delta = -delta;
 	}
 	else{
-		GPIOC->ODR &= ~(1UL << (1*3));
+		*dir = STEPPER_CW;
 	}
+	return((uint32_t)delta / stepIncrement);
+}
+
+/*************************************************************
+* Stepper_Decelerate() - Moves one step down the acceleration ramp.
+* No inputs.
+* No return value.
+*************************************************************/
+CCM_FUNC static void Stepper_Decelerate(void){
+	// c(n-1) = c(n) + 2c(n) / (4n - 1)
+	if(rampStep > 0){
+		stepDelay += (2 * stepDelay) / (4 * rampStep - 1);
+		rampStep--;
+	}
+	if(rampStep == 0){
+		stepDelay = firstDelay;
+	}
+}
+
+/*************************************************************
+* Stepper_Start() - Starts the step engine from standstill.
+* dir		- Direction to start moving in.
+* No return value.
+*************************************************************/
+static void Stepper_Start(int8_t dir){
+	engineDir = dir;
+	rampStep = 0;
+	stepDelay = (firstDelay > minDelay) ? firstDelay : minDelay;
+	Stepper_LoadDelay();
+	
+	CLEAR_BITS(STEPPER_TIMER->CNT, 0xFFFFUL);		// Full first period before the first step
+	SET_BITS(STEPPER_TIMER->CR1, TIM_CR1_CEN);
 }
 
 
@@ -71,29 +273,29 @@ static void Stepper_Ouput(uint8_t stepPattern){
 * No return value.
 *************************************************************/
 void Stepper_Init(void){
-	uint8_t PCx;	// GPIOC pin number (PC0-PC3)
-	
-	// 1. Turn on AHB so GPIOs are ON
+	// PC0-PC3 as push-pull outputs, OFF (0) before they start driving
 	RCC->AHBENR |= RCC_AHBENR_GPIOCEN;
+	GPIO_PORT_WRITE(C, STEPPER_PINS, 0UL);
+	GPIO_CONFIGURE(BOARD_STEPPER_A_PORT, STEPPER_COIL_PINS);
+	
+	Stepper_PwmInit();
 	
-	// PC0-PC3
-	for(PCx = 0; PCx < 4; PCx++){
-		// 2. GPIO Mode Register -> set to OUTPUT
-		// Reset PC0-PC3
-		GPIOC->MODER &= ~(3UL << (2*PCx));
-
-		// Set PC0-PC3 to output (01)
-		GPIOC->MODER |= (1UL << (2*PCx));
-		
-		// 3. Set GPIO output TYPE to push-pull (logic 0)
-		GPIOC->OTYPER &= ~(1UL << (1*PCx));
-		
-		// 4. (optional) set GPIO pull-up/pull-down register to default (no pull)
-		GPIOC->PUPDR &= ~(3UL << (2*PCx));
-		
-		// 5. Initialize to OFF (0)
-		GPIOC->ODR &= ~(1UL << (1*PCx));
-	}		
+	// Configure TIM6 as the step engine timebase
+	SET_BITS(BOARD_TIM_ENR(BOARD_STEPPER_TIMER), BOARD_TIM_EN(BOARD_STEPPER_TIMER));		// Enable the step timer
+	SET_BITS(STEPPER_TIMER->PSC, 71UL);							// Set prescaler counts in 1us
+		// Timer Period = (Prescaler + 1) / SystemClockFreq
+		// 1us = (Prescaler + 1) / 72MHz
+		// (Prescaler + 1) = 72
+		// Prescaler = 71
+	SET_BITS(STEPPER_TIMER->CR1, TIM_CR1_URS);			// Only counter overflow generates an update interrupt
+	SET_BITS(STEPPER_TIMER->EGR, TIM_EGR_UG);				// Force an update event to preload the prescaler
+	SET_BITS(STEPPER_TIMER->DIER, TIM_DIER_UIE);		// Enable update interrupt (one step per update)
+	NVIC_SetPriority(STEPPER_TIMER_INT, STEPPER_PRIORITY);
+	NVIC_EnableIRQ(STEPPER_TIMER_INT);
+	
+	// Default motion profile
+	Stepper_SetMaxRate(STEPPER_DEFAULT_RATE);
+	Stepper_SetAccel(STEPPER_DEFAULT_ACCEL);
 }
 
 /****************************************************************
@@ -102,53 +304,336 @@ void Stepper_Init(void){
 * No return value.
 ****************************************************************/
 void Stepper_Step(uint8_t stepType){
-	uint8_t stepPatterns[] = {0x8, 0xA, 0x2, 0x6, 0x4, 0x5, 0x1, 0x9};		// The different possible binary step patterns
+	PROF_BEGIN(PROF_STEPPER_STEP);
+	TRACE(TRACE_STEPPER_CMD, stepType);
+	
+	// Manual steps take over from the step engine
+	Stepper_Halt();
 	
 	switch(stepType){
 		// Turn motor OFF
 		case 0: {
-			Stepper_Ouput(stepPatterns[0x7 & stepCounter]);	
+			Stepper_Ouput(stepCounter);
 			lastStepType = 0;
 			lastStep = 0;
 			break;
 		}
 		// Full-step clockwise
 		case 1:{
-			stepCounter += 2;
-			Stepper_Ouput(stepPatterns[0x7 & stepCounter]);		// & with 0x7 because we just want the lower 3 bits
+			stepCounter += STEP_FULL;
+			stepPosition += STEP_FULL;
+			Stepper_Ouput(stepCounter);
 			lastStepType = 1;
-			lastStep = 2;
+			lastStep = STEP_FULL;
 			break;
 		}
 		// Full-step coutner clockwise
 		case 2:{
-			stepCounter -= 2;
-			Stepper_Ouput(stepPatterns[0x7 & stepCounter]);		// & with 0x7 because we just want the lower 3 bits
+			stepCounter -= STEP_FULL;
+			stepPosition -= STEP_FULL;
+			Stepper_Ouput(stepCounter);
 			lastStepType = 2;
-			lastStep = -2;
+			lastStep = -STEP_FULL;
 			break;
 		}
 		// Half-step clockwise
 		case 3:{
-			stepCounter++;
-			Stepper_Ouput(stepPatterns[0x7 & stepCounter]);		// & with 0x7 because we just want the lower 3 bits
+			stepCounter += STEP_HALF;
+			stepPosition += STEP_HALF;
+			Stepper_Ouput(stepCounter);
 			lastStepType = 3;
-			lastStep = 1;
+			lastStep = STEP_HALF;
 			break;
 		}
 		// Half-step counter clockwise
 		case 4:{
-			stepCounter--;
-			Stepper_Ouput(stepPatterns[0x7 & stepCounter]);		// & with 0x7 because we just want the lower 3 bits			
+			stepCounter -= STEP_HALF;
+			stepPosition -= STEP_HALF;
+			Stepper_Ouput(stepCounter);
 			lastStepType = 4;
-			lastStep = -1;
+			lastStep = -STEP_HALF;
 			break;
 		}
 		// Repeat last valid input if bad value is passed to the funciton
 		default:{
 			stepCounter += lastStep;
-			Stepper_Ouput(stepPatterns[0x7 & stepCounter]);		// & with 0x7 because we just want the lower 3 bits
+			stepPosition += lastStep;
+			Stepper_Ouput(stepCounter);
 			break;
 		}
 	}
+	
+	PROF_END(PROF_STEPPER_STEP);
+}
+
+/****************************************************************
+* Stepper_Run() - Continuous output of a step type using the step engine.
+* stepType		- The type of step (OFF, FS-CW, FS-CCW, HS-CW, HS-CCW) to repeat.
+* No return value.
+****************************************************************/
+void Stepper_Run(uint8_t stepType){
+	TRACE(TRACE_STEPPER_CMD, stepType);
+	
+	switch(stepType){
+		// Full-step clockwise
+		case 1:{
+			Stepper_SetStepMode(STEPPER_FULL_STEP);
+			Stepper_Jog(STEPPER_CW);
+			break;
+		}
+		// Full-step counter clockwise
+		case 2:{
+			Stepper_SetStepMode(STEPPER_FULL_STEP);
+			Stepper_Jog(STEPPER_CCW);
+			break;
+		}
+		// Half-step clockwise
+		case 3:{
+			Stepper_SetStepMode(STEPPER_HALF_STEP);
+			Stepper_Jog(STEPPER_CW);
+			break;
+		}
+		// Half-step counter clockwise
+		case 4:{
+			Stepper_SetStepMode(STEPPER_HALF_STEP);
+			Stepper_Jog(STEPPER_CCW);
+			break;
+		}
+		// Turn motor OFF
+		default:{
+			Stepper_Stop();
+			break;
+		}
+	}
+}
+
+/****************************************************************
+* Stepper_SetStepMode() - Selects the step size of the step engine.
+* mode		- STEPPER_FULL_STEP, STEPPER_HALF_STEP or STEPPER_MICRO_4/8/16.
+* No return value.
+****************************************************************/
+void Stepper_SetStepMode(uint8_t mode){
+	uint32_t primask;
+	
+	NVIC_DisableIRQ(STEPPER_TIMER_INT);
+	switch(mode){
+		case STEPPER_HALF_STEP:	stepIncrement = STEP_HALF; break;
+		case STEPPER_MICRO_4:		stepIncrement = STEPPER_MICROSTEPS / 4; break;
+		case STEPPER_MICRO_8:		stepIncrement = STEPPER_MICROSTEPS / 8; break;
+		case STEPPER_MICRO_16:	stepIncrement = STEPPER_MICROSTEPS / 16; break;
+		default:								stepIncrement = STEP_FULL; break;
+	}
+	
+	// Full and half steps drive PC0-PC3 as GPIO outputs, microsteps drive them from TIM1 PWM.
+	// GPIOC->MODER holds other drivers' pins too, so its read-modify-write is masked.
+	if(stepIncrement < STEP_HALF){
+		microstepping = 1;
+		Stepper_Ouput(stepCounter);
+		primask = Atomic_Enter();
+		FORCE_BITS(GPIOC->MODER, 0xFFUL, 0xAAUL);		// PC0-PC3 AF
+		Atomic_Exit(primask);
+	}
+	else{
+		microstepping = 0;
+		Stepper_Ouput(stepCounter);
+		primask = Atomic_Enter();
+		FORCE_BITS(GPIOC->MODER, 0xFFUL, 0x55UL);		// PC0-PC3 output
+		Atomic_Exit(primask);
+	}
+	NVIC_EnableIRQ(STEPPER_TIMER_INT);
+}
+
+/****************************************************************
+* Stepper_SetMaxRate() - Sets the cruise step rate of the step engine.
+* stepsPerSec		- Max step rate (steps/s).
+* No return value.
+****************************************************************/
+void Stepper_SetMaxRate(uint32_t stepsPerSec){
+	if(stepsPerSec == 0){
+		stepsPerSec = 1;
+	}
+	minDelay = (1000000UL << 8) / stepsPerSec;
+}
+
+/****************************************************************
+* Stepper_SetAccel() - Sets the acceleration of the step engine.
+* stepsPerSecSq		- Acceleration and deceleration (steps/s^2).
+* No return value.
+****************************************************************/
+void Stepper_SetAccel(uint32_t stepsPerSecSq){
+	if(stepsPerSecSq == 0){
+		stepsPerSecSq = 1;
+	}
+	else if(stepsPerSecSq > STEPPER_MAX_ACCEL){
+		stepsPerSecSq = STEPPER_MAX_ACCEL;
+	}
+	
+	// c0 = 0.676 * sqrt(2 / accel) (s), sqrt taken on accel << 8 for 4 extra bits of precision
+	firstDelay = ((STEPPER_C0_SCALE << 4) / Stepper_Sqrt(stepsPerSecSq << 8)) << 8;
+}
+
+/****************************************************************
+* Stepper_MoveTo() - Moves to an absolute position with a trapezoidal profile.
+* position		- Target position in microsteps.
+* No return value.
+****************************************************************/
+void Stepper_MoveTo(int32_t position){
+	int8_t dir;
+	
+	NVIC_DisableIRQ(STEPPER_TIMER_INT);
+	targetPosition = position;
+	if(engineState == STEPPER_ENGINE_IDLE){
+		engineState = STEPPER_ENGINE_MOVE;
+		if(Stepper_StepsToGo(&dir) == 0){
+			engineState = STEPPER_ENGINE_IDLE;
+		}
+		else{
+			Stepper_Start(dir);
+		}
+	}
+	else{
+		engineState = STEPPER_ENGINE_MOVE;		// Engine slows down and reverses if needed
+	}
+	NVIC_EnableIRQ(STEPPER_TIMER_INT);
+}
+
+/****************************************************************
+* Stepper_Jog() - Runs continuously at the max rate until stopped.
+* dir		- STEPPER_CW or STEPPER_CCW.
+* No return value.
+****************************************************************/
+void Stepper_Jog(int8_t dir){
+	NVIC_DisableIRQ(STEPPER_TIMER_INT);
+	jogDir = (dir < 0) ? STEPPER_CCW : STEPPER_CW;
+	if(engineState == STEPPER_ENGINE_IDLE){
+		Stepper_Start(jogDir);
+	}
+	engineState = STEPPER_ENGINE_JOG;		// Engine slows down and reverses if needed
+	NVIC_EnableIRQ(STEPPER_TIMER_INT);
+}
+
+/****************************************************************
+* Stepper_Stop() - Decelerates the step engine to a stop.
+* No inputs.
+* No return value.
+****************************************************************/
+void Stepper_Stop(void){
+	NVIC_DisableIRQ(STEPPER_TIMER_INT);
+	if(engineState != STEPPER_ENGINE_IDLE){
+		// Stop after the steps it takes to come back down the ramp
+		targetPosition = stepPosition + engineDir * (int32_t)(rampStep * stepIncrement);
+		engineState = STEPPER_ENGINE_MOVE;
+	}
+	NVIC_EnableIRQ(STEPPER_TIMER_INT);
+}
+
+/****************************************************************
+* Stepper_Halt() - Stops the step engine immediately.
+* No inputs.
+* No return value.
+****************************************************************/
+CCM_FUNC void Stepper_Halt(void){
+	CLEAR_BITS(STEPPER_TIMER->CR1, TIM_CR1_CEN);
+	STEPPER_TIMER->SR = ~TIM_SR_UIF;
+	NVIC_ClearPendingIRQ(STEPPER_TIMER_INT);
+	engineState = STEPPER_ENGINE_IDLE;
+	rampStep = 0;
+}
+
+/****************************************************************
+* Stepper_GetPosition() - Gets the absolute stepper position.
+* No inputs.
+* Returns the position in microsteps.
+****************************************************************/
+int32_t Stepper_GetPosition(void){
+	return(stepPosition);
+}
+
+/****************************************************************
+* Stepper_SetPosition() - Redefines the current absolute position (e.g. after homing).
+* position		- New position in microsteps.
+* No return value.
+****************************************************************/
+void Stepper_SetPosition(int32_t position){
+	NVIC_DisableIRQ(STEPPER_TIMER_INT);
+	targetPosition += position - stepPosition;
+	stepPosition = position;
+	NVIC_EnableIRQ(STEPPER_TIMER_INT);
+}
+
+/****************************************************************
+* Stepper_IsRunning() - Checks whether the step engine is moving.
+* No inputs.
+* Returns TRUE if the engine is moving or FALSE if it is idle.
+****************************************************************/
+uint8_t Stepper_IsRunning(void){
+	return(engineState != STEPPER_ENGINE_IDLE);
+}
+
+/****************************************************************
+* TIM6_DAC_IRQHandler() - Step engine interrupt handler, takes one step per TIM6 update.
+* No inputs.
+* No return value.
+****************************************************************/
+CCM_FUNC void TIM6_DAC_IRQHandler(void){
+	uint32_t toGo;		// Steps left in the motion
+	int8_t dir;				// Direction the motion needs
+	
+	if(!IS_BIT_SET(STEPPER_TIMER->SR, TIM_SR_UIF)){
+		return;
+	}
+	STEPPER_TIMER->SR = ~TIM_SR_UIF;
+	
+	ISR_ENTER(ISR_STEPPER, STEPPER_TIMER);
+	ISR_LATENCY(ISR_STEPPER, 0);
+	
+	toGo = Stepper_StepsToGo(&dir);
+	if(dir != engineDir && rampStep > 0){
+		// Wrong way, keep stepping while slowing down before reversing
+		toGo = 0;
+	}
+	else if(toGo == 0){
+		Stepper_Halt();
+		ISR_EXIT(ISR_STEPPER);
+		return;
+	}
+	else{
+		engineDir = dir;
+		toGo--;
+	}
+	
+	// Take the step
+	stepCounter += engineDir * stepIncrement;
+	stepPosition += engineDir * stepIncrement;
+	Stepper_Ouput(stepCounter);
+	TRACE(TRACE_STEP, stepPosition);
+	
+	if(engineState == STEPPER_ENGINE_MOVE && dir == engineDir && toGo == 0){
+		Stepper_Halt();
+		ISR_EXIT(ISR_STEPPER);
+		return;
+	}
+	
+	// Work out the next step period
+	// c(n) = c(n-1) - 2c(n-1) / (4n + 1) while accelerating (D. Austin, "Generate stepper-motor speed profiles in real time")
+	if(toGo <= rampStep){
+		Stepper_Decelerate();
+	}
+	else if(stepDelay > minDelay){
+		rampStep++;
+		stepDelay -= (2 * stepDelay) / (4 * rampStep + 1);
+		if(stepDelay < minDelay){
+			stepDelay = minDelay;
+		}
+	}
+	else if(stepDelay < minDelay){
+		// Max rate was lowered while cruising
+		Stepper_Decelerate();
+		if(stepDelay > minDelay){
+			stepDelay = minDelay;
+		}
+	}
+	Stepper_LoadDelay();
+	
+	ISR_EXIT(ISR_STEPPER);
 }
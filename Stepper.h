@@ -9,8 +9,48 @@
 #define __Stepper_H
 
 #include "stm32f303xe.h"
+#include "Board.h"
+
+#define STEPPER_TIMER					BOARD_TIM(BOARD_STEPPER_TIMER)
+#define STEPPER_TIMER_INT			BOARD_TIM_IRQ(BOARD_STEPPER_TIMER)
+
+#define STEPPER_PRIORITY 8
+
+#define STEPPER_PWM_TIMER			BOARD_TIM(BOARD_STEPPER_PWM_TIMER)		// CH1-CH4 on the coil pins for microstepping
+#define STEPPER_PWM_PERIOD		3600UL	// 20kHz coil PWM at 72MHz
+
+// Step modes
+#define STEPPER_FULL_STEP		0
+#define STEPPER_HALF_STEP		1
+#define STEPPER_MICRO_4			2		// 1/4 step
+#define STEPPER_MICRO_8			3		// 1/8 step
+#define STEPPER_MICRO_16		4		// 1/16 step
+
+#define STEPPER_MICROSTEPS	16	// Position units per full step
+
+// Step directions
+#define STEPPER_CW		1
+#define STEPPER_CCW		-1
+
+// Default motion profile
+#define STEPPER_DEFAULT_RATE		200UL		// Max step rate (steps/s)
+#define STEPPER_DEFAULT_ACCEL		400UL		// Acceleration (steps/s^2)
 
 void Stepper_Init(void);
 void Stepper_Step(uint8_t stepType);
 
+// Timer-driven step engine
+void Stepper_Run(uint8_t stepType);
+void Stepper_SetStepMode(uint8_t mode);
+void Stepper_SetMaxRate(uint32_t stepsPerSec);
+void Stepper_SetAccel(uint32_t stepsPerSecSq);
+void Stepper_MoveTo(int32_t position);
+void Stepper_Jog(int8_t dir);
+void Stepper_Stop(void);
+void Stepper_Halt(void);
+int32_t Stepper_GetPosition(void);
+void Stepper_SetPosition(int32_t position);
+uint8_t Stepper_IsRunning(void);
+void TIM6_DAC_IRQHandler(void);
+
 #endif
@@ -22,6 +22,7 @@ void System_Clock_Init(void){
   // (HCLK) and the supply voltage of the device.		
 	FLASH->ACR &= ~FLASH_ACR_LATENCY;
 	FLASH->ACR |=  FLASH_ACR_LATENCY_2;
+	FLASH->ACR |=  FLASH_ACR_PRFTBE;		// Prefetch buffer hides the wait states on sequential fetches
 		
 	// Enable the External High Speed oscillator (HSE)
 	RCC->CR |= RCC_CR_HSEON;
@@ -58,3 +59,67 @@ void System_Clock_Init(void){
 
 } // System_Clock_Init()
 
+
+/***********************************************************************************************
+// System_Clock_InitStep() - System_Clock_Init() as a Boot_Run() state machine.
+//		Returns BOOT_BUSY while waiting on HSE, PLL or the clock switch instead of spinning,
+//		and updates SystemCoreClock once running from the PLL.
+***********************************************************************************************/
+
+uint8_t System_Clock_InitStep(void){
+	static uint8_t state = 0;
+	
+	switch(state){
+		// Flash wait states, then start HSE
+		case 0:{
+			FLASH->ACR &= ~FLASH_ACR_LATENCY;
+			FLASH->ACR |=  FLASH_ACR_LATENCY_2;
+			FLASH->ACR |=  FLASH_ACR_PRFTBE;
+			RCC->CR |= RCC_CR_HSEON;
+			state = 1;
+			return(BOOT_BUSY);
+		}
+		// Wait for HSE, then turn PLL off (might already be on)
+		case 1:{
+			if((RCC->CR & RCC_CR_HSERDY) == 0){
+				return(BOOT_BUSY);
+			}
+			RCC->CR &= ~RCC_CR_PLLON;
+			state = 2;
+			return(BOOT_BUSY);
+		}
+		// Wait for PLL off, then configure HSE x 9 and start the PLL
+		case 2:{
+			if(RCC->CR & RCC_CR_PLLRDY){
+				return(BOOT_BUSY);
+			}
+			RCC->CFGR &= ~RCC_CFGR_PLLSRC_Msk;
+			RCC->CFGR |= RCC_CFGR_PLLSRC_HSE_PREDIV;
+			RCC->CFGR |= RCC_CFGR_PLLNODIV;
+			RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_PLLMUL) | RCC_CFGR_PLLMUL9;
+			RCC->CR |= RCC_CR_PLLON;
+			state = 3;
+			return(BOOT_BUSY);
+		}
+		// Wait for PLL lock, then set the bus prescalers (APB1 36 MHz max) and switch to the PLL
+		case 3:{
+			if((RCC->CR & RCC_CR_PLLRDY) == 0){
+				return(BOOT_BUSY);
+			}
+			RCC->CFGR &= ~(RCC_CFGR_HPRE | RCC_CFGR_PPRE2 | RCC_CFGR_PPRE1);
+			RCC->CFGR |= RCC_CFGR_PPRE1_DIV2;
+			RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW) | RCC_CFGR_SW_PLL;
+			state = 4;
+			return(BOOT_BUSY);
+		}
+		// Wait for the switch
+		default:{
+			if((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL){
+				return(BOOT_BUSY);
+			}
+			SystemCoreClockUpdate();
+			state = 0;
+			return(BOOT_DONE);
+		}
+	}
+} // System_Clock_InitStep()
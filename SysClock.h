@@ -11,8 +11,10 @@
 ***********************************************************************************************/
 
 #include "stm32f303xe.h"
+#include "Boot.h"
 
 void System_Clock_Init(void);
+uint8_t System_Clock_InitStep(void);
 
 #endif
 
@@ -0,0 +1,120 @@
+/********************************************************************************
+* Name: Trace.c (implementation)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Event trace ring buffers for mobile robot.
+*							 The encoder, stepper and servo ISRs write only to their own rings,
+*							 so those writers never need a lock. Kernel tasks share one ring, as
+*							 do all other ISRs, and can preempt each other, so writes to those
+*							 two rings are made with interrupts masked.
+*							 Timestamps come from the 1us TIM2 counter.
+********************************************************************************/
+
+#include "Trace.h"
+#include "UART.h"
+#include "Utility.h"
+#include "Atomic.h"
+#include "Encoder.h"
+#include "Stepper.h"
+#include "RCServo.h"
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/	
+
+typedef struct {
+	Trace_Record records[TRACE_RING_SIZE];
+	volatile uint32_t head;		// Total records written (only the writer changes it)
+} Trace_Ring;
+
+static Trace_Ring rings[TRACE_CTX_COUNT] CCM_BSS;
+static volatile uint8_t tracePaused = 0;		// Writers drop events while a dump is reading the rings
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Trace_Context() - Work out which ring the caller owns.
+* No inputs.
+* Returns the trace context of the running code.
+*************************************************************/
+CCM_FUNC static uint8_t Trace_Context(void){
+	uint32_t ipsr = __get_IPSR();
+	
+	if(ipsr == 0){
+		return(TRACE_CTX_TASKS);
+	}
+	switch((int32_t)ipsr - 16){
+		case ENCODER_TIMER_INT:			return(TRACE_CTX_ENCODER);
+		case STEPPER_TIMER_INT:			return(TRACE_CTX_STEPPER);
+		case SERVO_TIMER_INT:				return(TRACE_CTX_SERVO);
+		default:										return(TRACE_CTX_ISR);
+	}
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Trace_Event() - Record an event in the caller's ring, overwriting the oldest.
+* id				- Event ID.
+* payload		- Event data.
+* No return value.
+*************************************************************/
+CCM_FUNC void Trace_Event(uint8_t id, uint16_t payload){
+	uint8_t context, shared;
+	uint32_t primask;
+	Trace_Ring *ring;
+	Trace_Record *rec;
+	
+	if(tracePaused){
+		return;
+	}
+	
+	context = Trace_Context();
+	ring = &rings[context];
+	shared = (context == TRACE_CTX_TASKS || context == TRACE_CTX_ISR);
+	primask = shared ? Atomic_Enter() : 0;
+	rec = &ring->records[ring->head & (TRACE_RING_SIZE - 1)];
+	rec->time = ENCODER_TIMER->CNT;
+	rec->id = id;
+	rec->context = context;
+	rec->payload = payload;
+	ring->head++;		// Publish after the record is complete
+	if(shared){
+		Atomic_Exit(primask);
+	}
+}
+
+/*************************************************************
+* Trace_Dump() - Print every ring over UART, oldest record first.
+* No inputs.
+* No return value.
+*************************************************************/
+void Trace_Dump(void){
+	uint32_t head;
+	uint32_t count;
+	Trace_Record *rec;
+	
+	tracePaused = 1;
+	
+	UART_printf("TRACE BEGIN %u\n", TRACE_CTX_COUNT);
+	for(int ctx = 0; ctx < TRACE_CTX_COUNT; ctx++){
+		head = rings[ctx].head;
+		count = (head < TRACE_RING_SIZE) ? head : TRACE_RING_SIZE;
+		
+		// time(us) context id payload
+		for(uint32_t i = head - count; i != head; i++){
+			rec = &rings[ctx].records[i & (TRACE_RING_SIZE - 1)];
+			UART_printf("%08lX %u %u %04X\n", (unsigned long)rec->time, rec->context, rec->id, rec->payload);
+		}
+	}
+	UART_printf("TRACE END\n");
+	
+	tracePaused = 0;
+}
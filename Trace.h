@@ -0,0 +1,56 @@
+/********************************************************************************
+* Name: Trace.h (interface)
+* Author(s): Noah Grant, Wyatt Richard
+* Date: October 19, 2026
+* Description: Event trace ring buffers for mobile robot.
+*							 Dumps are converted for chrome://tracing / Perfetto by trace_to_json.py.
+********************************************************************************/
+
+#ifndef __Trace_H
+#define __Trace_H
+
+#include "stm32f303xe.h"
+
+// Set to 0 to compile all trace points out
+#define TRACE_ENABLE 1
+
+#define TRACE_RING_SIZE		64		// Records per context (power of 2)
+
+// Trace contexts, one ring (and one writer at a time) each
+#define TRACE_CTX_TASKS			0		// Every kernel task (and main() before Kernel_Start), writes masked
+#define TRACE_CTX_ENCODER		1		// TIM2_IRQHandler
+#define TRACE_CTX_STEPPER		2		// TIM6_DAC_IRQHandler
+#define TRACE_CTX_SERVO			3		// TIM1_BRK_TIM15_IRQHandler
+#define TRACE_CTX_ISR				4		// Any other exception or ISR, writes masked
+#define TRACE_CTX_COUNT			5
+
+// Event IDs (payload in brackets), keep trace_to_json.py in sync
+#define TRACE_KEY_PRESS				1		// (key)
+#define TRACE_STEPPER_CMD			2		// (step type)
+#define TRACE_STEP						3		// (position, low 16 bits)
+#define TRACE_MOTOR_DIR				4		// (motor << 8 | dir)
+#define TRACE_MOTOR_SPEED			5		// (motor << 8 | duty cycle)
+#define TRACE_ENCODER_LEFT		6		// (period us, capped)
+#define TRACE_ENCODER_RIGHT		7		// (period us, capped)
+#define TRACE_ULTRA_PING			8		// ()
+#define TRACE_ULTRA_ECHO			9		// (echo us, capped)
+#define TRACE_SERVO_CMD				10	// (target angle 0.1 degrees), ID + servo number
+
+// Trace record
+typedef struct {
+	uint32_t time;			// TIM2 count (us)
+	uint8_t id;					// Event ID
+	uint8_t context;		// Trace context
+	uint16_t payload;
+} Trace_Record;
+
+#if TRACE_ENABLE
+#define TRACE(id, payload)	Trace_Event((id), (uint16_t)(payload))
+#else
+#define TRACE(id, payload)
+#endif
+
+void Trace_Event(uint8_t id, uint16_t payload);
+void Trace_Dump(void);
+
+#endif
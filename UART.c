@@ -3,12 +3,23 @@
 * Author(s): Noah Grant, Wyatt Richard
 * Date: January 25, 2023
 * Description: UART functions to initialize, configure, and Tx/Rx.
+*							 Output is collected into blocks from a fixed pool and sent by
+*							 USART2_IRQHandler, so writers only wait when every block is in use.
 ******************************************************************************/
 
 #include <stdarg.h>
-#include <stdio.h>
 #include "UART.h"
+#include "Format.h"
 #include "stm32f303xe.h"
+#include "Profile.h"
+#include "IsrMonitor.h"
+#include "Board.h"
+#include "Kernel.h"
+
+// UART2_Init() configures PA2 and PA3 (AF7)
+_Static_assert(BOARD_PORT_NUM(BOARD_UART_TX_PORT) == BOARD_PORT_A && BOARD_UART_TX_PIN == 2 &&
+	BOARD_PORT_NUM(BOARD_UART_RX_PORT) == BOARD_PORT_A && BOARD_UART_RX_PIN == 3,
+	"UART.c expects TX on PA2 and RX on PA3");
 
 
 /******************************************************************
@@ -16,13 +27,127 @@
 ******************************************************************/
 
 #define BAUD_RATE 9600
-#define UART_MAX_BUFF_SIZE 100
+
+// RX is filled by USART2_IRQHandler and drained by UART_getc()/UART_getcNB()
+QUEUE_DEFINE(UART_RxQueue, char, UART_RX_QUEUE_SIZE)
+
+static UART_RxQueue rxQueue;
+
+// TX blocks are filled by the writers and sent by USART2_IRQHandler, then freed
+typedef struct {
+	uint8_t length;
+	char text[UART_TX_BLOCK_SIZE];
+} UART_TxBlock;
+
+typedef UART_TxBlock *UART_TxBlockRef;
+
+POOL_DEFINE(UART_TxPool, UART_TxBlock, UART_TX_BLOCKS)
+QUEUE_DEFINE(UART_TxQueue, UART_TxBlockRef, UART_TX_BLOCKS)		// Never full, it holds every block
+
+// Writers fill and queue blocks with interrupts masked, so any task may write
+static UART_TxPool txPool;
+static UART_TxQueue txQueue;					// Filled blocks waiting to be sent
+static UART_TxBlock *txFill = NULL;		// Block being filled
+static UART_TxBlock *txSend = NULL;		// Block being sent
+static uint8_t txSent = 0;						// Chars of txSend already sent
+static uint8_t txReady = 0;						// Output before UART2_Init() is dropped
 
 
 /******************************************************************
 *												PRIVATE FUNCTIONS													*
 ******************************************************************/
 
+/*******************************************************
+* UART_TxNext() - Send the next queued char (TXE set, interrupts masked or ISR).
+* No inputs.
+* No return value.
+*******************************************************/
+static void UART_TxNext(void){
+	if(txSend == NULL && !UART_TxQueue_Get(&txQueue, &txSend)){
+		CLEAR_BITS(USART2->CR1, USART_CR1_TXEIE);		// Nothing left to send
+		return;
+	}
+	
+	// Writing USART_TDR clears the TXE flag
+	USART2->TDR = (uint8_t)txSend->text[txSent++];
+	if(txSent >= txSend->length){
+		UART_TxPool_Free(&txPool, txSend);
+		txSend = NULL;
+		txSent = 0;
+	}
+}
+
+/*******************************************************
+* UART_TxQueueFill() - Queue the block being filled (interrupts masked).
+* No inputs.
+* No return value.
+*******************************************************/
+static void UART_TxQueueFill(void){
+	if(txFill == NULL){
+		return;
+	}
+	if(txFill->length == 0){
+		UART_TxPool_Free(&txPool, txFill);
+	}
+	else{
+		(void)UART_TxQueue_Put(&txQueue, &txFill);
+		SET_BITS(USART2->CR1, USART_CR1_TXEIE);
+	}
+	txFill = NULL;
+}
+
+/*******************************************************
+* UART_TxWait() - Let blocks drain while every one is in use.
+* primask		- Interrupt mask of the writer.
+* No return value.
+*******************************************************/
+static void UART_TxWait(uint32_t primask){
+	// A task sleeps while the interrupt sends
+	if(Kernel_IsRunning() && __get_IPSR() == 0 && primask == 0){
+		Kernel_Delay(UART_TX_WAIT_US);
+		return;
+	}
+	
+	// Masked, in an ISR or before the kernel: send by polling
+	primask = Atomic_Enter();
+	if(USART2->ISR & USART_ISR_TXE){
+		UART_TxNext();
+	}
+	Atomic_Exit(primask);
+}
+
+/*******************************************************
+* UART_TxPut() - Add a char to the block being filled, queueing it when full.
+* c		- Char to transmit.
+* No return value.
+*******************************************************/
+static void UART_TxPut(char c){
+	uint32_t primask;
+	
+	if(!txReady){
+		return;
+	}
+	while(1){
+		primask = Atomic_Enter();
+		if(txFill == NULL){
+			txFill = UART_TxPool_Alloc(&txPool);
+			if(txFill != NULL){
+				txFill->length = 0;
+			}
+		}
+		if(txFill != NULL){
+			txFill->text[txFill->length++] = c;
+			if(txFill->length >= UART_TX_BLOCK_SIZE){
+				UART_TxQueueFill();
+			}
+			Atomic_Exit(primask);
+			return;
+		}
+		Atomic_Exit(primask);
+		UART_TxWait(primask);
+	}
+}
+
 /****************************************************
 * UART2_config() - Configure UART2 message settings.
 * No inputs.
@@ -53,6 +178,7 @@ static void UART2_Config(void){
 		// USART2 -> CR1, set TE and RE
 	USART2->CR1 |= USART_CR1_TE;	// Enable transmitter
 	USART2->CR1 |= USART_CR1_RE;	// Enable receiver
+	USART2->CR1 |= USART_CR1_RXNEIE;	// Interrupt on every received char
 	
 	// 5. Enable UART2 (set UE and CR1 to 1)
 		// USART2 -> CR1, set CR1
@@ -130,20 +256,72 @@ void UART2_Init(void){
 	
 	// Configure UART2
 	UART2_Config();
+	
+	// Queue received chars from the interrupt so bursts are not lost between main loop passes,
+	// and send queued blocks from it
+	UART_TxPool_Init(&txPool);
+	txReady = 1;
+	NVIC_SetPriority(USART2_IRQn, UART_PRIORITY);
+	NVIC_EnableIRQ(USART2_IRQn);
+}
+
+/*******************************************************
+* USART2_IRQHandler() - Queue a received char, send the next queued char.
+* No inputs.
+* No return value.
+*******************************************************/
+void USART2_IRQHandler(void){
+	ISR_ENTER_NO_LATENCY(ISR_UART);
+	uint32_t status = USART2->ISR;
+	char c;
+	
+	if(status & USART_ISR_RXNE){
+		// Reading USART_RDR clears the RXNE flag, a full queue counts the char as dropped
+		c = (char)USART2->RDR;
+		(void)UART_RxQueue_Put(&rxQueue, &c);
+	}
+	if(status & USART_ISR_ORE){
+		USART2->ICR = USART_ICR_ORECF;		// A char was lost in hardware, keep receiving
+	}
+	if((status & USART_ISR_TXE) && IS_BIT_SET(USART2->CR1, USART_CR1_TXEIE)){
+		UART_TxNext();
+	}
+	ISR_EXIT(ISR_UART);
+}
+
+/******************************************
+* UART2_SetBaud() - Recompute the baud rate after a clock change.
+* No inputs.
+* No return value.
+******************************************/
+void UART2_SetBaud(void){
+	uint32_t txeie = USART2->CR1 & USART_CR1_TXEIE;
+	uint32_t start = DWT->CYCCNT;
+	uint32_t limit = (SystemCoreClock / 1000000UL) * UART_BAUD_TIMEOUT_US;
+	
+	// Finish the current frame, BRR can only be written with the UART disabled.
+	// The interrupt is held off so it cannot start another one, and the wait
+	// gives up rather than hang if the frame never completes.
+	CLEAR_BITS(USART2->CR1, USART_CR1_TXEIE);
+	while((USART2->ISR & USART_ISR_TC) == 0 && DWT->CYCCNT - start <= limit);
+	
+	// Queued blocks carry on at the new rate
+	USART2->CR1 &= ~USART_CR1_UE;
+	USART2->BRR = SystemCoreClock / BAUD_RATE;
+	USART2->CR1 |= USART_CR1_UE | txeie;
 }
 
 /**************************************************************
-* UART_putc() - Write a char to transmit data register.
+* UART_putc() - Queue a char for transmission.
 * c	- Char to transmit.
 * No return value.
+* The block goes out at the end of the line, or on UART_Flush().
 **************************************************************/
 void UART_putc(char c){
-	// Wait TXE (TX empty) is set
-	while((USART2->ISR & USART_ISR_TXE) == 0);
-	
-	// Write char to the trasmit data register
-	// Writing USART_TDR automatically clears the TXE flag
-	USART2->TDR = (uint8_t)c;
+	UART_TxPut(c);
+	if(c == '\n'){
+		UART_Flush();
+	}
 }
 
 /********************************************************
@@ -154,8 +332,9 @@ void UART_putc(char c){
 void UART_puts(char *str){
 	// Don't send trailing NULL char
 	while(*str){
-		UART_putc(*str++);
+		UART_TxPut(*str++);
 	}
+	UART_Flush();
 }
 
 /*******************************************************
@@ -164,12 +343,11 @@ void UART_puts(char *str){
 * Returns a char.
 *******************************************************/
 char UART_getc(void){
-	// Wait until RXNE flag is set
-	while((USART2->ISR & USART_ISR_RXNE) == 0);
+	char c;
 	
-	// Read char from the receive data regsiter
-	// Reading USART_RDR automatically clears the RXNE flag
-	return((char)USART2->RDR);
+	// Wait until the interrupt has queued a char
+	while(!UART_RxQueue_Get(&rxQueue, &c));
+	return(c);
 }
 
 /*******************************************************
@@ -178,24 +356,63 @@ char UART_getc(void){
 * Returns a char.
 *******************************************************/
 char UART_getcNB(void){
-	// If RXNE flag is set
-	if(USART2->ISR & USART_ISR_RXNE){
-		// Read char from the receive data regsiter
-		// Reading USART_RDR automatically clears the RXNE flag
-		return((char)USART2->RDR);
+	char c;
+	
+	if(UART_RxQueue_Get(&rxQueue, &c)){
+		return(c);
 	}
 	else{
 		return('\0');
 	}
 }
 
+/*******************************************************
+* UART_Flush() - Queue a partly filled block for transmission.
+* No inputs.
+* No return value.
+*******************************************************/
+void UART_Flush(void){
+	uint32_t primask = Atomic_Enter();
+	
+	UART_TxQueueFill();
+	Atomic_Exit(primask);
+}
+
+/*******************************************************
+* UART_TxDone() - Check whether everything written has been sent.
+* No inputs.
+* Returns 1 once the last stop bit has gone, otherwise 0.
+*******************************************************/
+uint8_t UART_TxDone(void){
+	return(txFill == NULL && txSend == NULL && UART_TxQueue_Count(&txQueue) == 0 &&
+		(USART2->ISR & USART_ISR_TC));
+}
+
+/*******************************************************
+* UART_GetTxStats() - Transmit block statistics.
+* stats		- Filled with the blocks in use, peak and waits (failures).
+* No return value.
+*******************************************************/
+void UART_GetTxStats(Pool_Stats *stats){
+	*stats = txPool.stats;
+}
+
+/*******************************************************
+* UART_GetRxStats() - Receive queue statistics.
+* stats		- Filled with the high-water mark and drops.
+* No return value.
+*******************************************************/
+void UART_GetRxStats(Queue_Stats *stats){
+	*stats = rxQueue.stats;
+}
+
 /*******************************************************
 * UART_printf() - Formats and transmits string.
 * fmt		- String to transmit.
 * No return value.
 *******************************************************/
 void UART_printf(char* fmt, ...){
-	char buff[UART_MAX_BUFF_SIZE];
+	PROF_BEGIN(PROF_UART_PRINTF);
 	
 	// Instructions for function with variable argument list in W2 slides
 	va_list args;
@@ -203,12 +420,12 @@ void UART_printf(char* fmt, ...){
 	// 1. Call va_start with local variable and the name of the last fixed parameter 
 	va_start(args, fmt);
 	
-	// 2.
-	vsnprintf(buff, UART_MAX_BUFF_SIZE, fmt, args);
+	// 2. Format straight into transmit blocks
+	(void)Format_vprintf(UART_TxPut, fmt, args);
 	
 	// 3. Call va_end() with your local variable when finished to clean up
 	va_end(args);
+	UART_Flush();
 	
-	// Transmit UART buff
-	UART_puts(buff);
+	PROF_END(PROF_UART_PRINTF);
 }
@@ -9,9 +9,20 @@
 #define __UART_H
 
 #include "stm32f303xe.h"
+#include "Queue.h"
+#include "Pool.h"
+
+#define UART_PRIORITY					11
+#define UART_RX_QUEUE_SIZE		32		// Received chars buffered for the main loop (power of 2)
+#define UART_TX_BLOCKS				8			// Transmit blocks queued for the interrupt (power of 2)
+#define UART_TX_BLOCK_SIZE		32		// Chars per transmit block
+#define UART_TX_WAIT_US				1000	// Task sleep while every transmit block is in use
+#define UART_BAUD_TIMEOUT_US	25000	// UART2_SetBaud() frame wait (two frames at the old rate after 72MHz -> 8MHz)
 
 // UART setup
 void UART2_Init(void);
+void UART2_SetBaud(void);
+void USART2_IRQHandler(void);
 
 // UART I/O
 void UART_putc(char c);
@@ -19,5 +30,9 @@ void UART_puts(char *str);
 char UART_getc(void);
 char UART_getcNB(void);
 void UART_printf(char *format, ...);
+void UART_Flush(void);
+uint8_t UART_TxDone(void);
+void UART_GetRxStats(Queue_Stats *stats);
+void UART_GetTxStats(Pool_Stats *stats);
 
 #endif
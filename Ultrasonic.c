@@ -8,6 +8,44 @@
 #include "Ultrasonic.h"
 #include "stm32f303xe.h"
 #include "Utility.h"
+#include "Board.h"
+#include "Gpio.h"
+#include "RegInit.h"
+#include "Trace.h"
+#include "Bus.h"
+
+// Trigger and echo pins (Board.h)
+#define ULTRA_TRIGGER_PINS(X)	X(ULTRA_TRIGGER, GPIO_MODE_AF, GPIO_OTYPE_PP, GPIO_PUPD_NO)
+#define ULTRA_ECHO_PINS(X)		X(ULTRA_ECHO, GPIO_MODE_AF, GPIO_OTYPE_PP, GPIO_PUPD_NO)
+
+// Timers count in 1us: Timer Period = (Prescaler + 1) / SystemClockFreq, 1us = (71 + 1) / 72MHz
+
+// TIM16 CH1 PWM in one-shot mode, 10us pulse every trigger (100ms period)
+static const RegInit_Write ultraTrigger[] = {
+	REG_SET(BOARD_TIM_ENR(BOARD_ULTRA_TRIGGER_TIMER), BOARD_TIM_EN(BOARD_ULTRA_TRIGGER_TIMER)),			// Turn on TIM16
+	REG_FORCE(ULTRA_TRIGGER_TIMER->PSC, 0xFFFFUL, 71UL),					// Set PSC so it counts in 1us
+	REG_FORCE(ULTRA_TRIGGER_TIMER->ARR, 0xFFFFUL, 99999UL),				// Set ARR to 100ms (ARR = Repeating Counter Period - 1)
+	REG_SET(ULTRA_TRIGGER_TIMER->CR1, TIM_CR1_ARPE | TIM_CR1_OPM),	// Enable ARR preload (ARPE), one-shot mode
+	REG_SET(ULTRA_TRIGGER_TIMER->BDTR, TIM_BDTR_MOE),							// Set main output enabled (MOE) in BDTR
+	REG_SET(ULTRA_TRIGGER_TIMER->CCMR1, TIM_CCMR1_OC1M | TIM_CCMR1_OC1PE),		// PWM mode with output compare preload (OC1PE)
+	REG_FORCE(ULTRA_TRIGGER_TIMER->CCER, TIM_CCER_CC1E | TIM_CCER_CC1P, TIM_CCER_CC1E),	// Enable CH1, active HI
+	REG_FORCE(ULTRA_TRIGGER_TIMER->CCR1, 0xFFFFUL, 10UL),					// 10us pulse width
+	REG_WRITE(ULTRA_TRIGGER_TIMER->EGR, TIM_EGR_UG),							// Force an update event to preload all the registers
+};
+
+// TIM3 reset on the TI2 rising edge, CCR1 captures TI2 falling edge (pulse width)
+static const RegInit_Write ultraEcho[] = {
+	REG_SET(BOARD_TIM_ENR(BOARD_ULTRA_ECHO_TIMER), BOARD_TIM_EN(BOARD_ULTRA_ECHO_TIMER)),				// Turn on clock for TIM3
+	REG_FORCE(ULTRA_ECHO_TIMER->PSC, 0xFFFFUL, 71UL),							// Set PSC so it counts in 1us
+	REG_CLEAR(ULTRA_ECHO_TIMER->CR1, TIM_CR1_DIR),								// Set TIM3 counting direction to upcounting
+	REG_FORCE(ULTRA_ECHO_TIMER->ARR, 0xFFFFUL, 0xFFFFUL),					// Set ARR to max value
+	REG_FORCE(ULTRA_ECHO_TIMER->CCMR1, TIM_CCMR1_IC2F | TIM_CCMR1_IC2PSC | TIM_CCMR1_CC1S,
+		TIM_CCMR1_CC1S_1),																// No TI2 filter or prescaler, TI2 internally connected to CCR1
+	REG_FORCE(ULTRA_ECHO_TIMER->CCER, TIM_CCER_CC1P | TIM_CCER_CC1NP, TIM_CCER_CC1P),		// Capture TI2 falling edge
+	REG_SET(ULTRA_ECHO_TIMER->SMCR, (6UL << TIM_SMCR_TS_Pos) | (4UL << TIM_SMCR_SMS_Pos)),	// Reset slave mode on filtered TI2
+	REG_SET(ULTRA_ECHO_TIMER->CCER, TIM_CCER_CC1E),								// Enable counter capture
+	REG_SET(ULTRA_ECHO_TIMER->CR1, TIM_CR1_CEN),									// Enable TIM3 main counter
+};
 	
 /******************************************************************
 *												STATIC VARIABLES									  			*
@@ -16,6 +54,7 @@
 static uint32_t Global_UltraEcho;
 
 
+
 /******************************************************************
 *												PUBLIC FUNCTIONS													*
 ******************************************************************/
@@ -27,34 +66,10 @@ static uint32_t Global_UltraEcho;
 *************************************************************/	
 static void Ultra_InitTrigger(void){
 	// Configure GPIO Pin
-	ENABLE_GPIO_CLOCK(A);										// Enable GPIO Port A
-	GPIO_MODER_SET(A, 12, GPIO_MODE_AF);		// Set MODE to AF
-	GPIO_AFR_SET(A, 12, 1);									// TIM16 CH1
-	GPIO_OTYPER_SET(A, 12, GPIO_OTYPE_PP);	// Set OTYPE to Push-pull
-	GPIO_PUPDR_SET(A, 12, GPIO_PUPD_NO);		// Set PUPD to No pull-up/pull-down
-	
-	// Configure TIM16 CH1
-	SET_BITS(RCC->APB2ENR, RCC_APB2ENR_TIM16EN);	// Turn on TIM16
-	SET_BITS(TIM16->PSC, 71UL);										// Set PSC so it counts in 1us (1-10us)
-		// Timer Period = (Prescaler + 1) / SystemClockFreq
-		// 1us = (Prescaler + 1) / 72MHz
-		// (Prescaler + 1) = 72
-		// Prescaler = 71
-	FORCE_BITS(TIM16->ARR, 0xFFFFUL, 99999UL);		// Set ARR to 100ms (100-500ms)
-		// ARR = Repeating Counter Period - 1
-	SET_BITS(TIM16->CR1, TIM_CR1_ARPE);						// Enable ARR preload (ARPE) in CR1
-	SET_BITS(TIM16->BDTR, TIM_BDTR_MOE);					// Set main output enabled (MOE) in BDTR
+	GPIO_CONFIGURE(BOARD_ULTRA_TRIGGER_PORT, ULTRA_TRIGGER_PINS);		// TIM16 CH1, push-pull, no pull-up/pull-down
 	
-	// Configure TIM16 CH1 for OCM with PWM
-	SET_BITS(TIM16->CCMR1, TIM_CCMR1_OC1M);				// Set TIM16 to PWM mode
-	SET_BITS(TIM16->CCMR1, TIM_CCMR1_OC1PE);			// Enable Output Compare Preload (OC1PE)
-	SET_BITS(TIM16->CCER, TIM_CCER_CC1E);					// Enable Regular Output Channel for CH1
-	CLEAR_BITS(TIM16->CCER, TIM_CCER_CC1P);				// Make CH1 active HI
-	FORCE_BITS(TIM16->CCR1, 0xFFFFUL, 10UL);			// Set CH1 CCR1 initial output waveform on-time to 10us PWM pulse width
-	
-	// Configure TIM16 CH1 for PWM (repeating mode)
-	SET_BITS(TIM16->CR1, TIM_CR1_OPM);						// Set TIM16 to one-shot mode
-	SET_BITS(TIM16->EGR, TIM_EGR_UG);							// Force an update event to prelaod all the registers
+	// Configure TIM16 CH1 for a one-shot 10us trigger pulse
+	RegInit_Apply(ultraTrigger, REG_TABLE_SIZE(ultraTrigger));
 }
 
 /*************************************************************
@@ -64,34 +79,10 @@ static void Ultra_InitTrigger(void){
 *************************************************************/	
 static void Ultra_InitEcho(void){
 	// Configure GPIO Pin
-	ENABLE_GPIO_CLOCK(C);										// Enable GPIO Port C
-	GPIO_MODER_SET(C, 7, GPIO_MODE_AF);			// Set MODE to AF
-	GPIO_AFR_SET(C, 7, 2);									// TIM3 CH2
-	GPIO_PUPDR_SET(C, 7, GPIO_PUPD_NO);			// Set PUPD to No pull-up/pull-down
-	
-	// Configure TIM3 CH2 (TI2)
-	SET_BITS(RCC->APB1ENR, RCC_APB1ENR_TIM3EN);		// Turn on clock for TIM3																			
-	SET_BITS(TIM3->PSC, 71UL);										// Set PSC so it counts in 1us
-		// 1us = (Prescaler + 1) / 72MHz
-		// (Prescaler + 1) = 72
-		// Prescaler = 71
-	CLEAR_BITS(TIM3->CR1, TIM_CR1_DIR);						// Set TIM3 counting direction to upcounting
-	FORCE_BITS(TIM3->ARR, 0xFFFFUL, 0xFFFFUL);		// Set ARR to max value
-	CLEAR_BITS(TIM3->CCMR1, TIM_CCMR1_IC2F);			// Set TIM3 TI2 to No Input Filtering
-	CLEAR_BITS(TIM3->CCMR1, TIM_CCMR1_IC2PSC);		// Set TI2 Prescaler to zero to capture every valid transition event		
-
-	// Configure TIM3 CCR1 for PW measurement on TI2
-	SET_BITS(TIM3->CCMR1, TIM_CCMR1_CC1S_1);		// Internally connect TIM3 TI2 to CCR1
-	SET_BITS(TIM3->CCER, TIM_CCER_CC1P);				// Set TIM3 CCR1 to capture TI2 falling edge
-	CLEAR_BITS(TIM3->CCER, TIM_CCER_CC1NP);			// Set TIM3 CCR1 to capture TI2 falling edge
-
-	// Configure TIM3 to Slave Reset on TI2 Rising Edge
-	SET_BITS(TIM3->SMCR, 6UL << TIM_SMCR_TS_Pos);		// Select Filtered Input Timer 2 (TI2) as the trigger source of the Timer Reset
-	SET_BITS(TIM3->SMCR, 4UL << TIM_SMCR_SMS_Pos);	// Select RESET slave mode on TI2 Rising Edge
+	GPIO_CONFIGURE(BOARD_ULTRA_ECHO_PORT, ULTRA_ECHO_PINS);				// TIM3 CH2, no pull-up/pull-down
 	
-	// Enable Counter Capture
-	SET_BITS(TIM3->CCER, TIM_CCER_CC1E);
-	SET_BITS(TIM3->CR1, TIM_CR1_CEN);				// Enable TIM3 main counter
+	// Configure TIM3 to measure the echo pulse width on TI2
+	RegInit_Apply(ultraEcho, REG_TABLE_SIZE(ultraEcho));
 }
 
 
@@ -115,7 +106,8 @@ void Ultra_Init(void){
 * No return value.
 *************************************************************/	
 void Ultra_StartTrigger(void){
-	SET_BITS(TIM16->CR1, TIM_CR1_CEN);	// Enable TIM16
+	TRACE(TRACE_ULTRA_PING, 0);
+	SET_BITS(ULTRA_TRIGGER_TIMER->CR1, TIM_CR1_CEN);	// Enable TIM16
 }
 
 /*************************************************************
@@ -125,8 +117,14 @@ void Ultra_StartTrigger(void){
 *************************************************************/	
 uint8_t Ultra_EchoRx(void){
 	// Check whether (CC1IF) in SR is set
-	if(IS_BIT_SET(TIM3->SR, TIM_SR_CC1IF)){
-		Global_UltraEcho = TIM3->CCR1;				// Record TIM3 CCR1 value in a global variable for further processing
+	if(IS_BIT_SET(ULTRA_ECHO_TIMER->SR, TIM_SR_CC1IF)){
+		Global_UltraEcho = ULTRA_ECHO_TIMER->CCR1;				// Record TIM3 CCR1 value in a global variable for further processing
+		TRACE(TRACE_ULTRA_ECHO, (Global_UltraEcho > 0xFFFFUL) ? 0xFFFFUL : Global_UltraEcho);
+		
+		Bus_Ultra *sample = Bus_Claim(BUS_TOPIC_ULTRA);
+		sample->echo = Global_UltraEcho;
+		sample->distance = Ultra_ReadSensor();
+		Bus_Publish(BUS_TOPIC_ULTRA);
 		return(1);
 	}
 	return(0);
@@ -9,6 +9,10 @@
 #define __Ultrasonic_H
 
 #include "stm32f303xe.h"
+#include "Board.h"
+
+#define ULTRA_TRIGGER_TIMER		BOARD_TIM(BOARD_ULTRA_TRIGGER_TIMER)		// CH1 one-shot trigger pulse
+#define ULTRA_ECHO_TIMER			BOARD_TIM(BOARD_ULTRA_ECHO_TIMER)				// TI2 reset, CH1 pulse width capture
 
 void Ultra_Init(void);
 void Ultra_StartTrigger(void);
@@ -7,6 +7,7 @@
 
 #include "Utility.h"
 #include "stm32f303xe.h"
+#include "Kernel.h"
 
 
 /******************************************************************
@@ -14,11 +15,19 @@
 ******************************************************************/
 
 /******************************************
-* UART2_init() - Initialize UART2 setting.
-* No inputs.
+* Delay_ms() - Wait a number of milliseconds.
+* msec - Time to wait (ms).
 * No return value.
+* Tasks sleep on the kernel timer, so a task preempted mid-delay cannot
+* leave another polling a stopped SysTick. SysTick is only used before
+* Kernel_Start() or from an ISR.
 ******************************************/
 void Delay_ms(uint32_t msec){
+	if(Kernel_IsRunning() && __get_IPSR() == 0){
+		Kernel_Delay(msec * 1000UL);
+		return;
+	}
+	
 	// Stop SysTick
 	SysTick->CTRL = 0;
 	
@@ -57,6 +57,17 @@
 #define GPIO_ODR_BIT_CLEAR	0UL
 #define GPIO_ODR_BIT_SET		1UL
 
+// Atomic port write through BSRR (upper half resets, lower half sets), other pins are untouched
+#define GPIO_BSRR_VALUE(mask, value) ((((mask) & ~(value)) << 16) | ((value) & (mask)))
+#define GPIO_PORT_WRITE(port, mask, value) (GPIO(port)->BSRR = GPIO_BSRR_VALUE((mask), (value)))
+#define GPIO_PINS_SET(port, mask) (GPIO(port)->BSRR = (mask))
+#define GPIO_PINS_CLEAR(port, mask) (GPIO(port)->BRR = (mask))
+
+// Core coupled RAM placement (see EP4_Mobile_Robot_Controller.sct). Tagged functions are
+// never inlined, so map_size.py --check-ccm can find every one of them in CCM.
+#define CCM_FUNC	__attribute__((section(".ccmram.text"), noinline))		// Run from CCM RAM (no flash wait states)
+#define CCM_BSS		__attribute__((section(".bss.ccmram")))		// Zero initialized data in CCM RAM
+
 #define ENABLE_GPIO_CLOCK(port)	ENABLE_GPIO_CLOCKx(port)
 #define ENABLE_GPIO_CLOCKx(port) RCC -> AHBENR |= RCC_AHBENR_GPIO ## port ## EN
 
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+###############################################################################
+# Name: board_report.py
+# Author(s): Noah Grant, Wyatt Richard
+# Date: October 19, 2026
+# Description: Prints the pinout and timer allocation described by Board.h.
+#              The build itself rejects double assignments (_Static_assert in
+#              Board.h); this report lists them too so they are easy to find.
+#
+# Usage: python3 board_report.py [Board.h]
+###############################################################################
+
+import re
+import sys
+
+DEFINE = re.compile(r"^#define\s+BOARD_(\w+?)_(PORT|PIN|AF|TIMER)\s+(\w+)", re.MULTILINE)
+USE_PUSHBUTTON = re.compile(r"^#define\s+BOARD_USE_PUSHBUTTON\s+(\d+)", re.MULTILINE)
+CHANNEL = re.compile(r"X\(BOARD_(\w+)_TIMER, (\d)\)")
+
+
+def main():
+    path = sys.argv[1] if len(sys.argv) > 1 else "Board.h"
+    with open(path) as source:
+        text = source.read()
+
+    fields = {}
+    for name, field, value in DEFINE.findall(text):
+        fields.setdefault(name, {})[field] = value
+    use_pushbutton = USE_PUSHBUTTON.search(text)
+    if use_pushbutton and use_pushbutton.group(1) == "0":
+        fields.pop("PUSHBUTTON", None)
+
+    conflicts = 0
+
+    pins = {}
+    for name, f in fields.items():
+        if "PORT" in f and "PIN" in f:
+            pins.setdefault(("P%s%d" % (f["PORT"], int(f["PIN"]))), []).append(
+                (name, "GPIO" if f.get("AF") == "BOARD_GPIO" else "AF" + f.get("AF", "?")))
+
+    print("%-6s %-24s %s" % ("Pin", "Function", "Mode"))
+    for pin in sorted(pins, key=lambda p: (p[1], int(p[2:]))):
+        for name, mode in pins[pin]:
+            clash = "  CONFLICT" if len(pins[pin]) > 1 else ""
+            print("%-6s %-24s %s%s" % (pin, name, mode, clash))
+        conflicts += len(pins[pin]) > 1
+
+    timers = {name: int(f["TIMER"]) for name, f in fields.items() if "TIMER" in f}
+    channels = {}
+    for name, channel in CHANNEL.findall(text):
+        channels.setdefault((timers[name], int(channel)), []).append(name)
+
+    print("\n%-6s %-8s %s" % ("Timer", "Channel", "Owner"))
+    for (timer, channel) in sorted(channels):
+        owners = channels[(timer, channel)]
+        clash = "  CONFLICT" if len(owners) > 1 else ""
+        print("TIM%-3d %-8s %s%s" % (timer, "counter" if channel == 0 else "CH%d" % channel, ", ".join(owners), clash))
+        conflicts += len(owners) > 1
+
+    if conflicts:
+        print("\n%d conflict(s)" % conflicts)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
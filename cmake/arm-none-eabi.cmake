@@ -0,0 +1,40 @@
+###############################################################################
+# Name: arm-none-eabi.cmake
+# Author(s): agent
+# Date: October 19, 2026
+# Description: CMake toolchain file for the GNU Arm Embedded toolchain.
+#              The compiler is taken from PATH unless ARM_TOOLCHAIN_DIR is set.
+#
+# Usage: cmake -S . -B build-arm -DCMAKE_TOOLCHAIN_FILE=cmake/arm-none-eabi.cmake
+#        -DCMSIS_CORE_DIR=<CMSIS/Core/Include> -DCMSIS_DEVICE_DIR=<Device/ST/STM32F3xx/Include>
+###############################################################################
+
+set(CMAKE_SYSTEM_NAME Generic)
+set(CMAKE_SYSTEM_PROCESSOR arm)
+
+set(ARM_TOOLCHAIN_DIR "" CACHE PATH "Directory holding arm-none-eabi-gcc (empty to use PATH)")
+if(ARM_TOOLCHAIN_DIR)
+	set(ARM_PREFIX "${ARM_TOOLCHAIN_DIR}/arm-none-eabi-")
+else()
+	set(ARM_PREFIX "arm-none-eabi-")
+endif()
+
+set(CMAKE_C_COMPILER "${ARM_PREFIX}gcc")
+set(CMAKE_ASM_COMPILER "${ARM_PREFIX}gcc")
+set(CMAKE_OBJCOPY "${ARM_PREFIX}objcopy" CACHE FILEPATH "")
+set(CMAKE_SIZE "${ARM_PREFIX}size" CACHE FILEPATH "")
+set(CMAKE_NM "${ARM_PREFIX}nm" CACHE FILEPATH "")
+set(CMAKE_OBJDUMP "${ARM_PREFIX}objdump" CACHE FILEPATH "")
+
+# Test programs cannot link without the startup file and linker script
+set(CMAKE_TRY_COMPILE_TARGET_TYPE STATIC_LIBRARY)
+
+# Cortex-M4F, the same core options as the Keil target
+set(ARM_CPU_FLAGS "-mcpu=cortex-m4 -mthumb -mfpu=fpv4-sp-d16 -mfloat-abi=hard")
+set(CMAKE_C_FLAGS_INIT "${ARM_CPU_FLAGS} -ffunction-sections -fdata-sections")
+set(CMAKE_ASM_FLAGS_INIT "${ARM_CPU_FLAGS}")
+set(CMAKE_EXE_LINKER_FLAGS_INIT "${ARM_CPU_FLAGS} --specs=nano.specs --specs=nosys.specs -Wl,--gc-sections")
+
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
@@ -0,0 +1,218 @@
+/********************************************************************************
+* Name: BenchMain.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: robot_bench, the Bench.c benchmarks on the simulator. Each case is
+*							 timed on the simulated DWT cycle counter and its register reads
+*							 and writes counted, and one JSON object per case is printed.
+*							 Virtual time only charges register accesses, so the numbers
+*							 track bus traffic rather than instruction counts.
+*							 --save <file> writes the results as a baseline; --baseline
+*							 <file> compares against one and exits non zero when a case is
+*							 slower, or makes more register accesses, than the baseline by
+*							 more than --threshold percent (BENCH_THRESHOLD_PCT by default).
+*
+* Usage: robot_bench [--baseline <file>] [--threshold <pct>] [--save <file>]
+********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Sim.h"
+#include "Bench.h"
+#include "Encoder.h"
+#include "Kernel.h"
+#include "KeyPad.h"
+#include "LCD.h"
+#include "Profile.h"
+#include "Stepper.h"
+#include "SysClock.h"
+#include "UART.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define BENCH_MAIN_PRIORITY		1				// Below the Bench.c switch partner
+#define BENCH_MAIN_STACK			256			// Words
+#define BENCH_MAIN_LINE				256			// Longest baseline line
+
+// One case as run on the simulator
+typedef struct {
+	Bench_Result bench;
+	uint32_t nsPerOp;				// cycles_min at the simulated HCLK
+	uint32_t reads;					// Register reads per run of the case
+	uint32_t writes;				// Register writes per run
+} BenchMain_Case;
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static Kernel_Task mainTask;
+static uint32_t mainStack[BENCH_MAIN_STACK];
+static const char *baselineFile = NULL;
+static const char *saveFile = NULL;
+static uint32_t threshold = BENCH_THRESHOLD_PCT;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* BenchMain_Field() - Read a number from a JSON line.
+* line		- One baseline object.
+* key			- Field name.
+* value		- Returns the number.
+* Returns 1 if the field was found, otherwise 0.
+*************************************************************/
+static int BenchMain_Field(const char *line, const char *key, uint32_t *value){
+	char quoted[64];
+	const char *at;
+
+	snprintf(quoted, sizeof(quoted), "\"%s\":", key);
+	at = strstr(line, quoted);
+	if(at == NULL){
+		return(0);
+	}
+	*value = (uint32_t)strtoul(at + strlen(quoted), NULL, 10);
+	return(1);
+}
+
+/*************************************************************
+* BenchMain_Baseline() - Find a case in the baseline file.
+* file		- Baseline, one object per line as --save writes them.
+* name		- Case name.
+* base		- Returns the baseline ns/op and register accesses.
+* Returns 1 if the case has a baseline, otherwise 0.
+*************************************************************/
+static int BenchMain_Baseline(FILE *file, const char *name, BenchMain_Case *base){
+	char line[BENCH_MAIN_LINE];
+	char quoted[64];
+
+	snprintf(quoted, sizeof(quoted), "\"name\":\"%s\"", name);
+	rewind(file);
+	while(fgets(line, sizeof(line), file) != NULL){
+		if(strstr(line, quoted) != NULL){
+			return(BenchMain_Field(line, "ns_per_op", &base->nsPerOp) &&
+				BenchMain_Field(line, "reads_per_op", &base->reads) &&
+				BenchMain_Field(line, "writes_per_op", &base->writes));
+		}
+	}
+	return(0);
+}
+
+/*************************************************************
+* BenchMain_Over() - Compare a result with its baseline.
+* value		- Measured.
+* base		- Baseline.
+* Returns 1 if value is above base by more than the threshold.
+*************************************************************/
+static int BenchMain_Over(uint32_t value, uint32_t base){
+	return((uint64_t)value * 100 > (uint64_t)base * (100 + threshold));
+}
+
+/*************************************************************
+* BenchMain_Task() - Run every case, print the results and exit.
+* arg		- Unused.
+* Never returns.
+*************************************************************/
+static void BenchMain_Task(void *arg){
+	BenchMain_Case result, base;
+	FILE *baseline = NULL, *save = NULL;
+	uint32_t cyclesPerUs = Sim_Hclk() / 1000000UL;
+	int regressions = 0, regression;
+
+	if(baselineFile != NULL && (baseline = fopen(baselineFile, "r")) == NULL){
+		perror(baselineFile);
+		_exit(2);
+	}
+	if(saveFile != NULL && (save = fopen(saveFile, "w")) == NULL){
+		perror(saveFile);
+		_exit(2);
+	}
+
+	for(uint32_t i = 0; i < Bench_Count(); i++){
+		Sim_ResetCounts();
+		Bench_Measure(i, &result.bench);
+		Sim_GetCounts(&result.reads, &result.writes);
+		result.reads = result.reads / BENCH_ITERATIONS - 2;		// Less Bench_Measure()'s cycle counter reads
+		result.writes /= BENCH_ITERATIONS;
+		result.nsPerOp = (result.bench.cyclesMin * 1000UL) / cyclesPerUs;
+
+		printf("{\"name\":\"%s\",\"cycles_min\":%u,\"cycles_mean\":%u,\"ns_per_op\":%u,\"reads_per_op\":%u,\"writes_per_op\":%u",
+			result.bench.name, result.bench.cyclesMin, result.bench.cyclesMean, result.nsPerOp, result.reads, result.writes);
+		if(save != NULL){
+			fprintf(save, "{\"name\":\"%s\",\"ns_per_op\":%u,\"reads_per_op\":%u,\"writes_per_op\":%u}\n",
+				result.bench.name, result.nsPerOp, result.reads, result.writes);
+		}
+
+		// Every case needs a baseline, a new case fails until the file is updated
+		if(baseline != NULL){
+			if(BenchMain_Baseline(baseline, result.bench.name, &base)){
+				regression = BenchMain_Over(result.nsPerOp, base.nsPerOp) ||
+					BenchMain_Over(result.reads + result.writes, base.reads + base.writes);
+				printf(",\"baseline_ns_per_op\":%u,\"baseline_accesses_per_op\":%u,\"regression\":%s",
+					base.nsPerOp, base.reads + base.writes, regression ? "true" : "false");
+			}
+			else{
+				regression = 1;
+				printf(",\"baseline_ns_per_op\":null,\"regression\":true");
+			}
+			regressions += regression;
+		}
+		printf("}\n");
+	}
+
+	if(save != NULL){
+		fclose(save);
+	}
+	if(baseline != NULL){
+		fclose(baseline);
+		printf("{\"cases\":%u,\"threshold_pct\":%u,\"regressions\":%d}\n", Bench_Count(), threshold, regressions);
+	}
+	fflush(stdout);
+	_exit(regressions ? 1 : 0);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(int argc, char **argv){
+	for(int i = 1; i < argc; i++){
+		if(strcmp(argv[i], "--baseline") == 0 && i + 1 < argc){
+			baselineFile = argv[++i];
+		}
+		else if(strcmp(argv[i], "--save") == 0 && i + 1 < argc){
+			saveFile = argv[++i];
+		}
+		else if(strcmp(argv[i], "--threshold") == 0 && i + 1 < argc){
+			threshold = (uint32_t)atoi(argv[++i]);
+		}
+		else{
+			fprintf(stderr, "usage: %s [--baseline <file>] [--threshold <pct>] [--save <file>]\n", argv[0]);
+			return(2);
+		}
+	}
+
+	// The drivers the cases use, at 72 MHz as on the board
+	System_Clock_Init();
+	SystemCoreClockUpdate();
+	Profile_Init();
+	Stepper_Init();
+	LCD_Init();
+	KeyPad_Init();
+	UART2_Init();
+	Encoder_Init();
+
+	Kernel_Init();
+	Bench_Init();
+	Kernel_TaskCreate(&mainTask, "main", BenchMain_Task, NULL, mainStack, BENCH_MAIN_STACK, BENCH_MAIN_PRIORITY);
+	Kernel_Start();
+}
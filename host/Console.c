@@ -0,0 +1,87 @@
+/********************************************************************************
+* Name: Console.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Terminal for robot_host, the firmware running on the simulator.
+*							 USART2 output goes to stdout and stdin is fed to USART2 RX,
+*							 so the UART menus work as they do over the ST-LINK port.
+*							 ROBOT_SECONDS in the environment ends the run after that much
+*							 virtual time (it runs until interrupted otherwise).
+********************************************************************************/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "Sim.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define CONSOLE_POLL_US		10000UL			// Virtual time between stdin checks
+#define CONSOLE_CHUNK			16					// Characters taken from stdin per check
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Console_Putc() - USART2 sink, one character to stdout.
+* c				- Character sent.
+* No return value.
+*************************************************************/
+static void Console_Putc(char c){
+	putchar(c);
+	if(c == '\n'){
+		fflush(stdout);
+	}
+}
+
+/*************************************************************
+* Console_Poll() - Pass what has been typed to USART2 RX, then check again later.
+* arg			- Unused.
+* No return value.
+*************************************************************/
+static void Console_Poll(void *arg){
+	char text[CONSOLE_CHUNK + 1];
+	ssize_t count = read(STDIN_FILENO, text, CONSOLE_CHUNK);
+
+	fflush(stdout);
+	if(count == 0){
+		return;				// End of input, stop polling
+	}
+	if(count > 0){
+		text[count] = '\0';
+		Sim_UartRx(text);
+	}
+	Sim_At(Sim_TimeUs() + CONSOLE_POLL_US, Console_Poll, NULL);
+}
+
+/*************************************************************
+* Console_End() - Stop once ROBOT_SECONDS of virtual time have passed.
+* No inputs.
+* Never returns.
+*************************************************************/
+static void Console_End(void){
+	fflush(stdout);
+	_exit(0);
+}
+
+/*************************************************************
+* Console_Init() - Connect USART2 to the terminal before main() runs.
+* No inputs.
+* No return value.
+*************************************************************/
+__attribute__((constructor)) static void Console_Init(void){
+	const char *seconds = getenv("ROBOT_SECONDS");
+
+	fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+	Sim_SetUartSink(Console_Putc);
+	Sim_At(CONSOLE_POLL_US, Console_Poll, NULL);
+	if(seconds != NULL){
+		Sim_SetEnd((uint64_t)(atof(seconds) * 1e6), Console_End);
+	}
+}
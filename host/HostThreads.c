@@ -0,0 +1,210 @@
+/********************************************************************************
+* Name: HostThreads.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: core_cm4.h intrinsics on host threads for the ThreadSanitizer
+*							 build (see HostThreads.h).
+********************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+#include "HostThreads.h"
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static pthread_mutex_t core = PTHREAD_MUTEX_INITIALIZER;	// Held while interrupts are masked
+static __thread uint32_t primask;							// This thread's PRIMASK
+static __thread uint32_t ipsr;								// Non zero inside HostThreads_Isr()
+static __thread volatile uint32_t *exclusive;	// LDREX reservation
+static __thread uint32_t exclusiveValue;			// Value the reservation was taken with
+static uint32_t strexFailures;								// STREX that lost the word to another thread
+static uint32_t eventRegister;								// SEV/WFE event
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* HostThreads_Isr() - Run a handler the way the core takes an ISR.
+* handler	- Handler, runs with thread mode held off.
+* arg			- Passed to the handler.
+* No return value.
+*************************************************************/
+void HostThreads_Isr(void (*handler)(void *arg), void *arg){
+	pthread_mutex_lock(&core);
+	ipsr = 1;
+	handler(arg);
+	ipsr = 0;
+	pthread_mutex_unlock(&core);
+}
+
+/*************************************************************
+* HostThreads_StrexFailures() - STREX stores lost to another thread so far.
+* No inputs.
+* Returns the count.
+*************************************************************/
+uint32_t HostThreads_StrexFailures(void){
+	return(__atomic_load_n(&strexFailures, __ATOMIC_RELAXED));
+}
+
+
+/******************************************************************
+*											CORE INTRINSICS (core_cm4.h)											*
+******************************************************************/
+
+/*************************************************************
+* Host_DisableIrq() - __disable_irq(): take the core.
+* No inputs.
+* No return value.
+*************************************************************/
+void Host_DisableIrq(void){
+	if(primask == 0 && ipsr == 0){
+		pthread_mutex_lock(&core);
+	}
+	primask = 1;
+}
+
+/*************************************************************
+* Host_EnableIrq() - __enable_irq(): let the ISRs in again.
+* No inputs.
+* No return value.
+*************************************************************/
+void Host_EnableIrq(void){
+	if(primask != 0 && ipsr == 0){
+		pthread_mutex_unlock(&core);
+	}
+	primask = 0;
+}
+
+/*************************************************************
+* Host_GetPrimask() - __get_PRIMASK().
+* No inputs.
+* Returns PRIMASK.
+*************************************************************/
+uint32_t Host_GetPrimask(void){
+	return(primask);
+}
+
+/*************************************************************
+* Host_SetPrimask() - __set_PRIMASK().
+* mask		- New PRIMASK.
+* No return value.
+*************************************************************/
+void Host_SetPrimask(uint32_t mask){
+	if(mask & 1UL){
+		Host_DisableIrq();
+	}
+	else{
+		Host_EnableIrq();
+	}
+}
+
+/*************************************************************
+* Host_GetIpsr() - __get_IPSR().
+* No inputs.
+* Returns 1 inside HostThreads_Isr(), 0 in thread mode.
+*************************************************************/
+uint32_t Host_GetIpsr(void){
+	return(ipsr);
+}
+
+/*************************************************************
+* Host_GetMsp() - __get_MSP(): not modelled.
+* No inputs.
+* Returns 0.
+*************************************************************/
+uint32_t Host_GetMsp(void){
+	return(0);
+}
+
+/*************************************************************
+* Host_GetPsp() - __get_PSP(): not modelled.
+* No inputs.
+* Returns 0.
+*************************************************************/
+uint32_t Host_GetPsp(void){
+	return(0);
+}
+
+/*************************************************************
+* Host_SetPsp() - __set_PSP(): ignored.
+* psp		- Unused.
+* No return value.
+*************************************************************/
+void Host_SetPsp(uint32_t psp){
+	(void)psp;
+}
+
+/*************************************************************
+* Host_Wfi() - __WFI(): give the other threads a turn.
+* No inputs.
+* No return value.
+*************************************************************/
+void Host_Wfi(void){
+	sched_yield();
+}
+
+/*************************************************************
+* Host_Wfe() - __WFE(): take the event, or give the other threads a turn.
+* No inputs.
+* No return value.
+*************************************************************/
+void Host_Wfe(void){
+	if(__atomic_exchange_n(&eventRegister, 0, __ATOMIC_ACQ_REL) == 0){
+		sched_yield();
+	}
+}
+
+/*************************************************************
+* Host_Sev() - __SEV(): set the event register.
+* No inputs.
+* No return value.
+*************************************************************/
+void Host_Sev(void){
+	__atomic_store_n(&eventRegister, 1, __ATOMIC_RELEASE);
+}
+
+/*************************************************************
+* Host_Ldrex() - __LDREXW(): load and reserve.
+* addr		- Word.
+* Returns the value.
+*************************************************************/
+uint32_t Host_Ldrex(volatile uint32_t *addr){
+	exclusive = addr;
+	exclusiveValue = __atomic_load_n(addr, __ATOMIC_RELAXED);
+	return(exclusiveValue);
+}
+
+/*************************************************************
+* Host_Strex() - __STREXW(): store if no other thread stored since the LDREX.
+* value		- Value.
+* addr		- Word.
+* Returns 0 if stored, 1 if the reservation was lost.
+*************************************************************/
+uint32_t Host_Strex(uint32_t value, volatile uint32_t *addr){
+	uint32_t expected = exclusiveValue;
+
+	if(exclusive != addr){
+		return(1);
+	}
+	exclusive = NULL;
+	if(!__atomic_compare_exchange_n(addr, &expected, value, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+		__atomic_fetch_add(&strexFailures, 1, __ATOMIC_RELAXED);
+		return(1);
+	}
+	return(0);
+}
+
+/*************************************************************
+* Host_Clrex() - __CLREX(): drop the reservation.
+* No inputs.
+* No return value.
+*************************************************************/
+void Host_Clrex(void){
+	exclusive = NULL;
+}
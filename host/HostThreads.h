@@ -0,0 +1,24 @@
+/********************************************************************************
+* Name: HostThreads.h (interface)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: core_cm4.h intrinsics on host threads, in place of Sim.c, so
+*							 ThreadSanitizer can check the Atomic.h primitives. Threads stand
+*							 in for main and the ISRs. PRIMASK is one lock for the whole
+*							 core: a thread holds it while it masks interrupts, and a handler
+*							 run through HostThreads_Isr() holds it for the whole handler,
+*							 as nothing in thread mode runs while an ISR does. LDREX/STREX
+*							 are a load and a compare and swap, so STREX fails when another
+*							 thread stored to the word in between.
+********************************************************************************/
+
+#ifndef __HostThreads_H
+#define __HostThreads_H
+
+#include <stdint.h>
+#include "stm32f303xe.h"
+
+void HostThreads_Isr(void (*handler)(void *arg), void *arg);
+uint32_t HostThreads_StrexFailures(void);
+
+#endif
@@ -0,0 +1,138 @@
+/********************************************************************************
+* Name: KernelPort.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: POSIX thread port of the kernel for the host build. Each task runs
+*							 on its own thread and only the thread holding the baton runs,
+*							 so the simulated core still executes one task at a time.
+*							 PendSV_Handler asks Kernel_Switch() for the next task, hands it
+*							 the baton and waits to be handed it back. The value the kernel
+*							 keeps in Kernel_Task.sp is the task's thread record.
+********************************************************************************/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "KernelPort.h"
+#include "Sim.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+typedef struct {
+	Kernel_Task *task;
+	void (*entry)(void *);
+	void *arg;
+	pthread_t thread;
+	uint8_t started;
+} Port_Thread;
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static Port_Thread threads[KERNEL_MAX_TASKS];
+static uint32_t threadCount = 0;
+static pthread_mutex_t baton = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t batonMoved = PTHREAD_COND_INITIALIZER;
+static Port_Thread *running = NULL;						// NULL until main() switches away
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* KernelPort_Wait() - Block until this thread is handed the baton.
+* self		- Thread record (NULL for main(), which never gets it back).
+* No return value.
+*************************************************************/
+static void KernelPort_Wait(Port_Thread *self){
+	pthread_mutex_lock(&baton);
+	while(running != self){
+		pthread_cond_wait(&batonMoved, &baton);
+	}
+	pthread_mutex_unlock(&baton);
+}
+
+/*************************************************************
+* KernelPort_Thread() - Body of a task thread.
+* arg			- Thread record.
+* Never returns.
+*************************************************************/
+static void *KernelPort_Thread(void *arg){
+	Port_Thread *self = arg;
+
+	KernelPort_Wait(self);
+	Sim_PendSvReturn();
+	self->entry(self->arg);
+	Kernel_TaskExit();
+	return(NULL);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* KernelPort_InitStack() - Record the thread a task will run on (started on its first switch).
+* task		- Task control block.
+* entry		- Task function, entry(arg).
+* arg			- Argument passed to entry.
+* Returns the thread record, kept by the kernel as the task's stack pointer.
+*************************************************************/
+uint32_t *KernelPort_InitStack(Kernel_Task *task, void (*entry)(void *), void *arg){
+	Port_Thread *thread;
+
+	if(threadCount >= KERNEL_MAX_TASKS){
+		fprintf(stderr, "kernel: more than %d tasks\n", KERNEL_MAX_TASKS);
+		abort();
+	}
+	thread = &threads[threadCount++];
+	thread->task = task;
+	thread->entry = entry;
+	thread->arg = arg;
+	thread->started = 0;
+	return((uint32_t *)thread);
+}
+
+/*************************************************************
+* KernelPort_Start() - Nothing to set up, main() blocks in its first PendSV.
+* No inputs.
+* No return value.
+*************************************************************/
+void KernelPort_Start(void){
+}
+
+/*************************************************************
+* PendSV_Handler() - Hand the baton to the highest ready task and wait for it back.
+* No inputs.
+* No return value.
+*************************************************************/
+void PendSV_Handler(void){
+	Port_Thread *self = running;
+	Port_Thread *next = (Port_Thread *)Kernel_Switch((uint32_t *)self);
+
+	if(next == self){
+		return;
+	}
+
+	pthread_mutex_lock(&baton);
+	running = next;
+	if(!next->started){
+		next->started = 1;
+		if(pthread_create(&next->thread, NULL, KernelPort_Thread, next) != 0){
+			fprintf(stderr, "kernel: cannot start task %s\n", next->task->name);
+			abort();
+		}
+	}
+	pthread_cond_broadcast(&batonMoved);
+	pthread_mutex_unlock(&baton);
+
+	KernelPort_Wait(self);
+	Sim_PendSvReturn();
+}
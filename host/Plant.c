@@ -0,0 +1,232 @@
+/********************************************************************************
+* Name: Plant.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: robot_plant, the unmodified firmware on the simulator with its
+*							 motors and sensors wired to an outside physics model (robot_sim.py)
+*							 over stdin/stdout. The two run in lock step on virtual time: at
+*							 each step the plant prints what the firmware drives and has
+*							 measured, then applies the model's sensor edges and runs to the
+*							 next step. Encoder vanes are TIM2 captures, the echo is TIM3
+*							 (reset on the rising edge, CCR1 captures the falling edge) and a
+*							 ping is a TIM16 CEN write.
+*
+*							 Plant to model, one line per step, then the firmware's UART lines:
+*								 t <us> <left duty> <right duty> <pings> <left period> <right period>
+*									 <left edges> <right edges> <distance>
+*								 uart <text>
+*							 Duties are signed % (backwards below 0), pings are trigger pulses
+*							 since the last step and the rest is the latest BUS_TOPIC_ENCODER
+*							 and BUS_TOPIC_ULTRA sample (distance -1 before the first echo).
+*
+*							 Model to plant, any number of events for the next step, then run:
+*								 edge <wheel> <us>			encoder vane (0 left, 1 right)
+*								 echo <us> <width>			echo pulse rising at us, width us long
+*								 uart <text>						characters to USART2 RX
+*								 run <us>								run until us, then print the next step
+*							 End of input ends the run.
+********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Sim.h"
+#include "Board.h"
+#include "Utility.h"
+#include "Bus.h"
+#include "Encoder.h"
+#include "Ultrasonic.h"
+#include "DCMotor.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define PLANT_LINE				256				// Longest line either way
+
+// Motor direction outputs
+#define PLANT_DIR_PORT		GPIO(BOARD_DCMOTOR_LEFT_FWD_PORT)
+#define PLANT_LEFT_FWD		(1UL << BOARD_DCMOTOR_LEFT_FWD_PIN)
+#define PLANT_LEFT_BWD		(1UL << BOARD_DCMOTOR_LEFT_BWD_PIN)
+#define PLANT_RIGHT_FWD		(1UL << BOARD_DCMOTOR_RIGHT_FWD_PIN)
+#define PLANT_RIGHT_BWD		(1UL << BOARD_DCMOTOR_RIGHT_BWD_PIN)
+
+_Static_assert(BOARD_PORT_NUM(BOARD_DCMOTOR_LEFT_FWD_PORT) == BOARD_PORT_NUM(BOARD_DCMOTOR_RIGHT_BWD_PORT),
+	"Plant.c: the motor direction pins are read from one port");
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static uint32_t pings;										// Trigger pulses since the last step
+static char uartLine[PLANT_LINE];
+static uint32_t uartLength;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Plant_Putc() - USART2 sink, whole lines to stdout as "uart <text>".
+* c				- Character sent.
+* No return value.
+*************************************************************/
+static void Plant_Putc(char c){
+	if(c == '\n' || uartLength == sizeof(uartLine) - 1){
+		uartLine[uartLength] = '\0';
+		printf("uart %s\n", uartLine);
+		uartLength = 0;
+	}
+	if(c != '\n' && c != '\r'){
+		uartLine[uartLength++] = c;
+	}
+}
+
+/*************************************************************
+* Plant_Access() - Count pings: TIM16 started for a trigger pulse.
+* addr		- Register word address.
+* value		- Value written.
+* write		- Non zero for a write.
+* No return value.
+*************************************************************/
+static void Plant_Access(uint32_t addr, uint32_t value, uint8_t write){
+	if(write && addr == (uint32_t)(uintptr_t)&ULTRA_TRIGGER_TIMER->CR1 && (value & TIM_CR1_CEN)){
+		pings++;
+	}
+}
+
+/*************************************************************
+* Plant_Duty() - Signed duty cycle a motor is driven at.
+* fwd			- Forward direction pin.
+* bwd			- Backward direction pin.
+* ccr			- PWM compare register.
+* Returns the duty cycle (%), below 0 backwards.
+*************************************************************/
+static int32_t Plant_Duty(uint32_t fwd, uint32_t bwd, volatile uint32_t *ccr){
+	uint32_t odr = Sim_Peek(&PLANT_DIR_PORT->ODR);
+	int32_t duty = (int32_t)(Sim_Peek(ccr) * 100UL / (Sim_Peek(&DCMOTOR_TIMER->ARR) + 1));
+
+	if((odr & (fwd | bwd)) == fwd){
+		return(duty);
+	}
+	if((odr & (fwd | bwd)) == bwd){
+		return(-duty);
+	}
+	return(0);
+}
+
+/*************************************************************
+* Plant_Edge() - Encoder vane edge: capture on the wheel's TIM2 channel.
+* arg			- Wheel (LEFT_ENC or RIGHT_ENC).
+* No return value.
+*************************************************************/
+static void Plant_Edge(void *arg){
+	Sim_TimerCapture(ENCODER_TIMER, ((uintptr_t)arg == LEFT_ENC) ? 1 : 2);
+}
+
+/*************************************************************
+* Plant_EchoRise() - Echo rising edge: TIM3 slave reset.
+* arg			- Unused.
+* No return value.
+*************************************************************/
+static void Plant_EchoRise(void *arg){
+	Sim_TimerReset(ULTRA_ECHO_TIMER);
+}
+
+/*************************************************************
+* Plant_EchoFall() - Echo falling edge: TIM3 CCR1 captures the width.
+* arg			- Unused.
+* No return value.
+*************************************************************/
+static void Plant_EchoFall(void *arg){
+	Sim_TimerCapture(ULTRA_ECHO_TIMER, 1);
+}
+
+/*************************************************************
+* Plant_Report() - Print the step line.
+* No inputs.
+* No return value.
+*************************************************************/
+static void Plant_Report(void){
+	static Bus_Encoder encoder;
+	static long distance = -1;
+	Bus_Encoder encoderNow;
+	Bus_Ultra ultraNow;
+	uint32_t version;
+
+	// The firmware is stopped between two instructions: a sample being
+	// written is skipped and the last good one reported again
+	memcpy(&encoderNow, Bus_Latest(BUS_TOPIC_ENCODER, &version), sizeof(encoderNow));
+	if(Bus_Valid(BUS_TOPIC_ENCODER, version)){
+		encoder = encoderNow;
+	}
+	memcpy(&ultraNow, Bus_Latest(BUS_TOPIC_ULTRA, &version), sizeof(ultraNow));
+	if(version != 0 && Bus_Valid(BUS_TOPIC_ULTRA, version)){
+		distance = (long)ultraNow.distance;
+	}
+
+	printf("t %llu %d %d %u %u %u %u %u %ld\n", (unsigned long long)Sim_TimeUs(),
+		Plant_Duty(PLANT_LEFT_FWD, PLANT_LEFT_BWD, &DCMOTOR_TIMER->CCR1),
+		Plant_Duty(PLANT_RIGHT_FWD, PLANT_RIGHT_BWD, &DCMOTOR_TIMER->CCR2),
+		pings, encoder.period[LEFT_ENC], encoder.period[RIGHT_ENC],
+		encoder.edges[LEFT_ENC], encoder.edges[RIGHT_ENC], distance);
+	fflush(stdout);
+	pings = 0;
+}
+
+/*************************************************************
+* Plant_Step() - Report the step, then take the model's events up to "run".
+* arg			- Unused.
+* No return value.
+*************************************************************/
+static void Plant_Step(void *arg){
+	char line[PLANT_LINE];
+	unsigned long long at, width;
+	unsigned wheel;
+
+	Plant_Report();
+	while(fgets(line, sizeof(line), stdin) != NULL){
+		line[strcspn(line, "\n")] = '\0';
+		if(sscanf(line, "edge %u %llu", &wheel, &at) == 2 && wheel <= RIGHT_ENC){
+			Sim_At(at, Plant_Edge, (void *)(uintptr_t)wheel);
+		}
+		else if(sscanf(line, "echo %llu %llu", &at, &width) == 2){
+			Sim_At(at, Plant_EchoRise, NULL);
+			Sim_At(at + width, Plant_EchoFall, NULL);
+		}
+		else if(strncmp(line, "uart ", 5) == 0){
+			Sim_UartRx(line + 5);
+		}
+		else if(sscanf(line, "run %llu", &at) == 1){
+			Sim_At(at, Plant_Step, NULL);
+			return;
+		}
+		else{
+			fprintf(stderr, "robot_plant: bad command '%s'\n", line);
+		}
+	}
+
+	// The model is done
+	fflush(stdout);
+	_exit(0);
+}
+
+/*************************************************************
+* Plant_Init() - Wire the firmware to the model before main() runs.
+* No inputs.
+* No return value.
+*************************************************************/
+__attribute__((constructor)) static void Plant_Init(void){
+	// The keypad columns have pull-ups on the board, no key is down
+	Sim_GpioInput(GPIO(BOARD_KEYPAD_COL1_PORT), BOARD_KEYPAD_COL1_PIN, 1);
+	Sim_GpioInput(GPIO(BOARD_KEYPAD_COL2_PORT), BOARD_KEYPAD_COL2_PIN, 1);
+	Sim_GpioInput(GPIO(BOARD_KEYPAD_COL3_PORT), BOARD_KEYPAD_COL3_PIN, 1);
+	Sim_GpioInput(GPIO(BOARD_KEYPAD_COL4_PORT), BOARD_KEYPAD_COL4_PIN, 1);
+	Sim_SetUartSink(Plant_Putc);
+	Sim_SetAccessHook(Plant_Access);
+	Sim_At(0, Plant_Step, NULL);
+}
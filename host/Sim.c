@@ -0,0 +1,2063 @@
+/********************************************************************************
+* Name: Sim.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Simulated STM32F303RE for the host build (see Sim.h).
+*							 An access to a mapped register faults (SIGSEGV). The handler
+*							 brings the models up to the current virtual time, opens the page
+*							 and single steps the instruction (x86 trap flag). The SIGTRAP
+*							 that follows closes the page again, applies the write or read
+*							 side effects, charges the access to virtual time and takes any
+*							 interrupt that became pending. The models read and write the
+*							 registers through a second mapping of the same memory.
+*							 Built with -no-pie so the firmware's 32 bit address casts hold.
+********************************************************************************/
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include "Sim.h"
+#include "Utility.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define SIM_PS_PER_S				1000000000000ULL
+#define SIM_PS_PER_US				1000000ULL
+#define SIM_NEVER						0xFFFFFFFFFFFFFFFFULL
+#define SIM_PAGE						4096UL
+#define SIM_X86_TRAP_FLAG		0x100UL
+#define SIM_X86_ERR_WRITE		0x2UL
+
+#define SIM_HSI_HZ					8000000UL
+#define SIM_HSE_HZ					8000000UL				// Nucleo ST-LINK MCO
+
+#define SIM_EXC_PENDSV			14
+#define SIM_EXC_SYSTICK			15
+#define SIM_EXC_IRQ0				16
+#define SIM_IRQ_COUNT				85						// WWDG_IRQn to SPI4_IRQn
+#define SIM_IRQ_WORDS				((SIM_IRQ_COUNT + 31) / 32)
+#define SIM_THREAD_PRIORITY	16						// Below every exception priority
+#define SIM_MAX_NESTING			32
+#define SIM_MAX_INFLIGHT		4							// Pages one instruction may touch
+#define SIM_RX_QUEUE				256
+#define SIM_MSP_USED				0x100UL				// main()'s stack use shown by __get_MSP()
+
+// Register blocks mapped at their real addresses
+typedef struct {
+	uint32_t base;
+	uint32_t size;
+	uint8_t *view;						// Second mapping for the models
+} Sim_Region;
+
+static Sim_Region regions[] = {
+	{PERIPH_BASE, 0x30000UL, NULL},				// APB1, APB2 and AHB1 (RCC, FLASH, EXTI, ...)
+	{PERIPH_BB_BASE, 0x600000UL, NULL},		// Bit-band alias of the above
+	{AHB2PERIPH_BASE, 0x2000UL, NULL},		// GPIOA-GPIOH
+	{0xE0000000UL, 0x10000UL, NULL},			// DWT, SysTick, NVIC, SCB and CoreDebug
+};
+
+#define SIM_REGIONS					(sizeof(regions) / sizeof(regions[0]))
+
+// Timer model, one per TIMx
+typedef struct {
+	uint32_t base;
+	uint8_t apb2;							// Clocked from APB2 (else APB1)
+	uint8_t wide;							// 32 bit counter (TIM2)
+	int16_t upIrq;						// Update interrupt line
+	int16_t ccIrq;						// Capture/compare interrupt line
+	uint64_t lastPs;					// Time the counter was brought up to
+	uint64_t frac;						// Part of a kernel clock tick carried over (ps * Hz)
+	uint32_t pscCount;				// Prescaler counter
+	uint32_t psc;							// Active prescaler (PSC is preloaded)
+} Sim_Timer;
+
+static Sim_Timer timers[] = {
+	{TIM1_BASE, 1, 0, TIM1_UP_TIM16_IRQn, TIM1_CC_IRQn},
+	{TIM2_BASE, 0, 1, TIM2_IRQn, TIM2_IRQn},
+	{TIM3_BASE, 0, 0, TIM3_IRQn, TIM3_IRQn},
+	{TIM4_BASE, 0, 0, TIM4_IRQn, TIM4_IRQn},
+	{TIM6_BASE, 0, 0, TIM6_DAC_IRQn, TIM6_DAC_IRQn},
+	{TIM7_BASE, 0, 0, TIM7_IRQn, TIM7_IRQn},
+	{TIM8_BASE, 1, 0, TIM8_UP_IRQn, TIM8_CC_IRQn},
+	{TIM15_BASE, 1, 0, TIM1_BRK_TIM15_IRQn, TIM1_BRK_TIM15_IRQn},
+	{TIM16_BASE, 1, 0, TIM1_UP_TIM16_IRQn, TIM1_UP_TIM16_IRQn},
+	{TIM17_BASE, 1, 0, TIM1_TRG_COM_TIM17_IRQn, TIM1_TRG_COM_TIM17_IRQn},
+	{TIM20_BASE, 1, 0, TIM20_UP_IRQn, TIM20_CC_IRQn},
+};
+
+#define SIM_TIMERS					(sizeof(timers) / sizeof(timers[0]))
+
+// Event scheduled by Sim_At()
+typedef struct {
+	uint64_t ps;
+	void (*fn)(void *arg);
+	void *arg;
+} Sim_Event;
+
+// Page opened for the instruction being single stepped
+typedef struct {
+	uint32_t page;
+	uint32_t addr;						// Word address accessed
+	uint32_t before;					// Word value before the instruction
+	uint8_t write;						// Fault reported a write
+} Sim_Access;
+
+// Register names for Sim_RegName()
+typedef struct {
+	uint32_t offset;
+	const char *name;
+} Sim_Field;
+
+typedef struct {
+	uint32_t base;
+	uint32_t size;
+	const char *name;
+	const Sim_Field *fields;
+} Sim_Block;
+
+#define SIM_FIELD(type, field)		{offsetof(type, field), #field}
+
+static const Sim_Field timFields[] = {
+	SIM_FIELD(TIM_TypeDef, CR1), SIM_FIELD(TIM_TypeDef, CR2), SIM_FIELD(TIM_TypeDef, SMCR),
+	SIM_FIELD(TIM_TypeDef, DIER), SIM_FIELD(TIM_TypeDef, SR), SIM_FIELD(TIM_TypeDef, EGR),
+	SIM_FIELD(TIM_TypeDef, CCMR1), SIM_FIELD(TIM_TypeDef, CCMR2), SIM_FIELD(TIM_TypeDef, CCER),
+	SIM_FIELD(TIM_TypeDef, CNT), SIM_FIELD(TIM_TypeDef, PSC), SIM_FIELD(TIM_TypeDef, ARR),
+	SIM_FIELD(TIM_TypeDef, RCR), SIM_FIELD(TIM_TypeDef, CCR1), SIM_FIELD(TIM_TypeDef, CCR2),
+	SIM_FIELD(TIM_TypeDef, CCR3), SIM_FIELD(TIM_TypeDef, CCR4), SIM_FIELD(TIM_TypeDef, BDTR),
+	SIM_FIELD(TIM_TypeDef, DCR), SIM_FIELD(TIM_TypeDef, DMAR), SIM_FIELD(TIM_TypeDef, OR),
+	SIM_FIELD(TIM_TypeDef, CCMR3), SIM_FIELD(TIM_TypeDef, CCR5), SIM_FIELD(TIM_TypeDef, CCR6),
+	{0, NULL}
+};
+
+static const Sim_Field gpioFields[] = {
+	SIM_FIELD(GPIO_TypeDef, MODER), SIM_FIELD(GPIO_TypeDef, OTYPER), SIM_FIELD(GPIO_TypeDef, OSPEEDR),
+	SIM_FIELD(GPIO_TypeDef, PUPDR), SIM_FIELD(GPIO_TypeDef, IDR), SIM_FIELD(GPIO_TypeDef, ODR),
+	SIM_FIELD(GPIO_TypeDef, BSRR), SIM_FIELD(GPIO_TypeDef, LCKR), SIM_FIELD(GPIO_TypeDef, AFR[0]),
+	SIM_FIELD(GPIO_TypeDef, AFR[1]), SIM_FIELD(GPIO_TypeDef, BRR),
+	{0, NULL}
+};
+
+static const Sim_Field usartFields[] = {
+	SIM_FIELD(USART_TypeDef, CR1), SIM_FIELD(USART_TypeDef, CR2), SIM_FIELD(USART_TypeDef, CR3),
+	SIM_FIELD(USART_TypeDef, BRR), SIM_FIELD(USART_TypeDef, GTPR), SIM_FIELD(USART_TypeDef, RTOR),
+	SIM_FIELD(USART_TypeDef, RQR), SIM_FIELD(USART_TypeDef, ISR), SIM_FIELD(USART_TypeDef, ICR),
+	SIM_FIELD(USART_TypeDef, RDR), SIM_FIELD(USART_TypeDef, TDR),
+	{0, NULL}
+};
+
+static const Sim_Field rccFields[] = {
+	SIM_FIELD(RCC_TypeDef, CR), SIM_FIELD(RCC_TypeDef, CFGR), SIM_FIELD(RCC_TypeDef, CIR),
+	SIM_FIELD(RCC_TypeDef, APB2RSTR), SIM_FIELD(RCC_TypeDef, APB1RSTR), SIM_FIELD(RCC_TypeDef, AHBENR),
+	SIM_FIELD(RCC_TypeDef, APB2ENR), SIM_FIELD(RCC_TypeDef, APB1ENR), SIM_FIELD(RCC_TypeDef, BDCR),
+	SIM_FIELD(RCC_TypeDef, CSR), SIM_FIELD(RCC_TypeDef, AHBRSTR), SIM_FIELD(RCC_TypeDef, CFGR2),
+	SIM_FIELD(RCC_TypeDef, CFGR3),
+	{0, NULL}
+};
+
+static const Sim_Field flashFields[] = {
+	SIM_FIELD(FLASH_TypeDef, ACR), SIM_FIELD(FLASH_TypeDef, KEYR), SIM_FIELD(FLASH_TypeDef, SR),
+	SIM_FIELD(FLASH_TypeDef, CR),
+	{0, NULL}
+};
+
+static const Sim_Field pwrFields[] = {
+	SIM_FIELD(PWR_TypeDef, CR), SIM_FIELD(PWR_TypeDef, CSR),
+	{0, NULL}
+};
+
+static const Sim_Field syscfgFields[] = {
+	SIM_FIELD(SYSCFG_TypeDef, CFGR1), SIM_FIELD(SYSCFG_TypeDef, RCR), SIM_FIELD(SYSCFG_TypeDef, EXTICR[0]),
+	SIM_FIELD(SYSCFG_TypeDef, EXTICR[1]), SIM_FIELD(SYSCFG_TypeDef, EXTICR[2]),
+	SIM_FIELD(SYSCFG_TypeDef, EXTICR[3]), SIM_FIELD(SYSCFG_TypeDef, CFGR2),
+	{0, NULL}
+};
+
+static const Sim_Field extiFields[] = {
+	SIM_FIELD(EXTI_TypeDef, IMR), SIM_FIELD(EXTI_TypeDef, EMR), SIM_FIELD(EXTI_TypeDef, RTSR),
+	SIM_FIELD(EXTI_TypeDef, FTSR), SIM_FIELD(EXTI_TypeDef, SWIER), SIM_FIELD(EXTI_TypeDef, PR),
+	{0, NULL}
+};
+
+static const Sim_Field sysTickFields[] = {
+	SIM_FIELD(SysTick_Type, CTRL), SIM_FIELD(SysTick_Type, LOAD), SIM_FIELD(SysTick_Type, VAL),
+	SIM_FIELD(SysTick_Type, CALIB),
+	{0, NULL}
+};
+
+static const Sim_Field scbFields[] = {
+	SIM_FIELD(SCB_Type, CPUID), SIM_FIELD(SCB_Type, ICSR), SIM_FIELD(SCB_Type, VTOR),
+	SIM_FIELD(SCB_Type, AIRCR), SIM_FIELD(SCB_Type, SCR), SIM_FIELD(SCB_Type, CCR),
+	SIM_FIELD(SCB_Type, SHP[0]), SIM_FIELD(SCB_Type, SHP[4]), SIM_FIELD(SCB_Type, SHP[8]),
+	SIM_FIELD(SCB_Type, SHCSR), SIM_FIELD(SCB_Type, CPACR),
+	{0, NULL}
+};
+
+static const Sim_Field dwtFields[] = {
+	SIM_FIELD(DWT_Type, CTRL), SIM_FIELD(DWT_Type, CYCCNT),
+	{0, NULL}
+};
+
+static const Sim_Field debugFields[] = {
+	SIM_FIELD(CoreDebug_Type, DHCSR), SIM_FIELD(CoreDebug_Type, DEMCR),
+	{0, NULL}
+};
+
+static const Sim_Block blocks[] = {
+	{TIM1_BASE, 0x400, "TIM1", timFields}, {TIM2_BASE, 0x400, "TIM2", timFields},
+	{TIM3_BASE, 0x400, "TIM3", timFields}, {TIM4_BASE, 0x400, "TIM4", timFields},
+	{TIM6_BASE, 0x400, "TIM6", timFields}, {TIM7_BASE, 0x400, "TIM7", timFields},
+	{TIM8_BASE, 0x400, "TIM8", timFields}, {TIM15_BASE, 0x400, "TIM15", timFields},
+	{TIM16_BASE, 0x400, "TIM16", timFields}, {TIM17_BASE, 0x400, "TIM17", timFields},
+	{TIM20_BASE, 0x400, "TIM20", timFields},
+	{GPIOA_BASE, 0x400, "GPIOA", gpioFields}, {GPIOB_BASE, 0x400, "GPIOB", gpioFields},
+	{GPIOC_BASE, 0x400, "GPIOC", gpioFields}, {GPIOD_BASE, 0x400, "GPIOD", gpioFields},
+	{GPIOE_BASE, 0x400, "GPIOE", gpioFields}, {GPIOF_BASE, 0x400, "GPIOF", gpioFields},
+	{USART1_BASE, 0x400, "USART1", usartFields}, {USART2_BASE, 0x400, "USART2", usartFields},
+	{USART3_BASE, 0x400, "USART3", usartFields},
+	{RCC_BASE, 0x400, "RCC", rccFields}, {FLASH_R_BASE, 0x400, "FLASH", flashFields},
+	{PWR_BASE, 0x400, "PWR", pwrFields}, {SYSCFG_BASE, 0x400, "SYSCFG", syscfgFields},
+	{EXTI_BASE, 0x400, "EXTI", extiFields},
+	{SysTick_BASE, 0x10, "SysTick", sysTickFields}, {NVIC_BASE, 0xC00, "NVIC", NULL},
+	{SCB_BASE, 0x90, "SCB", scbFields}, {DWT_BASE, 0x20, "DWT", dwtFields},
+	{CoreDebug_BASE, 0x10, "CoreDebug", debugFields},
+};
+
+#define SIM_BLOCKS					(sizeof(blocks) / sizeof(blocks[0]))
+
+static const uint8_t ahbShift[16] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 6, 7, 8, 9};
+static const uint8_t apbShift[8] = {0, 0, 0, 0, 1, 2, 3, 4};
+
+// Vector table and main stack, host/Startup.c
+extern void (* const Sim_Vectors[SIM_EXC_IRQ0 + SIM_IRQ_COUNT])(void);
+extern uint32_t STACK$$Limit;
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static uint8_t ready = 0;
+static uint64_t nowPs = 0;
+static uint64_t endPs = SIM_NEVER;
+static void (*endFn)(void) = NULL;
+static Sim_Event events[SIM_MAX_EVENTS];
+static uint32_t eventCount = 0;
+
+// Trap state
+static Sim_Access inFlight[SIM_MAX_INFLIGHT];
+static uint32_t inFlightCount = 0;
+static uint32_t pollAddr = 0;
+static uint32_t pollStreak = 0;
+static uint32_t reads = 0;
+static uint32_t writes = 0;
+static Sim_AccessFn accessHook = NULL;
+
+// Core
+static uint8_t primask = 0;
+static uint8_t eventRegister = 0;
+static uint8_t inPendSv = 0;
+static uint8_t pendSv = 0;
+static uint8_t sysTickPending = 0;
+static uint8_t active[SIM_MAX_NESTING];		// Exception numbers being handled, innermost last
+static uint32_t depth = 0;
+static uint32_t nvicEnabled[SIM_IRQ_WORDS];
+static uint32_t nvicPending[SIM_IRQ_WORDS];
+static uint32_t nvicActive[SIM_IRQ_WORDS];
+static volatile uint32_t *exclusive = NULL;	// LDREX reservation
+static uint64_t sysTickLastPs = 0;
+static uint64_t sysTickFrac = 0;
+static uint64_t cycLastPs = 0;
+static uint64_t cycFrac = 0;
+
+// USART2
+static uint64_t txBusyPs = 0;						// Shift register empties
+static uint8_t txHolding = 0;						// TDR written while shifting
+static uint16_t txNext = 0;
+static uint64_t rxPs[SIM_RX_QUEUE];
+static char rxChar[SIM_RX_QUEUE];
+static uint32_t rxHead = 0;
+static uint32_t rxCount = 0;
+static void (*uartSink)(char c) = NULL;
+
+// GPIO
+static uint32_t gpioLevel[8];						// Levels driven from outside
+static uint32_t gpioDriven[8];					// Pins driven from outside
+static uint32_t (*gpioHook)(GPIO_TypeDef *port, uint32_t idr) = NULL;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Sim_Fail() - Stop the run on something the target would not survive.
+* message	- Reason.
+* No return value.
+*************************************************************/
+static void Sim_Fail(const char *message){
+	fprintf(stderr, "sim: %s at %llu us\n", message, (unsigned long long)(nowPs / SIM_PS_PER_US));
+	fflush(stdout);
+	abort();
+}
+
+/*************************************************************
+* Sim_Word() - Model's view of a register word.
+* addr		- Target address.
+* Returns the word, or NULL if addr is not mapped.
+*************************************************************/
+static uint32_t *Sim_Word(uint32_t addr){
+	for(uint32_t i = 0; i < SIM_REGIONS; i++){
+		if(addr - regions[i].base < regions[i].size){
+			return((uint32_t *)(regions[i].view + ((addr - regions[i].base) & ~3UL)));
+		}
+	}
+	return(NULL);
+}
+
+// Model access to a peripheral by its CMSIS pointer
+#define SIM_REG(peripheral)		((__typeof__(peripheral))Sim_Word((uint32_t)(uintptr_t)(peripheral)))
+
+/*************************************************************
+* Sim_Clock() - Ticks of a clock since it was last brought up to date.
+* lastPs	- Time last brought up to date, moved to now.
+* frac		- Carried part tick (ps * Hz).
+* hz			- Clock frequency.
+* Returns the whole ticks elapsed.
+*************************************************************/
+static uint64_t Sim_Clock(uint64_t *lastPs, uint64_t *frac, uint32_t hz){
+	unsigned __int128 total = (unsigned __int128)(nowPs - *lastPs) * hz + *frac;
+
+	*lastPs = nowPs;
+	*frac = (uint64_t)(total % SIM_PS_PER_S);
+	return((uint64_t)(total / SIM_PS_PER_S));
+}
+
+/*************************************************************
+* Sim_ClockWhen() - Time a clock brought up to date now reaches a tick count.
+* frac		- Carried part tick (ps * Hz).
+* hz			- Clock frequency.
+* ticks		- Ticks from now (at least 1).
+* Returns the time (ps).
+*************************************************************/
+static uint64_t Sim_ClockWhen(uint64_t frac, uint32_t hz, uint64_t ticks){
+	unsigned __int128 need = (unsigned __int128)ticks * SIM_PS_PER_S - frac;
+
+	if(hz == 0){
+		return(SIM_NEVER);
+	}
+	need = (need + hz - 1) / hz;
+	return((need > SIM_NEVER - nowPs) ? SIM_NEVER : nowPs + (uint64_t)need);
+}
+
+
+/******************************************************************
+*														CLOCKS																*
+******************************************************************/
+
+/*************************************************************
+* Sim_Sysclk() - System clock from the RCC switch and PLL settings.
+* No inputs.
+* Returns SYSCLK (Hz).
+*************************************************************/
+static uint32_t Sim_Sysclk(void){
+	RCC_TypeDef *rcc = SIM_REG(RCC);
+	uint32_t source, mul, prediv;
+
+	switch(rcc->CFGR & RCC_CFGR_SWS){
+		case RCC_CFGR_SWS_HSE:{
+			return(SIM_HSE_HZ);
+		}
+		case RCC_CFGR_SWS_PLL:{
+			mul = ((rcc->CFGR & RCC_CFGR_PLLMUL) >> RCC_CFGR_PLLMUL_Pos) + 2;
+			prediv = (rcc->CFGR2 & RCC_CFGR2_PREDIV) + 1;
+			if(mul > 16){
+				mul = 16;
+			}
+			source = rcc->CFGR & RCC_CFGR_PLLSRC;
+			if(source == 0){																		// HSI/2
+				return(SIM_HSI_HZ / 2 * mul);
+			}
+			return(((source == RCC_CFGR_PLLSRC_HSE_PREDIV) ? SIM_HSE_HZ : SIM_HSI_HZ) / prediv * mul);
+		}
+		default:{
+			return(SIM_HSI_HZ);
+		}
+	}
+}
+
+/*************************************************************
+* Sim_Pclk() - Peripheral bus clock.
+* apb2		- 1 for APB2, 0 for APB1.
+* Returns PCLK (Hz).
+*************************************************************/
+static uint32_t Sim_Pclk(uint8_t apb2){
+	uint32_t cfgr = SIM_REG(RCC)->CFGR;
+	uint32_t shift = apb2 ? apbShift[(cfgr & RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos]
+		: apbShift[(cfgr & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos];
+
+	return(Sim_Hclk() >> shift);
+}
+
+/*************************************************************
+* Sim_TimerHz() - Kernel clock of a timer (twice PCLK when its APB is divided).
+* t				- Timer model.
+* Returns the clock (Hz).
+*************************************************************/
+static uint32_t Sim_TimerHz(const Sim_Timer *t){
+	uint32_t hclk = Sim_Hclk();
+	uint32_t pclk = Sim_Pclk(t->apb2);
+
+	return((pclk == hclk) ? pclk : 2 * pclk);
+}
+
+/*************************************************************
+* Sim_CyclesPs() - Duration of core cycles.
+* cycles	- Core cycles.
+* Returns the time (ps).
+*************************************************************/
+static uint64_t Sim_CyclesPs(uint32_t cycles){
+	return((uint64_t)cycles * SIM_PS_PER_S / Sim_Hclk());
+}
+
+
+/******************************************************************
+*														TIMERS																*
+******************************************************************/
+
+/*************************************************************
+* Sim_TimerFind() - Timer model of a register block.
+* base		- Timer base address.
+* Returns the model, or NULL.
+*************************************************************/
+static Sim_Timer *Sim_TimerFind(uint32_t base){
+	for(uint32_t i = 0; i < SIM_TIMERS; i++){
+		if(timers[i].base == base){
+			return(&timers[i]);
+		}
+	}
+	return(NULL);
+}
+
+/*************************************************************
+* Sim_TimerCompares() - Output compare channels of a timer.
+* r				- Timer registers (model view).
+* Returns a bit per channel 1-4 (bit 1-4) set to output compare.
+*************************************************************/
+static uint32_t Sim_TimerCompares(const TIM_TypeDef *r){
+	uint32_t mask = 0;
+
+	mask |= ((r->CCMR1 & TIM_CCMR1_CC1S) == 0) ? (1UL << 1) : 0;
+	mask |= ((r->CCMR1 & TIM_CCMR1_CC2S) == 0) ? (1UL << 2) : 0;
+	mask |= ((r->CCMR2 & TIM_CCMR2_CC3S) == 0) ? (1UL << 3) : 0;
+	mask |= ((r->CCMR2 & TIM_CCMR2_CC4S) == 0) ? (1UL << 4) : 0;
+	return(mask);
+}
+
+/*************************************************************
+* Sim_TimerCcr() - Capture/compare register of a channel.
+* r				- Timer registers (model view).
+* channel	- 1 to 4.
+* Returns the register.
+*************************************************************/
+static volatile uint32_t *Sim_TimerCcr(TIM_TypeDef *r, uint8_t channel){
+	volatile uint32_t *ccr[] = {&r->CCR1, &r->CCR2, &r->CCR3, &r->CCR4};
+
+	return(ccr[channel - 1]);
+}
+
+/*************************************************************
+* Sim_TimerUpdate() - Update event: reload the prescaler, flag UIF.
+* t				- Timer model.
+* r				- Timer registers (model view).
+* flag		- Set UIF.
+* No return value.
+*************************************************************/
+static void Sim_TimerUpdate(Sim_Timer *t, TIM_TypeDef *r, uint8_t flag){
+	t->psc = r->PSC & 0xFFFFUL;
+	t->pscCount = 0;
+	if(flag && !(r->CR1 & TIM_CR1_UDIS)){
+		r->SR |= TIM_SR_UIF;
+	}
+}
+
+/*************************************************************
+* Sim_TimerCount() - Advance the counter (upcounting).
+* t				- Timer model.
+* r				- Timer registers (model view).
+* n				- Counter increments.
+* No return value.
+*************************************************************/
+static void Sim_TimerCount(Sim_Timer *t, TIM_TypeDef *r, uint64_t n){
+	uint32_t max = t->wide ? 0xFFFFFFFFUL : 0xFFFFUL;
+	uint32_t compares = Sim_TimerCompares(r);
+	uint64_t cnt, arr, top, toWrap, ccr;
+
+	while(n != 0 && (r->CR1 & TIM_CR1_CEN)){
+		cnt = r->CNT & max;
+		arr = r->ARR & max;
+		if(arr == 0){
+			return;															// Counter blocked
+		}
+		top = (cnt <= arr) ? arr : max;
+		toWrap = top - cnt + 1;
+
+		// Compare matches on the values passed before the wrap, then 0
+		for(uint8_t ch = 1; ch <= 4; ch++){
+			ccr = *Sim_TimerCcr(r, ch) & max;
+			if((compares & (1UL << ch)) && ((ccr > cnt && ccr - cnt <= n && ccr <= top) || (n >= toWrap && ccr == 0))){
+				r->SR |= TIM_SR_CC1IF << (ch - 1);
+			}
+		}
+
+		if(n < toWrap){
+			r->CNT = (uint32_t)(cnt + n);
+			return;
+		}
+		n -= toWrap;
+		r->CNT = 0;
+		if(cnt > arr){
+			continue;															// Rolled over from above ARR, no update
+		}
+		Sim_TimerUpdate(t, r, 1);
+		if(r->CR1 & TIM_CR1_OPM){
+			r->CR1 &= ~TIM_CR1_CEN;
+			return;
+		}
+
+		// Whole periods pass every value once more
+		if(n > arr){
+			r->SR |= TIM_SR_UIF;
+			for(uint8_t ch = 1; ch <= 4; ch++){
+				if((compares & (1UL << ch)) && (*Sim_TimerCcr(r, ch) & max) <= arr){
+					r->SR |= TIM_SR_CC1IF << (ch - 1);
+				}
+			}
+			n %= arr + 1;
+		}
+	}
+}
+
+/*************************************************************
+* Sim_TimerSync() - Bring a timer up to now.
+* t				- Timer model.
+* No return value.
+*************************************************************/
+static void Sim_TimerSync(Sim_Timer *t){
+	TIM_TypeDef *r = (TIM_TypeDef *)Sim_Word(t->base);
+	uint64_t ticks = Sim_Clock(&t->lastPs, &t->frac, Sim_TimerHz(t));
+	uint64_t total;
+
+	if(!(r->CR1 & TIM_CR1_CEN)){
+		return;
+	}
+	total = t->pscCount + ticks;
+	t->pscCount = (uint32_t)(total % (t->psc + 1));
+	Sim_TimerCount(t, r, total / (t->psc + 1));
+}
+
+/*************************************************************
+* Sim_TimerNext() - Next flag a timer raises.
+* t				- Timer model (synced).
+* Returns the time (ps) or SIM_NEVER.
+*************************************************************/
+static uint64_t Sim_TimerNext(const Sim_Timer *t){
+	const TIM_TypeDef *r = (const TIM_TypeDef *)Sim_Word(t->base);
+	uint32_t max = t->wide ? 0xFFFFFFFFUL : 0xFFFFUL;
+	uint32_t compares = Sim_TimerCompares(r);
+	uint64_t cnt = r->CNT & max;
+	uint64_t arr = r->ARR & max;
+	uint64_t toWrap, ccr, increments = SIM_NEVER;
+
+	if(!(r->CR1 & TIM_CR1_CEN) || arr == 0){
+		return(SIM_NEVER);
+	}
+	toWrap = ((cnt <= arr) ? arr : max) - cnt + 1;
+	if(!(r->SR & TIM_SR_UIF) || (r->CR1 & TIM_CR1_OPM) || cnt > arr){
+		increments = toWrap;
+	}
+	for(uint8_t ch = 1; ch <= 4; ch++){
+		if(!(compares & (1UL << ch)) || (r->SR & (TIM_SR_CC1IF << (ch - 1)))){
+			continue;
+		}
+		ccr = *Sim_TimerCcr((TIM_TypeDef *)r, ch) & max;
+		if(ccr > cnt && ccr - cnt < increments){
+			increments = ccr - cnt;
+		}
+		else if(ccr <= cnt && ccr <= arr && toWrap + ccr < increments){
+			increments = toWrap + ccr;
+		}
+	}
+	if(increments == SIM_NEVER){
+		return(SIM_NEVER);
+	}
+	return(Sim_ClockWhen(t->frac, Sim_TimerHz(t), increments * (t->psc + 1) - t->pscCount));
+}
+
+/*************************************************************
+* Sim_TimerWrite() - Side effects of a timer register write.
+* t				- Timer model.
+* offset	- Register offset.
+* before	- Register value before the write.
+* No return value.
+*************************************************************/
+static void Sim_TimerWrite(Sim_Timer *t, uint32_t offset, uint32_t before){
+	TIM_TypeDef *r = (TIM_TypeDef *)Sim_Word(t->base);
+	uint32_t egr;
+
+	switch(offset){
+		case offsetof(TIM_TypeDef, SR):{
+			r->SR &= before;													// rc_w0
+			break;
+		}
+		case offsetof(TIM_TypeDef, EGR):{
+			egr = r->EGR;
+			r->EGR = 0;
+			if(egr & TIM_EGR_UG){
+				r->CNT = 0;
+				Sim_TimerUpdate(t, r, !(r->CR1 & TIM_CR1_URS));
+			}
+			r->SR |= egr & (TIM_EGR_CC1G | TIM_EGR_CC2G | TIM_EGR_CC3G | TIM_EGR_CC4G);
+			break;
+		}
+		case offsetof(TIM_TypeDef, CR1):{
+			if((r->CR1 & TIM_CR1_CEN) && !(before & TIM_CR1_CEN)){
+				t->frac = 0;
+			}
+			break;
+		}
+		default:{
+			break;
+		}
+	}
+}
+
+/*************************************************************
+* Sim_TimerRead() - Side effects of a timer register read.
+* base		- Timer base address.
+* offset	- Register offset.
+* No return value.
+*************************************************************/
+static void Sim_TimerRead(uint32_t base, uint32_t offset){
+	TIM_TypeDef *r = (TIM_TypeDef *)Sim_Word(base);
+	uint8_t channel;
+
+	// Reading an input capture CCRx clears CCxIF
+	if(offset < offsetof(TIM_TypeDef, CCR1) || offset > offsetof(TIM_TypeDef, CCR4)){
+		return;
+	}
+	channel = (offset - offsetof(TIM_TypeDef, CCR1)) / 4 + 1;
+	if(!(Sim_TimerCompares(r) & (1UL << channel))){
+		r->SR &= ~(TIM_SR_CC1IF << (channel - 1));
+	}
+}
+
+/*************************************************************
+* Sim_TimerIrqs() - Raise the interrupt lines of every timer.
+* level		- Line levels, one bit per IRQ.
+* No return value.
+*************************************************************/
+static void Sim_TimerIrqs(uint32_t *level){
+	for(uint32_t i = 0; i < SIM_TIMERS; i++){
+		const TIM_TypeDef *r = (const TIM_TypeDef *)Sim_Word(timers[i].base);
+		uint32_t raised = r->SR & r->DIER;
+
+		if(raised & TIM_SR_UIF){
+			level[timers[i].upIrq >> 5] |= 1UL << (timers[i].upIrq & 31);
+		}
+		if(raised & (TIM_SR_CC1IF | TIM_SR_CC2IF | TIM_SR_CC3IF | TIM_SR_CC4IF)){
+			level[timers[i].ccIrq >> 5] |= 1UL << (timers[i].ccIrq & 31);
+		}
+	}
+}
+
+
+/******************************************************************
+*											SYSTICK AND DWT															*
+******************************************************************/
+
+/*************************************************************
+* Sim_SysTickHz() - SysTick clock (HCLK or HCLK/8).
+* No inputs.
+* Returns the clock (Hz).
+*************************************************************/
+static uint32_t Sim_SysTickHz(void){
+	return((SIM_REG(SysTick)->CTRL & SysTick_CTRL_CLKSOURCE_Msk) ? Sim_Hclk() : Sim_Hclk() / 8);
+}
+
+/*************************************************************
+* Sim_SysTickSync() - Count SysTick down to now.
+* No inputs.
+* No return value.
+*************************************************************/
+static void Sim_SysTickSync(void){
+	SysTick_Type *r = SIM_REG(SysTick);
+	uint64_t n = Sim_Clock(&sysTickLastPs, &sysTickFrac, Sim_SysTickHz());
+	uint32_t load = r->LOAD & SysTick_LOAD_RELOAD_Msk;
+
+	if(!(r->CTRL & SysTick_CTRL_ENABLE_Msk)){
+		return;
+	}
+	while(n != 0){
+		if(r->VAL == 0){
+			if(load == 0){
+				return;
+			}
+			r->VAL = load;														// Reload on the tick after reaching 0
+			n--;
+			continue;
+		}
+		if(n < r->VAL){
+			r->VAL -= (uint32_t)n;
+			return;
+		}
+		n -= r->VAL;
+		r->VAL = 0;
+		r->CTRL |= SysTick_CTRL_COUNTFLAG_Msk;
+		if(r->CTRL & SysTick_CTRL_TICKINT_Msk){
+			sysTickPending = 1;
+		}
+		n %= (uint64_t)load + 1;
+	}
+}
+
+/*************************************************************
+* Sim_SysTickNext() - Time SysTick next reaches 0.
+* No inputs.
+* Returns the time (ps) or SIM_NEVER.
+*************************************************************/
+static uint64_t Sim_SysTickNext(void){
+	const SysTick_Type *r = SIM_REG(SysTick);
+	uint32_t load = r->LOAD & SysTick_LOAD_RELOAD_Msk;
+
+	if(!(r->CTRL & SysTick_CTRL_ENABLE_Msk) || load == 0){
+		return(SIM_NEVER);
+	}
+	if((r->CTRL & SysTick_CTRL_COUNTFLAG_Msk) && !(r->CTRL & SysTick_CTRL_TICKINT_Msk)){
+		return(SIM_NEVER);
+	}
+	return(Sim_ClockWhen(sysTickFrac, Sim_SysTickHz(), (r->VAL == 0) ? (uint64_t)load + 1 : r->VAL));
+}
+
+/*************************************************************
+* Sim_CycleSync() - Count DWT CYCCNT up to now.
+* No inputs.
+* No return value.
+*************************************************************/
+static void Sim_CycleSync(void){
+	DWT_Type *r = SIM_REG(DWT);
+	uint64_t cycles = Sim_Clock(&cycLastPs, &cycFrac, Sim_Hclk());
+
+	if(r->CTRL & DWT_CTRL_CYCCNTENA_Msk){
+		r->CYCCNT += (uint32_t)cycles;
+	}
+}
+
+
+/******************************************************************
+*														USART2																*
+******************************************************************/
+
+/*************************************************************
+* Sim_UartHz() - USART2 kernel clock (RCC_CFGR3 USART2SW).
+* No inputs.
+* Returns the clock (Hz).
+*************************************************************/
+static uint32_t Sim_UartHz(void){
+	switch((SIM_REG(RCC)->CFGR3 & RCC_CFGR3_USART2SW) >> RCC_CFGR3_USART2SW_Pos){
+		case 1:{
+			return(Sim_Sysclk());
+		}
+		case 2:{
+			return(32768UL);															// LSE
+		}
+		case 3:{
+			return(SIM_HSI_HZ);
+		}
+		default:{
+			return(Sim_Pclk(0));
+		}
+	}
+}
+
+/*************************************************************
+* Sim_UartCharPs() - Time to shift one 10 bit character (16x oversampling).
+* No inputs.
+* Returns the time (ps).
+*************************************************************/
+static uint64_t Sim_UartCharPs(void){
+	uint32_t brr = SIM_REG(USART2)->BRR & 0xFFFFUL;
+
+	return(10ULL * (brr ? brr : 1) * SIM_PS_PER_S / Sim_UartHz());
+}
+
+/*************************************************************
+* Sim_UartSync() - Move transmit and receive on to now.
+* No inputs.
+* No return value.
+*************************************************************/
+static void Sim_UartSync(void){
+	USART_TypeDef *r = SIM_REG(USART2);
+
+	// Transmit: TDR moves to the shift register once it empties
+	while(!(r->ISR & USART_ISR_TC) && nowPs >= txBusyPs){
+		if(txHolding){
+			txHolding = 0;
+			txBusyPs += Sim_UartCharPs();
+			r->ISR |= USART_ISR_TXE;
+			if(uartSink != NULL){
+				uartSink((char)txNext);
+			}
+		}
+		else{
+			r->ISR |= USART_ISR_TC;
+		}
+	}
+
+	// Receive
+	while(rxCount != 0 && nowPs >= rxPs[rxHead]){
+		if(r->ISR & USART_ISR_RXNE){
+			r->ISR |= USART_ISR_ORE;
+		}
+		else if(r->CR1 & USART_CR1_RE){
+			r->RDR = (uint8_t)rxChar[rxHead];
+			r->ISR |= USART_ISR_RXNE;
+		}
+		rxHead = (rxHead + 1) % SIM_RX_QUEUE;
+		rxCount--;
+	}
+}
+
+/*************************************************************
+* Sim_UartNext() - Next transmit or receive event.
+* No inputs.
+* Returns the time (ps) or SIM_NEVER.
+*************************************************************/
+static uint64_t Sim_UartNext(void){
+	uint64_t next = SIM_NEVER;
+
+	if(!(SIM_REG(USART2)->ISR & USART_ISR_TC)){
+		next = txBusyPs;
+	}
+	if(rxCount != 0 && rxPs[rxHead] < next){
+		next = rxPs[rxHead];
+	}
+	return(next);
+}
+
+/*************************************************************
+* Sim_UartWrite() - Side effects of a USART2 register write.
+* offset	- Register offset.
+* before	- Register value before the write.
+* No return value.
+*************************************************************/
+static void Sim_UartWrite(uint32_t offset, uint32_t before){
+	USART_TypeDef *r = SIM_REG(USART2);
+
+	switch(offset){
+		case offsetof(USART_TypeDef, TDR):{
+			if(!(r->CR1 & USART_CR1_TE)){
+				break;
+			}
+			if(r->ISR & USART_ISR_TC){
+				r->ISR &= ~USART_ISR_TC;
+				txBusyPs = nowPs + Sim_UartCharPs();
+				if(uartSink != NULL){
+					uartSink((char)r->TDR);
+				}
+			}
+			else{
+				txHolding = 1;
+				txNext = r->TDR;
+				r->ISR &= ~USART_ISR_TXE;
+			}
+			break;
+		}
+		case offsetof(USART_TypeDef, CR1):{
+			FORCE_BITS(r->ISR, USART_ISR_TEACK, ((r->CR1 & USART_CR1_UE) && (r->CR1 & USART_CR1_TE)) ? USART_ISR_TEACK : 0);
+			FORCE_BITS(r->ISR, USART_ISR_REACK, ((r->CR1 & USART_CR1_UE) && (r->CR1 & USART_CR1_RE)) ? USART_ISR_REACK : 0);
+			break;
+		}
+		case offsetof(USART_TypeDef, ISR):{
+			r->ISR = before;														// Read only
+			break;
+		}
+		case offsetof(USART_TypeDef, ICR):{
+			r->ISR &= ~(r->ICR & (USART_ICR_TCCF | USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NCF | USART_ICR_PECF));
+			r->ICR = 0;
+			break;
+		}
+		case offsetof(USART_TypeDef, RQR):{
+			if(r->RQR & USART_RQR_RXFRQ){
+				r->ISR &= ~USART_ISR_RXNE;
+			}
+			r->RQR = 0;
+			break;
+		}
+		default:{
+			break;
+		}
+	}
+}
+
+/*************************************************************
+* Sim_UartIrq() - Raise the USART2 interrupt line.
+* level		- Line levels, one bit per IRQ.
+* No return value.
+*************************************************************/
+static void Sim_UartIrq(uint32_t *level){
+	const USART_TypeDef *r = SIM_REG(USART2);
+	uint32_t isr = r->ISR;
+	uint32_t cr1 = r->CR1;
+
+	if(((cr1 & USART_CR1_TXEIE) && (isr & USART_ISR_TXE)) || ((cr1 & USART_CR1_TCIE) && (isr & USART_ISR_TC))
+		|| ((cr1 & USART_CR1_RXNEIE) && (isr & (USART_ISR_RXNE | USART_ISR_ORE)))){
+		level[USART2_IRQn >> 5] |= 1UL << (USART2_IRQn & 31);
+	}
+}
+
+
+/******************************************************************
+*												GPIO AND EXTI																*
+******************************************************************/
+
+/*************************************************************
+* Sim_GpioIdr() - Pin levels a port reads back.
+* port		- Port index (0 = GPIOA).
+* Returns IDR.
+*************************************************************/
+static uint32_t Sim_GpioIdr(uint32_t port){
+	GPIO_TypeDef *app = (GPIO_TypeDef *)(uintptr_t)(GPIOA_BASE + port * 0x400UL);
+	const GPIO_TypeDef *r = (const GPIO_TypeDef *)Sim_Word((uint32_t)(uintptr_t)app);
+	uint32_t idr = 0;
+	uint32_t mode, pull, outside;
+
+	for(uint32_t pin = 0; pin < 16; pin++){
+		mode = (r->MODER >> (pin * 2)) & 3UL;
+		pull = (r->PUPDR >> (pin * 2)) & 3UL;
+		if(gpioDriven[port] & (1UL << pin)){
+			outside = (gpioLevel[port] >> pin) & 1UL;
+		}
+		else{
+			outside = (pull == GPIO_PUPD_PU);
+		}
+		if(mode == GPIO_MODE_OUT && (!(r->OTYPER & (1UL << pin)) || !(r->ODR & (1UL << pin)))){
+			outside = (r->ODR >> pin) & 1UL;							// Push-pull, or open drain pulling low
+		}
+		idr |= outside << pin;
+	}
+	if(gpioHook != NULL){
+		idr = gpioHook(app, idr) & 0xFFFFUL;
+	}
+	return(idr);
+}
+
+/*************************************************************
+* Sim_ExtiEdge() - Feed an input edge to EXTI.
+* port		- Port index (0 = GPIOA).
+* pin			- Pin number (EXTI line).
+* rising	- 1 for a rising edge, 0 for falling.
+* No return value.
+*************************************************************/
+static void Sim_ExtiEdge(uint32_t port, uint32_t pin, uint8_t rising){
+	EXTI_TypeDef *exti = SIM_REG(EXTI);
+	const SYSCFG_TypeDef *syscfg = SIM_REG(SYSCFG);
+	uint32_t bit = 1UL << pin;
+
+	if(((syscfg->EXTICR[pin >> 2] >> ((pin & 3UL) * 4)) & 0xFUL) != port){
+		return;
+	}
+	if(!((rising ? exti->RTSR : exti->FTSR) & bit)){
+		return;
+	}
+	if(exti->IMR & bit){
+		exti->PR |= bit;
+	}
+	if(exti->EMR & bit){
+		eventRegister = 1;
+	}
+}
+
+/*************************************************************
+* Sim_ExtiIrqs() - Raise the EXTI interrupt lines.
+* level		- Line levels, one bit per IRQ.
+* No return value.
+*************************************************************/
+static void Sim_ExtiIrqs(uint32_t *level){
+	static const int16_t lines[16] = {
+		EXTI0_IRQn, EXTI1_IRQn, EXTI2_TSC_IRQn, EXTI3_IRQn, EXTI4_IRQn,
+		EXTI9_5_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn,
+		EXTI15_10_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn
+	};
+	const EXTI_TypeDef *exti = SIM_REG(EXTI);
+	uint32_t raised = exti->PR & exti->IMR & 0xFFFFUL;
+
+	for(uint32_t line = 0; raised != 0; line++, raised >>= 1){
+		if(raised & 1UL){
+			level[lines[line] >> 5] |= 1UL << (lines[line] & 31);
+		}
+	}
+}
+
+/*************************************************************
+* Sim_GpioWrite() - Side effects of a GPIO or EXTI register write.
+* addr		- Register address.
+* before	- Register value before the write.
+* No return value.
+*************************************************************/
+static void Sim_GpioWrite(uint32_t addr, uint32_t before){
+	uint32_t *word = Sim_Word(addr);
+	uint32_t port = (addr - GPIOA_BASE) / 0x400UL;
+	GPIO_TypeDef *r;
+
+	if(addr - EXTI_BASE < 0x400UL){
+		if(addr == (uint32_t)(uintptr_t)&EXTI->PR){
+			*word = before & ~*word;														// rc_w1
+		}
+		else if(addr == (uint32_t)(uintptr_t)&EXTI->SWIER){
+			SIM_REG(EXTI)->PR |= *word & SIM_REG(EXTI)->IMR;
+		}
+		return;
+	}
+	if(addr - GPIOA_BASE >= 0x2000UL){
+		return;
+	}
+	r = (GPIO_TypeDef *)Sim_Word(GPIOA_BASE + port * 0x400UL);
+	switch(addr & 0x3FFUL){
+		case offsetof(GPIO_TypeDef, BSRR):{
+			r->ODR = (r->ODR | (r->BSRR & 0xFFFFUL)) & ~(r->BSRR >> 16);
+			r->BSRR = 0;
+			break;
+		}
+		case offsetof(GPIO_TypeDef, BRR):{
+			r->ODR &= ~(r->BRR & 0xFFFFUL);
+			r->BRR = 0;
+			break;
+		}
+		case offsetof(GPIO_TypeDef, IDR):{
+			r->IDR = before;																		// Read only
+			break;
+		}
+		default:{
+			break;
+		}
+	}
+}
+
+
+/******************************************************************
+*														RCC																		*
+******************************************************************/
+
+/*************************************************************
+* Sim_RccWrite() - Oscillators and the clock switch settle at once.
+* No inputs.
+* No return value.
+*************************************************************/
+static void Sim_RccWrite(void){
+	RCC_TypeDef *r = SIM_REG(RCC);
+
+	FORCE_BITS(r->CR, RCC_CR_HSIRDY, (r->CR & RCC_CR_HSION) ? RCC_CR_HSIRDY : 0);
+	FORCE_BITS(r->CR, RCC_CR_HSERDY, (r->CR & RCC_CR_HSEON) ? RCC_CR_HSERDY : 0);
+	FORCE_BITS(r->CR, RCC_CR_PLLRDY, (r->CR & RCC_CR_PLLON) ? RCC_CR_PLLRDY : 0);
+	FORCE_BITS(r->CFGR, RCC_CFGR_SWS, (r->CFGR & RCC_CFGR_SW) << 2);
+	FORCE_BITS(r->BDCR, RCC_BDCR_LSERDY, (r->BDCR & RCC_BDCR_LSEON) ? RCC_BDCR_LSERDY : 0);
+	FORCE_BITS(r->CSR, RCC_CSR_LSIRDY, (r->CSR & RCC_CSR_LSION) ? RCC_CSR_LSIRDY : 0);
+}
+
+
+/******************************************************************
+*														NVIC AND SCB														*
+******************************************************************/
+
+/*************************************************************
+* Sim_CoreRefresh() - Show the NVIC and SCB state in their registers.
+* No inputs.
+* No return value.
+*************************************************************/
+static void Sim_CoreRefresh(void){
+	NVIC_Type *nvic = SIM_REG(NVIC);
+	SCB_Type *scb = SIM_REG(SCB);
+	uint32_t icsr = 0;
+
+	for(uint32_t i = 0; i < SIM_IRQ_WORDS; i++){
+		nvic->ISER[i] = nvicEnabled[i];
+		nvic->ICER[i] = nvicEnabled[i];
+		nvic->ISPR[i] = nvicPending[i];
+		nvic->ICPR[i] = nvicPending[i];
+		nvic->IABR[i] = nvicActive[i];
+	}
+	icsr |= pendSv ? SCB_ICSR_PENDSVSET_Msk : 0;
+	icsr |= sysTickPending ? (1UL << 26) : 0;
+	icsr |= depth ? active[depth - 1] : (inPendSv ? SIM_EXC_PENDSV : 0);
+	scb->ICSR = icsr;
+}
+
+/*************************************************************
+* Sim_CoreWrite() - Side effects of a core register write.
+* addr		- Register address.
+* before	- Register value before the write.
+* No return value.
+*************************************************************/
+static void Sim_CoreWrite(uint32_t addr, uint32_t before){
+	uint32_t value = *Sim_Word(addr);
+	uint32_t offset;
+
+	if(addr - NVIC_BASE < offsetof(NVIC_Type, IP)){
+		offset = addr - NVIC_BASE;
+		if(offset / 0x80UL == 0){
+			nvicEnabled[(offset & 0x7FUL) / 4] |= value;
+		}
+		else if(offset / 0x80UL == 1){
+			nvicEnabled[(offset & 0x7FUL) / 4] &= ~value;
+		}
+		else if(offset / 0x80UL == 2){
+			nvicPending[(offset & 0x7FUL) / 4] |= value;
+		}
+		else if(offset / 0x80UL == 3){
+			nvicPending[(offset & 0x7FUL) / 4] &= ~value;
+		}
+	}
+	else if(addr == (uint32_t)(uintptr_t)&SCB->ICSR){
+		if(value & SCB_ICSR_PENDSVSET_Msk){
+			pendSv = 1;
+		}
+		if(value & SCB_ICSR_PENDSVCLR_Msk){
+			pendSv = 0;
+		}
+		if(value & (1UL << 26)){
+			sysTickPending = 1;
+		}
+		if(value & (1UL << 25)){
+			sysTickPending = 0;
+		}
+	}
+	else if(addr == (uint32_t)(uintptr_t)&SysTick->CTRL){
+		SysTick_Type *r = SIM_REG(SysTick);
+
+		FORCE_BITS(r->CTRL, SysTick_CTRL_COUNTFLAG_Msk, before);				// Read only
+		if((r->CTRL & SysTick_CTRL_ENABLE_Msk) && !(before & SysTick_CTRL_ENABLE_Msk)){
+			sysTickFrac = 0;
+		}
+	}
+	else if(addr == (uint32_t)(uintptr_t)&SysTick->VAL){
+		SIM_REG(SysTick)->VAL = 0;
+		SIM_REG(SysTick)->CTRL &= ~SysTick_CTRL_COUNTFLAG_Msk;
+	}
+	Sim_CoreRefresh();
+}
+
+
+/******************************************************************
+*												INTERRUPTS AND TIME														*
+******************************************************************/
+
+/*************************************************************
+* Sim_Priority() - Priority of an exception.
+* exception	- Exception number.
+* Returns the priority (0 highest to 15).
+*************************************************************/
+static uint32_t Sim_Priority(uint32_t exception){
+	const SCB_Type *scb = SIM_REG(SCB);
+
+	if(exception == SIM_EXC_PENDSV){
+		return(scb->SHP[10] >> (8U - __NVIC_PRIO_BITS));
+	}
+	if(exception == SIM_EXC_SYSTICK){
+		return(scb->SHP[11] >> (8U - __NVIC_PRIO_BITS));
+	}
+	return(SIM_REG(NVIC)->IP[exception - SIM_EXC_IRQ0] >> (8U - __NVIC_PRIO_BITS));
+}
+
+/*************************************************************
+* Sim_Levels() - Pend every interrupt line that is raised and not being handled.
+* No inputs.
+* No return value.
+*************************************************************/
+static void Sim_Levels(void){
+	uint32_t level[SIM_IRQ_WORDS] = {0};
+
+	Sim_TimerIrqs(level);
+	Sim_UartIrq(level);
+	Sim_ExtiIrqs(level);
+	for(uint32_t i = 0; i < SIM_IRQ_WORDS; i++){
+		nvicPending[i] |= level[i] & ~nvicActive[i];
+	}
+	Sim_CoreRefresh();
+}
+
+/*************************************************************
+* Sim_Highest() - Pending exception that would preempt the running code.
+* No inputs.
+* Returns the exception number, or 0 if none (PRIMASK is not checked).
+*************************************************************/
+static uint32_t Sim_Highest(void){
+	uint32_t current = depth ? Sim_Priority(active[depth - 1]) : SIM_THREAD_PRIORITY;
+	uint32_t best = 0;
+	uint32_t priority;
+
+	if(inPendSv){
+		current = Sim_Priority(SIM_EXC_PENDSV);
+	}
+	if(pendSv && depth == 0 && !inPendSv && Sim_Priority(SIM_EXC_PENDSV) < current){
+		best = SIM_EXC_PENDSV;
+		current = Sim_Priority(SIM_EXC_PENDSV);
+	}
+	if(sysTickPending && Sim_Priority(SIM_EXC_SYSTICK) < current){
+		best = SIM_EXC_SYSTICK;
+		current = Sim_Priority(SIM_EXC_SYSTICK);
+	}
+	for(uint32_t irq = 0; irq < SIM_IRQ_COUNT; irq++){
+		if((nvicPending[irq >> 5] & nvicEnabled[irq >> 5] & (1UL << (irq & 31))) == 0){
+			continue;
+		}
+		priority = Sim_Priority(SIM_EXC_IRQ0 + irq);
+		if(priority < current){
+			best = SIM_EXC_IRQ0 + irq;
+			current = priority;
+		}
+	}
+	return(best);
+}
+
+/*************************************************************
+* Sim_Dispatch() - Take pending interrupts in priority order while PRIMASK is clear.
+* No inputs.
+* No return value.
+*************************************************************/
+static void Sim_Dispatch(void){
+	uint32_t exception, irq = 0;
+	void (*handler)(void);
+
+	while(!primask){
+		Sim_Levels();
+		exception = Sim_Highest();
+		if(exception == 0){
+			return;
+		}
+		handler = Sim_Vectors[exception];
+		if(handler == NULL){
+			Sim_Fail("exception without a handler");
+		}
+		exclusive = NULL;															// Exception entry clears the monitor
+
+		// PendSV switches threads, host/KernelPort.c returns through Sim_PendSvReturn()
+		if(exception == SIM_EXC_PENDSV){
+			pendSv = 0;
+			inPendSv = 1;
+			handler();
+			inPendSv = 0;
+			continue;
+		}
+
+		if(depth >= SIM_MAX_NESTING){
+			Sim_Fail("exceptions nested too deep");
+		}
+		if(exception == SIM_EXC_SYSTICK){
+			sysTickPending = 0;
+		}
+		else{
+			irq = exception - SIM_EXC_IRQ0;
+			nvicPending[irq >> 5] &= ~(1UL << (irq & 31));
+			nvicActive[irq >> 5] |= 1UL << (irq & 31);
+		}
+		active[depth++] = (uint8_t)exception;
+		handler();
+		depth--;
+		if(exception != SIM_EXC_SYSTICK){
+			nvicActive[irq >> 5] &= ~(1UL << (irq & 31));
+		}
+	}
+}
+
+/*************************************************************
+* Sim_SyncAll() - Bring every model up to now.
+* No inputs.
+* No return value.
+*************************************************************/
+static void Sim_SyncAll(void){
+	for(uint32_t i = 0; i < SIM_TIMERS; i++){
+		Sim_TimerSync(&timers[i]);
+	}
+	Sim_SysTickSync();
+	Sim_CycleSync();
+	Sim_UartSync();
+}
+
+/*************************************************************
+* Sim_Next() - Earliest model or scheduled event.
+* No inputs.
+* Returns the time (ps) or SIM_NEVER.
+*************************************************************/
+static uint64_t Sim_Next(void){
+	uint64_t next = (endFn != NULL) ? endPs : SIM_NEVER;
+	uint64_t t;
+
+	Sim_SyncAll();
+	for(uint32_t i = 0; i < SIM_TIMERS; i++){
+		t = Sim_TimerNext(&timers[i]);
+		next = (t < next) ? t : next;
+	}
+	t = Sim_SysTickNext();
+	next = (t < next) ? t : next;
+	t = Sim_UartNext();
+	next = (t < next) ? t : next;
+	for(uint32_t i = 0; i < eventCount; i++){
+		next = (events[i].ps < next) ? events[i].ps : next;
+	}
+	return((next < nowPs) ? nowPs : next);
+}
+
+/*************************************************************
+* Sim_RunEvents() - Call the Sim_At() events that are due.
+* No inputs.
+* No return value.
+*************************************************************/
+static void Sim_RunEvents(void){
+	Sim_Event due;
+
+	for(uint32_t i = 0; i < eventCount; ){
+		if(events[i].ps > nowPs){
+			i++;
+			continue;
+		}
+		due = events[i];
+		events[i] = events[--eventCount];
+		due.fn(due.arg);
+		i = 0;																				// The event may have scheduled others
+	}
+	if(nowPs >= endPs && endFn != NULL){
+		void (*fn)(void) = endFn;
+
+		endFn = NULL;
+		endPs = SIM_NEVER;
+		fn();
+	}
+}
+
+/*************************************************************
+* Sim_Advance() - Move virtual time forward, stopping at every event on the way.
+* ps			- Time to add.
+* No return value.
+*************************************************************/
+static void Sim_Advance(uint64_t ps){
+	uint64_t target = nowPs + ps;
+	uint64_t next;
+
+	while((next = Sim_Next()) <= target){
+		nowPs = next;
+		Sim_SyncAll();
+		Sim_RunEvents();
+		if(Sim_Next() <= next && next != target){
+			Sim_Fail("model event did not move on");
+		}
+	}
+	nowPs = target;
+	Sim_SyncAll();
+	Sim_RunEvents();
+}
+
+/*************************************************************
+* Sim_Sleep() - WFI/WFE: skip to the next event until an interrupt can be taken.
+*								In stop mode (SLEEPDEEP) only EXTI wakes the core. The timers
+*								keep counting here, unlike the board, and their interrupts wait.
+* wfe			- Also wake on the event register.
+* No return value.
+*************************************************************/
+static void Sim_Sleep(uint8_t wfe){
+	RCC_TypeDef *rcc = SIM_REG(RCC);
+	uint8_t stop = (SIM_REG(SCB)->SCR & SCB_SCR_SLEEPDEEP_Msk) != 0;
+	uint64_t next;
+
+	while(1){
+		Sim_Levels();
+		if(stop && ((wfe && eventRegister) || (SIM_REG(EXTI)->PR & SIM_REG(EXTI)->IMR))){
+			break;
+		}
+		if(!stop && (Sim_Highest() != 0 || (wfe && eventRegister))){
+			break;
+		}
+		next = Sim_Next();
+		if(next == SIM_NEVER){
+			Sim_Fail("sleeping with nothing left to wake it");
+		}
+		Sim_Advance((next > nowPs) ? next - nowPs : 0);
+	}
+
+	// Stop mode wakes on HSI with HSE and the PLL off
+	if(stop){
+		Sim_SyncAll();
+		rcc->CR = (rcc->CR | RCC_CR_HSION) & ~(RCC_CR_HSEON | RCC_CR_PLLON);
+		rcc->CFGR &= ~RCC_CFGR_SW;
+		Sim_RccWrite();
+	}
+	eventRegister = 0;
+	Sim_Dispatch();
+}
+
+
+/******************************************************************
+*														TRAPS																	*
+******************************************************************/
+
+/*************************************************************
+* Sim_Refresh() - Compute the value a register reads as.
+* addr		- Word address.
+* No return value.
+*************************************************************/
+static void Sim_Refresh(uint32_t addr){
+	uint32_t target, bit;
+
+	if(addr - PERIPH_BB_BASE < regions[1].size){
+		target = (PERIPH_BASE + (addr - PERIPH_BB_BASE) / 32) & ~3UL;
+		bit = ((addr - PERIPH_BB_BASE) / 4) & 31UL;
+		Sim_Refresh(target);
+		*Sim_Word(addr) = (*Sim_Word(target) >> bit) & 1UL;
+	}
+	else if(addr - GPIOA_BASE < 0x2000UL && (addr & 0x3FFUL) == offsetof(GPIO_TypeDef, IDR)){
+		*Sim_Word(addr) = Sim_GpioIdr((addr - GPIOA_BASE) / 0x400UL);
+	}
+}
+
+/*************************************************************
+* Sim_Written() - Apply the side effects of a register write.
+* addr		- Word address.
+* before	- Word value before the write.
+* No return value.
+*************************************************************/
+static void Sim_Written(uint32_t addr, uint32_t before){
+	Sim_Timer *t = Sim_TimerFind(addr & ~0x3FFUL);
+	uint32_t target, bit, *word;
+
+	if(addr - PERIPH_BB_BASE < regions[1].size){
+		// Bit-band write: read-modify-write of the target word
+		target = (PERIPH_BASE + (addr - PERIPH_BB_BASE) / 32) & ~3UL;
+		bit = ((addr - PERIPH_BB_BASE) / 4) & 31UL;
+		word = Sim_Word(target);
+		before = *word;
+		FORCE_BITS(*word, 1UL << bit, (*Sim_Word(addr) & 1UL) << bit);
+		Sim_Written(target, before);
+		return;
+	}
+	if(t != NULL){
+		Sim_TimerWrite(t, addr & 0x3FFUL, before);
+	}
+	else if(addr - USART2_BASE < 0x400UL){
+		Sim_UartWrite(addr & 0x3FFUL, before);
+	}
+	else if(addr - RCC_BASE < 0x400UL){
+		Sim_RccWrite();
+	}
+	else if(addr - GPIOA_BASE < 0x2000UL || addr - EXTI_BASE < 0x400UL){
+		Sim_GpioWrite(addr, before);
+	}
+	else if(addr >= 0xE0000000UL){
+		Sim_CoreWrite(addr, before);
+	}
+}
+
+/*************************************************************
+* Sim_Read() - Side effects of a register read.
+* addr		- Word address.
+* No return value.
+*************************************************************/
+static void Sim_Read(uint32_t addr){
+	if(addr == (uint32_t)(uintptr_t)&SysTick->CTRL){
+		SIM_REG(SysTick)->CTRL &= ~SysTick_CTRL_COUNTFLAG_Msk;
+	}
+	else if(addr == (uint32_t)(uintptr_t)&USART2->RDR){
+		SIM_REG(USART2)->ISR &= ~USART_ISR_RXNE;
+	}
+	else if(Sim_TimerFind(addr & ~0x3FFUL) != NULL){
+		Sim_TimerRead(addr & ~0x3FFUL, addr & 0x3FFUL);
+	}
+}
+
+/*************************************************************
+* Sim_Cost() - Virtual time an access takes.
+* addr		- Word address.
+* write		- Access was a write.
+* Returns the time (ps).
+*************************************************************/
+static uint64_t Sim_Cost(uint32_t addr, uint8_t write){
+	uint64_t cost = Sim_CyclesPs(SIM_ACCESS_CYCLES);
+	uint64_t untilNext, poll;
+	uint32_t shift;
+
+	// A loop reading one register is polling: let time pass faster, up to the next event.
+	// The cycle counter is read to time code, back to back when the code is short.
+	if(write || addr != pollAddr || addr == (uint32_t)(uintptr_t)&DWT->CYCCNT){
+		pollAddr = (write || addr == (uint32_t)(uintptr_t)&DWT->CYCCNT) ? 0 : addr;
+		pollStreak = 0;
+		return(cost);
+	}
+	if(++pollStreak < SIM_POLL_STREAK){
+		return(cost);
+	}
+
+	// 1us per read, doubling every SIM_POLL_DOUBLE reads (overshoots a busy-wait by
+	// about 1/SIM_POLL_DOUBLE) up to SIM_POLL_MAX_US
+	shift = (pollStreak - SIM_POLL_STREAK) / SIM_POLL_DOUBLE;
+	poll = ((shift >= 10) ? SIM_POLL_MAX_US : (1ULL << shift)) * SIM_PS_PER_US;
+	untilNext = Sim_Next() - nowPs;
+	if(untilNext > poll){
+		untilNext = poll;
+	}
+	return((untilNext > cost) ? untilNext : cost);
+}
+
+/*************************************************************
+* Sim_Segv() - A register access faulted: open the page and single step.
+* sig			- SIGSEGV.
+* info		- Fault address.
+* context	- Interrupted thread.
+* No return value.
+*************************************************************/
+static void Sim_Segv(int sig, siginfo_t *info, void *context){
+	ucontext_t *uc = context;
+	uintptr_t fault = (uintptr_t)info->si_addr;
+	uint32_t addr = (uint32_t)fault & ~3UL;
+	uint32_t *word;
+	Sim_Access *access;
+
+	(void)sig;
+	if(fault > 0xFFFFFFFFUL || (word = Sim_Word(addr)) == NULL || inFlightCount >= SIM_MAX_INFLIGHT){
+		signal(SIGSEGV, SIG_DFL);
+		fprintf(stderr, "sim: invalid access to %p\n", info->si_addr);
+		return;																				// Faults again without the handler
+	}
+
+	Sim_SyncAll();
+	Sim_Refresh(addr);
+
+	access = &inFlight[inFlightCount++];
+	access->page = addr & ~(SIM_PAGE - 1);
+	access->addr = addr;
+	access->before = *word;
+	access->write = (uc->uc_mcontext.gregs[REG_ERR] & SIM_X86_ERR_WRITE) != 0;
+	mprotect((void *)(uintptr_t)access->page, SIM_PAGE, PROT_READ | PROT_WRITE);
+	uc->uc_mcontext.gregs[REG_EFL] |= SIM_X86_TRAP_FLAG;
+}
+
+/*************************************************************
+* Sim_Trap() - The access completed: close the page and model it.
+* sig			- SIGTRAP.
+* info		- Unused.
+* context	- Interrupted thread.
+* No return value.
+*************************************************************/
+static void Sim_Trap(int sig, siginfo_t *info, void *context){
+	ucontext_t *uc = context;
+	Sim_Access done[SIM_MAX_INFLIGHT];
+	uint32_t count = inFlightCount;
+	uint32_t value;
+	uint8_t write;
+
+	(void)sig;
+	(void)info;
+	uc->uc_mcontext.gregs[REG_EFL] &= ~SIM_X86_TRAP_FLAG;
+	memcpy(done, inFlight, sizeof(done));
+	inFlightCount = 0;
+
+	for(uint32_t i = 0; i < count; i++){
+		mprotect((void *)(uintptr_t)done[i].page, SIM_PAGE, PROT_NONE);
+	}
+	for(uint32_t i = 0; i < count; i++){
+		value = *Sim_Word(done[i].addr);
+		write = done[i].write || value != done[i].before;
+		if(write){
+			writes++;
+			Sim_Written(done[i].addr, done[i].before);
+		}
+		else{
+			reads++;
+			Sim_Read(done[i].addr);
+		}
+		if(accessHook != NULL){
+			accessHook(done[i].addr, value, write);
+		}
+		Sim_Advance(Sim_Cost(done[i].addr, write));
+	}
+	Sim_Dispatch();
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Sim_Init() - Map the register blocks and install the trap handlers (host/Startup.c).
+* No inputs.
+* No return value.
+*************************************************************/
+void Sim_Init(void){
+	struct sigaction action;
+	int fd;
+
+	if(ready){
+		return;
+	}
+	for(uint32_t i = 0; i < SIM_REGIONS; i++){
+		fd = memfd_create("sim", 0);
+		if(fd < 0 || ftruncate(fd, regions[i].size) != 0){
+			Sim_Fail("no memory for registers");
+		}
+		if(mmap((void *)(uintptr_t)regions[i].base, regions[i].size, PROT_NONE, MAP_SHARED | MAP_FIXED_NOREPLACE,
+			fd, 0) != (void *)(uintptr_t)regions[i].base){
+			Sim_Fail("register addresses already in use (build with -no-pie)");
+		}
+		regions[i].view = mmap(NULL, regions[i].size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if(regions[i].view == MAP_FAILED){
+			Sim_Fail("no memory for registers");
+		}
+		close(fd);
+	}
+
+	memset(&action, 0, sizeof(action));
+	action.sa_flags = SA_SIGINFO | SA_NODEFER;
+	action.sa_sigaction = Sim_Segv;
+	sigaction(SIGSEGV, &action, NULL);
+	action.sa_sigaction = Sim_Trap;
+	sigaction(SIGTRAP, &action, NULL);
+
+	// Reset values
+	SIM_REG(RCC)->CR = RCC_CR_HSION | RCC_CR_HSIRDY | (16UL << RCC_CR_HSITRIM_Pos);
+	SIM_REG(USART1)->ISR = USART_ISR_TXE | USART_ISR_TC;
+	SIM_REG(USART2)->ISR = USART_ISR_TXE | USART_ISR_TC;
+	SIM_REG(USART3)->ISR = USART_ISR_TXE | USART_ISR_TC;
+	for(uint32_t i = 0; i < SIM_TIMERS; i++){
+		((TIM_TypeDef *)Sim_Word(timers[i].base))->ARR = timers[i].wide ? 0xFFFFFFFFUL : 0xFFFFUL;
+	}
+	SIM_REG(GPIOA)->MODER = 0xA8000000UL;									// SWD pins
+	SIM_REG(GPIOB)->MODER = 0x00000280UL;
+	Sim_Poke((volatile void *)&SysTick->CALIB, 9000UL);
+	Sim_Poke((volatile void *)&SCB->CPUID, 0x410FC241UL);
+	ready = 1;
+}
+
+/*************************************************************
+* Sim_TimePs() - Virtual time since reset.
+* No inputs.
+* Returns the time (ps).
+*************************************************************/
+uint64_t Sim_TimePs(void){
+	return(nowPs);
+}
+
+/*************************************************************
+* Sim_TimeUs() - Virtual time since reset.
+* No inputs.
+* Returns the time (us).
+*************************************************************/
+uint64_t Sim_TimeUs(void){
+	return(nowPs / SIM_PS_PER_US);
+}
+
+/*************************************************************
+* Sim_Run() - Let time pass in thread mode, taking interrupts as they come.
+* us			- Time to run (us).
+* No return value.
+*************************************************************/
+void Sim_Run(uint64_t us){
+	uint64_t target = nowPs + us * SIM_PS_PER_US;
+	uint64_t next;
+
+	Sim_Dispatch();
+	while(nowPs < target){
+		next = Sim_Next();
+		Sim_Advance(((next < target) ? next : target) - nowPs);
+		Sim_Dispatch();
+	}
+}
+
+/*************************************************************
+* Sim_At() - Call a function at a virtual time, from whatever code is running.
+* us			- Time (us since reset).
+* fn			- Function, fn(arg).
+* arg			- Argument.
+* No return value.
+*************************************************************/
+void Sim_At(uint64_t us, void (*fn)(void *arg), void *arg){
+	if(eventCount >= SIM_MAX_EVENTS){
+		Sim_Fail("too many scheduled events");
+	}
+	events[eventCount].ps = us * SIM_PS_PER_US;
+	events[eventCount].fn = fn;
+	events[eventCount].arg = arg;
+	eventCount++;
+}
+
+/*************************************************************
+* Sim_SetEnd() - Call a function once virtual time reaches a limit.
+* us			- Time (us since reset).
+* fn			- Function, typically checks results and exits.
+* No return value.
+*************************************************************/
+void Sim_SetEnd(uint64_t us, void (*fn)(void)){
+	endPs = us * SIM_PS_PER_US;
+	endFn = fn;
+}
+
+/*************************************************************
+* Sim_Peek() - Read a register without it counting as a firmware access.
+* reg			- Register (CMSIS address).
+* Returns the value.
+*************************************************************/
+uint32_t Sim_Peek(const volatile void *reg){
+	uint32_t addr = (uint32_t)(uintptr_t)reg;
+
+	Sim_SyncAll();
+	Sim_Refresh(addr & ~3UL);
+	return(*Sim_Word(addr) >> ((addr & 3UL) * 8));
+}
+
+/*************************************************************
+* Sim_Poke() - Set a register behind the firmware's back (no side effects).
+* reg			- Register (CMSIS address).
+* value		- Value.
+* No return value.
+*************************************************************/
+void Sim_Poke(volatile void *reg, uint32_t value){
+	*Sim_Word((uint32_t)(uintptr_t)reg) = value;
+}
+
+/*************************************************************
+* Sim_SetAccessHook() - Observe every firmware register access.
+* fn			- Observer, or NULL.
+* No return value.
+*************************************************************/
+void Sim_SetAccessHook(Sim_AccessFn fn){
+	accessHook = fn;
+}
+
+/*************************************************************
+* Sim_GetCounts() - Register accesses since Sim_ResetCounts().
+* readCount		- Receives the reads.
+* writeCount	- Receives the writes.
+* No return value.
+*************************************************************/
+void Sim_GetCounts(uint32_t *readCount, uint32_t *writeCount){
+	*readCount = reads;
+	*writeCount = writes;
+}
+
+/*************************************************************
+* Sim_ResetCounts() - Zero the register access counts.
+* No inputs.
+* No return value.
+*************************************************************/
+void Sim_ResetCounts(void){
+	reads = 0;
+	writes = 0;
+}
+
+/*************************************************************
+* Sim_RegName() - Name of a register, e.g. "TIM6->ARR".
+* addr		- Register address.
+* buf			- Receives the name.
+* size		- Size of buf.
+* Returns buf.
+*************************************************************/
+const char *Sim_RegName(uint32_t addr, char *buf, uint32_t size){
+	for(uint32_t i = 0; i < SIM_BLOCKS; i++){
+		uint32_t offset = addr - blocks[i].base;
+
+		if(offset >= blocks[i].size){
+			continue;
+		}
+		for(const Sim_Field *field = blocks[i].fields; field != NULL && field->name != NULL; field++){
+			if(field->offset == (offset & ~3UL)){
+				snprintf(buf, size, "%s->%s", blocks[i].name, field->name);
+				return(buf);
+			}
+		}
+		snprintf(buf, size, "%s+0x%03lX", blocks[i].name, (unsigned long)offset);
+		return(buf);
+	}
+	snprintf(buf, size, "0x%08lX", (unsigned long)addr);
+	return(buf);
+}
+
+/*************************************************************
+* Sim_UartRx() - Characters arriving on USART2 RX, back to back from now.
+* text		- Characters.
+* No return value.
+*************************************************************/
+void Sim_UartRx(const char *text){
+	uint64_t at = nowPs;
+	uint32_t tail;
+
+	for(uint32_t i = 0; i < rxCount; i++){
+		tail = (rxHead + i) % SIM_RX_QUEUE;
+		at = (rxPs[tail] > at) ? rxPs[tail] : at;
+	}
+	for(; *text != '\0' && rxCount < SIM_RX_QUEUE; text++){
+		at += Sim_UartCharPs();
+		tail = (rxHead + rxCount) % SIM_RX_QUEUE;
+		rxPs[tail] = at;
+		rxChar[tail] = *text;
+		rxCount++;
+	}
+
+	// The first start bit is a falling edge on PA3 (wakes STOP through EXTI3)
+	Sim_ExtiEdge(0, 3, 0);
+}
+
+/*************************************************************
+* Sim_SetUartSink() - Receive every character USART2 sends.
+* fn			- Receiver, or NULL to drop them.
+* No return value.
+*************************************************************/
+void Sim_SetUartSink(void (*fn)(char c)){
+	uartSink = fn;
+}
+
+/*************************************************************
+* Sim_GpioInput() - Drive an input pin from outside.
+* port		- GPIOx.
+* pin			- Pin number.
+* level		- 0 or 1.
+* No return value.
+*************************************************************/
+void Sim_GpioInput(GPIO_TypeDef *port, uint8_t pin, uint8_t level){
+	uint32_t index = ((uint32_t)(uintptr_t)port - GPIOA_BASE) / 0x400UL;
+	uint32_t before = (Sim_GpioIdr(index) >> pin) & 1UL;
+
+	gpioDriven[index] |= 1UL << pin;
+	FORCE_BITS(gpioLevel[index], 1UL << pin, (uint32_t)(level != 0) << pin);
+	if(((Sim_GpioIdr(index) >> pin) & 1UL) != before){
+		Sim_ExtiEdge(index, pin, level != 0);
+	}
+}
+
+/*************************************************************
+* Sim_SetGpioHook() - Compute inputs that depend on outputs (e.g. a key matrix).
+* fn			- Called on every IDR read with the port and the modelled IDR, returns IDR.
+* No return value.
+*************************************************************/
+void Sim_SetGpioHook(uint32_t (*fn)(GPIO_TypeDef *port, uint32_t idr)){
+	gpioHook = fn;
+}
+
+/*************************************************************
+* Sim_TimerCapture() - Input capture edge on a channel: CCRx = CNT, flag CCxIF.
+* timer		- TIMx.
+* channel	- 1 to 4.
+* No return value.
+*************************************************************/
+void Sim_TimerCapture(TIM_TypeDef *timer, uint8_t channel){
+	Sim_Timer *t = Sim_TimerFind((uint32_t)(uintptr_t)timer);
+	TIM_TypeDef *r = SIM_REG(timer);
+
+	Sim_TimerSync(t);
+	if(r->SR & (TIM_SR_CC1IF << (channel - 1))){
+		r->SR |= TIM_SR_CC1OF << (channel - 1);
+	}
+	*Sim_TimerCcr(r, channel) = r->CNT;
+	r->SR |= TIM_SR_CC1IF << (channel - 1);
+}
+
+/*************************************************************
+* Sim_TimerReset() - Slave reset mode trigger: the counter restarts from 0.
+* timer		- TIMx.
+* No return value.
+*************************************************************/
+void Sim_TimerReset(TIM_TypeDef *timer){
+	Sim_Timer *t = Sim_TimerFind((uint32_t)(uintptr_t)timer);
+	TIM_TypeDef *r = SIM_REG(timer);
+
+	Sim_TimerSync(t);
+	r->CNT = 0;
+	t->pscCount = 0;
+}
+
+/*************************************************************
+* Sim_Hclk() - Core and AHB clock.
+* No inputs.
+* Returns HCLK (Hz).
+*************************************************************/
+uint32_t Sim_Hclk(void){
+	uint32_t cfgr = SIM_REG(RCC)->CFGR;
+
+	return(Sim_Sysclk() >> ahbShift[(cfgr & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos]);
+}
+
+/*************************************************************
+* Sim_TimerClock() - Kernel clock of a timer.
+* timer		- TIMx.
+* Returns the clock (Hz).
+*************************************************************/
+uint32_t Sim_TimerClock(TIM_TypeDef *timer){
+	return(Sim_TimerHz(Sim_TimerFind((uint32_t)(uintptr_t)timer)));
+}
+
+/*************************************************************
+* Sim_UartClock() - USART2 kernel clock.
+* No inputs.
+* Returns the clock (Hz).
+*************************************************************/
+uint32_t Sim_UartClock(void){
+	return(Sim_UartHz());
+}
+
+/*************************************************************
+* Sim_PendSvReturn() - A thread resumed from PendSV_Handler (host/KernelPort.c).
+* No inputs.
+* No return value.
+*************************************************************/
+void Sim_PendSvReturn(void){
+	inPendSv = 0;
+}
+
+
+/******************************************************************
+*											CORE INTRINSICS (core_cm4.h)											*
+******************************************************************/
+
+/*************************************************************
+* Host_DisableIrq() - __disable_irq(): set PRIMASK.
+* No inputs.
+* No return value.
+*************************************************************/
+void Host_DisableIrq(void){
+	primask = 1;
+}
+
+/*************************************************************
+* Host_EnableIrq() - __enable_irq(): clear PRIMASK and take what is pending.
+* No inputs.
+* No return value.
+*************************************************************/
+void Host_EnableIrq(void){
+	primask = 0;
+	Sim_Dispatch();
+}
+
+/*************************************************************
+* Host_GetPrimask() - __get_PRIMASK().
+* No inputs.
+* Returns PRIMASK.
+*************************************************************/
+uint32_t Host_GetPrimask(void){
+	return(primask);
+}
+
+/*************************************************************
+* Host_SetPrimask() - __set_PRIMASK().
+* mask		- New PRIMASK.
+* No return value.
+*************************************************************/
+void Host_SetPrimask(uint32_t mask){
+	primask = (mask & 1UL);
+	Sim_Dispatch();
+}
+
+/*************************************************************
+* Host_GetIpsr() - __get_IPSR().
+* No inputs.
+* Returns the exception number being handled, 0 in thread mode.
+*************************************************************/
+uint32_t Host_GetIpsr(void){
+	return(depth ? active[depth - 1] : (inPendSv ? SIM_EXC_PENDSV : 0));
+}
+
+/*************************************************************
+* Host_GetMsp() - __get_MSP(): just below the top of the startup stack.
+* No inputs.
+* Returns the main stack pointer.
+*************************************************************/
+uint32_t Host_GetMsp(void){
+	return((uint32_t)(uintptr_t)&STACK$$Limit - SIM_MSP_USED);
+}
+
+/*************************************************************
+* Host_GetPsp() - __get_PSP(): tasks run on host threads, not the PSP.
+* No inputs.
+* Returns 0.
+*************************************************************/
+uint32_t Host_GetPsp(void){
+	return(0);
+}
+
+/*************************************************************
+* Host_SetPsp() - __set_PSP(): ignored.
+* psp		- Unused.
+* No return value.
+*************************************************************/
+void Host_SetPsp(uint32_t psp){
+	(void)psp;
+}
+
+/*************************************************************
+* Host_Wfi() - __WFI(): sleep until an interrupt could be taken.
+* No inputs.
+* No return value.
+*************************************************************/
+void Host_Wfi(void){
+	Sim_Sleep(0);
+}
+
+/*************************************************************
+* Host_Wfe() - __WFE(): sleep until an event or interrupt.
+* No inputs.
+* No return value.
+*************************************************************/
+void Host_Wfe(void){
+	if(eventRegister){
+		eventRegister = 0;
+		return;
+	}
+	Sim_Sleep(1);
+}
+
+/*************************************************************
+* Host_Sev() - __SEV(): set the event register.
+* No inputs.
+* No return value.
+*************************************************************/
+void Host_Sev(void){
+	eventRegister = 1;
+}
+
+/*************************************************************
+* Host_Ldrex() - __LDREXW(): load and reserve.
+* addr		- Word.
+* Returns the value.
+*************************************************************/
+uint32_t Host_Ldrex(volatile uint32_t *addr){
+	exclusive = addr;
+	return(*addr);
+}
+
+/*************************************************************
+* Host_Strex() - __STREXW(): store if the reservation still holds.
+* value		- Value.
+* addr		- Word.
+* Returns 0 if stored, 1 if an exception took the reservation.
+*************************************************************/
+uint32_t Host_Strex(uint32_t value, volatile uint32_t *addr){
+	if(exclusive != addr){
+		return(1);
+	}
+	exclusive = NULL;
+	*addr = value;
+	return(0);
+}
+
+/*************************************************************
+* Host_Clrex() - __CLREX(): drop the reservation.
+* No inputs.
+* No return value.
+*************************************************************/
+void Host_Clrex(void){
+	exclusive = NULL;
+}
@@ -0,0 +1,65 @@
+/********************************************************************************
+* Name: Sim.h (interface)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Simulated STM32F303RE for the host build.
+*							 The peripheral and core register blocks are mapped at their real
+*							 addresses with no access rights. Every driver access traps, is
+*							 single stepped and then modelled (timers, USART2, GPIO, EXTI,
+*							 RCC, SysTick, DWT, NVIC and the SCB), so the firmware runs
+*							 unchanged. Time is virtual: each register access costs a few
+*							 core cycles and WFI jumps straight to the next hardware event,
+*							 so runs are deterministic and faster than real time.
+*							 Interrupts are taken after any register access, WFI, or when
+*							 PRIMASK is cleared, by priority like the NVIC.
+********************************************************************************/
+
+#ifndef __Sim_H
+#define __Sim_H
+
+#include <stdint.h>
+#include "stm32f303xe.h"
+
+#define SIM_ACCESS_CYCLES		2				// Core cycles charged per register access
+#define SIM_POLL_STREAK			64			// Reads in a row without a write before a loop counts as polling
+#define SIM_POLL_DOUBLE			16			// Polling reads per doubling of their virtual time
+#define SIM_POLL_MAX_US			1000		// Most virtual time one polling read may take (us)
+#define SIM_MAX_EVENTS			64			// Sim_At() events waiting at once
+
+// Register access observer: addr is the word address, write is 0 for a read
+typedef void (*Sim_AccessFn)(uint32_t addr, uint32_t value, uint8_t write);
+
+void Sim_Init(void);
+
+// Virtual time
+uint64_t Sim_TimePs(void);
+uint64_t Sim_TimeUs(void);
+void Sim_Run(uint64_t us);
+void Sim_At(uint64_t us, void (*fn)(void *arg), void *arg);
+void Sim_SetEnd(uint64_t us, void (*fn)(void));
+
+// Register access
+uint32_t Sim_Peek(const volatile void *reg);
+void Sim_Poke(volatile void *reg, uint32_t value);
+void Sim_SetAccessHook(Sim_AccessFn fn);
+void Sim_GetCounts(uint32_t *reads, uint32_t *writes);
+void Sim_ResetCounts(void);
+const char *Sim_RegName(uint32_t addr, char *buf, uint32_t size);
+
+// Inputs
+void Sim_UartRx(const char *text);
+void Sim_SetUartSink(void (*fn)(char c));
+void Sim_GpioInput(GPIO_TypeDef *port, uint8_t pin, uint8_t level);
+void Sim_SetGpioHook(uint32_t (*fn)(GPIO_TypeDef *port, uint32_t idr));
+void Sim_TimerCapture(TIM_TypeDef *timer, uint8_t channel);
+void Sim_TimerReset(TIM_TypeDef *timer);
+
+// Clocks
+uint32_t Sim_Hclk(void);
+uint32_t Sim_TimerClock(TIM_TypeDef *timer);
+uint32_t Sim_UartClock(void);
+
+// Kernel port hooks (host/KernelPort.c)
+void Sim_PendSvReturn(void);
+
+#endif
@@ -0,0 +1,249 @@
+/********************************************************************************
+* Name: Startup.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Host build counterpart of startup_stm32f303xe.s: the stack and heap
+*							 areas (STACK$$Base/Limit, HEAP$$Base/Limit for StackMonitor.c),
+*							 the vector table Sim.c takes exceptions from, and the reset
+*							 sequence (SystemInit() before main()).
+*							 Handlers are weak references, so a vector the firmware does not
+*							 define is NULL and Sim.c stops if it is ever taken.
+********************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Sim.h"
+#include "system_stm32f3xx.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define STARTUP_STACK_SIZE			0x400				// Stack_Size in startup_stm32f303xe.s
+#define STARTUP_HEAP_SIZE				0x200				// Heap_Size
+
+static uint32_t stackMem[STARTUP_STACK_SIZE / 4] __attribute__((used, aligned(8)));
+static uint32_t heapMem[STARTUP_HEAP_SIZE / 4] __attribute__((used, aligned(8)));
+
+// armlink region symbols, named the same so StackMonitor.c builds unchanged
+__asm__(
+	"	.globl	\"STACK$$Base\"\n"
+	"	.globl	\"STACK$$Limit\"\n"
+	"	.globl	\"HEAP$$Base\"\n"
+	"	.globl	\"HEAP$$Limit\"\n"
+	"	.set	\"STACK$$Base\", stackMem\n"
+	"	.set	\"STACK$$Limit\", stackMem + 1024\n"
+	"	.set	\"HEAP$$Base\", heapMem\n"
+	"	.set	\"HEAP$$Limit\", heapMem + 512\n"
+);
+
+void NMI_Handler(void) __attribute__((weak));
+void HardFault_Handler(void) __attribute__((weak));
+void MemManage_Handler(void) __attribute__((weak));
+void BusFault_Handler(void) __attribute__((weak));
+void UsageFault_Handler(void) __attribute__((weak));
+void SVC_Handler(void) __attribute__((weak));
+void DebugMon_Handler(void) __attribute__((weak));
+void PendSV_Handler(void) __attribute__((weak));
+void SysTick_Handler(void) __attribute__((weak));
+void WWDG_IRQHandler(void) __attribute__((weak));
+void PVD_IRQHandler(void) __attribute__((weak));
+void TAMP_STAMP_IRQHandler(void) __attribute__((weak));
+void RTC_WKUP_IRQHandler(void) __attribute__((weak));
+void FLASH_IRQHandler(void) __attribute__((weak));
+void RCC_IRQHandler(void) __attribute__((weak));
+void EXTI0_IRQHandler(void) __attribute__((weak));
+void EXTI1_IRQHandler(void) __attribute__((weak));
+void EXTI2_TSC_IRQHandler(void) __attribute__((weak));
+void EXTI3_IRQHandler(void) __attribute__((weak));
+void EXTI4_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel1_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel2_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel3_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel4_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel5_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel6_IRQHandler(void) __attribute__((weak));
+void DMA1_Channel7_IRQHandler(void) __attribute__((weak));
+void ADC1_2_IRQHandler(void) __attribute__((weak));
+void USB_HP_CAN_TX_IRQHandler(void) __attribute__((weak));
+void USB_LP_CAN_RX0_IRQHandler(void) __attribute__((weak));
+void CAN_RX1_IRQHandler(void) __attribute__((weak));
+void CAN_SCE_IRQHandler(void) __attribute__((weak));
+void EXTI9_5_IRQHandler(void) __attribute__((weak));
+void TIM1_BRK_TIM15_IRQHandler(void) __attribute__((weak));
+void TIM1_UP_TIM16_IRQHandler(void) __attribute__((weak));
+void TIM1_TRG_COM_TIM17_IRQHandler(void) __attribute__((weak));
+void TIM1_CC_IRQHandler(void) __attribute__((weak));
+void TIM2_IRQHandler(void) __attribute__((weak));
+void TIM3_IRQHandler(void) __attribute__((weak));
+void TIM4_IRQHandler(void) __attribute__((weak));
+void I2C1_EV_IRQHandler(void) __attribute__((weak));
+void I2C1_ER_IRQHandler(void) __attribute__((weak));
+void I2C2_EV_IRQHandler(void) __attribute__((weak));
+void I2C2_ER_IRQHandler(void) __attribute__((weak));
+void SPI1_IRQHandler(void) __attribute__((weak));
+void SPI2_IRQHandler(void) __attribute__((weak));
+void USART1_IRQHandler(void) __attribute__((weak));
+void USART2_IRQHandler(void) __attribute__((weak));
+void USART3_IRQHandler(void) __attribute__((weak));
+void EXTI15_10_IRQHandler(void) __attribute__((weak));
+void RTC_Alarm_IRQHandler(void) __attribute__((weak));
+void USBWakeUp_IRQHandler(void) __attribute__((weak));
+void TIM8_BRK_IRQHandler(void) __attribute__((weak));
+void TIM8_UP_IRQHandler(void) __attribute__((weak));
+void TIM8_TRG_COM_IRQHandler(void) __attribute__((weak));
+void TIM8_CC_IRQHandler(void) __attribute__((weak));
+void ADC3_IRQHandler(void) __attribute__((weak));
+void FMC_IRQHandler(void) __attribute__((weak));
+void SPI3_IRQHandler(void) __attribute__((weak));
+void UART4_IRQHandler(void) __attribute__((weak));
+void UART5_IRQHandler(void) __attribute__((weak));
+void TIM6_DAC_IRQHandler(void) __attribute__((weak));
+void TIM7_IRQHandler(void) __attribute__((weak));
+void DMA2_Channel1_IRQHandler(void) __attribute__((weak));
+void DMA2_Channel2_IRQHandler(void) __attribute__((weak));
+void DMA2_Channel3_IRQHandler(void) __attribute__((weak));
+void DMA2_Channel4_IRQHandler(void) __attribute__((weak));
+void DMA2_Channel5_IRQHandler(void) __attribute__((weak));
+void ADC4_IRQHandler(void) __attribute__((weak));
+void COMP1_2_3_IRQHandler(void) __attribute__((weak));
+void COMP4_5_6_IRQHandler(void) __attribute__((weak));
+void COMP7_IRQHandler(void) __attribute__((weak));
+void I2C3_EV_IRQHandler(void) __attribute__((weak));
+void I2C3_ER_IRQHandler(void) __attribute__((weak));
+void USB_HP_IRQHandler(void) __attribute__((weak));
+void USB_LP_IRQHandler(void) __attribute__((weak));
+void USBWakeUp_RMP_IRQHandler(void) __attribute__((weak));
+void TIM20_BRK_IRQHandler(void) __attribute__((weak));
+void TIM20_UP_IRQHandler(void) __attribute__((weak));
+void TIM20_TRG_COM_IRQHandler(void) __attribute__((weak));
+void TIM20_CC_IRQHandler(void) __attribute__((weak));
+void FPU_IRQHandler(void) __attribute__((weak));
+void SPI4_IRQHandler(void) __attribute__((weak));
+
+
+/******************************************************************
+*												VECTOR TABLE															*
+******************************************************************/
+
+void (* const Sim_Vectors[])(void) = {
+	NULL,													// Initial stack pointer (host stack)
+	NULL,													// Reset (Startup_Reset() runs before main())
+	NMI_Handler,
+	HardFault_Handler,
+	MemManage_Handler,
+	BusFault_Handler,
+	UsageFault_Handler,
+	NULL,													// Reserved
+	NULL,													// Reserved
+	NULL,													// Reserved
+	NULL,													// Reserved
+	SVC_Handler,
+	DebugMon_Handler,
+	NULL,													// Reserved
+	PendSV_Handler,
+	SysTick_Handler,
+	WWDG_IRQHandler,
+	PVD_IRQHandler,
+	TAMP_STAMP_IRQHandler,
+	RTC_WKUP_IRQHandler,
+	FLASH_IRQHandler,
+	RCC_IRQHandler,
+	EXTI0_IRQHandler,
+	EXTI1_IRQHandler,
+	EXTI2_TSC_IRQHandler,
+	EXTI3_IRQHandler,
+	EXTI4_IRQHandler,
+	DMA1_Channel1_IRQHandler,
+	DMA1_Channel2_IRQHandler,
+	DMA1_Channel3_IRQHandler,
+	DMA1_Channel4_IRQHandler,
+	DMA1_Channel5_IRQHandler,
+	DMA1_Channel6_IRQHandler,
+	DMA1_Channel7_IRQHandler,
+	ADC1_2_IRQHandler,
+	USB_HP_CAN_TX_IRQHandler,
+	USB_LP_CAN_RX0_IRQHandler,
+	CAN_RX1_IRQHandler,
+	CAN_SCE_IRQHandler,
+	EXTI9_5_IRQHandler,
+	TIM1_BRK_TIM15_IRQHandler,
+	TIM1_UP_TIM16_IRQHandler,
+	TIM1_TRG_COM_TIM17_IRQHandler,
+	TIM1_CC_IRQHandler,
+	TIM2_IRQHandler,
+	TIM3_IRQHandler,
+	TIM4_IRQHandler,
+	I2C1_EV_IRQHandler,
+	I2C1_ER_IRQHandler,
+	I2C2_EV_IRQHandler,
+	I2C2_ER_IRQHandler,
+	SPI1_IRQHandler,
+	SPI2_IRQHandler,
+	USART1_IRQHandler,
+	USART2_IRQHandler,
+	USART3_IRQHandler,
+	EXTI15_10_IRQHandler,
+	RTC_Alarm_IRQHandler,
+	USBWakeUp_IRQHandler,
+	TIM8_BRK_IRQHandler,
+	TIM8_UP_IRQHandler,
+	TIM8_TRG_COM_IRQHandler,
+	TIM8_CC_IRQHandler,
+	ADC3_IRQHandler,
+	FMC_IRQHandler,
+	NULL,													// Reserved
+	NULL,													// Reserved
+	SPI3_IRQHandler,
+	UART4_IRQHandler,
+	UART5_IRQHandler,
+	TIM6_DAC_IRQHandler,
+	TIM7_IRQHandler,
+	DMA2_Channel1_IRQHandler,
+	DMA2_Channel2_IRQHandler,
+	DMA2_Channel3_IRQHandler,
+	DMA2_Channel4_IRQHandler,
+	DMA2_Channel5_IRQHandler,
+	ADC4_IRQHandler,
+	NULL,													// Reserved
+	NULL,													// Reserved
+	COMP1_2_3_IRQHandler,
+	COMP4_5_6_IRQHandler,
+	COMP7_IRQHandler,
+	NULL,													// Reserved
+	NULL,													// Reserved
+	NULL,													// Reserved
+	NULL,													// Reserved
+	NULL,													// Reserved
+	I2C3_EV_IRQHandler,
+	I2C3_ER_IRQHandler,
+	USB_HP_IRQHandler,
+	USB_LP_IRQHandler,
+	USBWakeUp_RMP_IRQHandler,
+	TIM20_BRK_IRQHandler,
+	TIM20_UP_IRQHandler,
+	TIM20_TRG_COM_IRQHandler,
+	TIM20_CC_IRQHandler,
+	FPU_IRQHandler,
+	NULL,													// Reserved
+	NULL,													// Reserved
+	SPI4_IRQHandler,
+};
+
+_Static_assert(sizeof(Sim_Vectors) / sizeof(Sim_Vectors[0]) == 16 + SPI4_IRQn + 1, "Vector table size");
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Startup_Reset() - Reset_Handler: map the simulated registers and run SystemInit().
+* No inputs.
+* No return value, runs before the other constructors (test set up), then main().
+*************************************************************/
+__attribute__((constructor(101))) static void Startup_Reset(void){
+	Sim_Init();
+	SystemInit();
+}
@@ -0,0 +1,241 @@
+/********************************************************************************
+* Name: core_cm4.h (interface)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Host build stand-in for the CMSIS Cortex-M4 core header.
+*							 SCB, NVIC, SysTick, DWT and CoreDebug keep their CMSIS layout and
+*							 addresses, which Sim.c maps in like the device peripherals. The
+*							 intrinsics call the host backend: Sim.c for the simulated target,
+*							 HostThreads.c for the threaded (ThreadSanitizer) harness.
+********************************************************************************/
+
+#ifndef __CORE_CM4_H_GENERIC
+#define __CORE_CM4_H_GENERIC
+
+#include <stdint.h>
+
+#define __CORTEX_M				4U
+
+#define __I			volatile const
+#define __O			volatile
+#define __IO		volatile
+#define __IM		volatile const
+#define __OM		volatile
+#define __IOM		volatile
+
+#define __ASM							__asm
+#define __INLINE					inline
+#define __STATIC_INLINE		static inline
+#define __STATIC_FORCEINLINE	static inline __attribute__((always_inline))
+
+
+/******************************************************************
+*												CORE PERIPHERALS													*
+******************************************************************/
+
+typedef struct {
+	__IOM uint32_t ISER[8];
+	uint32_t RESERVED0[24];
+	__IOM uint32_t ICER[8];
+	uint32_t RESERVED1[24];
+	__IOM uint32_t ISPR[8];
+	uint32_t RESERVED2[24];
+	__IOM uint32_t ICPR[8];
+	uint32_t RESERVED3[24];
+	__IOM uint32_t IABR[8];
+	uint32_t RESERVED4[56];
+	__IOM uint8_t IP[240];
+	uint32_t RESERVED5[644];
+	__OM uint32_t STIR;
+} NVIC_Type;
+
+typedef struct {
+	__IM uint32_t CPUID;
+	__IOM uint32_t ICSR;
+	__IOM uint32_t VTOR;
+	__IOM uint32_t AIRCR;
+	__IOM uint32_t SCR;
+	__IOM uint32_t CCR;
+	__IOM uint8_t SHP[12];
+	__IOM uint32_t SHCSR;
+	__IOM uint32_t CFSR;
+	__IOM uint32_t HFSR;
+	__IOM uint32_t DFSR;
+	__IOM uint32_t MMFAR;
+	__IOM uint32_t BFAR;
+	__IOM uint32_t AFSR;
+	__IM uint32_t PFR[2];
+	__IM uint32_t DFR;
+	__IM uint32_t ADR;
+	__IM uint32_t MMFR[4];
+	__IM uint32_t ISAR[5];
+	uint32_t RESERVED0[5];
+	__IOM uint32_t CPACR;
+} SCB_Type;
+
+typedef struct {
+	__IOM uint32_t CTRL;
+	__IOM uint32_t LOAD;
+	__IOM uint32_t VAL;
+	__IM uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct {
+	__IOM uint32_t CTRL;
+	__IOM uint32_t CYCCNT;
+	__IOM uint32_t CPICNT;
+	__IOM uint32_t EXCCNT;
+	__IOM uint32_t SLEEPCNT;
+	__IOM uint32_t LSUCNT;
+	__IOM uint32_t FOLDCNT;
+	__IM uint32_t PCSR;
+} DWT_Type;
+
+typedef struct {
+	__IOM uint32_t DHCSR;
+	__OM uint32_t DCRSR;
+	__IOM uint32_t DCRDR;
+	__IOM uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define SCS_BASE				(0xE000E000UL)
+#define DWT_BASE				(0xE0001000UL)
+#define CoreDebug_BASE	(0xE000EDF0UL)
+#define SysTick_BASE		(SCS_BASE + 0x0010UL)
+#define NVIC_BASE				(SCS_BASE + 0x0100UL)
+#define SCB_BASE				(SCS_BASE + 0x0D00UL)
+
+#define SCB							((SCB_Type *)SCB_BASE)
+#define SysTick					((SysTick_Type *)SysTick_BASE)
+#define NVIC						((NVIC_Type *)NVIC_BASE)
+#define DWT							((DWT_Type *)DWT_BASE)
+#define CoreDebug				((CoreDebug_Type *)CoreDebug_BASE)
+
+#define SCB_ICSR_PENDSVSET_Pos		28U
+#define SCB_ICSR_PENDSVSET_Msk		(1UL << SCB_ICSR_PENDSVSET_Pos)
+#define SCB_ICSR_PENDSVCLR_Pos		27U
+#define SCB_ICSR_PENDSVCLR_Msk		(1UL << SCB_ICSR_PENDSVCLR_Pos)
+#define SCB_ICSR_VECTACTIVE_Msk		(0x1FFUL)
+#define SCB_SCR_SLEEPDEEP_Pos			2U
+#define SCB_SCR_SLEEPDEEP_Msk			(1UL << SCB_SCR_SLEEPDEEP_Pos)
+#define SCB_SCR_SLEEPONEXIT_Msk		(1UL << 1U)
+
+#define SysTick_CTRL_COUNTFLAG_Pos	16U
+#define SysTick_CTRL_COUNTFLAG_Msk	(1UL << SysTick_CTRL_COUNTFLAG_Pos)
+#define SysTick_CTRL_CLKSOURCE_Msk	(1UL << 2U)
+#define SysTick_CTRL_TICKINT_Msk		(1UL << 1U)
+#define SysTick_CTRL_ENABLE_Msk			(1UL)
+#define SysTick_LOAD_RELOAD_Msk			(0xFFFFFFUL)
+
+#define DWT_CTRL_CYCCNTENA_Msk				(1UL)
+#define CoreDebug_DEMCR_TRCENA_Msk		(1UL << 24U)
+
+
+/******************************************************************
+*												INTRINSICS																*
+******************************************************************/
+
+// Host backend (Sim.c or HostThreads.c)
+void Host_DisableIrq(void);
+void Host_EnableIrq(void);
+uint32_t Host_GetPrimask(void);
+void Host_SetPrimask(uint32_t primask);
+uint32_t Host_GetIpsr(void);
+uint32_t Host_GetMsp(void);
+uint32_t Host_GetPsp(void);
+void Host_SetPsp(uint32_t psp);
+void Host_Wfi(void);
+void Host_Wfe(void);
+void Host_Sev(void);
+uint32_t Host_Ldrex(volatile uint32_t *addr);
+uint32_t Host_Strex(uint32_t value, volatile uint32_t *addr);
+void Host_Clrex(void);
+
+__STATIC_FORCEINLINE void __disable_irq(void){ Host_DisableIrq(); }
+__STATIC_FORCEINLINE void __enable_irq(void){ Host_EnableIrq(); }
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void){ return(Host_GetPrimask()); }
+__STATIC_FORCEINLINE void __set_PRIMASK(uint32_t primask){ Host_SetPrimask(primask); }
+__STATIC_FORCEINLINE uint32_t __get_IPSR(void){ return(Host_GetIpsr()); }
+__STATIC_FORCEINLINE uint32_t __get_MSP(void){ return(Host_GetMsp()); }
+__STATIC_FORCEINLINE uint32_t __get_PSP(void){ return(Host_GetPsp()); }
+__STATIC_FORCEINLINE void __set_PSP(uint32_t psp){ Host_SetPsp(psp); }
+__STATIC_FORCEINLINE void __WFI(void){ Host_Wfi(); }
+__STATIC_FORCEINLINE void __WFE(void){ Host_Wfe(); }
+__STATIC_FORCEINLINE void __SEV(void){ Host_Sev(); }
+__STATIC_FORCEINLINE uint32_t __LDREXW(volatile uint32_t *addr){ return(Host_Ldrex(addr)); }
+__STATIC_FORCEINLINE uint32_t __STREXW(uint32_t value, volatile uint32_t *addr){ return(Host_Strex(value, addr)); }
+__STATIC_FORCEINLINE void __CLREX(void){ Host_Clrex(); }
+
+__STATIC_FORCEINLINE void __DMB(void){ __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+__STATIC_FORCEINLINE void __DSB(void){ __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+__STATIC_FORCEINLINE void __ISB(void){ __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+__STATIC_FORCEINLINE void __NOP(void){ __asm volatile("nop"); }
+
+__STATIC_FORCEINLINE uint8_t __CLZ(uint32_t value){
+	return((value == 0) ? 32U : (uint8_t)__builtin_clz(value));
+}
+
+
+/******************************************************************
+*												NVIC AND SYSTICK													*
+******************************************************************/
+
+__STATIC_INLINE void NVIC_EnableIRQ(IRQn_Type IRQn){
+	if((int32_t)IRQn >= 0){
+		NVIC->ISER[(uint32_t)IRQn >> 5] = 1UL << ((uint32_t)IRQn & 0x1FUL);
+	}
+}
+
+__STATIC_INLINE void NVIC_DisableIRQ(IRQn_Type IRQn){
+	if((int32_t)IRQn >= 0){
+		NVIC->ICER[(uint32_t)IRQn >> 5] = 1UL << ((uint32_t)IRQn & 0x1FUL);
+	}
+}
+
+__STATIC_INLINE void NVIC_SetPendingIRQ(IRQn_Type IRQn){
+	if((int32_t)IRQn >= 0){
+		NVIC->ISPR[(uint32_t)IRQn >> 5] = 1UL << ((uint32_t)IRQn & 0x1FUL);
+	}
+}
+
+__STATIC_INLINE void NVIC_ClearPendingIRQ(IRQn_Type IRQn){
+	if((int32_t)IRQn >= 0){
+		NVIC->ICPR[(uint32_t)IRQn >> 5] = 1UL << ((uint32_t)IRQn & 0x1FUL);
+	}
+}
+
+__STATIC_INLINE uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn){
+	if((int32_t)IRQn >= 0){
+		return((NVIC->ISPR[(uint32_t)IRQn >> 5] >> ((uint32_t)IRQn & 0x1FUL)) & 1UL);
+	}
+	return(0);
+}
+
+__STATIC_INLINE void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority){
+	if((int32_t)IRQn >= 0){
+		NVIC->IP[(uint32_t)IRQn] = (uint8_t)((priority << (8U - __NVIC_PRIO_BITS)) & 0xFFUL);
+	}
+	else{
+		SCB->SHP[((uint32_t)IRQn & 0xFUL) - 4UL] = (uint8_t)((priority << (8U - __NVIC_PRIO_BITS)) & 0xFFUL);
+	}
+}
+
+__STATIC_INLINE uint32_t NVIC_GetPriority(IRQn_Type IRQn){
+	if((int32_t)IRQn >= 0){
+		return((uint32_t)NVIC->IP[(uint32_t)IRQn] >> (8U - __NVIC_PRIO_BITS));
+	}
+	return((uint32_t)SCB->SHP[((uint32_t)IRQn & 0xFUL) - 4UL] >> (8U - __NVIC_PRIO_BITS));
+}
+
+__STATIC_INLINE uint32_t SysTick_Config(uint32_t ticks){
+	if((ticks - 1UL) > SysTick_LOAD_RELOAD_Msk){
+		return(1UL);
+	}
+	SysTick->LOAD = ticks - 1UL;
+	NVIC_SetPriority(SysTick_IRQn, (1UL << __NVIC_PRIO_BITS) - 1UL);
+	SysTick->VAL = 0UL;
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+	return(0UL);
+}
+
+#endif
@@ -0,0 +1,14 @@
+/********************************************************************************
+* Name: stm32f3xx.h (interface)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Host build stand-in for the STM32F3xx family header, which only
+*							 selects the device header.
+********************************************************************************/
+
+#ifndef __STM32F3xx_H
+#define __STM32F3xx_H
+
+#include "stm32f303xe.h"
+
+#endif
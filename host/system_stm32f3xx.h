@@ -0,0 +1,21 @@
+/********************************************************************************
+* Name: system_stm32f3xx.h (interface)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Host build stand-in for the STM32F3xx CMSIS system header
+*							 (system_stm32f3xx.c is built unchanged).
+********************************************************************************/
+
+#ifndef __SYSTEM_STM32F3XX_H
+#define __SYSTEM_STM32F3XX_H
+
+#include <stdint.h>
+
+extern uint32_t SystemCoreClock;
+extern const uint8_t AHBPrescTable[16];
+extern const uint8_t APBPrescTable[8];
+
+void SystemInit(void);
+void SystemCoreClockUpdate(void);
+
+#endif
@@ -17,203 +17,180 @@
 #include "DCMotor.h"
 #include "LCD.h"
 #include "Encoder.h"
+#include "Profile.h"
+#include "IsrMonitor.h"
+#include "LoopMonitor.h"
+#include "Trace.h"
+#include "Bench.h"
+#include "StackMonitor.h"
+#include "Boot.h"
+#include "Power.h"
+#include "RegInit.h"
+#include "Bus.h"
+#include "Kernel.h"
+#include "Robot.h"
+
+// Init tasks in the order they are stepped, safety first
+enum {
+	INIT_DCMOTOR,
+	INIT_STEPPER,
+	INIT_CLOCK,
+	INIT_LCD,
+	INIT_LED,
+	INIT_KEYPAD,
+	INIT_UART,
+	INIT_RCSERVO,
+	INIT_ULTRASONIC,
+	INIT_ENCODER,
+	INIT_LOOPMONITOR,
+	INIT_COUNT
+};
+
+static const Boot_Task bootTasks[] = {
+	[INIT_DCMOTOR] =			{"DCMotor",			DCMotor_Init,			NULL,										0},
+	[INIT_STEPPER] =			{"Stepper",			Stepper_Init,			NULL,										0},
+	[INIT_CLOCK] =				{"Clock",				NULL,							System_Clock_InitStep,	0},
+	[INIT_LCD] =					{"LCD",					NULL,							LCD_InitStep,						0},
+	[INIT_LED] =					{"LED",					LED_Init,					NULL,										0},
+	[INIT_KEYPAD] =				{"KeyPad",			KeyPad_Init,			NULL,										0},
+	[INIT_UART] =					{"UART",				UART2_Init,				NULL,										BOOT_NEEDS(INIT_CLOCK)},
+	[INIT_RCSERVO] =			{"RCServo",			RCServo_Init,			NULL,										BOOT_NEEDS(INIT_CLOCK)},
+	[INIT_ULTRASONIC] =		{"Ultrasonic",	Ultra_Init,				NULL,										BOOT_NEEDS(INIT_CLOCK)},
+	[INIT_ENCODER] =			{"Encoder",			Encoder_Init,			NULL,										BOOT_NEEDS(INIT_CLOCK)},
+	[INIT_LOOPMONITOR] =	{"LoopMonitor",	LoopMonitor_Init,	NULL,										BOOT_NEEDS(INIT_ENCODER)},
+};
+
+_Static_assert(sizeof(bootTasks) / sizeof(bootTasks[0]) == INIT_COUNT, "main.c: bootTasks must have an entry for every INIT_ index");
+_Static_assert(INIT_COUNT <= BOOT_MAX_TASKS, "main.c: too many init tasks for Boot_Run()");
+
+// Kernel tasks (priority 0 is the kernel idle task)
+#define MAIN_TASK_PRIORITY		1			// Keypad and UART commands, paced by the TIM7 loop tick
+#define MAIN_TASK_STACK				384		// Words
+
+static Kernel_Task mainTask;
+static uint32_t mainStack[MAIN_TASK_STACK];
+
+static void Main_Task(void *arg);
 
 int main(void){	
 	// INITIALIZE
-	uint8_t pressedKey = '\0';		// Key pressed by user
-	int8_t RCServoAngle = 0;			// Servo angle
-	uint8_t StepperMode = 0;			// Stepper mode (continuous or single output)
-	uint8_t StepperLastStep = 0;	// The last step the servo took
+	StackMonitor_Init();					// Paint the unused stack for the high-water mark
+	Profile_Init();
+	IsrMonitor_Init();
 	
-	System_Clock_Init();					// Scale clock speed to 72MHz
-	SystemCoreClockUpdate();
+	// Bring up the clock (72MHz) and drivers, overlapping their waits
+	Boot_Run(bootTasks, INIT_COUNT);
+	Power_Init();
 	
-	UART2_Init();
-	Stepper_Init();
-	RCServo_Init();
-	LED_Init();
-	KeyPad_Init();
-	Ultra_Init();
-	DCMotor_Init();
-	LCD_Init();
-	Encoder_Init();
+	// Hand over to the kernel, main()'s stack becomes the ISR stack
+	Kernel_Init();
+	Bench_Init();
+	Robot_Init();
+	Kernel_TaskCreate(&mainTask, "main", Main_Task, NULL, mainStack, MAIN_TASK_STACK, MAIN_TASK_PRIORITY);
+	Kernel_Start();
+}
+
+/*************************************************************
+* Main_Task() - Keypad and UART command loop.
+* arg		- Unused.
+* No return value.
+*************************************************************/
+static void Main_Task(void *arg){
+	uint8_t pressedKey = '\0';		// Key pressed by user
+	char uartCmd = '\0';					// Command received over UART
 	
-	// Print menu
+	// Print menu once the robot task is running, the task sleeps while it goes out at 9600 baud
 	UART_printf("Embedded Systems Software Semester 4 Final Demonstration\n");
 	UART_printf("Press a key on the keypad\n");
-
+	Boot_Report();
+	UART_printf("Send 'p' over UART for a profile dump, 'i' for ISR load, 'l' for CPU load, 't' for an event trace, 'b' to benchmark, 's' for stack usage, 'r' for the init register log, 'd' for data bus rates, 'k' for kernel tasks, 'h' for the robot mode\n");
+	UART_printf("Send 'm' for manual, 'a' for autonomous, 'c' to calibrate, 'e' to stop everything (fault), 'u' for the next microstep size\n");
+	
 	// PROGRAM LOOP
 	while(1){
+		// Keys drive the robot mode state machine
 		pressedKey = KeyPad_GetKey();
-
-		switch(pressedKey){
-			// STEPPER
-			// OFF
-			case '0':{
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: 0");
-				LCD_printf("\nStepper Off");
-
-				StepperLastStep = 0;
-				Stepper_Step(0);
-				break;
-			}
-			// Full step CW
-			case '1':{
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: 1");
-				LCD_printf("\nFull Step CW");
-
-				StepperLastStep = 1;
-				Stepper_Step(1);
+		if(pressedKey != 'f'){
+			TRACE(TRACE_KEY_PRESS, pressedKey);
+			Power_Activity();
+			Robot_Post(ROBOT_EV_KEY, pressedKey);
+		}
+		
+		// Profile and ISR load dumps on demand
+		uartCmd = UART_getcNB();
+		if(uartCmd != '\0'){
+			Power_Activity();
+		}
+		switch(uartCmd){
+			case 'p':{
+				Profile_Dump();
 				break;
 			}
-			// Full step CCW
-			case '2':{
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: 2");
-				LCD_printf("\nFull Step CCW");
-				StepperLastStep = 2;
-				Stepper_Step(2);
+			case 'i':{
+				IsrMonitor_Report();
 				break;
 			}
-			// Half step CW
-			case '3':{
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: 3");
-				LCD_printf("\nHalf Step CW");
-				StepperLastStep = 3;
-				Stepper_Step(3);
+			case 'l':{
+				LoopMonitor_Report();
 				break;
 			}
-			// Half step CCW
-			case '4':{
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: 4");
-				LCD_printf("\nHalf Step CCW");
-				StepperLastStep = 4;
-				Stepper_Step(4);
+			case 't':{
+				Trace_Dump();
 				break;
 			}
-			// ping ultrasonic
-			case '5':{
-				Ultra_StartTrigger();
-				while(!Ultra_EchoRx());
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: 5");
-				LCD_printf("\nUltrasonic: %dcm", Ultra_ReadSensor());
+			case 'b':{
+				Bench_Run();
 				break;
 			}
-			// 
-			case '6':{
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: 6");
-				LCD_printf("\nIt's a button.");
+			case 's':{
+				StackMonitor_Report();
 				break;
 			}
-			// SERVO
-			// Decrease servo angle
-			case '7':{
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: 7");
-				LCD_printf("\nDec Servo Angle");
-				RCServoAngle -= 5;
-				RCServo_SetAngle(RCServoAngle);
+			case 'r':{
+				RegInit_Report();
 				break;
 			}
-			// Centre servo
-			case '8':{
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: 8");
-				LCD_printf("\nCentre Servo");
-				RCServoAngle = 0;
-				RCServo_SetAngle(RCServoAngle);
+			case 'd':{
+				Bus_Report();
 				break;
 			}
-			// Increase servo angle
-			case '9':{
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: 9");
-				LCD_printf("\nInc Servo Angle");
-				RCServoAngle += 5;
-				RCServo_SetAngle(RCServoAngle);
+			case 'k':{
+				Kernel_Report();
 				break;
 			}
-			// Toggle between continuous output mode or single output mode
-			case '#':{
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: #");
-				LCD_printf("\nToggle Mode");
-				if(StepperMode == 1){
-					StepperMode = 0;
-				}
-				else{
-					StepperMode = 1;
-				}
+			case 'h':{
+				Robot_Report();
 				break;
 			}
 			
-			// LED
-			case '*':{
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: *");
-				LCD_printf("\nToggle LED");
-				LED_Toggle();
+			// Robot modes
+			case 'm':{
+				Robot_Post(ROBOT_EV_MANUAL, 0);
 				break;
 			}
-			// dc motors forward
-			case 'A':{
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: A");
-				LCD_printf("\nDC Forward");
-				DCMotor_Forward(100);
+			case 'a':{
+				Robot_Post(ROBOT_EV_AUTO, 0);
 				break;
 			}
-			// dc motors off
-			case 'B':{
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: B");
-				LCD_printf("\nDC Stop");
-				DCMotor_Stop();
+			case 'c':{
+				Robot_Post(ROBOT_EV_CALIBRATE, 0);
 				break;
 			}
-			// dc motors backwards 
-			case 'C':{
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: C");
-				LCD_printf("\nDC Backward");
-				DCMotor_Backward(100);
+			case 'e':{
+				Robot_Post(ROBOT_EV_FAULT, 0);
 				break;
 			}
-			// check encoder values
-			case 'D':{
-				Encoder_CalculateSpeed();
-				LCD_Clear();
-				LCD_HomeCursor();
-				LCD_printf("User Input: D");
-				LCD_printf("\nL: %d R: %d", Global_LeftEncoderPeriod, Global_RightEncoderPeriod);
+			case 'u':{
+				Robot_Post(ROBOT_EV_MICROSTEP, 0);
 				break;
 			}
 		}
+
+		// Slow the clock down or stop while parked
+		Power_Update(Stepper_IsRunning() || DCMotor_IsRunning() || RCServo_IsMoving(SERVO_PAN) ||
+			RCServo_IsMoving(SERVO_TILT) || RCServo_IsMoving(SERVO_GRIPPER));
 		
-		// Stepper continuous output mode
-		if(StepperMode){
-			Stepper_Step(StepperLastStep);
-		}
+		// Nothing else to do until the next loop tick
+		LoopMonitor_Sleep();
 	}
 }
@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+###############################################################################
+# Name: map_size.py
+# Author(s): Noah Grant, Wyatt Richard
+# Date: October 19, 2026
+# Description: Flash/RAM size report from the armlink map file Keil writes to
+#              .\Listings\ (Options for Target > Listing > Linker Listing), or
+#              the GNU ld map the CMake build writes next to each image.
+#              With two map files, prints what grew or shrank between builds.
+#              GNU ld maps only list global symbols, so with a GNU map the
+#              symbols (statics included) come from the .elf beside it when
+#              objdump ($OBJDUMP, else arm-none-eabi-objdump or objdump) runs.
+#              --check-ccm fails unless every function and variable tagged
+#              CCM_FUNC or CCM_BSS in the sources is in CCM RAM, including
+#              any missing from the map (CCM_FUNC is never inlined).
+#
+# Usage: python3 map_size.py Listings/build.map [--symbols N]
+#        python3 map_size.py old.map new.map
+#        python3 map_size.py --check-ccm Listings/build.map [--src DIR]
+###############################################################################
+
+import glob
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+# "  Code (inc. data)   RO Data    RW Data    ZI Data      Debug   Object Name"
+OBJECT_LINE = re.compile(r"^\s*(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\S+\.o)\s*$")
+# "  main    0x08000199   Thumb Code   120  main.o(.text)"
+SYMBOL_LINE = re.compile(r"^\s*(\S+)\s+(0x[0-9a-fA-F]+)\s+(Thumb Code|ARM Code|Data)\s+(\d+)\s+(\S+)\s*$")
+
+# GNU ld: " .text.main  0x08000190  0x64 CMakeFiles/robot_O1.dir/main.c.obj" (long names wrap
+# before the address) and "                0x08000190                main"
+GNU_MAP_START = "Linker script and memory map"
+GNU_SECTION_LINE = re.compile(r"^ (\S+)(?:\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(\S.*?))?\s*$")
+GNU_SECTION_REST = re.compile(r"^\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(\S.*?)\s*$")
+GNU_SYMBOL_LINE = re.compile(r"^\s+(0x[0-9a-fA-F]+)\s+([A-Za-z_.$][\w.$]*)\s*$")
+GNU_OUTPUT_LINE = re.compile(r"^(\S+)")
+# objdump -t: "08000190 g     F .text	00000064 main"
+OBJDUMP_LINE = re.compile(r"^([0-9a-fA-F]+) (.{7}) (\S+)\s+([0-9a-fA-F]+)\s+(\S+)$")
+
+# Sections tagged CCM_FUNC / CCM_BSS (Utility.h) (and the GNU output sections holding them)
+# and the CCM RAM address range
+CCM_SECTIONS = ("(.ccmram.text)", "(.bss.ccmram)", "(.ccmram)", "(.ccmbss)")
+CCM_START = 0x10000000
+CCM_END = 0x10004000
+
+# "CCM_FUNC static void Kernel_Schedule(void){" and "static Trace_Ring rings[N] CCM_BSS;"
+CCM_FUNC = re.compile(r"^CCM_FUNC\b(?:\s+__attribute__\(\([^)]*\)\))*[^(;]*?\b(\w+)\s*\(", re.MULTILINE)
+CCM_BSS = re.compile(r"\b(\w+)\s*(?:\[[^\]]*\]\s*)*CCM_BSS\b")
+
+
+def parse(path):
+    """Returns ({object: (code, ro, rw, zi)}, {symbol: (kind, size, section, address)})."""
+    with open(path, errors="replace") as source:
+        lines = source.readlines()
+    if any(line.startswith(GNU_MAP_START) for line in lines):
+        return parse_gnu(path, lines)
+
+    objects = {}
+    symbols = {}
+    for line in lines:
+        match = OBJECT_LINE.match(line)
+        if match:
+            code, _, ro, rw, zi, _, name = match.groups()
+            objects[name] = (int(code), int(ro), int(rw), int(zi))
+            continue
+        match = SYMBOL_LINE.match(line)
+        if match:
+            name, address, kind, size, section = match.groups()
+            symbols[name] = (kind, int(size), section, int(address, 16))
+    return objects, symbols
+
+
+def gnu_object(path):
+    """CMakeFiles/robot_O1.dir/main.c.obj -> main.o, as armlink names objects."""
+    name = os.path.basename(path)
+    return re.sub(r"\.[csS]\.(obj|o)$", ".o", name)
+
+
+def gnu_kind(section):
+    """Returns the (code, ro, rw, zi) slot an input section counts in, or None."""
+    if section.startswith((".text", ".ccmram.text", ".isr_vector", ".glue_7", ".init", ".fini", ".vfp11_veneer")):
+        return 0
+    if section.startswith((".rodata", ".ARM.exidx", ".ARM.extab", ".init_array", ".fini_array", ".preinit_array")):
+        return 1
+    if section.startswith(".data"):
+        return 2
+    if section.startswith((".bss", "COMMON")):
+        return 3
+    return None
+
+
+def elf_symbols(path):
+    """Returns {symbol: (kind, size, section, address)} from objdump -t of the image, or {}."""
+    elf = os.path.splitext(path)[0] + ".elf"
+    tools = [os.environ.get("OBJDUMP"), "arm-none-eabi-objdump", "objdump"]
+    tool = next((shutil.which(tool) for tool in tools if tool and shutil.which(tool)), None)
+    if not os.path.exists(elf) or tool is None:
+        return {}
+    output = subprocess.run([tool, "-t", elf], stdout=subprocess.PIPE, universal_newlines=True).stdout
+    symbols = {}
+    for line in output.splitlines():
+        match = OBJDUMP_LINE.match(line)
+        if match:
+            address, flags, section, size, name = match.groups()
+            if flags[6] in "FO" and int(size, 16) > 0:
+                kind = "Thumb Code" if flags[6] == "F" else "Data"
+                symbols[name] = (kind, int(size, 16), "(%s)" % section, int(address, 16))
+    return symbols
+
+
+def parse_gnu(path, lines):
+    """parse() for a GNU ld map. Without the image, symbol sizes run to the next symbol."""
+    objects = {}
+    symbols = {}
+    placed = []
+    pending = None
+    output = None
+    for line in lines[next(i for i, line in enumerate(lines) if line.startswith(GNU_MAP_START)):]:
+        if not line.startswith(" ") and GNU_OUTPUT_LINE.match(line):
+            output = GNU_OUTPUT_LINE.match(line).group(1)
+            pending = None
+            continue
+        if output == "/DISCARD/" or line.startswith((" *", " LOAD", " OUTPUT")):
+            continue
+        match = GNU_SECTION_REST.match(line) if pending else None
+        if match:
+            section_line = (pending,) + match.groups()
+        else:
+            match = GNU_SECTION_LINE.match(line)
+            section_line = match.groups() if match else None
+        pending = None
+        if section_line:
+            section, address, size, source = section_line
+            if address is None:
+                pending = section
+                continue
+            slot = gnu_kind(section)
+            address, size = int(address, 16), int(size, 16)
+            if slot is None or size == 0 or address == 0:
+                continue
+            name = gnu_object(source)
+            sizes = list(objects.get(name, (0, 0, 0, 0)))
+            sizes[slot] += size
+            objects[name] = tuple(sizes)
+            placed.append((address, address + size, slot, "%s(%s)" % (name, section)))
+            continue
+        match = GNU_SYMBOL_LINE.match(line)
+        if match and placed:
+            address, name = int(match.group(1), 16), match.group(2)
+            start, end, slot, section = placed[-1]
+            if start <= address < end:
+                symbols[name] = ("Thumb Code" if slot == 0 else "Data", end - address, section, address)
+
+    # A symbol ends where the next one in its input section starts
+    ordered = sorted(symbols.items(), key=lambda item: item[1][3])
+    for (name, (kind, size, section, address)), following in zip(ordered, ordered[1:] + [None]):
+        if following and following[1][2] == section and following[1][3] > address:
+            symbols[name] = (kind, min(size, following[1][3] - address), section, address)
+
+    # Exact sizes and the static symbols from the image, keeping the map's input sections
+    for name, (kind, size, section, address) in elf_symbols(path).items():
+        holder = next((placed_section for start, end, _, placed_section in placed if start <= address < end), section)
+        symbols[name] = (kind, size, holder, address)
+    return objects, symbols
+
+
+def flash_ram(sizes):
+    code, ro, rw, zi = sizes
+    return code + ro + rw, rw + zi
+
+
+def report(objects, symbols, count):
+    print("%-24s %8s %8s" % ("Object", "Flash", "RAM"))
+    total_flash = total_ram = 0
+    for name, sizes in sorted(objects.items(), key=lambda item: -flash_ram(item[1])[0]):
+        flash, ram = flash_ram(sizes)
+        total_flash += flash
+        total_ram += ram
+        print("%-24s %8d %8d" % (name, flash, ram))
+    print("%-24s %8d %8d" % ("TOTAL", total_flash, total_ram))
+
+    print("\n%-32s %-10s %8s  %s" % ("Symbol", "Type", "Size", "Section"))
+    for name, (kind, size, section, _) in sorted(symbols.items(), key=lambda item: -item[1][1])[:count]:
+        print("%-32s %-10s %8d  %s" % (name, kind, size, section))
+
+
+def diff(old, new):
+    old_objects, old_symbols = old
+    new_objects, new_symbols = new
+
+    print("%-24s %8s %8s" % ("Object", "dFlash", "dRAM"))
+    for name in sorted(set(old_objects) | set(new_objects)):
+        old_flash, old_ram = flash_ram(old_objects.get(name, (0, 0, 0, 0)))
+        new_flash, new_ram = flash_ram(new_objects.get(name, (0, 0, 0, 0)))
+        if (old_flash, old_ram) != (new_flash, new_ram):
+            print("%-24s %+8d %+8d" % (name, new_flash - old_flash, new_ram - old_ram))
+
+    print("\n%-32s %8s %8s %8s" % ("Symbol", "Old", "New", "Delta"))
+    changes = []
+    for name in set(old_symbols) | set(new_symbols):
+        old_size = old_symbols.get(name, ("", 0, "", 0))[1]
+        new_size = new_symbols.get(name, ("", 0, "", 0))[1]
+        if old_size != new_size:
+            changes.append((new_size - old_size, name, old_size, new_size))
+    for delta, name, old_size, new_size in sorted(changes, key=lambda change: -abs(change[0])):
+        print("%-32s %8d %8d %+8d" % (name, old_size, new_size, delta))
+
+
+def tagged(directory):
+    """Returns the names tagged CCM_FUNC or CCM_BSS in the C sources."""
+    names = set()
+    for path in glob.glob(os.path.join(directory, "*.c")):
+        with open(path, errors="replace") as source:
+            text = source.read()
+        names.update(CCM_FUNC.findall(text))
+        names.update(CCM_BSS.findall(text))
+    return names
+
+
+def check_ccm(symbols, expected):
+    """Checks every CCM tagged symbol was placed in CCM RAM. Returns True if all were."""
+    ok = True
+    used = 0
+    print("%-32s %-10s %8s  %s" % ("CCM symbol", "Address", "Size", "Section"))
+    for name, (kind, size, section, address) in sorted(symbols.items(), key=lambda item: item[1][3]):
+        if not section.endswith(CCM_SECTIONS) and name not in expected:
+            continue
+        placed = CCM_START <= address < CCM_END
+        used += size if placed else 0
+        ok = ok and placed
+        print("%-32s 0x%08X %8d  %s%s" % (name, address, size, section, "" if placed else "  NOT IN CCM"))
+    for name in sorted(expected - set(symbols)):
+        ok = False
+        print("%-32s %-10s %8s  %s" % (name, "-", "-", "MISSING (removed as unused?)"))
+    print("CCM used %d of %d bytes" % (used, CCM_END - CCM_START))
+    return ok
+
+
+def main():
+    args = sys.argv[1:]
+    count = 20
+    if "--symbols" in args:
+        index = args.index("--symbols")
+        count = int(args[index + 1])
+        del args[index:index + 2]
+
+    src = os.path.dirname(os.path.abspath(__file__))
+    if "--src" in args:
+        index = args.index("--src")
+        src = args[index + 1]
+        del args[index:index + 2]
+
+    if "--check-ccm" in args:
+        args.remove("--check-ccm")
+        sys.exit(0 if check_ccm(parse(args[0])[1], tagged(src)) else 1)
+    elif len(args) == 1:
+        report(*parse(args[0]), count)
+    elif len(args) == 2:
+        diff(parse(args[0]), parse(args[1]))
+    else:
+        sys.stderr.write(__doc__ or "usage: map_size.py build.map [other.map] [--symbols N]\n")
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
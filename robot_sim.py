@@ -0,0 +1,307 @@
+#!/usr/bin/env python3
+###############################################################################
+# Name: robot_sim.py
+# Author(s): Noah Grant, Wyatt Richard
+# Date: October 19, 2026
+# Description: Deterministic, faster than real time simulation of the robot
+#              for regression batches. The unmodified firmware runs in
+#              robot_plant (host/Plant.c, the simulated STM32F303RE) and this
+#              model is its world: it drives the wheels from the motor outputs,
+#              feeds encoder vanes and ultrasonic echoes back as timer
+#              captures and types the UART commands. Each run centres the
+#              servos (calibration mode), then drives in autonomous mode. The
+#              physics cover differential drive, encoder vanes and the
+#              ultrasonic beam. Prints one JSON object per run and a summary
+#              line.
+#
+# Usage: python3 robot_sim.py [--scenario arena|corridor|clutter] [--runs N]
+#                             [--seed K] [--seconds S] [--plant PATH]
+###############################################################################
+
+import argparse
+import json
+import math
+import os
+import random
+import subprocess
+import sys
+
+# Robot geometry and motors (measured on the robot, not in the firmware)
+WHEEL_DIAMETER_M = 0.065
+ENCODER_VANES = 20              # Vanes (capture edges) per wheel revolution
+TRACK_M = 0.14                  # Distance between the wheels
+ROBOT_RADIUS_M = 0.10
+MAX_WHEEL_SPEED_MPS = 0.45      # At 100% duty cycle
+MIN_DUTY = 50                   # DCMotor_SetSpeed() floor
+MOTOR_TAU_S = 0.08              # Wheel speed time constant
+
+# Ultrasonic sensor
+SOUND_US_PER_CM = 58.3          # Echo pulse width per cm of range (round trip)
+SENSOR_MAX_CM = 400
+BEAM_HALF_ANGLE_DEG = 15
+BEAM_RAYS = 7
+
+STEP_US = 1000                  # Simulation step (virtual time), lock step with robot_plant
+STEP_S = STEP_US / 1e6
+
+# Firmware operation, over its UART
+BOOT_US = 500000                # Boot and the menu are out
+CALIBRATION_TIMEOUT_US = 5000000
+
+
+###############################################################################
+#                                   WORLD
+###############################################################################
+
+def box(width, height):
+    """Wall segments of a width x height room with a corner at the origin."""
+    corners = [(0, 0), (width, 0), (width, height), (0, height)]
+    return [(corners[i], corners[(i + 1) % 4]) for i in range(4)]
+
+
+def scenario(name, rng):
+    """Returns (walls, circular obstacles, start pose) for a scenario."""
+    if name == "arena":
+        return box(3.0, 3.0), [], (1.5, 1.5, rng.uniform(-math.pi, math.pi))
+    if name == "corridor":
+        return box(6.0, 0.8), [], (0.4, 0.4, rng.uniform(-0.3, 0.3))
+    if name == "clutter":
+        obstacles = []
+        while len(obstacles) < 8:
+            x, y, r = rng.uniform(0.3, 3.7), rng.uniform(0.3, 3.7), rng.uniform(0.05, 0.15)
+            if math.hypot(x - 2.0, y - 2.0) > r + ROBOT_RADIUS_M + 0.3:
+                obstacles.append((x, y, r))
+        return box(4.0, 4.0), obstacles, (2.0, 2.0, rng.uniform(-math.pi, math.pi))
+    sys.exit("robot_sim: unknown scenario %s" % name)
+
+
+def ray_segment(ox, oy, dx, dy, segment):
+    """Distance along a ray to a segment, or None."""
+    (x1, y1), (x2, y2) = segment
+    ex, ey = x2 - x1, y2 - y1
+    denom = dx * ey - dy * ex
+    if abs(denom) < 1e-12:
+        return None
+    t = ((x1 - ox) * ey - (y1 - oy) * ex) / denom
+    u = ((x1 - ox) * dy - (y1 - oy) * dx) / denom
+    return t if t >= 0 and 0 <= u <= 1 else None
+
+
+def ray_circle(ox, oy, dx, dy, circle):
+    """Distance along a ray to a circle, or None."""
+    cx, cy, r = circle
+    fx, fy = ox - cx, oy - cy
+    b = fx * dx + fy * dy
+    c = fx * fx + fy * fy - r * r
+    disc = b * b - c
+    if disc < 0:
+        return None
+    t = -b - math.sqrt(disc)
+    return t if t >= 0 else None
+
+
+def point_segment(px, py, segment):
+    """Distance from a point to a segment."""
+    (x1, y1), (x2, y2) = segment
+    ex, ey = x2 - x1, y2 - y1
+    t = max(0.0, min(1.0, ((px - x1) * ex + (py - y1) * ey) / (ex * ex + ey * ey)))
+    return math.hypot(px - (x1 + t * ex), py - (y1 + t * ey))
+
+
+def blocked(x, y, walls, obstacles):
+    """True if the robot footprint at (x, y) touches a wall or obstacle."""
+    if any(point_segment(x, y, wall) < ROBOT_RADIUS_M for wall in walls):
+        return True
+    return any(math.hypot(x - cx, y - cy) < r + ROBOT_RADIUS_M for cx, cy, r in obstacles)
+
+
+def sonar(x, y, heading, walls, obstacles):
+    """Nearest echo in the beam (cm), or None when nothing is in range."""
+    nearest = None
+    for i in range(BEAM_RAYS):
+        angle = heading + math.radians(BEAM_HALF_ANGLE_DEG) * (2.0 * i / (BEAM_RAYS - 1) - 1.0)
+        dx, dy = math.cos(angle), math.sin(angle)
+        hits = [ray_segment(x, y, dx, dy, wall) for wall in walls]
+        hits += [ray_circle(x, y, dx, dy, obstacle) for obstacle in obstacles]
+        hits = [hit for hit in hits if hit is not None]
+        if hits and (nearest is None or min(hits) < nearest):
+            nearest = min(hits)
+    if nearest is None or nearest * 100 > SENSOR_MAX_CM:
+        return None
+    return nearest * 100
+
+
+###############################################################################
+#                                   ROBOT
+###############################################################################
+
+def wheel_speed(duty):
+    """Steady state wheel speed (m/s) for a signed duty cycle (%)."""
+    if duty == 0:
+        return 0.0
+    magnitude = max(MIN_DUTY, min(100, abs(duty)))
+    return math.copysign(MAX_WHEEL_SPEED_MPS * magnitude / 100.0, duty)
+
+
+class Plant:
+    """robot_plant, the firmware on the simulated STM32F303RE, in lock step."""
+
+    def __init__(self, path):
+        self.process = subprocess.Popen([path], stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                                        universal_newlines=True, bufsize=1)
+        self.uart = []
+
+    def step(self):
+        """Reads up to the next step line; returns its fields (UART lines go to self.uart)."""
+        for line in self.process.stdout:
+            if line.startswith("uart "):
+                self.uart.append(line[5:].rstrip("\n"))
+            elif line.startswith("t "):
+                fields = [int(field) for field in line.split()[1:]]
+                return dict(zip(("us", "left", "right", "pings", "left_period", "right_period",
+                                 "left_edges", "right_edges", "distance"), fields))
+        sys.exit("robot_plant: ended early")
+
+    def send(self, line):
+        self.process.stdin.write(line + "\n")
+
+    def close(self):
+        self.process.stdin.close()
+        self.process.wait()
+
+
+def run(name, seed, seconds, plant_path):
+    """Simulates one run and returns its metrics."""
+    rng = random.Random(seed)
+    walls, obstacles, (x, y, heading) = scenario(name, rng)
+    vane_m = math.pi * WHEEL_DIAMETER_M / ENCODER_VANES
+    plant = Plant(plant_path)
+
+    phase = "boot"
+    calibrating_us = auto_us = None
+    asked = seen_calibrate = False
+    speed = [0.0, 0.0]
+    travel = [0.0, 0.0]                     # Wheel travel since the last vane (m)
+    last_edges = [0, 0]
+
+    metrics = {"scenario": name, "seed": seed, "calibration_s": None,
+               "collisions": 0, "distance_m": 0.0, "avoid_entries": 0, "avoid_s": 0.0,
+               "min_range_cm": None, "speed_error_pct": 0.0}
+    touching = avoiding = False
+    error_sum, error_count = 0.0, 0
+
+    while True:
+        out = plant.step()
+        now = out["us"]
+        duty = [out["left"], out["right"]]
+
+        # Operator: calibrate, wait for the report to show manual again, then autonomous
+        reports = [line[len("robot: "):] for line in plant.uart if line.startswith("robot: ")]
+        plant.uart = []
+        if phase == "boot" and now >= BOOT_US:
+            plant.send("uart c")
+            phase, calibrating_us = "calibrate", now
+        elif phase == "calibrate":
+            seen_calibrate |= any(report.startswith("calibrate") for report in reports)
+            if seen_calibrate and any(report.startswith("step manual") for report in reports):
+                metrics["calibration_s"] = round((now - calibrating_us) / 1e6, 2)
+                plant.send("uart a")
+                phase, auto_us = "auto", now
+            elif now - calibrating_us > CALIBRATION_TIMEOUT_US:
+                sys.exit("robot_sim: calibration did not finish")
+            elif reports or not asked:
+                # One report at a time, each is ~150ms of UART output
+                plant.send("uart h")
+                asked = True
+        elif phase == "auto" and now - auto_us >= seconds * 1e6:
+            break
+
+        # Autonomous mode: the firmware's Bus_Ultra distance, and avoiding is turning on the spot
+        if phase == "auto":
+            if out["distance"] >= 0 and (metrics["min_range_cm"] is None or out["distance"] < metrics["min_range_cm"]):
+                metrics["min_range_cm"] = out["distance"]
+            turning = duty[0] < 0 < duty[1]
+            if turning and not avoiding:
+                metrics["avoid_entries"] += 1
+            avoiding = turning
+            if avoiding:
+                metrics["avoid_s"] += STEP_S
+
+        # Encoder_CalculateSpeed()'s input: the firmware's capture period against the wheel
+        for wheel, side in ((0, "left"), (1, "right")):
+            edges = out[side + "_edges"]
+            if edges != last_edges[wheel] and out[side + "_period"] and abs(speed[wheel]) > 0.01:
+                estimate = vane_m / (out[side + "_period"] / 1e6)
+                error_sum += abs(estimate - abs(speed[wheel])) / abs(speed[wheel])
+                error_count += 1
+            last_edges[wheel] = edges
+
+        # Pings (TIM16 started): the echo of what the beam sees now
+        if out["pings"]:
+            range_cm = sonar(x, y, heading, walls, obstacles)
+            if range_cm is not None:
+                plant.send("echo %d %d" % (now, round(range_cm * SOUND_US_PER_CM)))
+
+        # Motors
+        for wheel in (0, 1):
+            speed[wheel] += (wheel_speed(duty[wheel]) - speed[wheel]) * STEP_S / MOTOR_TAU_S
+        v = (speed[0] + speed[1]) / 2.0
+        w = (speed[1] - speed[0]) / TRACK_M
+        nx = x + v * math.cos(heading) * STEP_S
+        ny = y + v * math.sin(heading) * STEP_S
+        heading += w * STEP_S
+        if blocked(nx, ny, walls, obstacles):
+            if not touching:
+                metrics["collisions"] += 1
+            touching = True
+            speed = [0.0 if (s > 0) == (v > 0) else s for s in speed]
+        else:
+            touching = False
+            if phase == "auto":
+                metrics["distance_m"] += math.hypot(nx - x, ny - y)
+            x, y = nx, ny
+
+        # Encoder vanes during the step, captured on TIM2 when they pass
+        for wheel in (0, 1):
+            moved = abs(speed[wheel]) * STEP_S
+            travel[wheel] += moved
+            if travel[wheel] >= vane_m:
+                travel[wheel] -= vane_m
+                plant.send("edge %d %d" % (wheel, now + round(STEP_US * (1.0 - travel[wheel] / moved))))
+
+        plant.send("run %d" % (now + STEP_US))
+
+    plant.close()
+    metrics["distance_m"] = round(metrics["distance_m"], 3)
+    metrics["avoid_s"] = round(metrics["avoid_s"], 3)
+    metrics["speed_error_pct"] = round(100.0 * error_sum / error_count, 2) if error_count else None
+    return metrics
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Deterministic robot regression simulator")
+    parser.add_argument("--scenario", default="clutter", choices=["arena", "corridor", "clutter"])
+    parser.add_argument("--runs", type=int, default=1)
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--seconds", type=float, default=60.0, help="virtual seconds of autonomous driving per run")
+    parser.add_argument("--plant", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "build", "robot_plant"),
+                        help="robot_plant executable (host build)")
+    args = parser.parse_args()
+
+    if not os.access(args.plant, os.X_OK):
+        sys.exit("robot_sim: %s not found, build the host target robot_plant" % args.plant)
+    results = []
+    for seed in range(args.seed, args.seed + args.runs):
+        result = run(args.scenario, seed, args.seconds, args.plant)
+        results.append(result)
+        print(json.dumps(result))
+
+    collided = sum(1 for result in results if result["collisions"])
+    print(json.dumps({"summary": args.scenario, "runs": len(results), "runs_with_collisions": collided,
+                      "collisions": sum(result["collisions"] for result in results),
+                      "mean_distance_m": round(sum(result["distance_m"] for result in results) / len(results), 3)}))
+    return 1 if collided else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+###############################################################################
+# Name: stack_check.py
+# Author(s): Noah Grant, Wyatt Richard
+# Date: October 19, 2026
+# Description: Static worst-case stack check from the armlink callgraph that
+#              Keil writes to .\Objects\<name>.htm (Options for Target >
+#              Listing > Linker Listing > Callgraph).
+#              - Main stack (MSP): main's deepest call chain plus every
+#                exception handler's (IRQs, PendSV, SysTick, faults) deepest
+#                chain and exception frame, as if they all nested at once,
+#                against Stack_Size in startup_stm32f303xe.s.
+#              - Each kernel task stack (PSP): the entry function's deepest
+#                chain, the exception frame an interrupt stacks on it and the
+#                registers PendSV_Handler saves there, against the stack size
+#                passed to Kernel_TaskCreate() in the sources.
+#              Calls through function pointers (state machine handlers, boot
+#              steps) are not in the callgraph, so keep some margin.
+#              Exits with status 1 if any stack can overflow.
+#
+# Usage: python3 stack_check.py "Objects/ESS Lab 4 Keypad.htm" [--top N]
+#        [--frame BYTES] [--startup startup_stm32f303xe.s] [--src DIR]
+###############################################################################
+
+import argparse
+import glob
+import html
+import os
+import re
+import sys
+
+# <P><STRONG><a name="[5]"></a>main</STRONG> (Thumb, 96 bytes, Stack size 24 bytes, main.o(.text))
+FUNCTION = re.compile(r"<STRONG>(?:<a name=\"[^\"]*\"></a>)?([^<]+)</STRONG>\s*\((?:Thumb|ARM), \d+ bytes, "
+                      r"Stack size (\d+) bytes")
+MAX_DEPTH = re.compile(r"Max Depth = (\d+)")
+STACK_SIZE = re.compile(r"^Stack_Size\s+EQU\s+(0x[0-9a-fA-F]+|\d+)", re.MULTILINE)
+# Kernel_TaskCreate(&task, "name", Entry, arg, stack, STACK_WORDS, priority);
+TASK_CREATE = re.compile(r"Kernel_TaskCreate\(\s*&\w+\s*,\s*\"([^\"]*)\"\s*,\s*(\w+)\s*,\s*\w+\s*,\s*\w+\s*,\s*(\w+)\s*,")
+DEFINE = re.compile(r"^#define\s+(\w+)\s+\(?(\d+)U?L?\)?", re.MULTILINE)
+
+EXCEPTION_FRAME = 32    # R0-R3, R12, LR, PC, xPSR (104 with a lazily stacked FPU context)
+TASK_FRAME = 104        # Interrupted task's stacked frame, FPU context included
+PENDSV_SAVE = 100       # R4-R11, EXC_RETURN and S16-S31 saved by PendSV_Handler
+
+
+def parse_callgraph(path):
+    """Returns {function: (own stack bytes, max depth bytes)}."""
+    functions = {}
+    with open(path, errors="replace") as source:
+        text = source.read()
+    entries = list(FUNCTION.finditer(text))
+    for index, match in enumerate(entries):
+        end = entries[index + 1].start() if index + 1 < len(entries) else len(text)
+        own = int(match.group(2))
+        depth = MAX_DEPTH.search(text, match.end(), end)
+        functions[html.unescape(match.group(1)).strip()] = (own, int(depth.group(1)) if depth else own)
+    return functions
+
+
+def parse_stack_size(path):
+    with open(path, errors="replace") as source:
+        match = STACK_SIZE.search(source.read())
+    if not match:
+        sys.exit("Stack_Size not found in %s" % path)
+    return int(match.group(1), 0)
+
+
+def parse_tasks(directory):
+    """Returns [(task name, entry function, stack bytes)] from the Kernel_TaskCreate() calls."""
+    defines = {}
+    calls = []
+    for path in sorted(glob.glob(os.path.join(directory, "*.[ch]"))):
+        with open(path, errors="replace") as source:
+            text = source.read()
+        defines.update((name, int(value)) for name, value in DEFINE.findall(text))
+        calls += TASK_CREATE.findall(text)
+    tasks = []
+    for name, entry, words in calls:
+        if words not in defines and not words.isdigit():
+            sys.exit("Stack size %s of task %s not found in %s" % (words, name, directory))
+        tasks.append((name, entry, 4 * (int(words) if words.isdigit() else defines[words])))
+    return tasks
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Static worst-case stack check")
+    parser.add_argument("callgraph")
+    parser.add_argument("--startup", default="startup_stm32f303xe.s")
+    parser.add_argument("--frame", type=int, default=EXCEPTION_FRAME)
+    parser.add_argument("--top", type=int, default=15)
+    parser.add_argument("--src", default=os.path.dirname(os.path.abspath(__file__)))
+    args = parser.parse_args()
+
+    functions = parse_callgraph(args.callgraph)
+    stack_size = parse_stack_size(args.startup)
+    tasks = parse_tasks(args.src)
+    if "main" not in functions:
+        sys.exit("main not found in %s" % args.callgraph)
+    fail = False
+
+    print("%-32s %8s %10s" % ("Function", "Own", "Max depth"))
+    for name, (own, depth) in sorted(functions.items(), key=lambda item: -item[1][1])[:args.top]:
+        print("%-32s %8d %10d" % (name, own, depth))
+
+    # Every exception handler in the vector table ends in _Handler or _IRQHandler
+    handlers = {name: depth for name, (own, depth) in functions.items() if name.endswith(("_Handler", "_IRQHandler"))}
+    worst = functions["main"][1]
+    print("\nMain stack (MSP)")
+    print("%-32s %10d" % ("main", worst))
+    for name, depth in sorted(handlers.items()):
+        print("%-32s %10d  +%d frame" % (name, depth, args.frame))
+        worst += depth + args.frame
+    print("Worst case %d of %d bytes (%d%%)" % (worst, stack_size, worst * 100 // stack_size))
+    if worst > stack_size:
+        print("FAIL: worst case exceeds Stack_Size")
+        fail = True
+
+    print("\nTask stacks (PSP)")
+    for name, entry, size in tasks:
+        if entry not in functions:
+            print("%-10s %-22s not in callgraph  FAIL" % (name, entry))
+            fail = True
+            continue
+        worst = functions[entry][1] + TASK_FRAME + PENDSV_SAVE
+        print("%-10s %-22s %6d of %6d bytes (%d%%)%s" % (name, entry, worst, size, worst * 100 // size,
+                                                          "  FAIL" if worst > size else ""))
+        fail = fail or worst > size
+
+    if fail:
+        sys.exit(1)
+    print("OK")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,493 @@
+@******************** (C) COPYRIGHT 2016 STMicroelectronics ********************
+@* File Name          : startup_stm32f303xe_gcc.s
+@* Author             : MCD Application Team
+@* Description        : STM32F303xE devices vector table for the GNU toolchain.
+@*                      GNU assembler port of startup_stm32f303xe.s (MDK-ARM) for
+@*                      the CMake build. The stack, heap and vector table are the
+@*                      same. This module performs:
+@*                      - Set the initial SP
+@*                      - Set the initial PC == Reset_Handler
+@*                      - Set the vector table entries with the exceptions ISR address
+@*                      - Calls SystemInit, then does what __main does under
+@*                        armlink: copies .data and the CCM RAM code from flash,
+@*                        zeroes .bss and .bss.ccmram, runs the C library
+@*                        constructors and calls main().
+@*                      After Reset the CortexM4 processor is in Thread mode,
+@*                      priority is Privileged, and the Stack is set to Main.
+@*
+@*******************************************************************************
+@
+@* Redistribution and use in source and binary forms, with or without modification,
+@* are permitted provided that the following conditions are met:
+@*   1. Redistributions of source code must retain the above copyright notice,
+@*      this list of conditions and the following disclaimer.
+@*   2. Redistributions in binary form must reproduce the above copyright notice,
+@*      this list of conditions and the following disclaimer in the documentation
+@*      and/or other materials provided with the distribution.
+@*   3. Neither the name of STMicroelectronics nor the names of its contributors
+@*      may be used to endorse or promote products derived from this software
+@*      without specific prior written permission.
+@*
+@* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+@* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+@* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+@* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+@* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+@* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+@* SERVICES@ LOSS OF USE, DATA, OR PROFITS@ OR BUSINESS INTERRUPTION) HOWEVER
+@* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+@* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+@* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@
+@*******************************************************************************
+
+
+                .syntax unified
+                .cpu    cortex-m4
+                .fpu    softvfp
+                .thumb
+
+@ Amount of memory (in bytes) allocated for Stack and Heap, as in startup_stm32f303xe.s
+                .equ    Stack_Size, 0x400
+                .equ    Heap_Size, 0x200
+
+                .section .stack, "aw", %nobits
+                .align  3
+Stack_Mem:      .space  Stack_Size
+                .global __initial_sp
+__initial_sp:
+
+                .section .heap, "aw", %nobits
+                .align  3
+                .global __heap_base
+__heap_base:
+Heap_Mem:       .space  Heap_Size
+                .global __heap_limit
+__heap_limit:
+
+
+@ Vector Table Mapped to Address 0 at Reset
+                .section .isr_vector, "a", %progbits
+                .global __Vectors
+                .global __Vectors_End
+                .global __Vectors_Size
+                .type   __Vectors, %object
+
+__Vectors:
+                .word   __initial_sp                      @ Top of Stack
+                .word   Reset_Handler                     @ Reset Handler
+                .word   NMI_Handler                       @ NMI Handler
+                .word   HardFault_Handler                 @ Hard Fault Handler
+                .word   MemManage_Handler                 @ MPU Fault Handler
+                .word   BusFault_Handler                  @ Bus Fault Handler
+                .word   UsageFault_Handler                @ Usage Fault Handler
+                .word   0                                 @ Reserved
+                .word   0                                 @ Reserved
+                .word   0                                 @ Reserved
+                .word   0                                 @ Reserved
+                .word   SVC_Handler                       @ SVCall Handler
+                .word   DebugMon_Handler                  @ Debug Monitor Handler
+                .word   0                                 @ Reserved
+                .word   PendSV_Handler                    @ PendSV Handler
+                .word   SysTick_Handler                   @ SysTick Handler
+                .word   WWDG_IRQHandler                   @ Window WatchDog
+                .word   PVD_IRQHandler                    @ PVD through EXTI Line detection
+                .word   TAMP_STAMP_IRQHandler             @ Tamper and TimeStamps through the EXTI line
+                .word   RTC_WKUP_IRQHandler               @ RTC Wakeup through the EXTI line
+                .word   FLASH_IRQHandler                  @ FLASH
+                .word   RCC_IRQHandler                    @ RCC
+                .word   EXTI0_IRQHandler                  @ EXTI Line0
+                .word   EXTI1_IRQHandler                  @ EXTI Line1
+                .word   EXTI2_TSC_IRQHandler              @ EXTI Line2 and Touch Sense controller
+                .word   EXTI3_IRQHandler                  @ EXTI Line3
+                .word   EXTI4_IRQHandler                  @ EXTI Line4
+                .word   DMA1_Channel1_IRQHandler          @ DMA1 Channel 1
+                .word   DMA1_Channel2_IRQHandler          @ DMA1 Channel 2
+                .word   DMA1_Channel3_IRQHandler          @ DMA1 Channel 3
+                .word   DMA1_Channel4_IRQHandler          @ DMA1 Channel 4
+                .word   DMA1_Channel5_IRQHandler          @ DMA1 Channel 5
+                .word   DMA1_Channel6_IRQHandler          @ DMA1 Channel 6
+                .word   DMA1_Channel7_IRQHandler          @ DMA1 Channel 7
+                .word   ADC1_2_IRQHandler                 @ ADC1 and ADC2
+                .word   USB_HP_CAN_TX_IRQHandler          @ USB Device High Priority or CAN TX
+                .word   USB_LP_CAN_RX0_IRQHandler         @ USB Device Low Priority or CAN RX0
+                .word   CAN_RX1_IRQHandler                @ CAN RX1
+                .word   CAN_SCE_IRQHandler                @ CAN SCE
+                .word   EXTI9_5_IRQHandler                @ External Line[9:5]s
+                .word   TIM1_BRK_TIM15_IRQHandler         @ TIM1 Break and TIM15
+                .word   TIM1_UP_TIM16_IRQHandler          @ TIM1 Update and TIM16
+                .word   TIM1_TRG_COM_TIM17_IRQHandler     @ TIM1 Trigger and Commutation and TIM17
+                .word   TIM1_CC_IRQHandler                @ TIM1 Capture Compare
+                .word   TIM2_IRQHandler                   @ TIM2
+                .word   TIM3_IRQHandler                   @ TIM3
+                .word   TIM4_IRQHandler                   @ TIM4
+                .word   I2C1_EV_IRQHandler                @ I2C1 Event
+                .word   I2C1_ER_IRQHandler                @ I2C1 Error
+                .word   I2C2_EV_IRQHandler                @ I2C2 Event
+                .word   I2C2_ER_IRQHandler                @ I2C2 Error
+                .word   SPI1_IRQHandler                   @ SPI1
+                .word   SPI2_IRQHandler                   @ SPI2
+                .word   USART1_IRQHandler                 @ USART1
+                .word   USART2_IRQHandler                 @ USART2
+                .word   USART3_IRQHandler                 @ USART3
+                .word   EXTI15_10_IRQHandler              @ External Line[15:10]s
+                .word   RTC_Alarm_IRQHandler              @ RTC Alarm (A and B) through EXTI Line
+                .word   USBWakeUp_IRQHandler              @ USB Wakeup through EXTI line
+                .word   TIM8_BRK_IRQHandler               @ TIM8 Break
+                .word   TIM8_UP_IRQHandler                @ TIM8 Update
+                .word   TIM8_TRG_COM_IRQHandler           @ TIM8 Trigger and Commutation
+                .word   TIM8_CC_IRQHandler                @ TIM8 Capture Compare
+                .word   ADC3_IRQHandler                   @ ADC3
+                .word   FMC_IRQHandler                    @ FMC
+                .word   0                                 @ Reserved
+                .word   0                                 @ Reserved
+                .word   SPI3_IRQHandler                   @ SPI3
+                .word   UART4_IRQHandler                  @ UART4
+                .word   UART5_IRQHandler                  @ UART5
+                .word   TIM6_DAC_IRQHandler               @ TIM6 and DAC1&2 underrun errors
+                .word   TIM7_IRQHandler                   @ TIM7
+                .word   DMA2_Channel1_IRQHandler          @ DMA2 Channel 1
+                .word   DMA2_Channel2_IRQHandler          @ DMA2 Channel 2
+                .word   DMA2_Channel3_IRQHandler          @ DMA2 Channel 3
+                .word   DMA2_Channel4_IRQHandler          @ DMA2 Channel 4
+                .word   DMA2_Channel5_IRQHandler          @ DMA2 Channel 5
+                .word   ADC4_IRQHandler                   @ ADC4
+                .word   0                                 @ Reserved
+                .word   0                                 @ Reserved
+                .word   COMP1_2_3_IRQHandler              @ COMP1, COMP2 and COMP3
+                .word   COMP4_5_6_IRQHandler              @ COMP4, COMP5 and COMP6
+                .word   COMP7_IRQHandler                  @ COMP7
+                .word   0                                 @ Reserved
+                .word   0                                 @ Reserved
+                .word   0                                 @ Reserved
+                .word   0                                 @ Reserved
+                .word   0                                 @ Reserved
+                .word   I2C3_EV_IRQHandler                @ I2C3 Event
+                .word   I2C3_ER_IRQHandler                @ I2C3 Error
+                .word   USB_HP_IRQHandler                 @ USB High Priority remap
+                .word   USB_LP_IRQHandler                 @ USB Low Priority remap
+                .word   USBWakeUp_RMP_IRQHandler          @ USB Wakeup remap through EXTI
+                .word   TIM20_BRK_IRQHandler              @ TIM20 Break
+                .word   TIM20_UP_IRQHandler               @ TIM20 Update
+                .word   TIM20_TRG_COM_IRQHandler          @ TIM20 Trigger and Commutation
+                .word   TIM20_CC_IRQHandler               @ TIM20 Capture Compare
+                .word   FPU_IRQHandler                    @ FPU
+                .word   0                                 @ Reserved
+                .word   0                                 @ Reserved
+                .word   SPI4_IRQHandler                   @ SPI4
+
+__Vectors_End:
+                .equ    __Vectors_Size, __Vectors_End - __Vectors
+                .size   __Vectors, . - __Vectors
+
+
+                .text
+
+@ Reset handler
+                .weak   Reset_Handler
+                .type   Reset_Handler, %function
+Reset_Handler:
+                ldr     r0, =SystemInit
+                blx     r0
+
+@ Copy .data and the CCM RAM code (section, load address and size from the linker script)
+                ldr     r0, =_sdata
+                ldr     r1, =_sidata
+                ldr     r2, =_edata
+                bl      CopyDown
+                ldr     r0, =_sccmram
+                ldr     r1, =_siccmram
+                ldr     r2, =_eccmram
+                bl      CopyDown
+
+@ Zero .bss and the CCM RAM data
+                movs    r3, #0
+                ldr     r0, =_sbss
+                ldr     r2, =_ebss
+                bl      ZeroFill
+                ldr     r0, =_sccmbss
+                ldr     r2, =_eccmbss
+                bl      ZeroFill
+
+                bl      __libc_init_array
+                bl      main
+                b       .
+                .size   Reset_Handler, . - Reset_Handler
+
+@ Copies words from r1 to r0 until r0 reaches r2
+                .type   CopyDown, %function
+CopyDown:
+                cmp     r0, r2
+                itt     lo
+                ldrlo   r3, [r1], #4
+                strlo   r3, [r0], #4
+                blo     CopyDown
+                bx      lr
+                .size   CopyDown, . - CopyDown
+
+@ Stores r3 (zero) from r0 until r0 reaches r2
+                .type   ZeroFill, %function
+ZeroFill:
+                cmp     r0, r2
+                itt     lo
+                strlo   r3, [r0], #4
+                blo     ZeroFill
+                bx      lr
+                .size   ZeroFill, . - ZeroFill
+
+@ Dummy Exception Handlers (infinite loops which can be modified)
+                .type   Default_Handler, %function
+Default_Handler:
+                b       .
+                .size   Default_Handler, . - Default_Handler
+
+                .weak   NMI_Handler
+                .thumb_set NMI_Handler, Default_Handler
+
+                .weak   HardFault_Handler
+                .thumb_set HardFault_Handler, Default_Handler
+
+                .weak   MemManage_Handler
+                .thumb_set MemManage_Handler, Default_Handler
+
+                .weak   BusFault_Handler
+                .thumb_set BusFault_Handler, Default_Handler
+
+                .weak   UsageFault_Handler
+                .thumb_set UsageFault_Handler, Default_Handler
+
+                .weak   SVC_Handler
+                .thumb_set SVC_Handler, Default_Handler
+
+                .weak   DebugMon_Handler
+                .thumb_set DebugMon_Handler, Default_Handler
+
+                .weak   PendSV_Handler
+                .thumb_set PendSV_Handler, Default_Handler
+
+                .weak   SysTick_Handler
+                .thumb_set SysTick_Handler, Default_Handler
+
+                .weak   WWDG_IRQHandler
+                .thumb_set WWDG_IRQHandler, Default_Handler
+
+                .weak   PVD_IRQHandler
+                .thumb_set PVD_IRQHandler, Default_Handler
+
+                .weak   TAMP_STAMP_IRQHandler
+                .thumb_set TAMP_STAMP_IRQHandler, Default_Handler
+
+                .weak   RTC_WKUP_IRQHandler
+                .thumb_set RTC_WKUP_IRQHandler, Default_Handler
+
+                .weak   FLASH_IRQHandler
+                .thumb_set FLASH_IRQHandler, Default_Handler
+
+                .weak   RCC_IRQHandler
+                .thumb_set RCC_IRQHandler, Default_Handler
+
+                .weak   EXTI0_IRQHandler
+                .thumb_set EXTI0_IRQHandler, Default_Handler
+
+                .weak   EXTI1_IRQHandler
+                .thumb_set EXTI1_IRQHandler, Default_Handler
+
+                .weak   EXTI2_TSC_IRQHandler
+                .thumb_set EXTI2_TSC_IRQHandler, Default_Handler
+
+                .weak   EXTI3_IRQHandler
+                .thumb_set EXTI3_IRQHandler, Default_Handler
+
+                .weak   EXTI4_IRQHandler
+                .thumb_set EXTI4_IRQHandler, Default_Handler
+
+                .weak   DMA1_Channel1_IRQHandler
+                .thumb_set DMA1_Channel1_IRQHandler, Default_Handler
+
+                .weak   DMA1_Channel2_IRQHandler
+                .thumb_set DMA1_Channel2_IRQHandler, Default_Handler
+
+                .weak   DMA1_Channel3_IRQHandler
+                .thumb_set DMA1_Channel3_IRQHandler, Default_Handler
+
+                .weak   DMA1_Channel4_IRQHandler
+                .thumb_set DMA1_Channel4_IRQHandler, Default_Handler
+
+                .weak   DMA1_Channel5_IRQHandler
+                .thumb_set DMA1_Channel5_IRQHandler, Default_Handler
+
+                .weak   DMA1_Channel6_IRQHandler
+                .thumb_set DMA1_Channel6_IRQHandler, Default_Handler
+
+                .weak   DMA1_Channel7_IRQHandler
+                .thumb_set DMA1_Channel7_IRQHandler, Default_Handler
+
+                .weak   ADC1_2_IRQHandler
+                .thumb_set ADC1_2_IRQHandler, Default_Handler
+
+                .weak   USB_HP_CAN_TX_IRQHandler
+                .thumb_set USB_HP_CAN_TX_IRQHandler, Default_Handler
+
+                .weak   USB_LP_CAN_RX0_IRQHandler
+                .thumb_set USB_LP_CAN_RX0_IRQHandler, Default_Handler
+
+                .weak   CAN_RX1_IRQHandler
+                .thumb_set CAN_RX1_IRQHandler, Default_Handler
+
+                .weak   CAN_SCE_IRQHandler
+                .thumb_set CAN_SCE_IRQHandler, Default_Handler
+
+                .weak   EXTI9_5_IRQHandler
+                .thumb_set EXTI9_5_IRQHandler, Default_Handler
+
+                .weak   TIM1_BRK_TIM15_IRQHandler
+                .thumb_set TIM1_BRK_TIM15_IRQHandler, Default_Handler
+
+                .weak   TIM1_UP_TIM16_IRQHandler
+                .thumb_set TIM1_UP_TIM16_IRQHandler, Default_Handler
+
+                .weak   TIM1_TRG_COM_TIM17_IRQHandler
+                .thumb_set TIM1_TRG_COM_TIM17_IRQHandler, Default_Handler
+
+                .weak   TIM1_CC_IRQHandler
+                .thumb_set TIM1_CC_IRQHandler, Default_Handler
+
+                .weak   TIM2_IRQHandler
+                .thumb_set TIM2_IRQHandler, Default_Handler
+
+                .weak   TIM3_IRQHandler
+                .thumb_set TIM3_IRQHandler, Default_Handler
+
+                .weak   TIM4_IRQHandler
+                .thumb_set TIM4_IRQHandler, Default_Handler
+
+                .weak   I2C1_EV_IRQHandler
+                .thumb_set I2C1_EV_IRQHandler, Default_Handler
+
+                .weak   I2C1_ER_IRQHandler
+                .thumb_set I2C1_ER_IRQHandler, Default_Handler
+
+                .weak   I2C2_EV_IRQHandler
+                .thumb_set I2C2_EV_IRQHandler, Default_Handler
+
+                .weak   I2C2_ER_IRQHandler
+                .thumb_set I2C2_ER_IRQHandler, Default_Handler
+
+                .weak   SPI1_IRQHandler
+                .thumb_set SPI1_IRQHandler, Default_Handler
+
+                .weak   SPI2_IRQHandler
+                .thumb_set SPI2_IRQHandler, Default_Handler
+
+                .weak   USART1_IRQHandler
+                .thumb_set USART1_IRQHandler, Default_Handler
+
+                .weak   USART2_IRQHandler
+                .thumb_set USART2_IRQHandler, Default_Handler
+
+                .weak   USART3_IRQHandler
+                .thumb_set USART3_IRQHandler, Default_Handler
+
+                .weak   EXTI15_10_IRQHandler
+                .thumb_set EXTI15_10_IRQHandler, Default_Handler
+
+                .weak   RTC_Alarm_IRQHandler
+                .thumb_set RTC_Alarm_IRQHandler, Default_Handler
+
+                .weak   USBWakeUp_IRQHandler
+                .thumb_set USBWakeUp_IRQHandler, Default_Handler
+
+                .weak   TIM8_BRK_IRQHandler
+                .thumb_set TIM8_BRK_IRQHandler, Default_Handler
+
+                .weak   TIM8_UP_IRQHandler
+                .thumb_set TIM8_UP_IRQHandler, Default_Handler
+
+                .weak   TIM8_TRG_COM_IRQHandler
+                .thumb_set TIM8_TRG_COM_IRQHandler, Default_Handler
+
+                .weak   TIM8_CC_IRQHandler
+                .thumb_set TIM8_CC_IRQHandler, Default_Handler
+
+                .weak   ADC3_IRQHandler
+                .thumb_set ADC3_IRQHandler, Default_Handler
+
+                .weak   FMC_IRQHandler
+                .thumb_set FMC_IRQHandler, Default_Handler
+
+                .weak   SPI3_IRQHandler
+                .thumb_set SPI3_IRQHandler, Default_Handler
+
+                .weak   UART4_IRQHandler
+                .thumb_set UART4_IRQHandler, Default_Handler
+
+                .weak   UART5_IRQHandler
+                .thumb_set UART5_IRQHandler, Default_Handler
+
+                .weak   TIM6_DAC_IRQHandler
+                .thumb_set TIM6_DAC_IRQHandler, Default_Handler
+
+                .weak   TIM7_IRQHandler
+                .thumb_set TIM7_IRQHandler, Default_Handler
+
+                .weak   DMA2_Channel1_IRQHandler
+                .thumb_set DMA2_Channel1_IRQHandler, Default_Handler
+
+                .weak   DMA2_Channel2_IRQHandler
+                .thumb_set DMA2_Channel2_IRQHandler, Default_Handler
+
+                .weak   DMA2_Channel3_IRQHandler
+                .thumb_set DMA2_Channel3_IRQHandler, Default_Handler
+
+                .weak   DMA2_Channel4_IRQHandler
+                .thumb_set DMA2_Channel4_IRQHandler, Default_Handler
+
+                .weak   DMA2_Channel5_IRQHandler
+                .thumb_set DMA2_Channel5_IRQHandler, Default_Handler
+
+                .weak   ADC4_IRQHandler
+                .thumb_set ADC4_IRQHandler, Default_Handler
+
+                .weak   COMP1_2_3_IRQHandler
+                .thumb_set COMP1_2_3_IRQHandler, Default_Handler
+
+                .weak   COMP4_5_6_IRQHandler
+                .thumb_set COMP4_5_6_IRQHandler, Default_Handler
+
+                .weak   COMP7_IRQHandler
+                .thumb_set COMP7_IRQHandler, Default_Handler
+
+                .weak   I2C3_EV_IRQHandler
+                .thumb_set I2C3_EV_IRQHandler, Default_Handler
+
+                .weak   I2C3_ER_IRQHandler
+                .thumb_set I2C3_ER_IRQHandler, Default_Handler
+
+                .weak   USB_HP_IRQHandler
+                .thumb_set USB_HP_IRQHandler, Default_Handler
+
+                .weak   USB_LP_IRQHandler
+                .thumb_set USB_LP_IRQHandler, Default_Handler
+
+                .weak   USBWakeUp_RMP_IRQHandler
+                .thumb_set USBWakeUp_RMP_IRQHandler, Default_Handler
+
+                .weak   TIM20_BRK_IRQHandler
+                .thumb_set TIM20_BRK_IRQHandler, Default_Handler
+
+                .weak   TIM20_UP_IRQHandler
+                .thumb_set TIM20_UP_IRQHandler, Default_Handler
+
+                .weak   TIM20_TRG_COM_IRQHandler
+                .thumb_set TIM20_TRG_COM_IRQHandler, Default_Handler
+
+                .weak   TIM20_CC_IRQHandler
+                .thumb_set TIM20_CC_IRQHandler, Default_Handler
+
+                .weak   FPU_IRQHandler
+                .thumb_set FPU_IRQHandler, Default_Handler
+
+                .weak   SPI4_IRQHandler
+                .thumb_set SPI4_IRQHandler, Default_Handler
+
+@************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE*****
@@ -0,0 +1,244 @@
+/********************************************************************************
+* Name: AtomicTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Atomic.h under ThreadSanitizer. Host threads stand in for main
+*							 and the ISRs (host/HostThreads.c): several threads hammer
+*							 Atomic_Add(), Atomic_Or() and Atomic_And() on shared words, count
+*							 in nested critical sections against an ISR thread, and read a
+*							 seqlock an ISR thread keeps rewriting. The totals must come out
+*							 exact, no seqlock copy may be torn, and ThreadSanitizer must not
+*							 report a race. With --unprotected the thread mode count skips
+*							 its critical section, and ThreadSanitizer must report it.
+*
+* Usage: AtomicTest [--unprotected]
+********************************************************************************/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include "HostThreads.h"
+#include "Atomic.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define ATOMIC_TEST_THREADS		4				// Thread mode contexts
+#define ATOMIC_TEST_LOOPS			20000		// Operations per thread and test
+#define ATOMIC_TEST_WORDS			4				// Words behind the seqlock
+
+// Records a failure with its line unless cond holds
+#define ATOMIC_TEST_CHECK(cond)	AtomicTest_Check((cond), __LINE__, #cond)
+
+// Data an ISR publishes under the seqlock, every word holds the sample number
+typedef struct {
+	uint32_t words[ATOMIC_TEST_WORDS];
+} AtomicTest_Sample;
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static volatile uint32_t counter;					// Atomic_Add()
+static volatile uint32_t flags;						// Atomic_Or() and Atomic_And(), a bit per thread
+static uint32_t shared;										// Plain word, critical sections only
+static Seqlock lock;
+static AtomicTest_Sample sample;
+static uint32_t retries;									// Seqlock copies taken again
+static uint32_t tornCopies;								// Words that differ within a copy
+static uint32_t failures;
+static pthread_barrier_t start;						// Lets every thread go at once
+static int unprotected;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* AtomicTest_Check() - Record a failed check.
+* ok			- Check result.
+* line		- Source line.
+* text		- Check as written.
+* No return value.
+*************************************************************/
+static void AtomicTest_Check(int ok, int line, const char *text){
+	if(!ok){
+		__atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED);
+		fprintf(stderr, "AtomicTest.c:%d: check failed: %s\n", line, text);
+	}
+}
+
+/*************************************************************
+* AtomicTest_Run() - Run a function on every thread and wait for them.
+* fn			- Thread body, gets the thread index.
+* No return value.
+*************************************************************/
+static void AtomicTest_Run(void *(*fn)(void *arg)){
+	pthread_t threads[ATOMIC_TEST_THREADS];
+
+	for(uintptr_t i = 0; i < ATOMIC_TEST_THREADS; i++){
+		pthread_create(&threads[i], NULL, fn, (void *)i);
+	}
+	for(uint32_t i = 0; i < ATOMIC_TEST_THREADS; i++){
+		pthread_join(threads[i], NULL);
+	}
+}
+
+/*************************************************************
+* AtomicTest_Add() - Count with Atomic_Add().
+* arg			- Thread index.
+* Returns NULL.
+*************************************************************/
+static void *AtomicTest_Add(void *arg){
+	pthread_barrier_wait(&start);
+	for(uint32_t i = 0; i < ATOMIC_TEST_LOOPS; i++){
+		(void)Atomic_Add(&counter, 1);
+	}
+	return(NULL);
+}
+
+/*************************************************************
+* AtomicTest_Bits() - Set and clear this thread's bit, the others' stay.
+* arg			- Thread index, the bit.
+* Returns NULL.
+*************************************************************/
+static void *AtomicTest_Bits(void *arg){
+	uint32_t bit = 1UL << (uintptr_t)arg;
+
+	pthread_barrier_wait(&start);
+	for(uint32_t i = 0; i < ATOMIC_TEST_LOOPS; i++){
+		ATOMIC_TEST_CHECK((Atomic_Or(&flags, bit) & bit) != 0);
+		ATOMIC_TEST_CHECK((Atomic_And(&flags, ~bit) & bit) == 0);
+	}
+	return(NULL);
+}
+
+/*************************************************************
+* AtomicTest_IsrCount() - ISR body: count the shared word.
+* arg			- Unused.
+* No return value.
+*************************************************************/
+static void AtomicTest_IsrCount(void *arg){
+	shared++;
+}
+
+/*************************************************************
+* AtomicTest_Critical() - Count the shared word in nested critical sections,
+*												 thread 0 as an ISR.
+* arg			- Thread index.
+* Returns NULL.
+*************************************************************/
+static void *AtomicTest_Critical(void *arg){
+	uint32_t outer, inner;
+
+	pthread_barrier_wait(&start);
+	for(uint32_t i = 0; i < ATOMIC_TEST_LOOPS; i++){
+		if((uintptr_t)arg == 0){
+			HostThreads_Isr(AtomicTest_IsrCount, NULL);
+		}
+		else if(unprotected){
+			shared++;
+		}
+		else{
+			outer = Atomic_Enter();
+			inner = Atomic_Enter();
+			shared++;
+			Atomic_Exit(inner);
+			ATOMIC_TEST_CHECK(Host_GetPrimask() == 1);		// The inner exit must not unmask
+			Atomic_Exit(outer);
+			ATOMIC_TEST_CHECK(Host_GetPrimask() == 0);
+		}
+	}
+	return(NULL);
+}
+
+/*************************************************************
+* AtomicTest_IsrPublish() - ISR body: write the next sample under the seqlock.
+* arg			- Sample number.
+* No return value.
+*************************************************************/
+static void AtomicTest_IsrPublish(void *arg){
+	Seqlock_WriteBegin(&lock);
+	for(uint32_t w = 0; w < ATOMIC_TEST_WORDS; w++){
+		__atomic_store_n(&sample.words[w], (uint32_t)(uintptr_t)arg, __ATOMIC_RELAXED);
+	}
+	Seqlock_WriteEnd(&lock);
+}
+
+/*************************************************************
+* AtomicTest_Seqlock() - Thread 0 publishes as an ISR, the others copy samples.
+* arg			- Thread index.
+* Returns NULL.
+*************************************************************/
+static void *AtomicTest_Seqlock(void *arg){
+	AtomicTest_Sample copy;
+	uint32_t seq, last = 0, again = 0, torn = 0;
+
+	pthread_barrier_wait(&start);
+	for(uint32_t i = 1; i <= ATOMIC_TEST_LOOPS; i++){
+		if((uintptr_t)arg == 0){
+			HostThreads_Isr(AtomicTest_IsrPublish, (void *)(uintptr_t)i);
+			continue;
+		}
+		// The word by word copy on the M4 is plain LDRs, relaxed loads are the same
+		for(;;){
+			seq = Seqlock_ReadBegin(&lock);
+			for(uint32_t w = 0; w < ATOMIC_TEST_WORDS; w++){
+				copy.words[w] = __atomic_load_n(&sample.words[w], __ATOMIC_RELAXED);
+			}
+			if(!Seqlock_ReadRetry(&lock, seq)){
+				break;
+			}
+			again++;
+		}
+
+		for(uint32_t w = 1; w < ATOMIC_TEST_WORDS; w++){
+			torn += (copy.words[w] != copy.words[0]);
+		}
+		ATOMIC_TEST_CHECK(copy.words[0] >= last);		// Samples never go back
+		last = copy.words[0];
+	}
+	__atomic_fetch_add(&retries, again, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&tornCopies, torn, __ATOMIC_RELAXED);
+	return(NULL);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(int argc, char **argv){
+	uint32_t total = ATOMIC_TEST_THREADS * ATOMIC_TEST_LOOPS;
+
+	unprotected = (argc > 1 && strcmp(argv[1], "--unprotected") == 0);
+	pthread_barrier_init(&start, NULL, ATOMIC_TEST_THREADS);
+
+	AtomicTest_Run(AtomicTest_Add);
+	ATOMIC_TEST_CHECK(counter == total);
+	printf("Atomic_Add:            %u threads x %u adds = %u, %u STREX retries\n",
+		ATOMIC_TEST_THREADS, ATOMIC_TEST_LOOPS, counter, HostThreads_StrexFailures());
+
+	AtomicTest_Run(AtomicTest_Bits);
+	ATOMIC_TEST_CHECK(flags == 0);
+	printf("Atomic_Or/And:         %u set/clear pairs, word 0x%08X, %u STREX retries in all\n",
+		total, flags, HostThreads_StrexFailures());
+
+	AtomicTest_Run(AtomicTest_Critical);
+	ATOMIC_TEST_CHECK(shared == total);
+	printf("Atomic_Enter/Exit:     %u counts (1 ISR, %u nested critical sections), shared = %u\n",
+		total, ATOMIC_TEST_THREADS - 1, shared);
+
+	AtomicTest_Run(AtomicTest_Seqlock);
+	ATOMIC_TEST_CHECK(sample.words[0] == ATOMIC_TEST_LOOPS);
+	ATOMIC_TEST_CHECK(tornCopies == 0);
+	printf("Seqlock:               %u samples, %u copies by %u readers, %u retried, %u torn words\n",
+		ATOMIC_TEST_LOOPS, (ATOMIC_TEST_THREADS - 1) * ATOMIC_TEST_LOOPS, ATOMIC_TEST_THREADS - 1, retries, tornCopies);
+
+	printf("%s\n", (failures == 0) ? "passed" : "failed");
+	return(failures != 0);
+}
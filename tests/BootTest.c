@@ -0,0 +1,75 @@
+/********************************************************************************
+* Name: BootTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Runs the unmodified firmware on the simulator: it must boot, keep
+*							 its 1 MHz timebase and answer the kernel and CPU load commands.
+********************************************************************************/
+
+#include <stdio.h>
+#include "Harness.h"
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static uint32_t tim2At1s;
+static uint32_t tim2At2s;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* BootTest_Sample() - Sample the free running TIM2 counter.
+* arg			- Where to keep it.
+* No return value.
+*************************************************************/
+static void BootTest_Sample(void *arg){
+	*(uint32_t *)arg = Sim_Peek(&TIM2->CNT);
+}
+
+/*************************************************************
+* BootTest_Check() - Check the output once the run ends.
+* No inputs.
+* Never returns.
+*************************************************************/
+static void BootTest_Check(void){
+	uint32_t bootUs = 0;
+	const char *boot = Harness_Find("Boot: ");
+
+	HARNESS_CHECK(Harness_Find("Embedded Systems Software") != NULL);
+	HARNESS_CHECK(boot != NULL && sscanf(boot, "Boot: %u us", &bootUs) == 1);
+	HARNESS_CHECK(bootUs > 0 && bootUs < 100000);
+
+	// TIM2 is the 1 us timebase
+	HARNESS_CHECK(tim2At2s - tim2At1s == 1000000UL);
+
+	// 'k': every kernel task is listed and has run
+	HARNESS_CHECK(Harness_Find("context switches") != NULL);
+	HARNESS_CHECK(Harness_Find(" idle ") != NULL);
+	HARNESS_CHECK(Harness_Find(" main ") != NULL);
+	HARNESS_CHECK(Harness_Find(" robot ") != NULL);
+	HARNESS_CHECK(Harness_Find(" bench ") != NULL);
+
+	// 'l': CPU load from the idle task
+	HARNESS_CHECK(Harness_Find("cpu load: ") != NULL);
+
+	Harness_Finish();
+}
+
+/*************************************************************
+* BootTest_Init() - Set up the run before main().
+* No inputs.
+* No return value.
+*************************************************************/
+__attribute__((constructor)) static void BootTest_Init(void){
+	Harness_CaptureUart();
+	Sim_At(1000000, BootTest_Sample, &tim2At1s);
+	Sim_At(2000000, BootTest_Sample, &tim2At2s);
+	Harness_SendAt(1000000, "k");
+	Harness_SendAt(1500000, "l");
+	Sim_SetEnd(2500000, BootTest_Check);
+}
@@ -0,0 +1,156 @@
+/********************************************************************************
+* Name: BootTimeTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Time to the first control loop of the firmware's Boot_Run() start
+*							 up against the serial init sequence main.c had before it. The
+*							 serial sequence runs in a second copy of this test (fresh
+*							 simulator, BOOT_TIME_SERIAL set) and reports its times on
+*							 stdout; the firmware's first control loop is the first time the
+*							 kernel is seen running. The motors' safe state is compared too.
+********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "Harness.h"
+#include "Kernel.h"
+#include "SysClock.h"
+#include "UART.h"
+#include "Stepper.h"
+#include "RCServo.h"
+#include "LED.h"
+#include "KeyPad.h"
+#include "Ultrasonic.h"
+#include "DCMotor.h"
+#include "LCD.h"
+#include "Encoder.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define BOOT_TIME_POLL_US			10				// Kernel_IsRunning() sample period
+#define BOOT_TIME_END_US			1000000		// Boot and its report are long over
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static uint64_t serialLoopUs;			// Serial sequence: all drivers up
+static uint64_t serialMotorUs;		// Serial sequence: DCMotor_Init() done
+static uint64_t firstLoopUs;			// Firmware: kernel first seen running
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* BootTimeTest_Serial() - The init sequence of main.c before Boot_Run(), timed.
+* No inputs.
+* Never returns.
+*************************************************************/
+static void BootTimeTest_Serial(void){
+	uint64_t motorUs;
+
+	// The old sequence left SystemCoreClock at 8 MHz, running every delay 9x short;
+	// updated here so both start ups wait what the LCD datasheet asks
+	System_Clock_Init();
+	SystemCoreClockUpdate();
+	UART2_Init();
+	Stepper_Init();
+	RCServo_Init();
+	LED_Init();
+	KeyPad_Init();
+	Ultra_Init();
+	DCMotor_Init();
+	motorUs = Sim_TimeUs();
+	LCD_Init();
+	Encoder_Init();
+	UART_printf("Embedded Systems Software Semester 4 Final Demonstration\n");
+	UART_printf("Press a key on the keypad\n");
+
+	printf("%llu %llu\n", (unsigned long long)Sim_TimeUs(), (unsigned long long)motorUs);
+	fflush(stdout);
+	_exit(0);
+}
+
+/*************************************************************
+* BootTimeTest_Poll() - Look for the kernel running, then stop looking.
+* arg			- Unused.
+* No return value.
+*************************************************************/
+static void BootTimeTest_Poll(void *arg){
+	if(Kernel_IsRunning()){
+		firstLoopUs = Sim_TimeUs();
+	}
+	else{
+		Sim_At(Sim_TimeUs() + BOOT_TIME_POLL_US, BootTimeTest_Poll, NULL);
+	}
+}
+
+/*************************************************************
+* BootTimeTest_Check() - Compare the two start ups once the run ends.
+* No inputs.
+* Never returns.
+*************************************************************/
+static void BootTimeTest_Check(void){
+	unsigned motorUs = 0;
+	const char *motor = Harness_Find("DCMotor ");
+
+	HARNESS_CHECK(motor != NULL && sscanf(motor, "DCMotor %u", &motorUs) == 1);
+	HARNESS_CHECK(serialLoopUs != 0);
+	HARNESS_CHECK(firstLoopUs != 0);
+
+	printf("first control loop: serial %llu us, Boot_Run() %llu us\n",
+		(unsigned long long)serialLoopUs, (unsigned long long)firstLoopUs);
+	printf("motors safe:        serial %llu us, Boot_Run() %u us\n", (unsigned long long)serialMotorUs, motorUs);
+
+	// The LCD wait overlaps the other drivers and the menu goes out after the kernel starts
+	HARNESS_CHECK(firstLoopUs < serialLoopUs);
+	HARNESS_CHECK(motorUs < serialMotorUs);
+
+	Harness_Finish();
+}
+
+/*************************************************************
+* BootTimeTest_Init() - Time the serial sequence, then set up the firmware run.
+* No inputs.
+* No return value.
+*************************************************************/
+__attribute__((constructor)) static void BootTimeTest_Init(void){
+	unsigned long long loopUs = 0, motorUs = 0;
+	char path[512];
+	FILE *serial;
+	ssize_t length;
+
+	if(getenv("BOOT_TIME_SERIAL") != NULL){
+		BootTimeTest_Serial();
+	}
+
+	// A second copy of this test, which only runs the serial sequence
+	length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+	if(length <= 0){
+		Harness_Fail("readlink /proc/self/exe");
+		Harness_Finish();
+	}
+	path[length] = '\0';
+	setenv("BOOT_TIME_SERIAL", "1", 1);
+	serial = popen(path, "r");
+	unsetenv("BOOT_TIME_SERIAL");
+	if(serial == NULL || fscanf(serial, "%llu %llu", &loopUs, &motorUs) != 2){
+		Harness_Fail("serial sequence did not report its times");
+	}
+	if(serial != NULL){
+		pclose(serial);
+	}
+	serialLoopUs = loopUs;
+	serialMotorUs = motorUs;
+
+	Harness_CaptureUart();
+	Sim_At(BOOT_TIME_POLL_US, BootTimeTest_Poll, NULL);
+	Sim_SetEnd(BOOT_TIME_END_US, BootTimeTest_Check);
+}
@@ -0,0 +1,290 @@
+/********************************************************************************
+* Name: BusTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Bus.c publish to read latency with many subscribers, on host
+*							 threads (host/HostThreads.c). A publisher thread, run as an ISR,
+*							 publishes a numbered encoder sample every BUS_TEST_PERIOD_US
+*							 while 1, 4 and 16 subscriber threads read the latest sample in
+*							 place. Every sample a subscriber accepts must be whole (all
+*							 fields from one publish) and versions must never go back. The
+*							 time from each publish until a subscriber first reads it, and the
+*							 cost of one publish and one read, are printed. Built at -O2
+*							 without ThreadSanitizer: a subscriber preempted mid-read may see
+*							 its slot reused, which Bus_Valid() catches but the sanitizer
+*							 would report.
+********************************************************************************/
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <time.h>
+#include "HostThreads.h"
+#include "Bus.h"
+#include "Encoder.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define BUS_TEST_SAMPLES			20000			// Publishes per run
+#define BUS_TEST_PERIOD_US		50				// Publish period
+#define BUS_TEST_MAX_READERS	16
+#define BUS_TEST_TIMES				256				// Publish times kept, a power of 2
+#define BUS_TEST_BUCKETS			64				// Latency histogram, log2 ns
+#define BUS_TEST_BENCH_OPS		10000000	// Publishes or reads timed on their own
+
+// Records a failure with its line unless cond holds
+#define BUS_TEST_CHECK(cond)	BusTest_Check((cond), __LINE__, #cond)
+
+// One subscriber's results
+typedef struct {
+	uint32_t seen;									// Samples read
+	uint32_t retries;								// Reads Bus_Valid() sent back
+	uint32_t torn;									// Accepted samples with fields from two publishes
+	uint32_t latency[BUS_TEST_BUCKETS];
+} BusTest_Reader;
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static uint64_t publishNs[BUS_TEST_TIMES];		// Publish time by version
+static uint32_t published;										// Encoder samples published
+static volatile uint32_t done;								// Publisher finished
+static BusTest_Reader readers[BUS_TEST_MAX_READERS];
+static uint32_t failures;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* BusTest_Check() - Record a failed check.
+* ok			- Check result.
+* line		- Source line.
+* text		- Check as written.
+* No return value.
+*************************************************************/
+static void BusTest_Check(int ok, int line, const char *text){
+	if(!ok){
+		__atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED);
+		fprintf(stderr, "BusTest.c:%d: check failed: %s\n", line, text);
+	}
+}
+
+/*************************************************************
+* BusTest_Ns() - Monotonic time.
+* No inputs.
+* Returns nanoseconds.
+*************************************************************/
+static uint64_t BusTest_Ns(void){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+}
+
+/*************************************************************
+* BusTest_Publish() - ISR body: publish the next sample, each field made from
+*										its number (the version it will get).
+* arg			- Unused.
+* No return value.
+*************************************************************/
+static void BusTest_Publish(void *arg){
+	uint32_t n = ++published;
+	Bus_Encoder *sample = Bus_Claim(BUS_TOPIC_ENCODER);
+
+	sample->period[LEFT_ENC] = n;
+	sample->period[RIGHT_ENC] = ~n;
+	sample->edges[LEFT_ENC] = n * 3;
+	sample->edges[RIGHT_ENC] = n * 5;
+	publishNs[n & (BUS_TEST_TIMES - 1)] = BusTest_Ns();
+	ENCODER_TIMER->CNT = (uint32_t)(publishNs[n & (BUS_TEST_TIMES - 1)] / 1000);
+	Bus_Publish(BUS_TOPIC_ENCODER);
+}
+
+/*************************************************************
+* BusTest_Publisher() - Publish BUS_TEST_SAMPLES samples at the publish period.
+* arg			- Unused.
+* Returns NULL.
+*************************************************************/
+static void *BusTest_Publisher(void *arg){
+	struct timespec next;
+
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	for(uint32_t n = 1; n <= BUS_TEST_SAMPLES; n++){
+		next.tv_nsec += BUS_TEST_PERIOD_US * 1000;
+		if(next.tv_nsec >= 1000000000L){
+			next.tv_nsec -= 1000000000L;
+			next.tv_sec++;
+		}
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+		HostThreads_Isr(BusTest_Publish, NULL);
+	}
+	__atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+	return(NULL);
+}
+
+/*************************************************************
+* BusTest_Subscriber() - Read the latest sample until the publisher is done.
+* arg			- Reader results.
+* Returns NULL.
+*************************************************************/
+static void *BusTest_Subscriber(void *arg){
+	BusTest_Reader *reader = arg;
+	const Bus_Encoder *sample;
+	Bus_Encoder copy;
+	uint32_t version, last = 0;
+	uint64_t latency;
+
+	while(!__atomic_load_n(&done, __ATOMIC_ACQUIRE)){
+		sample = Bus_Latest(BUS_TOPIC_ENCODER, &version);
+		copy = *sample;
+		if(!Bus_Valid(BUS_TOPIC_ENCODER, version)){
+			reader->retries++;
+			continue;
+		}
+		BUS_TEST_CHECK(version >= last);
+		if(version > last){
+			latency = BusTest_Ns() - publishNs[version & (BUS_TEST_TIMES - 1)];
+			reader->latency[63 - __builtin_clzll(latency | 1)]++;
+			reader->torn += (copy.period[LEFT_ENC] != version || copy.period[RIGHT_ENC] != ~version ||
+				copy.edges[LEFT_ENC] != version * 3 || copy.edges[RIGHT_ENC] != version * 5);
+			reader->seen++;
+			last = version;
+		}
+		Host_Wfi();
+	}
+	return(NULL);
+}
+
+/*************************************************************
+* BusTest_Percentile() - Latency percentile from the readers' histograms.
+* count		- Readers.
+* pct			- Percentile (0-100).
+* Returns the bucket's upper bound in us.
+*************************************************************/
+static double BusTest_Percentile(uint32_t count, uint32_t pct){
+	uint64_t total = 0, sum = 0;
+
+	for(uint32_t r = 0; r < count; r++){
+		total += readers[r].seen;
+	}
+	for(uint32_t b = 0; b < BUS_TEST_BUCKETS; b++){
+		for(uint32_t r = 0; r < count; r++){
+			sum += readers[r].latency[b];
+		}
+		if(sum * 100 >= total * pct){
+			return((double)(2ULL << b) / 1000.0);
+		}
+	}
+	return(0);
+}
+
+/*************************************************************
+* BusTest_Run() - One publisher against count subscribers.
+* count		- Subscriber threads.
+* No return value.
+*************************************************************/
+static void BusTest_Run(uint32_t count){
+	pthread_t publisher, subscribers[BUS_TEST_MAX_READERS];
+	uint32_t seen = 0, retries = 0, torn = 0;
+
+	__atomic_store_n(&done, 0, __ATOMIC_RELAXED);
+	for(uint32_t r = 0; r < count; r++){
+		readers[r] = (BusTest_Reader){0};
+		pthread_create(&subscribers[r], NULL, BusTest_Subscriber, &readers[r]);
+	}
+	pthread_create(&publisher, NULL, BusTest_Publisher, NULL);
+	pthread_join(publisher, NULL);
+	for(uint32_t r = 0; r < count; r++){
+		pthread_join(subscribers[r], NULL);
+		seen += readers[r].seen;
+		retries += readers[r].retries;
+		torn += readers[r].torn;
+	}
+	BUS_TEST_CHECK(torn == 0);
+	BUS_TEST_CHECK(seen != 0);
+	printf("%2u subscribers: %6u samples read, %3u retried, %u torn, latency p50 < %7.1f us, p99 < %7.1f us, max < %7.1f us\n",
+		count, seen, retries, torn, BusTest_Percentile(count, 50), BusTest_Percentile(count, 99),
+		BusTest_Percentile(count, 100));
+}
+
+/*************************************************************
+* BusTest_Bench() - Cost of one publish and one read on their own.
+* No inputs.
+* No return value.
+*************************************************************/
+static void BusTest_Bench(void){
+	const Bus_Encoder *sample;
+	Bus_Encoder *fill, copy;
+	uint32_t version, sum = 0;
+	uint64_t start, publishNsPerOp, readNsPerOp;
+
+	start = BusTest_Ns();
+	for(uint32_t i = 0; i < BUS_TEST_BENCH_OPS; i++){
+		fill = Bus_Claim(BUS_TOPIC_ULTRA);
+		((Bus_Ultra *)fill)->echo = i;
+		Bus_Publish(BUS_TOPIC_ULTRA);
+	}
+	publishNsPerOp = (BusTest_Ns() - start) * 1000 / BUS_TEST_BENCH_OPS;
+
+	start = BusTest_Ns();
+	for(uint32_t i = 0; i < BUS_TEST_BENCH_OPS; i++){
+		do{
+			sample = Bus_Latest(BUS_TOPIC_ENCODER, &version);
+			copy = *sample;
+		} while(!Bus_Valid(BUS_TOPIC_ENCODER, version));
+		sum += copy.edges[LEFT_ENC];
+	}
+	readNsPerOp = (BusTest_Ns() - start) * 1000 / BUS_TEST_BENCH_OPS;
+	BUS_TEST_CHECK(sum == published * 3U * BUS_TEST_BENCH_OPS);
+
+	printf("publish (claim, fill, publish): %llu.%03llu ns, read (latest, copy, valid): %llu.%03llu ns\n",
+		(unsigned long long)(publishNsPerOp / 1000), (unsigned long long)(publishNsPerOp % 1000),
+		(unsigned long long)(readNsPerOp / 1000), (unsigned long long)(readNsPerOp % 1000));
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* UART_printf() - Bus_Report() output, to stdout.
+* format	- printf format.
+* No return value.
+*************************************************************/
+void UART_printf(char *format, ...){
+	va_list args;
+
+	va_start(args, format);
+	vprintf(format, args);
+	va_end(args);
+}
+
+int main(void){
+	static const uint32_t counts[] = {1, 4, BUS_TEST_MAX_READERS};
+
+	// Bus_Publish() time stamps from TIM2->CNT, plain memory here
+	if(mmap((void *)TIM2_BASE, 4096, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0)
+		!= (void *)TIM2_BASE){
+		perror("mmap TIM2");
+		return(2);
+	}
+
+	for(uint32_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++){
+		BusTest_Run(counts[i]);
+	}
+	Bus_Report();
+	BusTest_Bench();
+
+	printf("%s\n", (failures == 0) ? "passed" : "failed");
+	return(failures != 0);
+}
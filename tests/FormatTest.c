@@ -0,0 +1,307 @@
+/********************************************************************************
+* Name: FormatTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: The integer printf against the C library's. Every supported
+*							 conversion, flag and width must print what vsnprintf() prints
+*							 for the same arguments, and %q what the integer division it
+*							 stands for prints. The time per call and the stack each
+*							 formatter needs (from a painted stack) are reported side by side.
+********************************************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+#include "Harness.h"
+#include "Format.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define FORMAT_TEST_OUT				128
+#define FORMAT_TEST_STACK			65536			// Painted stack for the stack measurement (bytes)
+#define FORMAT_TEST_PAINT			0xA5
+#define FORMAT_TEST_CALLS			100000
+
+// Formats taking one int, one unsigned, one string or one char
+static const char *intFormats[] = {"%d", "%i", "%5d", "%-5d|", "%05d", "%-05d|", "%1d", "%12d", "%ld", "[%d]", "%d%%"};
+static const char *uintFormats[] = {"%u", "%x", "%X", "%8X", "%08x", "%-8x|", "%lu", "%lX", "%010u"};
+static const char *strFormats[] = {"%s", "%8s", "%-8s|", "%.3s", "%8.2s", "%-18s|", "%s%s"};
+static const char *charFormats[] = {"%c", "%3c", "%-3c|"};
+
+static const int32_t ints[] = {0, 1, -1, 9, -9, 10, 42, -12345, 99999, 100000, 2147483647, -2147483647 - 1};
+static const uint32_t uints[] = {0, 1, 9, 15, 16, 255, 4096, 0xDEADBEEF, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF};
+static const char *strs[] = {"", "a", "abc", "LCD_cmd", "KeyPad_MatrixScan", "(longer than any width)"};
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static char out[FORMAT_TEST_OUT];
+static uint32_t outLen;
+static uint32_t wrong = 0;
+static uint32_t compared = 0;
+
+static ucontext_t callerContext, paintedContext;
+static uint8_t paintedStack[FORMAT_TEST_STACK];
+static void (*paintedFn)(void);
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* FormatTest_Sink() - Format_Sink into out.
+* c		- Character.
+* No return value.
+*************************************************************/
+static void FormatTest_Sink(char c){
+	if(outLen < FORMAT_TEST_OUT - 1){
+		out[outLen++] = c;
+	}
+	out[outLen] = '\0';
+}
+
+/*************************************************************
+* FormatTest_Format() - Format_vprintf() into out.
+* fmt		- Format string.
+* Returns the count Format_vprintf() returned.
+*************************************************************/
+static uint32_t FormatTest_Format(const char *fmt, ...){
+	va_list args;
+	uint32_t count;
+
+	outLen = 0;
+	out[0] = '\0';
+	va_start(args, fmt);
+	count = Format_vprintf(FormatTest_Sink, fmt, args);
+	va_end(args);
+	return(count);
+}
+
+/*************************************************************
+* FormatTest_Same() - Compare out with what the C library printed.
+* fmt				- Format string, for the failure message.
+* count			- Format_vprintf()'s count.
+* expected	- vsnprintf() output.
+* No return value.
+*************************************************************/
+static void FormatTest_Same(const char *fmt, uint32_t count, const char *expected){
+	compared++;
+	if(strcmp(out, expected) != 0 || count != strlen(expected)){
+		if(wrong++ < 10){
+			Harness_Fail("\"%s\" printed \"%s\" (%u), expected \"%s\"", fmt, out, count, expected);
+		}
+	}
+}
+
+/*************************************************************
+* FormatTest_Conversions() - Every conversion against snprintf().
+* No inputs.
+* No return value.
+*************************************************************/
+static void FormatTest_Conversions(void){
+	char expected[FORMAT_TEST_OUT];
+	uint32_t count;
+
+	for(uint32_t f = 0; f < sizeof(intFormats) / sizeof(intFormats[0]); f++){
+		for(uint32_t v = 0; v < sizeof(ints) / sizeof(ints[0]); v++){
+			// The 'l' modifier is 32 bits on the target
+			count = FormatTest_Format(intFormats[f], ints[v]);
+			snprintf(expected, sizeof(expected), strstr(intFormats[f], "l") ? "%d" : intFormats[f], ints[v]);
+			FormatTest_Same(intFormats[f], count, expected);
+		}
+	}
+	for(uint32_t f = 0; f < sizeof(uintFormats) / sizeof(uintFormats[0]); f++){
+		for(uint32_t v = 0; v < sizeof(uints) / sizeof(uints[0]); v++){
+			char host[16];
+
+			// Host long is 64 bits: drop the 'l' for the reference
+			strcpy(host, uintFormats[f]);
+			if(strchr(host, 'l') != NULL){
+				memmove(strchr(host, 'l'), strchr(host, 'l') + 1, strlen(strchr(host, 'l')));
+			}
+			count = FormatTest_Format(uintFormats[f], uints[v]);
+			snprintf(expected, sizeof(expected), host, uints[v]);
+			FormatTest_Same(uintFormats[f], count, expected);
+		}
+	}
+	for(uint32_t f = 0; f < sizeof(strFormats) / sizeof(strFormats[0]); f++){
+		for(uint32_t v = 0; v < sizeof(strs) / sizeof(strs[0]); v++){
+			count = FormatTest_Format(strFormats[f], strs[v], strs[0]);
+			snprintf(expected, sizeof(expected), strFormats[f], strs[v], strs[0]);
+			FormatTest_Same(strFormats[f], count, expected);
+		}
+	}
+	for(uint32_t f = 0; f < sizeof(charFormats) / sizeof(charFormats[0]); f++){
+		count = FormatTest_Format(charFormats[f], 'k');
+		snprintf(expected, sizeof(expected), charFormats[f], 'k');
+		FormatTest_Same(charFormats[f], count, expected);
+	}
+
+	// Mixed, as the drivers use it
+	count = FormatTest_Format("%-18s %7lu %9lu %9lu %9lu %10lu\n", "UART_printf", 4UL, 14UL, 5099998UL, 1275003UL, 17708UL);
+	snprintf(expected, sizeof(expected), "%-18s %7u %9u %9u %9u %10u\n", "UART_printf", 4, 14, 5099998, 1275003, 17708);
+	FormatTest_Same("profile row", count, expected);
+	count = FormatTest_Format("%08lX %u %u %04X\n", 0x1F4UL, 1, 6, 0x3E8);
+	snprintf(expected, sizeof(expected), "%08X %u %u %04X\n", 0x1F4, 1, 6, 0x3E8);
+	FormatTest_Same("trace record", count, expected);
+
+	// (null) like glibc, and a lone % at the end prints nothing
+	count = FormatTest_Format("%s", (const char *)NULL);
+	FormatTest_Same("%s NULL", count, "(null)");
+	count = FormatTest_Format("100%");
+	FormatTest_Same("trailing %", count, "100");
+
+	printf("%u formats compared with snprintf\n", compared);
+	HARNESS_CHECK(wrong == 0);
+}
+
+/*************************************************************
+* FormatTest_Fixed() - %q against the division it stands for.
+* No inputs.
+* No return value.
+*************************************************************/
+static void FormatTest_Fixed(void){
+	static const char *formats[] = {"%q", "%.0q", "%.1q", "%.2q", "%.3q", "%6.1q", "%-7.2q", "%06.1q", "%012.3q"};
+	char expected[FORMAT_TEST_OUT], number[32];
+	uint32_t count;
+
+	for(uint32_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++){
+		const char *spec = formats[f] + 1;
+		char flag = (*spec == '-' || *spec == '0') ? *spec++ : '\0';
+		int width = atoi(spec);
+		const char *dot = strchr(spec, '.');
+		int decimals = (dot != NULL) ? atoi(dot + 1) : 1;
+
+		for(uint32_t v = 0; v < sizeof(ints) / sizeof(ints[0]); v++){
+			int64_t value = ints[v];
+			uint64_t magnitude = (value < 0) ? (uint64_t)-value : (uint64_t)value;
+			uint64_t scale = 1;
+			const char *sign = (value < 0) ? "-" : "";
+			int pad;
+
+			for(int i = 0; i < decimals; i++){
+				scale *= 10;
+			}
+			if(decimals == 0){
+				snprintf(number, sizeof(number), "%llu", (unsigned long long)magnitude);
+			}
+			else{
+				snprintf(number, sizeof(number), "%llu.%0*llu", (unsigned long long)(magnitude / scale), decimals,
+					(unsigned long long)(magnitude % scale));
+			}
+
+			// Spaces before the sign, zeros after it, or spaces after the number
+			pad = width - (int)(strlen(sign) + strlen(number));
+			pad = (pad > 0) ? pad : 0;
+			if(flag == '-'){
+				snprintf(expected, sizeof(expected), "%s%s%*s", sign, number, pad, "");
+			}
+			else if(flag == '0'){
+				snprintf(expected, sizeof(expected), "%s%.*s%s", sign, pad, "0000000000000000", number);
+			}
+			else{
+				snprintf(expected, sizeof(expected), "%*s%s%s", pad, "", sign, number);
+			}
+			count = FormatTest_Format(formats[f], ints[v]);
+			FormatTest_Same(formats[f], count, expected);
+		}
+	}
+	HARNESS_CHECK(wrong == 0);
+}
+
+/*************************************************************
+* FormatTest_Painted() - Run paintedFn on the painted stack and come back.
+* No inputs.
+* No return value.
+*************************************************************/
+static void FormatTest_Painted(void){
+	paintedFn();
+}
+
+/*************************************************************
+* FormatTest_StackUsed() - Deepest stack a function reaches.
+* fn			- Function to run.
+* Returns the bytes of painted stack it overwrote.
+*************************************************************/
+static uint32_t FormatTest_StackUsed(void (*fn)(void)){
+	uint32_t unused = 0;
+
+	memset(paintedStack, FORMAT_TEST_PAINT, sizeof(paintedStack));
+	getcontext(&paintedContext);
+	paintedContext.uc_stack.ss_sp = paintedStack;
+	paintedContext.uc_stack.ss_size = sizeof(paintedStack);
+	paintedContext.uc_link = &callerContext;
+	paintedFn = fn;
+	makecontext(&paintedContext, FormatTest_Painted, 0);
+	swapcontext(&callerContext, &paintedContext);
+
+	while(unused < sizeof(paintedStack) && paintedStack[unused] == FORMAT_TEST_PAINT){
+		unused++;
+	}
+	return(sizeof(paintedStack) - unused);
+}
+
+static void FormatTest_RowFormat(void){
+	(void)FormatTest_Format("%-18s %7lu %9lu %9lu %9lu %10lu\n", "UART_printf", 4UL, 14UL, 5099998UL, 1275003UL, 17708UL);
+}
+
+static void FormatTest_RowLibrary(void){
+	(void)snprintf(out, sizeof(out), "%-18s %7u %9u %9u %9u %10u\n", "UART_printf", 4, 14, 5099998, 1275003, 17708);
+}
+
+static void FormatTest_Nothing(void){
+}
+
+/*************************************************************
+* FormatTest_Cost() - Time and stack per call of both formatters.
+* No inputs.
+* No return value.
+*************************************************************/
+static void FormatTest_Cost(void){
+	struct timespec start, end;
+	uint64_t formatNs, libraryNs;
+	uint32_t base = FormatTest_StackUsed(FormatTest_Nothing);
+	uint32_t formatStack = FormatTest_StackUsed(FormatTest_RowFormat) - base;
+	uint32_t libraryStack = FormatTest_StackUsed(FormatTest_RowLibrary) - base;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(uint32_t i = 0; i < FORMAT_TEST_CALLS; i++){
+		FormatTest_RowFormat();
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	formatNs = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000ULL + end.tv_nsec - start.tv_nsec;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(uint32_t i = 0; i < FORMAT_TEST_CALLS; i++){
+		FormatTest_RowLibrary();
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	libraryNs = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000ULL + end.tv_nsec - start.tv_nsec;
+
+	// Host numbers: the ratio and the stack are what carry over to the target
+	printf("profile row: Format_vprintf %llu ns, %u bytes of stack; snprintf %llu ns, %u bytes of stack\n",
+		(unsigned long long)(formatNs / FORMAT_TEST_CALLS), formatStack,
+		(unsigned long long)(libraryNs / FORMAT_TEST_CALLS), libraryStack);
+	HARNESS_CHECK(formatStack > 0 && formatStack < libraryStack);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(void){
+	FormatTest_Conversions();
+	FormatTest_Fixed();
+	FormatTest_Cost();
+
+	return(Harness_Result());
+}
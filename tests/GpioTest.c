@@ -0,0 +1,310 @@
+/********************************************************************************
+* Name: GpioTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Gpio.h folded pin and timer channel setup against the per pin
+*							 Utility.h macros the drivers used before. For the DCMotor
+*							 direction and PWM pins, the TIM8 complementary channels and the
+*							 TIM1 coil channels, the folded version must make exactly the
+*							 expected register writes and leave the registers as the macro
+*							 version does. Register accesses, simulated time and code size
+*							 of both are printed (built at -Os, see CMakeLists.txt).
+********************************************************************************/
+
+#include <stdio.h>
+#include "Harness.h"
+#include "Gpio.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define GPIO_TEST_MAX_WRITES	64
+#define GPIO_TEST_DIRTY				0xFFFFFFFFUL		// Start value, so every mask is exercised
+
+#define DIR_PINS(X) \
+	X(DCMOTOR_RIGHT_FWD, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(DCMOTOR_RIGHT_BWD, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(DCMOTOR_LEFT_FWD, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(DCMOTOR_LEFT_BWD, GPIO_MODE_OUT, GPIO_OTYPE_PP, GPIO_PUPD_NO)
+
+#define PWM_PINS(X) \
+	X(DCMOTOR_LEFT_PWM, GPIO_MODE_AF, GPIO_OTYPE_PP, GPIO_PUPD_NO) \
+	X(DCMOTOR_RIGHT_PWM, GPIO_MODE_AF, GPIO_OTYPE_PP, GPIO_PUPD_NO)
+
+#define MOTOR_CHANNELS(X) \
+	X(1, TIMER_OC_PWM1, TIMER_CC_OUTN) \
+	X(2, TIMER_OC_PWM1, TIMER_CC_OUTN)
+
+#define COIL_CHANNELS(X) \
+	X(1, TIMER_OC_PWM1, TIMER_CC_OUT) \
+	X(2, TIMER_OC_PWM1, TIMER_CC_OUT) \
+	X(3, TIMER_OC_PWM1, TIMER_CC_OUT) \
+	X(4, TIMER_OC_PWM1, TIMER_CC_OUT)
+
+// Each version in a section of its own, so its code size is __stop - __start
+#define GPIO_TEST_FUNC(name)		__attribute__((noinline, used, section("gpio_" #name))) static void name(void)
+#define GPIO_TEST_SIZE(name)		((uint32_t)(__stop_gpio_ ## name - __start_gpio_ ## name))
+#define GPIO_TEST_SECTION(name)	extern const char __start_gpio_ ## name[], __stop_gpio_ ## name[];
+
+// One register write
+typedef struct {
+	volatile uint32_t *reg;
+	uint32_t value;
+} GpioTest_Write;
+
+// One configuration, in both versions
+typedef struct {
+	const char *name;
+	void (*macro)(void);
+	void (*folded)(void);
+	uint32_t macroSize;
+	uint32_t foldedSize;
+	volatile uint32_t * const *regs;				// Registers it configures, NULL terminated
+	const GpioTest_Write *expect;						// Folded writes, in order
+	uint32_t expectCount;
+} GpioTest_Case;
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static GpioTest_Write writes[GPIO_TEST_MAX_WRITES];
+static uint32_t writeCount;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+GPIO_TEST_FUNC(DirMacro){
+	ENABLE_GPIO_CLOCK(C);
+	GPIO_MODER_SET(C, 8, GPIO_MODE_OUT);
+	GPIO_MODER_SET(C, 9, GPIO_MODE_OUT);
+	GPIO_MODER_SET(C, 12, GPIO_MODE_OUT);
+	GPIO_MODER_SET(C, 13, GPIO_MODE_OUT);
+	GPIO_OTYPER_SET(C, 8, GPIO_OTYPE_PP);
+	GPIO_OTYPER_SET(C, 9, GPIO_OTYPE_PP);
+	GPIO_OTYPER_SET(C, 12, GPIO_OTYPE_PP);
+	GPIO_OTYPER_SET(C, 13, GPIO_OTYPE_PP);
+	GPIO_PUPDR_SET(C, 8, GPIO_PUPD_NO);
+	GPIO_PUPDR_SET(C, 9, GPIO_PUPD_NO);
+	GPIO_PUPDR_SET(C, 12, GPIO_PUPD_NO);
+	GPIO_PUPDR_SET(C, 13, GPIO_PUPD_NO);
+}
+
+GPIO_TEST_FUNC(DirFolded){
+	GPIO_CONFIGURE(C, DIR_PINS);
+}
+
+GPIO_TEST_FUNC(PwmMacro){
+	ENABLE_GPIO_CLOCK(C);
+	GPIO_MODER_SET(C, 10, GPIO_MODE_AF);
+	GPIO_MODER_SET(C, 11, GPIO_MODE_AF);
+	GPIO_AFR_SET(C, 10, 4UL);
+	GPIO_AFR_SET(C, 11, 4UL);
+	GPIO_OTYPER_SET(C, 10, GPIO_OTYPE_PP);
+	GPIO_OTYPER_SET(C, 11, GPIO_OTYPE_PP);
+	GPIO_PUPDR_SET(C, 10, GPIO_PUPD_NO);
+	GPIO_PUPDR_SET(C, 11, GPIO_PUPD_NO);
+}
+
+GPIO_TEST_FUNC(PwmFolded){
+	GPIO_CONFIGURE(C, PWM_PINS);
+}
+
+GPIO_TEST_FUNC(MotorMacro){
+	FORCE_BITS(TIM8->CCMR1, TIM_CCMR1_CC1S_Msk | TIM_CCMR1_OC1M_Msk, 0x6UL << TIM_CCMR1_OC1M_Pos);
+	SET_BITS(TIM8->CCMR1, TIM_CCMR1_OC1PE);
+	SET_BITS(TIM8->CCER, TIM_CCER_CC1NE);
+	CLEAR_BITS(TIM8->CCER, TIM_CCER_CC1E | TIM_CCER_CC1P | TIM_CCER_CC1NP);
+	FORCE_BITS(TIM8->CCMR1, TIM_CCMR1_CC2S_Msk | TIM_CCMR1_OC2M_Msk, 0x6UL << TIM_CCMR1_OC2M_Pos);
+	SET_BITS(TIM8->CCMR1, TIM_CCMR1_OC2PE);
+	SET_BITS(TIM8->CCER, TIM_CCER_CC2NE);
+	CLEAR_BITS(TIM8->CCER, TIM_CCER_CC2E | TIM_CCER_CC2P | TIM_CCER_CC2NP);
+}
+
+GPIO_TEST_FUNC(MotorFolded){
+	TIMER_OC_CONFIGURE(TIM8, MOTOR_CHANNELS);
+}
+
+GPIO_TEST_FUNC(CoilMacro){
+	FORCE_BITS(TIM1->CCMR1, TIM_CCMR1_CC1S_Msk | TIM_CCMR1_OC1M_Msk, 0x6UL << TIM_CCMR1_OC1M_Pos);
+	SET_BITS(TIM1->CCMR1, TIM_CCMR1_OC1PE);
+	FORCE_BITS(TIM1->CCER, 0xFUL, TIM_CCER_CC1E);
+	FORCE_BITS(TIM1->CCMR1, TIM_CCMR1_CC2S_Msk | TIM_CCMR1_OC2M_Msk, 0x6UL << TIM_CCMR1_OC2M_Pos);
+	SET_BITS(TIM1->CCMR1, TIM_CCMR1_OC2PE);
+	FORCE_BITS(TIM1->CCER, 0xF0UL, TIM_CCER_CC2E);
+	FORCE_BITS(TIM1->CCMR2, TIM_CCMR2_CC3S_Msk | TIM_CCMR2_OC3M_Msk, 0x6UL << TIM_CCMR2_OC3M_Pos);
+	SET_BITS(TIM1->CCMR2, TIM_CCMR2_OC3PE);
+	FORCE_BITS(TIM1->CCER, 0xF00UL, TIM_CCER_CC3E);
+	FORCE_BITS(TIM1->CCMR2, TIM_CCMR2_CC4S_Msk | TIM_CCMR2_OC4M_Msk, 0x6UL << TIM_CCMR2_OC4M_Pos);
+	SET_BITS(TIM1->CCMR2, TIM_CCMR2_OC4PE);
+	FORCE_BITS(TIM1->CCER, 0xF000UL, TIM_CCER_CC4E);
+}
+
+GPIO_TEST_FUNC(CoilFolded){
+	TIMER_OC_CONFIGURE(TIM1, COIL_CHANNELS);
+}
+
+GPIO_TEST_SECTION(DirMacro) GPIO_TEST_SECTION(DirFolded)
+GPIO_TEST_SECTION(PwmMacro) GPIO_TEST_SECTION(PwmFolded)
+GPIO_TEST_SECTION(MotorMacro) GPIO_TEST_SECTION(MotorFolded)
+GPIO_TEST_SECTION(CoilMacro) GPIO_TEST_SECTION(CoilFolded)
+
+static volatile uint32_t * const portRegs[] = {
+	&RCC->AHBENR, &GPIOC->MODER, &GPIOC->OTYPER, &GPIOC->PUPDR, &GPIOC->AFR[0], &GPIOC->AFR[1], NULL
+};
+
+static volatile uint32_t * const tim8Regs[] = {&TIM8->CCMR1, &TIM8->CCMR2, &TIM8->CCER, NULL};
+static volatile uint32_t * const tim1Regs[] = {&TIM1->CCMR1, &TIM1->CCMR2, &TIM1->CCER, NULL};
+
+// Golden folded write sequences, from GPIO_TEST_DIRTY in every register (RCC->AHBENR from 0)
+static const GpioTest_Write dirWrites[] = {
+	{&RCC->AHBENR, 0x00080000UL},			// GPIOCEN
+	{&GPIOC->OTYPER, 0xFFFFCCFFUL},		// PC8, PC9, PC12, PC13 push-pull
+	{&GPIOC->PUPDR, 0xF0F0FFFFUL},		// No pull
+	{&GPIOC->MODER, 0xF5F5FFFFUL},		// Output
+};
+
+static const GpioTest_Write pwmWrites[] = {
+	{&RCC->AHBENR, 0x00080000UL},
+	{&GPIOC->AFR[1], 0xFFFF44FFUL},		// PC10, PC11 AF4
+	{&GPIOC->OTYPER, 0xFFFFF3FFUL},
+	{&GPIOC->PUPDR, 0xFF0FFFFFUL},
+	{&GPIOC->MODER, 0xFFAFFFFFUL},		// Alternate function
+};
+
+static const GpioTest_Write motorWrites[] = {
+	{&TIM8->CCMR1, 0xFEFEECECUL},			// CH1/CH2 PWM1, preload, output (OCxCE/OCxFE kept, OCxM bit 3 cleared)
+	{&TIM8->CCER, 0xFFFFFF44UL},			// CH1N/CH2N, active high
+};
+
+static const GpioTest_Write coilWrites[] = {
+	{&TIM1->CCMR1, 0xFEFEECECUL},
+	{&TIM1->CCMR2, 0xFEFEECECUL},
+	{&TIM1->CCER, 0xFFFF1111UL},			// CH1-CH4, active high
+};
+
+/*************************************************************
+* GpioTest_Access() - Record every register write.
+* addr		- Register word address.
+* value		- Value written.
+* write		- Non zero for a write.
+* No return value.
+*************************************************************/
+static void GpioTest_Access(uint32_t addr, uint32_t value, uint8_t write){
+	if(write && writeCount < GPIO_TEST_MAX_WRITES){
+		writes[writeCount].reg = (volatile uint32_t *)(uintptr_t)addr;
+		writes[writeCount].value = value;
+		writeCount++;
+	}
+}
+
+/*************************************************************
+* GpioTest_Dirty() - Put the configured registers in a known state.
+* regs		- Registers, NULL terminated (RCC->AHBENR starts with every port clock off).
+* No return value.
+*************************************************************/
+static void GpioTest_Dirty(volatile uint32_t * const *regs){
+	for(; *regs != NULL; regs++){
+		Sim_Poke(*regs, (*regs == &RCC->AHBENR) ? 0UL : GPIO_TEST_DIRTY);
+	}
+}
+
+/*************************************************************
+* GpioTest_Run() - Run one version and count its accesses and time.
+* fn			- Version.
+* reads		- Returns the register reads.
+* ns			- Returns the simulated time (ns).
+* No return value.
+*************************************************************/
+static void GpioTest_Run(void (*fn)(void), uint32_t *reads, uint32_t *ns){
+	uint32_t unused;
+	uint64_t start;
+
+	writeCount = 0;
+	Sim_ResetCounts();
+	start = Sim_TimePs();
+	fn();
+	*ns = (uint32_t)((Sim_TimePs() - start) / 1000);
+	Sim_GetCounts(reads, &unused);
+}
+
+/*************************************************************
+* GpioTest_Compare() - Compare the two versions of one configuration.
+* test		- Configuration.
+* No return value.
+*************************************************************/
+static void GpioTest_Compare(const GpioTest_Case *test){
+	uint32_t macro[8], macroReads, macroNs, macroWrites;
+	uint32_t foldedReads, foldedNs, n = 0;
+
+	// Macro version, keeping what it leaves behind
+	GpioTest_Dirty(test->regs);
+	GpioTest_Run(test->macro, &macroReads, &macroNs);
+	macroWrites = writeCount;
+	for(n = 0; test->regs[n] != NULL; n++){
+		macro[n] = Sim_Peek(test->regs[n]);
+	}
+
+	// Folded version: the golden writes, and the same registers at the end
+	GpioTest_Dirty(test->regs);
+	GpioTest_Run(test->folded, &foldedReads, &foldedNs);
+	HARNESS_CHECK(writeCount == test->expectCount);
+	for(uint32_t i = 0; i < writeCount && i < test->expectCount; i++){
+		if(writes[i].reg != test->expect[i].reg || writes[i].value != test->expect[i].value){
+			Harness_Fail("%s: write %u is 0x%08X to %p, expected 0x%08X to %p", test->name, i,
+				writes[i].value, (void *)writes[i].reg, test->expect[i].value, (void *)test->expect[i].reg);
+		}
+	}
+	for(n = 0; test->regs[n] != NULL; n++){
+		if(Sim_Peek(test->regs[n]) != macro[n]){
+			Harness_Fail("%s: register %u is 0x%08X, the macros leave 0x%08X", test->name, n,
+				Sim_Peek(test->regs[n]), macro[n]);
+		}
+	}
+
+	HARNESS_CHECK(writeCount < macroWrites);
+	HARNESS_CHECK(foldedNs < macroNs);
+
+	printf("%-12s %6u %6u %6u %6u %6u %6u %6u %6u\n", test->name,
+		macroReads, macroWrites, macroNs, test->macroSize, foldedReads, writeCount, foldedNs, test->foldedSize);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(void){
+	const GpioTest_Case cases[] = {
+		{"DCMotor dir",	DirMacro,		DirFolded,		GPIO_TEST_SIZE(DirMacro),		GPIO_TEST_SIZE(DirFolded),
+			portRegs, dirWrites, sizeof(dirWrites) / sizeof(dirWrites[0])},
+		{"DCMotor PWM",	PwmMacro,		PwmFolded,		GPIO_TEST_SIZE(PwmMacro),		GPIO_TEST_SIZE(PwmFolded),
+			portRegs, pwmWrites, sizeof(pwmWrites) / sizeof(pwmWrites[0])},
+		{"TIM8 CH1N/2N", MotorMacro,	MotorFolded,	GPIO_TEST_SIZE(MotorMacro),	GPIO_TEST_SIZE(MotorFolded),
+			tim8Regs, motorWrites, sizeof(motorWrites) / sizeof(motorWrites[0])},
+		{"TIM1 CH1-4",	CoilMacro,	CoilFolded,		GPIO_TEST_SIZE(CoilMacro),	GPIO_TEST_SIZE(CoilFolded),
+			tim1Regs, coilWrites, sizeof(coilWrites) / sizeof(coilWrites[0])},
+	};
+
+	// Timer registers only take writes with the timer clocked
+	SET_BITS(RCC->APB2ENR, RCC_APB2ENR_TIM1EN | RCC_APB2ENR_TIM8EN);
+	Sim_SetAccessHook(GpioTest_Access);
+
+	printf("%-12s %27s %27s\n", "", "macros", "folded");
+	printf("%-12s %6s %6s %6s %6s %6s %6s %6s %6s\n", "", "reads", "writes", "ns", "bytes", "reads", "writes", "ns", "bytes");
+	for(uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++){
+		GpioTest_Compare(&cases[i]);
+	}
+
+	printf("folded bytes are the call site: Gpio_Configure() and Timer_OcConfigure() are shared,\n"
+		"each list adds a %u byte Gpio_PortConfig or %u byte Timer_OcConfig constant\n",
+		(unsigned)sizeof(Gpio_PortConfig), (unsigned)sizeof(Timer_OcConfig));
+
+	Sim_SetAccessHook(NULL);
+	return(Harness_Result());
+}
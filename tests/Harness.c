@@ -0,0 +1,159 @@
+/********************************************************************************
+* Name: Harness.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Checks and UART capture shared by the host tests.
+********************************************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "Harness.h"
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static char output[HARNESS_OUTPUT_SIZE];
+static uint32_t outputLength = 0;
+static uint32_t checks = 0;
+static uint32_t failures = 0;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Harness_Putc() - USART2 sink that keeps the output.
+* c				- Character sent.
+* No return value.
+*************************************************************/
+static void Harness_Putc(char c){
+	if(outputLength < HARNESS_OUTPUT_SIZE - 1){
+		output[outputLength++] = c;
+		output[outputLength] = '\0';
+	}
+}
+
+/*************************************************************
+* Harness_Send() - Sim_At() callback that types text on USART2 RX.
+* arg			- Text.
+* No return value.
+*************************************************************/
+static void Harness_Send(void *arg){
+	Sim_UartRx(arg);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* Harness_Check() - Count a check and report it if it failed.
+* ok			- Non zero if the check passed.
+* file		- Source file of the check.
+* line		- Line of the check.
+* text		- The checked expression.
+* No return value.
+*************************************************************/
+void Harness_Check(int ok, const char *file, int line, const char *text){
+	checks++;
+	if(!ok){
+		failures++;
+		printf("%s:%d: check failed: %s\n", file, line, text);
+	}
+}
+
+/*************************************************************
+* Harness_Fail() - Count a failure with a message.
+* format	- printf style message.
+* No return value.
+*************************************************************/
+void Harness_Fail(const char *format, ...){
+	va_list args;
+
+	checks++;
+	failures++;
+	printf("failed: ");
+	va_start(args, format);
+	vprintf(format, args);
+	va_end(args);
+	printf("\n");
+}
+
+/*************************************************************
+* Harness_CaptureUart() - Keep everything USART2 sends.
+* No inputs.
+* No return value.
+*************************************************************/
+void Harness_CaptureUart(void){
+	Sim_SetUartSink(Harness_Putc);
+}
+
+/*************************************************************
+* Harness_Output() - USART2 output so far.
+* No inputs.
+* Returns the output.
+*************************************************************/
+const char *Harness_Output(void){
+	return(output);
+}
+
+/*************************************************************
+* Harness_ClearOutput() - Forget the USART2 output so far.
+* No inputs.
+* No return value.
+*************************************************************/
+void Harness_ClearOutput(void){
+	outputLength = 0;
+	output[0] = '\0';
+}
+
+/*************************************************************
+* Harness_Find() - Look for text in the USART2 output.
+* text		- Text to find.
+* Returns where it starts in the output, or NULL.
+*************************************************************/
+const char *Harness_Find(const char *text){
+	return(strstr(output, text));
+}
+
+/*************************************************************
+* Harness_SendAt() - Type text on USART2 RX at a virtual time.
+* us			- Time (us since reset).
+* text		- Text, must stay valid until then.
+* No return value.
+*************************************************************/
+void Harness_SendAt(uint64_t us, const char *text){
+	Sim_At(us, Harness_Send, (void *)text);
+}
+
+/*************************************************************
+* Harness_Result() - Print the summary.
+* No inputs.
+* Returns the exit status, 0 if every check passed.
+*************************************************************/
+int Harness_Result(void){
+	printf("%u checks, %u failed\n", checks, failures);
+	fflush(stdout);
+	return((failures == 0 && checks > 0) ? 0 : 1);
+}
+
+/*************************************************************
+* Harness_Finish() - Print the summary and end the process, from a firmware test.
+* No inputs.
+* Never returns.
+*************************************************************/
+void Harness_Finish(void){
+	int status = Harness_Result();
+
+	if(status != 0){
+		printf("--- UART output ---\n%s\n", output);
+		fflush(stdout);
+	}
+	_exit(status);
+}
@@ -0,0 +1,32 @@
+/********************************************************************************
+* Name: Harness.h (interface)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Checks and UART capture shared by the host tests. A test either
+*							 has its own main() and calls drivers directly, or is linked
+*							 with main.c and runs the firmware, set up from a constructor
+*							 and checked from the Sim_SetEnd() callback.
+********************************************************************************/
+
+#ifndef __Harness_H
+#define __Harness_H
+
+#include <stdint.h>
+#include "Sim.h"
+
+#define HARNESS_OUTPUT_SIZE		65536			// UART characters kept
+
+// Records a failure with its location unless cond holds
+#define HARNESS_CHECK(cond)		Harness_Check((cond), __FILE__, __LINE__, #cond)
+
+void Harness_Check(int ok, const char *file, int line, const char *text);
+void Harness_Fail(const char *format, ...);
+void Harness_CaptureUart(void);
+const char *Harness_Output(void);
+void Harness_ClearOutput(void);
+const char *Harness_Find(const char *text);
+void Harness_SendAt(uint64_t us, const char *text);
+int Harness_Result(void);
+void Harness_Finish(void);
+
+#endif
@@ -0,0 +1,194 @@
+/********************************************************************************
+* Name: HsmTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Event sequences through Hsm.c on a small test machine. Every
+*							 handler offered an event, and every entry and exit action, is
+*							 logged; each dispatch must leave the log the UML run to
+*							 completion rules give (handlers innermost first, exits innermost
+*							 first, entries outermost first, then initial children).
+*
+*							 R
+*							 +- A				(initial A1)
+*							 |  +- A1
+*							 |  +- A2
+*							 +- B				(initial B1)
+*							    +- B1		(initial B11)
+*							       +- B11
+********************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "Harness.h"
+#include "Hsm.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define HSM_TEST_LOG		256
+
+// Events: NOP is handled without a transition, GO transitions to param
+#define SIG_NOP					(HSM_SIG_USER + 0)
+#define SIG_GO					(HSM_SIG_USER + 1)
+
+// States
+#define S_R							0
+#define S_A							1
+#define S_A1						2
+#define S_A2						3
+#define S_B							4
+#define S_B1						5
+#define S_B11						6
+#define S_COUNT					7
+
+static void HsmTest_Entry(Hsm_Machine *hsm);
+static void HsmTest_Exit(Hsm_Machine *hsm);
+static uint8_t HsmTest_Handle(Hsm_Machine *hsm, const Hsm_Event *event);
+
+static const Hsm_State testStates[] = {
+	//						name		parent		initial		entry						exit					handle
+	[S_R] =				{"R",		HSM_NONE,	S_A,			HsmTest_Entry,	HsmTest_Exit,	HsmTest_Handle},
+	[S_A] =				{"A",		S_R,			S_A1,			HsmTest_Entry,	HsmTest_Exit,	HsmTest_Handle},
+	[S_A1] =			{"A1",	S_A,			HSM_NONE,	HsmTest_Entry,	HsmTest_Exit,	HsmTest_Handle},
+	[S_A2] =			{"A2",	S_A,			HSM_NONE,	HsmTest_Entry,	HsmTest_Exit,	HsmTest_Handle},
+	[S_B] =				{"B",		S_R,			S_B1,			HsmTest_Entry,	HsmTest_Exit,	HsmTest_Handle},
+	[S_B1] =			{"B1",	S_B,			S_B11,		HsmTest_Entry,	HsmTest_Exit,	HsmTest_Handle},
+	[S_B11] =			{"B11",	S_B1,			HSM_NONE,	HsmTest_Entry,	HsmTest_Exit,	HsmTest_Handle},
+};
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static Hsm_Machine machine;
+static char log[HSM_TEST_LOG];
+static uint8_t handler;							// State that handles the next event, HSM_NONE for none
+static uint8_t changing;						// State whose entry or exit is being logged
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* HsmTest_Log() - Add "<mark><state>" to the log.
+* mark		- '+' entry, '-' exit, '?' event offered.
+* state		- State.
+* No return value.
+*************************************************************/
+static void HsmTest_Log(char mark, uint8_t state){
+	size_t length = strlen(log);
+
+	snprintf(log + length, sizeof(log) - length, "%s%c%s", (length != 0) ? " " : "", mark, testStates[state].name);
+}
+
+/*************************************************************
+* HsmTest_Entry() - Entry action of every state: log it.
+* hsm			- State machine, current is the state entered.
+* No return value.
+*************************************************************/
+static void HsmTest_Entry(Hsm_Machine *hsm){
+	HsmTest_Log('+', hsm->current);
+}
+
+/*************************************************************
+* HsmTest_Exit() - Exit action of every state: log it.
+* hsm			- State machine, current is the state left.
+* No return value.
+*************************************************************/
+static void HsmTest_Exit(Hsm_Machine *hsm){
+	HsmTest_Log('-', hsm->current);
+}
+
+/*************************************************************
+* HsmTest_Handle() - Event handler of every state: log the offer, and handle
+*										 the event if this is the handler state.
+* hsm			- State machine.
+* event		- Event.
+* Returns HSM_HANDLED in the handler state, otherwise HSM_UNHANDLED.
+*************************************************************/
+static uint8_t HsmTest_Handle(Hsm_Machine *hsm, const Hsm_Event *event){
+	HsmTest_Log('?', changing);
+	if(changing != handler){
+		changing = hsm->states[changing].parent;
+		return(HSM_UNHANDLED);
+	}
+	if(event->signal == SIG_GO){
+		Hsm_Transition(hsm, event->param);
+	}
+	return(HSM_HANDLED);
+}
+
+/*************************************************************
+* HsmTest_Send() - Dispatch one event and check the log it leaves.
+* by				- State that handles it (HSM_NONE for none).
+* signal		- SIG_NOP or SIG_GO.
+* target		- SIG_GO target.
+* expected	- Log the dispatch must leave.
+* No return value.
+*************************************************************/
+static void HsmTest_Send(uint8_t by, uint8_t signal, uint8_t target, const char *expected){
+	Hsm_Event event = {signal, target};
+	char from[8];
+
+	snprintf(from, sizeof(from), "%s", testStates[machine.current].name);
+	log[0] = '\0';
+	handler = by;
+	changing = machine.current;
+	Hsm_Dispatch(&machine, &event);
+	if(strcmp(log, expected) != 0){
+		Harness_Fail("in %s, %s to %s by %s: \"%s\", expected \"%s\"", from, (signal == SIG_GO) ? "go" : "nop",
+			testStates[target].name, (by == HSM_NONE) ? "none" : testStates[by].name, log, expected);
+	}
+	else{
+		printf("%-4s %s %-3s by %-4s  %s\n", from, (signal == SIG_GO) ? "go " : "nop",
+			(signal == SIG_GO) ? testStates[target].name : "", (by == HSM_NONE) ? "none" : testStates[by].name, log);
+	}
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(void){
+	Hsm_Event event;
+
+	// Initial state and its initial children, outermost first
+	Hsm_Init(&machine, "test", testStates, S_COUNT, S_R);
+	HARNESS_CHECK(strcmp(log, "+R +A +A1") == 0);
+	HARNESS_CHECK(machine.current == S_A1);
+
+	HsmTest_Send(S_A1, SIG_NOP, 0, "?A1");
+	HsmTest_Send(S_A, SIG_NOP, 0, "?A1 ?A");
+	HsmTest_Send(HSM_NONE, SIG_NOP, 0, "?A1 ?A ?R");
+	HARNESS_CHECK(machine.stats.unhandled == 1);
+
+	// Sibling, then across the tree from a parent's handler into initial children
+	HsmTest_Send(S_A1, SIG_GO, S_A2, "?A1 -A1 +A2");
+	HsmTest_Send(S_A, SIG_GO, S_B, "?A2 ?A -A2 -A +B +B1 +B11");
+	HARNESS_CHECK(machine.current == S_B11);
+	HARNESS_CHECK(Hsm_IsIn(&machine, S_B1) && Hsm_IsIn(&machine, S_B) && !Hsm_IsIn(&machine, S_A));
+
+	// To a parent (it is left and entered again), to itself, and from the root to a leaf
+	HsmTest_Send(S_B11, SIG_GO, S_B1, "?B11 -B11 -B1 +B1 +B11");
+	HsmTest_Send(S_B11, SIG_GO, S_B11, "?B11 -B11 +B11");
+	HsmTest_Send(S_R, SIG_GO, S_A2, "?B11 ?B1 ?B ?R -B11 -B1 -B +A +A2");
+	HARNESS_CHECK(machine.current == S_A2);
+	HARNESS_CHECK(machine.stats.events == 8 && machine.stats.transitions == 5);
+
+	// The queue keeps HSM_QUEUE_SIZE events in order and drops the next
+	for(uint8_t i = 0; i < HSM_QUEUE_SIZE; i++){
+		HARNESS_CHECK(Hsm_Post(&machine, SIG_NOP, i));
+	}
+	HARNESS_CHECK(!Hsm_Post(&machine, SIG_NOP, HSM_QUEUE_SIZE));
+	HARNESS_CHECK(machine.queue.drops == 1);
+	for(uint8_t i = 0; i < HSM_QUEUE_SIZE; i++){
+		HARNESS_CHECK(Kernel_QueueReceive(&machine.queue, &event, 0) && event.param == i);
+	}
+
+	return(Harness_Result());
+}
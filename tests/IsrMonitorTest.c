@@ -0,0 +1,191 @@
+/********************************************************************************
+* Name: IsrMonitorTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Interrupt statistics from simulated interrupt arrival. Encoder
+*							 edges are captured on TIM2 CH1 at a fixed rate while the main
+*							 program sometimes masks interrupts, and IsrMonitor_Report()
+*							 must count every interrupt and show the entry latency the mask
+*							 caused. Nested entries are driven directly to check the run
+*							 times, the nesting depth and the window restart.
+********************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "Harness.h"
+#include "Encoder.h"
+#include "IsrMonitor.h"
+#include "Profile.h"
+#include "SysClock.h"
+#include "UART.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define ISR_TEST_EDGES				100			// Encoder edges in the window
+#define ISR_TEST_PERIOD_US		1000		// Between edges
+#define ISR_TEST_MASK_US			40			// Interrupts masked around one edge
+
+// One row of the report
+typedef struct {
+	unsigned long count;
+	unsigned long load;				// 0.01%
+	unsigned long maxCycles;
+	unsigned long latAvg;			// us
+	unsigned long latMax;			// us
+} IsrTest_Stats;
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static uint32_t edges = 0;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* IsrTest_Edge() - Encoder edge on the left wheel, then schedule the next.
+* arg		- Unused.
+* No return value.
+*************************************************************/
+static void IsrTest_Edge(void *arg){
+	Sim_TimerCapture(TIM2, 1);
+	if(++edges < ISR_TEST_EDGES){
+		Sim_At(Sim_TimeUs() + ISR_TEST_PERIOD_US, IsrTest_Edge, NULL);
+	}
+}
+
+/*************************************************************
+* IsrTest_Report() - Print the report and wait for it to be sent.
+* No inputs.
+* Returns the window length (us), or 0 if the report is missing.
+*************************************************************/
+static unsigned long IsrTest_Report(void){
+	unsigned long window;
+	unsigned nesting;
+	const char *line;
+
+	Harness_ClearOutput();
+	IsrMonitor_Report();
+	while(!UART_TxDone()){
+		Sim_Run(1000);
+	}
+
+	line = Harness_Find("window:");
+	if(line == NULL || sscanf(line, "window: %lu us, max nesting: %u", &window, &nesting) != 2){
+		return(0);
+	}
+	return(window);
+}
+
+/*************************************************************
+* IsrTest_Row() - Read one ISR's row of the last report.
+* name		- ISR name as the report prints it.
+* row			- Returns the row.
+* Returns 1 if the row was found, otherwise 0.
+*************************************************************/
+static int IsrTest_Row(const char *name, IsrTest_Stats *row){
+	const char *line = Harness_Find(name);
+
+	if(line == NULL || sscanf(line + 15, "%lu %lu %lu %lu %lu", &row->count, &row->load, &row->maxCycles,
+		&row->latAvg, &row->latMax) != 5){
+		return(0);
+	}
+	printf("%.*s", (int)(strchr(line, '\n') - line + 1), line);
+	return(1);
+}
+
+/*************************************************************
+* IsrTest_Arrival() - Periodic edges, one of them arriving while masked.
+* No inputs.
+* No return value.
+*************************************************************/
+static void IsrTest_Arrival(void){
+	IsrTest_Stats row;
+	uint64_t start;
+	unsigned long window;
+
+	IsrMonitor_Init();
+	start = Sim_TimeUs();
+	Sim_At(start + ISR_TEST_PERIOD_US, IsrTest_Edge, NULL);
+
+	// Mask across the 50th edge, as a long critical section would
+	Sim_Run(50 * ISR_TEST_PERIOD_US - ISR_TEST_MASK_US / 2);
+	__disable_irq();
+	Sim_Run(ISR_TEST_MASK_US);
+	__enable_irq();
+	Sim_Run((uint64_t)ISR_TEST_EDGES * ISR_TEST_PERIOD_US - (Sim_TimeUs() - start) + ISR_TEST_PERIOD_US / 2);
+	HARNESS_CHECK(edges == ISR_TEST_EDGES);
+
+	window = IsrTest_Report();
+	HARNESS_CHECK(IsrTest_Row("TIM2 (encoder)", &row));
+	HARNESS_CHECK(window >= ISR_TEST_EDGES * ISR_TEST_PERIOD_US && window <= (ISR_TEST_EDGES + 1) * ISR_TEST_PERIOD_US);
+	HARNESS_CHECK(row.count == ISR_TEST_EDGES);
+
+	// Edges taken at once have no latency, the masked one waits out the mask
+	HARNESS_CHECK(row.latMax >= ISR_TEST_MASK_US / 2 - 1 && row.latMax <= ISR_TEST_MASK_US / 2 + 1);
+	HARNESS_CHECK(row.latAvg == 0);
+	HARNESS_CHECK(row.maxCycles > 0 && row.load <= (row.count * row.maxCycles * 10000UL) / (window * 72UL));
+}
+
+/*************************************************************
+* IsrTest_Nesting() - A nested entry, run times and the window restart.
+* No inputs.
+* No return value.
+*************************************************************/
+static void IsrTest_Nesting(void){
+	IsrTest_Stats row;
+	uint32_t outer, inner;
+	unsigned long window;
+
+	IsrMonitor_Init();
+	__disable_irq();
+	outer = IsrMonitor_Enter();
+	Sim_Run(10);
+	inner = IsrMonitor_Enter();
+	Sim_Run(10);
+	IsrMonitor_Exit(ISR_STEPPER, inner);
+	Sim_Run(10);
+	IsrMonitor_Exit(ISR_SERVO, outer);
+	__enable_irq();
+	Sim_Run(1000);
+
+	// 72 cycles per us plus the exit's cycle counter read, the outer run includes the inner
+	window = IsrTest_Report();
+	HARNESS_CHECK(Harness_Find("max nesting: 2\n") != NULL);
+	HARNESS_CHECK(IsrTest_Row("TIM6 (stepper)", &row));
+	HARNESS_CHECK(row.count == 1 && row.maxCycles >= 720 && row.maxCycles <= 720 + 2 * SIM_ACCESS_CYCLES);
+	HARNESS_CHECK(IsrTest_Row("TIM15 (servo)", &row));
+	HARNESS_CHECK(row.count == 1 && row.maxCycles >= 2160 && row.maxCycles <= 2160 + 4 * SIM_ACCESS_CYCLES);
+	HARNESS_CHECK(row.load == (row.maxCycles * 10000UL) / (window * 72UL));
+
+	// The report starts a new window, with only the USART2 interrupts that sent it
+	IsrTest_Report();
+	HARNESS_CHECK(Harness_Find("max nesting: 1\n") != NULL);
+	HARNESS_CHECK(IsrTest_Row("TIM15 (servo)", &row) && row.count == 0 && row.maxCycles == 0);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(void){
+	System_Clock_Init();
+	SystemCoreClockUpdate();
+	Profile_Init();
+	UART2_Init();
+	Encoder_Init();
+	Harness_CaptureUart();
+
+	IsrTest_Arrival();
+	IsrTest_Nesting();
+
+	return(Harness_Result());
+}
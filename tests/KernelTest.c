@@ -0,0 +1,278 @@
+/********************************************************************************
+* Name: KernelTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Scheduling order of the kernel on the POSIX thread port
+*							 (host/KernelPort.c) and the simulator. A control task gives,
+*							 sends and sleeps while three worker tasks above and below it log
+*							 when they run; the log must show the highest ready task running
+*							 first, preemption on a give to a higher task only, delays waking
+*							 in time order, FIFO queues and timeouts on time. The context
+*							 switch time is printed in simulated time (register accesses
+*							 only) and in host time (a thread hand off in the port).
+********************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "Harness.h"
+#include "Kernel.h"
+#include "SysClock.h"
+#include "Encoder.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define KERNEL_TEST_STACK			256				// Words per task
+#define KERNEL_TEST_LOG				256				// Log characters
+#define KERNEL_TEST_LATE_US		10				// Most a wake up may be late
+#define KERNEL_TEST_ROUNDS		10000			// Give/take round trips timed
+#define KERNEL_TEST_PERIOD_US	1000			// Kernel_DelayUntil() period
+#define KERNEL_TEST_PERIODS		10
+
+// Priorities, the control task sits between the workers
+#define KERNEL_TEST_HIGH			6
+#define KERNEL_TEST_CONTROL		4
+#define KERNEL_TEST_MID				3
+#define KERNEL_TEST_LOW				2
+
+// A worker: waits on its semaphore, logs its letter, then sleeps delayUs if set
+typedef struct {
+	Kernel_Task task;
+	uint32_t stack[KERNEL_TEST_STACK];
+	Kernel_Sem sem;
+	char letter;
+	uint32_t delayUs;
+	uint32_t lateUs;							// How late its last wake up was
+} KernelTest_Worker;
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static KernelTest_Worker high = {.sem = KERNEL_SEM_INIT(0, 1), .letter = 'H'};
+static KernelTest_Worker mid = {.sem = KERNEL_SEM_INIT(0, 1), .letter = 'M'};
+static KernelTest_Worker low = {.sem = KERNEL_SEM_INIT(0, 1), .letter = 'L'};
+static Kernel_Task control;
+static uint32_t controlStack[KERNEL_TEST_STACK];
+static Kernel_Sem timeoutSem = KERNEL_SEM_INIT(0, 1);
+static Kernel_Queue queue;
+static uint32_t queueItems[4];
+static char log[KERNEL_TEST_LOG];
+static uint32_t logLength;
+static uint64_t givenPs, switchedPs;			// Give to the high worker, and it running
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* KernelTest_Log() - Add a character to the run log.
+* c				- Task letter, 'c' for the control task.
+* No return value.
+*************************************************************/
+static void KernelTest_Log(char c){
+	if(logLength < KERNEL_TEST_LOG - 1){
+		log[logLength++] = c;
+		log[logLength] = '\0';
+	}
+}
+
+/*************************************************************
+* KernelTest_Expect() - Check the log, then clear it.
+* expected	- Log the scenario must leave.
+* scenario	- Name for the report.
+* No return value.
+*************************************************************/
+static void KernelTest_Expect(const char *expected, const char *scenario){
+	if(strcmp(log, expected) != 0){
+		Harness_Fail("%s: ran \"%s\", expected \"%s\"", scenario, log, expected);
+	}
+	else{
+		printf("%-32s %s\n", scenario, log);
+	}
+	logLength = 0;
+	log[0] = '\0';
+}
+
+/*************************************************************
+* KernelTest_Ns() - Host monotonic time.
+* No inputs.
+* Returns nanoseconds.
+*************************************************************/
+static uint64_t KernelTest_Ns(void){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+}
+
+/*************************************************************
+* KernelTest_WorkerTask() - Worker task body.
+* arg			- The worker.
+* Never returns.
+*************************************************************/
+static void KernelTest_WorkerTask(void *arg){
+	KernelTest_Worker *worker = arg;
+	uint64_t start;
+
+	while(1){
+		Kernel_SemTake(&worker->sem, KERNEL_FOREVER);
+		if(switchedPs == 0){
+			switchedPs = Sim_TimePs();
+		}
+		KernelTest_Log(worker->letter);
+		if(worker->delayUs != 0){
+			start = Sim_TimeUs();
+			Kernel_Delay(worker->delayUs);
+			worker->lateUs = (uint32_t)(Sim_TimeUs() - start - worker->delayUs);
+			KernelTest_Log(worker->letter + ('a' - 'A'));
+		}
+	}
+}
+
+/*************************************************************
+* KernelTest_GiveAll() - ISR: give every worker at once.
+* arg			- Unused.
+* No return value.
+*************************************************************/
+static void KernelTest_GiveAll(void *arg){
+	Kernel_SemGive(&low.sem);
+	Kernel_SemGive(&mid.sem);
+	Kernel_SemGive(&high.sem);
+}
+
+/*************************************************************
+* KernelTest_Send() - ISR: queue 1, 2 and 3.
+* arg			- Unused.
+* No return value.
+*************************************************************/
+static void KernelTest_Send(void *arg){
+	for(uint32_t item = 1; item <= 3; item++){
+		HARNESS_CHECK(Kernel_QueueSend(&queue, &item));
+	}
+}
+
+/*************************************************************
+* KernelTest_Scenarios() - Scheduling order checks.
+* No inputs.
+* No return value.
+*************************************************************/
+static void KernelTest_Scenarios(void){
+	uint32_t item, last;
+	uint64_t start;
+
+	// A give to a lower task waits for the giver to block, a give to a higher one preempts
+	KernelTest_Log('c');
+	Kernel_SemGive(&low.sem);
+	KernelTest_Log('c');
+	givenPs = Sim_TimePs();
+	switchedPs = 0;
+	Kernel_SemGive(&high.sem);
+	KernelTest_Log('c');
+	Kernel_Delay(100);
+	KernelTest_Expect("ccHcL", "give lower, then higher");
+	printf("  give to higher task running: %llu ns simulated\n", (unsigned long long)((switchedPs - givenPs) / 1000));
+
+	// Readied together by an ISR, they run highest first
+	Sim_At(Sim_TimeUs() + 50, KernelTest_GiveAll, NULL);
+	Kernel_Delay(100);
+	KernelTest_Expect("HML", "ISR gives all three");
+
+	// Delays wake in time order, not priority order
+	high.delayUs = 300;
+	mid.delayUs = 100;
+	low.delayUs = 200;
+	KernelTest_GiveAll(NULL);
+	Kernel_Delay(500);
+	KernelTest_Expect("HMLmlh", "delays 300, 100, 200 us");
+	HARNESS_CHECK(high.lateUs <= KERNEL_TEST_LATE_US && mid.lateUs <= KERNEL_TEST_LATE_US && low.lateUs <= KERNEL_TEST_LATE_US);
+	printf("  wake ups late by %u, %u, %u us\n", high.lateUs, mid.lateUs, low.lateUs);
+	high.delayUs = mid.delayUs = low.delayUs = 0;
+
+	// A queue filled by an ISR is received in order
+	Kernel_QueueInit(&queue, queueItems, sizeof(queueItems[0]), 4);
+	Sim_At(Sim_TimeUs() + 50, KernelTest_Send, NULL);
+	for(uint32_t expected = 1; expected <= 3; expected++){
+		HARNESS_CHECK(Kernel_QueueReceive(&queue, &item, KERNEL_FOREVER) && item == expected);
+		KernelTest_Log('0' + item);
+	}
+	KernelTest_Expect("123", "ISR sends 1, 2, 3");
+
+	// Timeouts
+	start = Sim_TimeUs();
+	HARNESS_CHECK(Kernel_QueueReceive(&queue, &item, 500) == 0);
+	HARNESS_CHECK(Sim_TimeUs() - start >= 500 && Sim_TimeUs() - start <= 500 + KERNEL_TEST_LATE_US);
+	printf("%-32s %llu us\n", "queue receive timeout 500 us", (unsigned long long)(Sim_TimeUs() - start));
+	start = Sim_TimeUs();
+	HARNESS_CHECK(Kernel_SemTake(&timeoutSem, 300) == 0);
+	HARNESS_CHECK(Sim_TimeUs() - start >= 300 && Sim_TimeUs() - start <= 300 + KERNEL_TEST_LATE_US);
+	printf("%-32s %llu us\n", "semaphore take timeout 300 us", (unsigned long long)(Sim_TimeUs() - start));
+
+	// A periodic task does not drift
+	last = ENCODER_TIMER->CNT;
+	start = Sim_TimeUs();
+	for(uint32_t i = 0; i < KERNEL_TEST_PERIODS; i++){
+		Kernel_DelayUntil(&last, KERNEL_TEST_PERIOD_US);
+	}
+	HARNESS_CHECK(Sim_TimeUs() - start >= KERNEL_TEST_PERIODS * KERNEL_TEST_PERIOD_US);
+	HARNESS_CHECK(Sim_TimeUs() - start <= KERNEL_TEST_PERIODS * KERNEL_TEST_PERIOD_US + KERNEL_TEST_LATE_US);
+	printf("%-32s %llu us\n", "10 periods of 1000 us", (unsigned long long)(Sim_TimeUs() - start));
+}
+
+/*************************************************************
+* KernelTest_Switches() - Time give/take round trips with the high worker.
+* No inputs.
+* No return value.
+*************************************************************/
+static void KernelTest_Switches(void){
+	uint32_t before = Kernel_GetSwitches();
+	uint64_t startPs = Sim_TimePs(), startNs = KernelTest_Ns();
+	uint64_t switchCount, simNs, hostNs;
+
+	for(uint32_t i = 0; i < KERNEL_TEST_ROUNDS; i++){
+		Kernel_SemGive(&high.sem);		// Runs it, it blocks again and switches back
+	}
+	hostNs = KernelTest_Ns() - startNs;
+	simNs = (Sim_TimePs() - startPs) / 1000;
+	switchCount = Kernel_GetSwitches() - before;
+	HARNESS_CHECK(switchCount == 2 * KERNEL_TEST_ROUNDS);
+	logLength = 0;
+
+	printf("context switch: %llu switches, %llu ns simulated, %llu ns host thread hand off each\n",
+		(unsigned long long)switchCount, (unsigned long long)(simNs / switchCount),
+		(unsigned long long)(hostNs / switchCount));
+}
+
+/*************************************************************
+* KernelTest_Control() - Control task: run the checks and end the test.
+* arg			- Unused.
+* Never returns.
+*************************************************************/
+static void KernelTest_Control(void *arg){
+	KernelTest_Scenarios();
+	KernelTest_Switches();
+	Harness_Finish();
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(void){
+	System_Clock_Init();
+	SystemCoreClockUpdate();
+	Encoder_Init();
+
+	Kernel_Init();
+	Kernel_TaskCreate(&high.task, "high", KernelTest_WorkerTask, &high, high.stack, KERNEL_TEST_STACK, KERNEL_TEST_HIGH);
+	Kernel_TaskCreate(&mid.task, "mid", KernelTest_WorkerTask, &mid, mid.stack, KERNEL_TEST_STACK, KERNEL_TEST_MID);
+	Kernel_TaskCreate(&low.task, "low", KernelTest_WorkerTask, &low, low.stack, KERNEL_TEST_STACK, KERNEL_TEST_LOW);
+	Kernel_TaskCreate(&control, "control", KernelTest_Control, NULL, controlStack, KERNEL_TEST_STACK, KERNEL_TEST_CONTROL);
+	Kernel_Start();
+}
@@ -0,0 +1,113 @@
+/********************************************************************************
+* Name: LoopMonitorTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Idle time accounting on the virtual clock. A kernel task stands in
+*							 for the main loop and is busy for a set time per TIM7 tick,
+*							 and the kernel idle task sleeps the rest. The CPU load, loop
+*							 rate, longest loop and histogram of each accounting second
+*							 must match the busy time, including a loop that overruns.
+********************************************************************************/
+
+#include <stdio.h>
+#include "Harness.h"
+#include "Encoder.h"
+#include "Kernel.h"
+#include "LoopMonitor.h"
+#include "SysClock.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define LOOP_TEST_LIGHT_US		2000		// Busy per loop for the first three seconds (20%)
+#define LOOP_TEST_HEAVY_US		12000		// Then longer than the loop tick
+#define LOOP_TEST_STACK				256			// Words
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static Kernel_Task loopTask;
+static uint32_t loopStack[LOOP_TEST_STACK];
+static LoopMonitor_Stats light;
+static LoopMonitor_Stats heavy;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* LoopTest_Task() - Main loop stand-in, busy then asleep until the next tick.
+* arg		- Unused.
+* No return value.
+*************************************************************/
+static void LoopTest_Task(void *arg){
+	while(1){
+		Sim_Run((Sim_TimeUs() < 3000000) ? LOOP_TEST_LIGHT_US : LOOP_TEST_HEAVY_US);
+		LoopMonitor_Sleep();
+	}
+}
+
+/*************************************************************
+* LoopTest_Sample() - Keep the last full second's statistics.
+* arg		- Where to keep them.
+* No return value.
+*************************************************************/
+static void LoopTest_Sample(void *arg){
+	LoopMonitor_Get((LoopMonitor_Stats *)arg);
+}
+
+/*************************************************************
+* LoopTest_Check() - Check both loads once the run ends.
+* No inputs.
+* Never returns.
+*************************************************************/
+static void LoopTest_Check(void){
+	uint32_t binned = 0;
+
+	printf("light: load %u.%02u%%, %u loops/s, max %u us\n", light.loadX100 / 100, light.loadX100 % 100,
+		light.loopsPerSec, light.maxLoopUs);
+	printf("heavy: load %u.%02u%%, %u loops/s, max %u us\n", heavy.loadX100 / 100, heavy.loadX100 % 100,
+		heavy.loopsPerSec, heavy.maxLoopUs);
+
+	// 2 ms in every 10 ms, the ticks and switches cost a little on top
+	HARNESS_CHECK(light.loadX100 >= 2000 && light.loadX100 <= 2010);
+	HARNESS_CHECK(light.loopsPerSec >= 99 && light.loopsPerSec <= 101);
+	HARNESS_CHECK(light.maxLoopUs >= LOOP_TEST_LIGHT_US && light.maxLoopUs <= LOOP_TEST_LIGHT_US + 2);
+	HARNESS_CHECK(light.histogram[3] == light.loopsPerSec || light.histogram[3] == light.loopsPerSec + 1);
+	for(int i = 0; i < LOOP_HIST_BINS; i++){
+		binned += light.histogram[i];
+	}
+	HARNESS_CHECK(binned == light.histogram[3]);
+
+	// Overrunning loops start again at once: never idle, one loop per 12 ms
+	HARNESS_CHECK(heavy.loadX100 >= 9990);
+	HARNESS_CHECK(heavy.loopsPerSec >= 83 && heavy.loopsPerSec <= 84);
+	HARNESS_CHECK(heavy.maxLoopUs >= LOOP_TEST_HEAVY_US && heavy.maxLoopUs <= LOOP_TEST_HEAVY_US + 2);
+	HARNESS_CHECK(heavy.histogram[5] >= 83 && heavy.histogram[5] <= 84);
+
+	Harness_Finish();
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(void){
+	System_Clock_Init();
+	Encoder_Init();
+	Kernel_Init();
+	LoopMonitor_Init();
+	Kernel_TaskCreate(&loopTask, "loop", LoopTest_Task, NULL, loopStack, LOOP_TEST_STACK, 1);
+
+	// Each sample is the second before, well inside its phase
+	Sim_At(Sim_TimeUs() + 2500000, LoopTest_Sample, &light);
+	Sim_At(Sim_TimeUs() + 5500000, LoopTest_Sample, &heavy);
+	Sim_SetEnd(Sim_TimeUs() + 6000000, LoopTest_Check);
+	Kernel_Start();
+}
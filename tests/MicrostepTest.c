@@ -0,0 +1,154 @@
+/********************************************************************************
+* Name: MicrostepTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Microstepping coil duties and their cost. In 1/16 step mode each
+*							 TIM6 step writes TIM1 CCR1-CCR4. The duties must trace the
+*							 sine/cosine table: one end of each coil driven at a time, a
+*							 constant current vector and an electrical angle that moves
+*							 90/16 degrees per microstep. The register accesses and DWT
+*							 cycles of each microstep update are reported.
+********************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include "Harness.h"
+#include "Profile.h"
+#include "Stepper.h"
+#include "SysClock.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define MICRO_TEST_STEPS			128			// Two electrical cycles at 1/16 step
+#define MICRO_TEST_PEAK				3600.0	// Table peak (STEPPER_PWM_PERIOD, 100% duty)
+#define MICRO_TEST_PI					3.14159265358979
+
+typedef struct {
+	uint32_t ccr[4];			// CCR1-CCR4 after the update
+	uint32_t reads;				// Register reads by TIM6_DAC_IRQHandler for this step
+	uint32_t writes;			// Register writes
+} MicroTest_Step;
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static MicroTest_Step steps[MICRO_TEST_STEPS + 1];
+static uint32_t stepCount = 0;
+static uint32_t ccr[4];
+static uint32_t reads = 0;
+static uint32_t writes = 0;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* MicroTest_Access() - Follow the CCR writes, one microstep ends at CCR4.
+* addr		- Register word address.
+* value		- Value written.
+* write		- Non zero for a write.
+* No return value.
+*************************************************************/
+static void MicroTest_Access(uint32_t addr, uint32_t value, uint8_t write){
+	uint32_t base = (uint32_t)(uintptr_t)&TIM1->CCR1;
+
+	if(write){
+		writes++;
+	}
+	else{
+		reads++;
+	}
+	if(!write || addr < base || addr > base + 12){
+		return;
+	}
+	ccr[(addr - base) / 4] = value;
+	if(addr == base + 12 && stepCount <= MICRO_TEST_STEPS){
+		for(uint32_t i = 0; i < 4; i++){
+			steps[stepCount].ccr[i] = ccr[i];
+		}
+		steps[stepCount].reads = reads;
+		steps[stepCount].writes = writes;
+		stepCount++;
+		reads = 0;
+		writes = 0;
+	}
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(void){
+	Profile_Stats stats;
+	double angle, lastAngle = 0, advance, magnitude;
+	double maxAngleError = 0, maxMagnitudeError = 0;
+	uint32_t maxReads = 0, maxWrites = 0;
+
+	System_Clock_Init();
+	Profile_Init();
+	Stepper_Init();
+
+	// Mode change: coils move to TIM1 (PC0-PC3 alternate function 2)
+	Stepper_SetStepMode(STEPPER_MICRO_16);
+	HARNESS_CHECK((Sim_Peek(&GPIOC->MODER) & 0xFFUL) == 0xAAUL);
+	HARNESS_CHECK((Sim_Peek(&GPIOC->AFR[0]) & 0xFFFFUL) == 0x2222UL);
+	HARNESS_CHECK((Sim_Peek(&TIM1->CR1) & TIM_CR1_CEN) != 0);
+	HARNESS_CHECK(Sim_Peek(&TIM1->ARR) == STEPPER_PWM_PERIOD - 1);
+
+	Profile_Reset();
+	Sim_SetAccessHook(MicroTest_Access);
+	Stepper_MoveTo(Stepper_GetPosition() + MICRO_TEST_STEPS);
+	for(uint32_t ms = 0; ms < 5000 && Stepper_IsRunning(); ms++){
+		Sim_Run(1000);
+	}
+	Sim_SetAccessHook(NULL);
+	HARNESS_CHECK(!Stepper_IsRunning());
+	HARNESS_CHECK(stepCount == MICRO_TEST_STEPS);
+
+	for(uint32_t i = 0; i < stepCount; i++){
+		const uint32_t *duty = steps[i].ccr;
+		double coilA = (double)duty[0] - duty[1];
+		double coilB = (double)duty[2] - duty[3];
+
+		// Only one end of each coil is driven, never beyond 100% duty
+		HARNESS_CHECK(duty[0] == 0 || duty[1] == 0);
+		HARNESS_CHECK(duty[2] == 0 || duty[3] == 0);
+		HARNESS_CHECK(duty[0] <= STEPPER_PWM_PERIOD && duty[1] <= STEPPER_PWM_PERIOD);
+		HARNESS_CHECK(duty[2] <= STEPPER_PWM_PERIOD && duty[3] <= STEPPER_PWM_PERIOD);
+
+		// Constant current vector, turning 90/16 degrees per microstep
+		magnitude = sqrt(coilA * coilA + coilB * coilB);
+		maxMagnitudeError = fmax(maxMagnitudeError, fabs(magnitude - MICRO_TEST_PEAK) / MICRO_TEST_PEAK);
+		angle = atan2(coilB, coilA) * 180.0 / MICRO_TEST_PI;
+		if(i > 0){
+			advance = fmod(angle - lastAngle + 540.0, 360.0) - 180.0;
+			maxAngleError = fmax(maxAngleError, fabs(advance - 90.0 / 16));
+		}
+		lastAngle = angle;
+
+		// First step's counts include the move set up
+		if(i > 0){
+			maxReads = (steps[i].reads > maxReads) ? steps[i].reads : maxReads;
+			maxWrites = (steps[i].writes > maxWrites) ? steps[i].writes : maxWrites;
+		}
+	}
+	HARNESS_CHECK(maxMagnitudeError < 0.005);
+	HARNESS_CHECK(maxAngleError < 0.25);
+
+	// Cost: the duty update itself and the whole step interrupt
+	Profile_Get(PROF_STEPPER_MICRO, &stats);
+	HARNESS_CHECK(stats.count == MICRO_TEST_STEPS);
+	printf("microstep: angle error %.3f deg, current error %.3f%%\n", maxAngleError, maxMagnitudeError * 100);
+	printf("microstep update: %u-%u cycles (mean %llu), step ISR: %u register reads, %u writes per microstep\n",
+		stats.min, stats.max, (unsigned long long)(stats.total / stats.count), maxReads, maxWrites);
+	HARNESS_CHECK(maxWrites <= 12);
+
+	return(Harness_Result());
+}
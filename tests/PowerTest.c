@@ -0,0 +1,165 @@
+/********************************************************************************
+* Name: PowerTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Clock profile changes must retime everything that depends on the
+*							 clock. In each profile every 1us timer must tick at 1MHz from
+*							 the clock the simulator gives it, USART2 must stay at 9600 baud
+*							 from its BRR, and the coil PWM duty must hold. Stop mode wakes on
+*							 HSI from a UART start bit and must come back to 72MHz.
+********************************************************************************/
+
+#include <stdio.h>
+#include "Harness.h"
+#include "Power.h"
+#include "SysClock.h"
+#include "Board.h"
+#include "UART.h"
+#include "Encoder.h"
+#include "Stepper.h"
+#include "RCServo.h"
+#include "KeyPad.h"
+#include "Ultrasonic.h"
+#include "DCMotor.h"
+#include "LoopMonitor.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define POWER_TEST_BAUD				9600UL
+#define POWER_TEST_BAUD_PCT		1				// Baud rate error allowed (the receiver copes with ~2%)
+#define POWER_TEST_WAKE_US		50000UL	// Stop mode lasts until a byte arrives this much later
+
+// Timers Power.c keeps at a 1us tick
+static TIM_TypeDef * const usTimers[] = {
+	BOARD_TIM(BOARD_ENCODER_TIMER), BOARD_TIM(BOARD_ULTRA_ECHO_TIMER), BOARD_TIM(BOARD_STEPPER_TIMER),
+	BOARD_TIM(BOARD_LOOP_TIMER), BOARD_TIM(BOARD_DCMOTOR_TIMER), BOARD_TIM(BOARD_SERVO_TIMER),
+	BOARD_TIM(BOARD_ULTRA_TRIGGER_TIMER), BOARD_TIM(BOARD_SERVO_GRIPPER_TIMER)
+};
+
+static const char * const usTimerNames[] = {
+	"encoder", "echo", "stepper", "loop", "dcmotor", "servo", "trigger", "gripper"
+};
+
+#define US_TIMER_COUNT (sizeof(usTimers) / sizeof(usTimers[0]))
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static uint32_t coilDuty;					// Coil A TIM1 duty, per mille, from POWER_RUN
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* PowerTest_Wake() - A byte on USART2 RX, its start bit wakes stop mode.
+* arg			- Unused.
+* No return value.
+*************************************************************/
+static void PowerTest_Wake(void *arg){
+	Sim_UartRx("x");
+}
+
+/*************************************************************
+* PowerTest_Check() - Check the clock dependent settings for a profile.
+* name			- Profile name for the report.
+* hclk			- Core clock the profile should run at (Hz).
+* No return value.
+*************************************************************/
+static void PowerTest_Check(const char *name, uint32_t hclk){
+	TIM_TypeDef *pwm = BOARD_TIM(BOARD_STEPPER_PWM_TIMER);
+	uint32_t psc = Power_TimerPrescaler(hclk);
+	uint32_t brr = Sim_Peek(&USART2->BRR);
+	uint32_t baud = Sim_UartClock() / brr;
+	uint32_t start, ticks, duty;
+
+	HARNESS_CHECK(Sim_Hclk() == hclk);
+	HARNESS_CHECK(SystemCoreClock == hclk);
+
+	for(uint32_t i = 0; i < US_TIMER_COUNT; i++){
+		if(Sim_Peek(&usTimers[i]->PSC) != psc || Sim_TimerClock(usTimers[i]) / (psc + 1) != 1000000UL){
+			Harness_Fail("%s: %s timer PSC %u at %u Hz is not a 1us tick", name, usTimerNames[i],
+				Sim_Peek(&usTimers[i]->PSC), Sim_TimerClock(usTimers[i]));
+		}
+	}
+
+	// The timebase counts 1000 in 1ms whatever the clock
+	start = Sim_Peek(&ENCODER_TIMER->CNT);
+	Sim_Run(1000);
+	ticks = Sim_Peek(&ENCODER_TIMER->CNT) - start;
+	HARNESS_CHECK(ticks >= 999 && ticks <= 1001);
+
+	HARNESS_CHECK(baud * 100 >= POWER_TEST_BAUD * (100 - POWER_TEST_BAUD_PCT));
+	HARNESS_CHECK(baud * 100 <= POWER_TEST_BAUD * (100 + POWER_TEST_BAUD_PCT));
+
+	// Coil PWM counts at the core clock: its frequency follows it, the duty must not
+	duty = (Sim_Peek(&pwm->CCR1) + Sim_Peek(&pwm->CCR2)) * 1000UL / (Sim_Peek(&pwm->ARR) + 1);
+	if(coilDuty == 0){
+		coilDuty = duty;
+	}
+	HARNESS_CHECK(duty == coilDuty);
+
+	printf("%-10s %8u Hz  PSC %2u  1ms = %4u ticks  BRR %4u  %4u baud  coil PWM %6u Hz %3u.%u%%\n",
+		name, hclk, psc, ticks, brr, baud, Sim_TimerClock(pwm) / (Sim_Peek(&pwm->ARR) + 1),
+		duty / 10, duty % 10);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(void){
+	uint64_t stopAt;
+
+	System_Clock_Init();
+	SystemCoreClockUpdate();
+	UART2_Init();
+	Encoder_Init();
+	Stepper_Init();
+	Ultra_Init();
+	DCMotor_Init();
+	RCServo_Init();
+	KeyPad_Init();
+	LoopMonitor_Init();
+	Power_Init();
+
+	// Hold a microstep so the coils have a PWM duty to keep
+	Stepper_SetStepMode(STEPPER_MICRO_16);
+	Stepper_Step(1);
+
+	HARNESS_CHECK(Power_TimerPrescaler(POWER_RUN_HZ) == 71);
+	HARNESS_CHECK(Power_TimerPrescaler(POWER_IDLE_HZ) == 7);
+
+	HARNESS_CHECK(Power_GetProfile() == POWER_RUN);
+	PowerTest_Check("run", POWER_RUN_HZ);
+
+	Power_SetProfile(POWER_IDLE);
+	HARNESS_CHECK(Power_GetProfile() == POWER_IDLE);
+	PowerTest_Check("idle", POWER_IDLE_HZ);
+
+	Power_SetProfile(POWER_RUN);
+	HARNESS_CHECK(Power_GetProfile() == POWER_RUN);
+	PowerTest_Check("run again", POWER_RUN_HZ);
+
+	// Stop wakes on HSI, then the PLL is restarted. The keypad columns have
+	// pull-ups on the board, no key is down.
+	for(uint8_t pin = 4; pin <= 7; pin++){
+		Sim_GpioInput(GPIOB, pin, 1);
+	}
+	stopAt = Sim_TimeUs();
+	Sim_At(stopAt + POWER_TEST_WAKE_US, PowerTest_Wake, NULL);
+	Power_SetProfile(POWER_STOP);
+	printf("stop mode woke after %llu us\n", (unsigned long long)(Sim_TimeUs() - stopAt));
+	HARNESS_CHECK(Sim_TimeUs() - stopAt >= POWER_TEST_WAKE_US);
+	HARNESS_CHECK(Power_GetProfile() == POWER_RUN);
+	PowerTest_Check("after stop", POWER_RUN_HZ);
+
+	return(Harness_Result());
+}
@@ -0,0 +1,137 @@
+/********************************************************************************
+* Name: ProfileTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Profiling probe aggregation. Profile_Record() must keep the
+*							 count, min, max and 64 bit total of each probe apart, and
+*							 Profile_Reset() must clear them. The probes themselves run on
+*							 the simulated DWT cycle counter, which counts virtual time, so
+*							 PROF_BEGIN/PROF_END around a known delay and around the
+*							 driver calls must read the right number of cycles.
+********************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "Harness.h"
+#include "Profile.h"
+#include "SysClock.h"
+#include "UART.h"
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* ProfileTest_Aggregate() - Count, min, max and total per probe.
+* No inputs.
+* No return value.
+*************************************************************/
+static void ProfileTest_Aggregate(void){
+	Profile_Stats stats;
+
+	Profile_Reset();
+	Profile_Record(PROF_LCD_CMD, 20);
+	Profile_Record(PROF_LCD_CMD, 10);
+	Profile_Record(PROF_LCD_CMD, 30);
+	Profile_Record(PROF_KEYPAD_SCAN, 5);
+
+	Profile_Get(PROF_LCD_CMD, &stats);
+	HARNESS_CHECK(stats.count == 3 && stats.min == 10 && stats.max == 30 && stats.total == 60);
+	Profile_Get(PROF_KEYPAD_SCAN, &stats);
+	HARNESS_CHECK(stats.count == 1 && stats.min == 5 && stats.max == 5 && stats.total == 5);
+
+	// A probe nothing recorded to
+	Profile_Get(PROF_STEPPER_STEP, &stats);
+	HARNESS_CHECK(stats.count == 0 && stats.min == 0xFFFFFFFFUL && stats.max == 0 && stats.total == 0);
+
+	// The total must not wrap at 32 bits
+	Profile_Record(PROF_STEPPER_STEP, 0xFFFFFFFFUL);
+	Profile_Record(PROF_STEPPER_STEP, 0xFFFFFFFFUL);
+	Profile_Get(PROF_STEPPER_STEP, &stats);
+	HARNESS_CHECK(stats.count == 2 && stats.total == 0x1FFFFFFFEULL);
+
+	Profile_Reset();
+	for(uint8_t id = 0; id < PROF_COUNT; id++){
+		Profile_Get(id, &stats);
+		HARNESS_CHECK(stats.count == 0 && stats.min == 0xFFFFFFFFUL && stats.max == 0 && stats.total == 0);
+	}
+}
+
+/*************************************************************
+* ProfileTest_Clock() - PROF_BEGIN/PROF_END around a known delay.
+* No inputs.
+* No return value.
+*************************************************************/
+static void ProfileTest_Clock(void){
+	Profile_Stats stats;
+
+	Profile_Reset();
+	for(uint32_t us = 100; us <= 500; us += 100){
+		PROF_BEGIN(PROF_STEPPER_MICRO);
+		Sim_Run(us);
+		PROF_END(PROF_STEPPER_MICRO);
+	}
+
+	// 72 cycles per us, plus the cost of the second cycle counter read
+	Profile_Get(PROF_STEPPER_MICRO, &stats);
+	printf("probe around 100-500 us: min %u max %u mean %llu cycles\n", stats.min, stats.max,
+		(unsigned long long)(stats.total / stats.count));
+	HARNESS_CHECK(stats.count == 5);
+	HARNESS_CHECK(stats.min >= 7200 && stats.min <= 7200 + 2 * SIM_ACCESS_CYCLES);
+	HARNESS_CHECK(stats.max >= 36000 && stats.max <= 36000 + 2 * SIM_ACCESS_CYCLES);
+	HARNESS_CHECK(stats.total >= 108000 && stats.total <= 108000 + 10 * SIM_ACCESS_CYCLES);
+}
+
+/*************************************************************
+* ProfileTest_Drivers() - The UART_printf probe and the dump.
+* No inputs.
+* No return value.
+*************************************************************/
+static void ProfileTest_Drivers(void){
+	Profile_Stats stats;
+	const char *line;
+
+	Profile_Reset();
+	for(int i = 0; i < 4; i++){
+		UART_printf("probe %d\n", i);
+	}
+	Profile_Get(PROF_UART_PRINTF, &stats);
+	printf("UART_printf: %u calls, min %u max %u cycles\n", stats.count, stats.min, stats.max);
+	HARNESS_CHECK(stats.count == 4);
+	HARNESS_CHECK(stats.min > 0 && stats.min <= stats.max);
+
+	// The dump is printed through UART_printf itself, so set the table first
+	Profile_Reset();
+	Profile_Record(PROF_LCD_CMD, 720);
+	Profile_Record(PROF_LCD_CMD, 2160);
+	Harness_ClearOutput();
+	Profile_Dump();
+	while(!UART_TxDone()){
+		Sim_Run(1000);		// 9600 baud
+	}
+
+	line = Harness_Find("LCD_cmd");
+	HARNESS_CHECK(line != NULL && strncmp(line, "LCD_cmd                  2       720      2160      1440         20\n", 68) == 0);
+	line = Harness_Find("Stepper_Step");
+	HARNESS_CHECK(line != NULL && strncmp(line, "Stepper_Step             0         -", 36) == 0);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(void){
+	System_Clock_Init();
+	SystemCoreClockUpdate();		// As System_Clock_InitStep() does, for the dump's us column
+	Profile_Init();
+	UART2_Init();
+	Harness_CaptureUart();
+
+	ProfileTest_Aggregate();
+	ProfileTest_Clock();
+	ProfileTest_Drivers();
+
+	return(Harness_Result());
+}
@@ -0,0 +1,303 @@
+/********************************************************************************
+* Name: QueuePoolTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Queue.h and Pool.h on host threads (host/HostThreads.c).
+*							 The stress test, built with ThreadSanitizer, passes a numbered
+*							 sequence from a producer thread to a consumer thread through a
+*							 small queue, has every thread allocate, fill and free pool blocks
+*							 at once, and sends pool blocks through a queue as an ISR would
+*							 hand messages to a task. Nothing may be lost, reordered, shared
+*							 or leaked, and ThreadSanitizer must not report a race.
+*							 With --bench (the QueuePoolBench build, -O2 without the
+*							 sanitizer) it prints the enqueue/dequeue and alloc/free rates.
+*
+* Usage: QueuePoolTest [--bench]
+********************************************************************************/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "HostThreads.h"
+#include "Queue.h"
+#include "Pool.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define QUEUE_POOL_SIZE				16				// Queue slots and pool blocks, small to hit full and empty
+#define QUEUE_POOL_THREADS		4					// Pool stress threads
+#define QUEUE_POOL_ITEMS			100000		// Items per stress test
+#define QUEUE_POOL_BENCH_OPS	10000000	// Operations per benchmark
+
+// Records a failure with its line unless cond holds
+#define QUEUE_POOL_CHECK(cond)	QueuePoolTest_Check((cond), __LINE__, #cond)
+
+// Message an ISR would fill: the sequence number repeated
+typedef struct {
+	uint32_t seq;
+	uint32_t words[7];
+} QueuePoolTest_Msg;
+
+typedef QueuePoolTest_Msg *QueuePoolTest_MsgRef;
+
+QUEUE_DEFINE(QueuePoolTest_Queue, uint32_t, QUEUE_POOL_SIZE)
+QUEUE_DEFINE(QueuePoolTest_MsgQueue, QueuePoolTest_MsgRef, QUEUE_POOL_SIZE)
+POOL_DEFINE(QueuePoolTest_Pool, QueuePoolTest_Msg, QUEUE_POOL_SIZE)
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static QueuePoolTest_Queue queue;
+static QueuePoolTest_MsgQueue msgQueue;
+static QueuePoolTest_Pool pool;
+static uint32_t failures;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* QueuePoolTest_Check() - Record a failed check.
+* ok			- Check result.
+* line		- Source line.
+* text		- Check as written.
+* No return value.
+*************************************************************/
+static void QueuePoolTest_Check(int ok, int line, const char *text){
+	if(!ok){
+		__atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED);
+		fprintf(stderr, "QueuePoolTest.c:%d: check failed: %s\n", line, text);
+	}
+}
+
+/*************************************************************
+* QueuePoolTest_Ns() - Monotonic time.
+* No inputs.
+* Returns nanoseconds.
+*************************************************************/
+static uint64_t QueuePoolTest_Ns(void){
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+}
+
+/*************************************************************
+* QueuePoolTest_Producer() - Put 1..QUEUE_POOL_ITEMS in order, waiting when full.
+* arg			- Unused.
+* Returns NULL.
+*************************************************************/
+static void *QueuePoolTest_Producer(void *arg){
+	for(uint32_t seq = 1; seq <= QUEUE_POOL_ITEMS; seq++){
+		while(!QueuePoolTest_Queue_Put(&queue, &seq)){
+			Host_Wfi();
+		}
+	}
+	return(NULL);
+}
+
+/*************************************************************
+* QueuePoolTest_Consumer() - Get the sequence, it must arrive whole and in order.
+* arg			- Unused.
+* Returns NULL.
+*************************************************************/
+static void *QueuePoolTest_Consumer(void *arg){
+	uint32_t seq, expected = 1;
+
+	while(expected <= QUEUE_POOL_ITEMS){
+		if(!QueuePoolTest_Queue_Get(&queue, &seq)){
+			Host_Wfi();
+			continue;
+		}
+		if(seq != expected){
+			QUEUE_POOL_CHECK(seq == expected);
+			return(NULL);
+		}
+		expected++;
+	}
+	return(NULL);
+}
+
+/*************************************************************
+* QueuePoolTest_Blocks() - Allocate, fill, check and free blocks; no block
+*													may be handed to two threads at once.
+* arg			- Thread index.
+* Returns NULL.
+*************************************************************/
+static void *QueuePoolTest_Blocks(void *arg){
+	QueuePoolTest_Msg *held[2];
+	uint32_t tag = (uint32_t)(uintptr_t)arg << 24;
+
+	for(uint32_t i = 0; i < QUEUE_POOL_ITEMS / QUEUE_POOL_THREADS; i++){
+		for(uint32_t b = 0; b < 2; b++){
+			while((held[b] = QueuePoolTest_Pool_Alloc(&pool)) == NULL){
+				Host_Wfi();
+			}
+			held[b]->seq = tag | i;
+			memset(held[b]->words, (int)b, sizeof(held[b]->words));
+		}
+		Host_Wfi();
+		for(uint32_t b = 0; b < 2; b++){
+			QUEUE_POOL_CHECK(held[b]->seq == (tag | i) && held[b]->words[6] == b * 0x01010101UL);
+			QueuePoolTest_Pool_Free(&pool, held[b]);
+		}
+	}
+	return(NULL);
+}
+
+/*************************************************************
+* QueuePoolTest_Send() - ISR side: fill pool blocks and queue them.
+* arg			- Unused.
+* Returns NULL.
+*************************************************************/
+static void *QueuePoolTest_Send(void *arg){
+	QueuePoolTest_Msg *msg;
+
+	for(uint32_t seq = 1; seq <= QUEUE_POOL_ITEMS; seq++){
+		while((msg = QueuePoolTest_Pool_Alloc(&pool)) == NULL){
+			Host_Wfi();
+		}
+		msg->seq = seq;
+		for(uint32_t w = 0; w < 7; w++){
+			msg->words[w] = seq;
+		}
+		// The queue has a slot per block, a block in hand always fits
+		QUEUE_POOL_CHECK(QueuePoolTest_MsgQueue_Put(&msgQueue, &msg));
+	}
+	return(NULL);
+}
+
+/*************************************************************
+* QueuePoolTest_Receive() - Task side: take the messages in order and free them.
+* arg			- Unused.
+* Returns NULL.
+*************************************************************/
+static void *QueuePoolTest_Receive(void *arg){
+	QueuePoolTest_Msg *msg;
+	uint32_t expected = 1;
+
+	while(expected <= QUEUE_POOL_ITEMS){
+		if(!QueuePoolTest_MsgQueue_Get(&msgQueue, &msg)){
+			Host_Wfi();
+			continue;
+		}
+		QUEUE_POOL_CHECK(msg->seq == expected && msg->words[6] == expected);
+		QueuePoolTest_Pool_Free(&pool, msg);
+		expected++;
+	}
+	return(NULL);
+}
+
+/*************************************************************
+* QueuePoolTest_Pair() - Run two threads and wait for both.
+* first		- First thread body.
+* second	- Second thread body.
+* Returns the wall time taken in ns.
+*************************************************************/
+static uint64_t QueuePoolTest_Pair(void *(*first)(void *), void *(*second)(void *)){
+	pthread_t threads[2];
+	uint64_t start = QueuePoolTest_Ns();
+
+	pthread_create(&threads[0], NULL, first, NULL);
+	pthread_create(&threads[1], NULL, second, NULL);
+	pthread_join(threads[0], NULL);
+	pthread_join(threads[1], NULL);
+	return(QueuePoolTest_Ns() - start);
+}
+
+/*************************************************************
+* QueuePoolTest_Stress() - The multithreaded checks.
+* No inputs.
+* No return value.
+*************************************************************/
+static void QueuePoolTest_Stress(void){
+	pthread_t threads[QUEUE_POOL_THREADS];
+
+	QueuePoolTest_Pair(QueuePoolTest_Producer, QueuePoolTest_Consumer);
+	QUEUE_POOL_CHECK(QueuePoolTest_Queue_Count(&queue) == 0);
+	QUEUE_POOL_CHECK(queue.stats.highWater <= QUEUE_POOL_SIZE);
+	printf("queue:    %u items in order, high water %u of %u, %u puts refused while full\n",
+		QUEUE_POOL_ITEMS, queue.stats.highWater, QUEUE_POOL_SIZE, queue.stats.drops);
+
+	QueuePoolTest_Pool_Init(&pool);
+	for(uintptr_t i = 0; i < QUEUE_POOL_THREADS; i++){
+		pthread_create(&threads[i], NULL, QueuePoolTest_Blocks, (void *)i);
+	}
+	for(uint32_t i = 0; i < QUEUE_POOL_THREADS; i++){
+		pthread_join(threads[i], NULL);
+	}
+	QUEUE_POOL_CHECK(pool.stats.inUse == 0);
+	QUEUE_POOL_CHECK(pool.stats.allocs == QUEUE_POOL_ITEMS * 2);
+	QUEUE_POOL_CHECK(pool.stats.peak <= QUEUE_POOL_SIZE);
+	printf("pool:     %u threads, %u allocs, peak %u of %u blocks, %u refused while empty\n",
+		QUEUE_POOL_THREADS, pool.stats.allocs, pool.stats.peak, QUEUE_POOL_SIZE, pool.stats.failures);
+
+	QueuePoolTest_Pool_Init(&pool);
+	QueuePoolTest_Pair(QueuePoolTest_Send, QueuePoolTest_Receive);
+	QUEUE_POOL_CHECK(pool.stats.inUse == 0);
+	QUEUE_POOL_CHECK(msgQueue.stats.drops == 0);
+	printf("messages: %u pool blocks through the queue in order, peak %u of %u blocks, %u refused while empty\n",
+		QUEUE_POOL_ITEMS, pool.stats.peak, QUEUE_POOL_SIZE, pool.stats.failures);
+}
+
+/*************************************************************
+* QueuePoolTest_Bench() - Enqueue/dequeue and alloc/free rates.
+* No inputs.
+* No return value.
+*************************************************************/
+static void QueuePoolTest_Bench(void){
+	QueuePoolTest_Msg *msg;
+	uint32_t item = 0, sum = 0;
+	uint64_t start, ns;
+
+	// One thread, a put then a get: the cost of the calls with the queue in cache
+	start = QueuePoolTest_Ns();
+	for(uint32_t i = 0; i < QUEUE_POOL_BENCH_OPS; i++){
+		(void)QueuePoolTest_Queue_Put(&queue, &i);
+		(void)QueuePoolTest_Queue_Get(&queue, &item);
+		sum += item;
+	}
+	ns = QueuePoolTest_Ns() - start;
+	QUEUE_POOL_CHECK(sum == (uint32_t)((uint64_t)QUEUE_POOL_BENCH_OPS * (QUEUE_POOL_BENCH_OPS - 1) / 2));
+	printf("queue put+get, one thread:   %6.2f ns/pair, %6.1f M items/s\n",
+		(double)ns / QUEUE_POOL_BENCH_OPS, QUEUE_POOL_BENCH_OPS * 1000.0 / ns);
+
+	// Producer and consumer threads through a 16 slot queue
+	ns = QueuePoolTest_Pair(QueuePoolTest_Producer, QueuePoolTest_Consumer);
+	printf("queue, two threads:          %6.2f ns/item, %6.1f M items/s\n",
+		(double)ns / QUEUE_POOL_ITEMS, QUEUE_POOL_ITEMS * 1000.0 / ns);
+
+	// Alloc then free, each in its critical section (a host mutex here, PRIMASK on the M4)
+	QueuePoolTest_Pool_Init(&pool);
+	start = QueuePoolTest_Ns();
+	for(uint32_t i = 0; i < QUEUE_POOL_BENCH_OPS; i++){
+		msg = QueuePoolTest_Pool_Alloc(&pool);
+		QueuePoolTest_Pool_Free(&pool, msg);
+	}
+	ns = QueuePoolTest_Ns() - start;
+	QUEUE_POOL_CHECK(pool.stats.inUse == 0);
+	printf("pool alloc+free, one thread: %6.2f ns/pair\n", (double)ns / QUEUE_POOL_BENCH_OPS);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(int argc, char **argv){
+	if(argc > 1 && strcmp(argv[1], "--bench") == 0){
+		QueuePoolTest_Bench();
+	}
+	else{
+		QueuePoolTest_Stress();
+	}
+	printf("%s\n", (failures == 0) ? "passed" : "failed");
+	return(failures != 0);
+}
@@ -0,0 +1,178 @@
+/********************************************************************************
+* Name: RegInitTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Golden register write trace of the driver inits. Every register
+*							 write each init makes is captured on the simulator as one line
+*							 ("Encoder: TIM2->CCMR1 = 0x00000101") and compared with the
+*							 reference capture, so any change to a peripheral configuration
+*							 shows up as a plain text diff. Register accesses and simulated
+*							 time of each init are printed too.
+*
+* Usage: RegInitTest <golden file> [--save]	(--save rewrites the golden file)
+********************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "Harness.h"
+#include "SysClock.h"
+#include "DCMotor.h"
+#include "Stepper.h"
+#include "LED.h"
+#include "KeyPad.h"
+#include "UART.h"
+#include "RCServo.h"
+#include "Ultrasonic.h"
+#include "Encoder.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define REGINIT_TEST_LINES		512			// Writes kept
+#define REGINIT_TEST_LINE			64			// Longest line
+#define REGINIT_TEST_DIFFS		20			// Differences printed
+
+// Inits in boot order (main.c bootTasks), the clock first
+typedef struct {
+	const char *name;
+	void (*init)(void);
+} RegInitTest_Driver;
+
+static const RegInitTest_Driver drivers[] = {
+	{"DCMotor",			DCMotor_Init},
+	{"Stepper",			Stepper_Init},
+	{"LED",					LED_Init},
+	{"KeyPad",			KeyPad_Init},
+	{"UART",				UART2_Init},
+	{"RCServo",			RCServo_Init},
+	{"Ultrasonic",	Ultra_Init},
+	{"Encoder",			Encoder_Init},
+};
+
+#define DRIVER_COUNT (sizeof(drivers) / sizeof(drivers[0]))
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static char lines[REGINIT_TEST_LINES][REGINIT_TEST_LINE];
+static uint32_t lineCount;
+static const char *driverName;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* RegInitTest_Access() - Capture every register write as a line.
+* addr		- Register word address.
+* value		- Value written.
+* write		- Non zero for a write.
+* No return value.
+*************************************************************/
+static void RegInitTest_Access(uint32_t addr, uint32_t value, uint8_t write){
+	char name[32];
+
+	if(write && lineCount < REGINIT_TEST_LINES){
+		snprintf(lines[lineCount++], REGINIT_TEST_LINE, "%s: %s = 0x%08X",
+			driverName, Sim_RegName(addr, name, sizeof(name)), value);
+	}
+}
+
+/*************************************************************
+* RegInitTest_Save() - Write the capture as the golden file.
+* path		- Golden file.
+* No return value.
+*************************************************************/
+static void RegInitTest_Save(const char *path){
+	FILE *file = fopen(path, "w");
+
+	if(file == NULL){
+		Harness_Fail("cannot write %s", path);
+		return;
+	}
+	for(uint32_t i = 0; i < lineCount; i++){
+		fprintf(file, "%s\n", lines[i]);
+	}
+	fclose(file);
+	printf("%u writes saved to %s\n", lineCount, path);
+}
+
+/*************************************************************
+* RegInitTest_Compare() - Compare the capture with the golden file.
+* path		- Golden file.
+* No return value.
+*************************************************************/
+static void RegInitTest_Compare(const char *path){
+	FILE *file = fopen(path, "r");
+	char golden[REGINIT_TEST_LINE + 2];
+	uint32_t line = 0, diffs = 0;
+
+	if(file == NULL){
+		Harness_Fail("cannot read %s (run with --save to create it)", path);
+		return;
+	}
+	while(fgets(golden, sizeof(golden), file) != NULL){
+		golden[strcspn(golden, "\n")] = '\0';
+		if(line >= lineCount || strcmp(golden, lines[line]) != 0){
+			if(diffs++ < REGINIT_TEST_DIFFS){
+				printf("line %u\n-%s\n+%s\n", line + 1, golden, (line < lineCount) ? lines[line] : "");
+			}
+		}
+		line++;
+	}
+	fclose(file);
+	for(; line < lineCount; line++){
+		if(diffs++ < REGINIT_TEST_DIFFS){
+			printf("line %u\n-\n+%s\n", line + 1, lines[line]);
+		}
+	}
+	if(diffs != 0){
+		Harness_Fail("%u lines differ from %s", diffs, path);
+	}
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(int argc, char **argv){
+	uint32_t reads, writes, first;
+	uint64_t start;
+
+	if(argc < 2){
+		fprintf(stderr, "usage: %s <golden file> [--save]\n", argv[0]);
+		return(2);
+	}
+
+	System_Clock_Init();
+	SystemCoreClockUpdate();
+
+	Sim_SetAccessHook(RegInitTest_Access);
+	printf("%-12s %6s %6s %8s\n", "init", "reads", "writes", "ns");
+	for(uint32_t i = 0; i < DRIVER_COUNT; i++){
+		driverName = drivers[i].name;
+		first = lineCount;
+		Sim_ResetCounts();
+		start = Sim_TimePs();
+		drivers[i].init();
+		Sim_GetCounts(&reads, &writes);
+		HARNESS_CHECK(writes == lineCount - first);
+		printf("%-12s %6u %6u %8llu\n", driverName, reads, writes, (unsigned long long)((Sim_TimePs() - start) / 1000));
+	}
+	Sim_SetAccessHook(NULL);
+	HARNESS_CHECK(lineCount < REGINIT_TEST_LINES);
+
+	if(argc > 2 && strcmp(argv[2], "--save") == 0){
+		RegInitTest_Save(argv[1]);
+	}
+	else{
+		RegInitTest_Compare(argv[1]);
+	}
+	return(Harness_Result());
+}
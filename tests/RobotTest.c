@@ -0,0 +1,146 @@
+/********************************************************************************
+* Name: RobotTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Runs the unmodified firmware and walks the robot state machine
+*							 through its modes from the UART commands, reading the active
+*							 states back from the 'h' report after each one. The report's
+*							 dispatch totals before and after each command give the cycles
+*							 that command's dispatch took (simulated cycles: peripheral
+*							 accesses and waits, not instructions).
+********************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "Harness.h"
+#include "Robot.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define ROBOT_TEST_START_US		1000000UL		// Boot and the menu are out
+#define ROBOT_TEST_STEP_US		200000UL		// Between a command and its report (mode changes write the LCD)
+#define ROBOT_TEST_SHORT_US		50000UL			// Report while the command's entry action is still running
+#define ROBOT_TEST_CAL_US			(ROBOT_CAL_TICKS * ROBOT_TICK_US + ROBOT_TEST_STEP_US)	// Calibration waits for trim keys
+#define ROBOT_TEST_HZ					72				// Cycles per us
+
+// A command, when its report is asked for and the states it must show, innermost first
+typedef struct {
+	const char *command;
+	const char *name;
+	uint32_t reportUs;
+	const char *states;
+} RobotTest_Step;
+
+static const RobotTest_Step steps[] = {
+	{"",	"boot",					ROBOT_TEST_STEP_US,		"step manual operating root"},
+	{"a",	"auto",					ROBOT_TEST_STEP_US,		"cruise auto operating root"},
+	{"",	"cruising",			ROBOT_TEST_STEP_US,		"cruise auto operating root"},	// Ticks only
+	{"e",	"fault",				ROBOT_TEST_STEP_US,		"fault root"},
+	{"a",	"auto in fault",	ROBOT_TEST_STEP_US,		"fault root"},
+	{"m",	"manual",				ROBOT_TEST_STEP_US,		"step manual operating root"},
+	{"u",	"microstep",		ROBOT_TEST_STEP_US,		"step manual operating root"},
+	{"c",	"calibrate",		ROBOT_TEST_SHORT_US,	"calibrate operating root"},	// Servos centred on the next tick
+	{"",	"calibrated",		ROBOT_TEST_CAL_US,		"step manual operating root"},	// Keys left alone for ROBOT_CAL_TICKS
+};
+
+#define STEP_COUNT (sizeof(steps) / sizeof(steps[0]))
+
+// Report fields
+typedef struct {
+	char states[64];
+	unsigned long events, unhandled, transitions, drops;
+	unsigned long min, mean, max;
+} RobotTest_Report;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* RobotTest_Parse() - Read the next robot report from the output.
+* text		- Output from where to look.
+* report	- Fields read.
+* Returns the output after the report, or NULL without one.
+*************************************************************/
+static const char *RobotTest_Parse(const char *text, RobotTest_Report *report){
+	const char *at = strstr(text, "robot: ");
+	size_t length;
+
+	if(at == NULL){
+		return(NULL);
+	}
+	at += strlen("robot: ");
+	length = strcspn(at, "\n");
+	if(length >= sizeof(report->states)){
+		return(NULL);
+	}
+	memcpy(report->states, at, length);
+	report->states[length] = '\0';
+	at += length;
+	if(sscanf(at, "\n  %lu events (%lu unhandled), %lu transitions, %lu queue drops\n  dispatch cycles min %lu, mean %lu, max %lu",
+		&report->events, &report->unhandled, &report->transitions, &report->drops,
+		&report->min, &report->mean, &report->max) != 7){
+		return(NULL);
+	}
+	return(at);
+}
+
+/*************************************************************
+* RobotTest_Check() - Check each report once the run ends.
+* No inputs.
+* Never returns.
+*************************************************************/
+static void RobotTest_Check(void){
+	const char *text = Harness_Output();
+	RobotTest_Report report, last = {0};
+	long cycles;
+
+	printf("%-14s %-28s %7s %9s %10s\n", "command", "states", "events", "unhandled", "cycles");
+	for(uint32_t i = 0; i < STEP_COUNT; i++){
+		text = RobotTest_Parse(text, &report);
+		if(text == NULL){
+			Harness_Fail("%s: no robot report", steps[i].name);
+			break;
+		}
+		if(strcmp(report.states, steps[i].states) != 0){
+			Harness_Fail("%s: \"%s\", expected \"%s\"", steps[i].name, report.states, steps[i].states);
+		}
+
+		// Totals from the rounded means, good to an event count of cycles
+		cycles = (long)(report.mean * report.events) - (long)(last.mean * last.events);
+		if(cycles < 0){
+			cycles = 0;
+		}
+		printf("%-14s %-28s %7lu %9lu %10ld (%ld.%02ld us at 72MHz)\n", steps[i].name, report.states,
+			report.events - last.events, report.unhandled - last.unhandled, cycles,
+			cycles / ROBOT_TEST_HZ, (cycles % ROBOT_TEST_HZ) * 100 / ROBOT_TEST_HZ);
+		HARNESS_CHECK(report.drops == 0);
+		last = report;
+	}
+	printf("dispatch cycles min %lu, mean %lu, max %lu over %lu events\n", last.min, last.mean, last.max, last.events);
+
+	Harness_Finish();
+}
+
+/*************************************************************
+* RobotTest_Init() - Queue the commands before main().
+* No inputs.
+* No return value.
+*************************************************************/
+__attribute__((constructor)) static void RobotTest_Init(void){
+	uint64_t at = ROBOT_TEST_START_US;
+
+	Harness_CaptureUart();
+	for(uint32_t i = 0; i < STEP_COUNT; i++){
+		if(steps[i].command[0] != '\0'){
+			Harness_SendAt(at, steps[i].command);
+		}
+		Harness_SendAt(at + steps[i].reportUs, "h");
+		at += steps[i].reportUs + ROBOT_TEST_STEP_US;
+	}
+	Sim_SetEnd(at + ROBOT_TEST_STEP_US, RobotTest_Check);
+}
@@ -0,0 +1,175 @@
+/********************************************************************************
+* Name: ServoChannelsTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Pan, tilt and gripper servos on TIM15 CH2, TIM15 CH1 and TIM17
+*							 CH1. Each channel must have its own pin, PWM set up and 20 ms
+*							 frame, all three trajectories must be updated together in the
+*							 one TIM15 frame interrupt, and the register accesses that
+*							 update costs per frame are reported.
+********************************************************************************/
+
+#include <stdio.h>
+#include "Harness.h"
+#include "RCServo.h"
+#include "SysClock.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define CHANNELS_TEST_FRAMES		60
+#define CHANNELS_TEST_FRAME_PS	20000000000ULL
+
+// Where each servo's pulse width is written
+static volatile uint32_t * const ccrs[SERVO_COUNT] = {&TIM15->CCR2, &TIM15->CCR1, &TIM17->CCR1};
+
+typedef struct {
+	uint64_t startPs;						// TIM15 update flag acknowledged
+	uint64_t lastWritePs;				// Last CCR write of the frame
+	uint16_t pw[SERVO_COUNT];		// Pulse widths written this frame (0 if none)
+	uint32_t accesses;					// Register accesses in the frame interrupt
+} ChannelsTest_Frame;
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static ChannelsTest_Frame frames[CHANNELS_TEST_FRAMES];
+static uint32_t frameCount = 0;
+static uint8_t inFrame = 0;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* ChannelsTest_Access() - Split the accesses into frames and note the CCR writes.
+* addr		- Register word address.
+* value		- Value written.
+* write		- Non zero for a write.
+* No return value.
+*************************************************************/
+static void ChannelsTest_Access(uint32_t addr, uint32_t value, uint8_t write){
+	ChannelsTest_Frame *frame;
+
+	if(write && addr == (uint32_t)(uintptr_t)&TIM15->SR){
+		inFrame = (frameCount < CHANNELS_TEST_FRAMES);
+		if(inFrame){
+			frames[frameCount].startPs = Sim_TimePs();
+			frameCount++;
+		}
+	}
+	if(!inFrame){
+		return;
+	}
+
+	frame = &frames[frameCount - 1];
+	frame->accesses++;
+	for(uint32_t servo = 0; servo < SERVO_COUNT; servo++){
+		if(write && addr == (uint32_t)(uintptr_t)ccrs[servo]){
+			frame->pw[servo] = (uint16_t)value;
+			frame->lastWritePs = Sim_TimePs();
+		}
+	}
+
+	// The interrupt ends with the servo bus topic publish (IsrMonitor exit reads the cycle counter)
+	if(!write && addr == (uint32_t)(uintptr_t)&DWT->CYCCNT && frame->lastWritePs != 0){
+		inFrame = 0;
+	}
+}
+
+/*************************************************************
+* ChannelsTest_Pins() - Each servo pin is its timer channel's alternate function.
+* No inputs.
+* No return value.
+*************************************************************/
+static void ChannelsTest_Pins(void){
+	const uint8_t pins[SERVO_COUNT] = {BOARD_SERVO_PAN_PIN, BOARD_SERVO_TILT_PIN, BOARD_SERVO_GRIPPER_PIN};
+	const uint8_t afs[SERVO_COUNT] = {BOARD_SERVO_PAN_AF, BOARD_SERVO_TILT_AF, BOARD_SERVO_GRIPPER_AF};
+	uint32_t moder = Sim_Peek(&GPIOB->MODER);
+
+	for(uint32_t servo = 0; servo < SERVO_COUNT; servo++){
+		uint8_t pin = pins[servo];
+		uint32_t afr = Sim_Peek(&GPIOB->AFR[pin >> 3]);
+
+		HARNESS_CHECK(((moder >> (2 * pin)) & 0x3UL) == 0x2UL);
+		HARNESS_CHECK(((afr >> (4 * (pin & 0x7))) & 0xFUL) == afs[servo]);
+	}
+
+	// PWM mode 1 with preload on each channel, outputs enabled
+	HARNESS_CHECK((Sim_Peek(&TIM15->CCMR1) & (TIM_CCMR1_OC1M | TIM_CCMR1_OC1PE)) == (TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1PE));
+	HARNESS_CHECK((Sim_Peek(&TIM15->CCMR1) & (TIM_CCMR1_OC2M | TIM_CCMR1_OC2PE)) == (TIM_CCMR1_OC2M_1 | TIM_CCMR1_OC2M_2 | TIM_CCMR1_OC2PE));
+	HARNESS_CHECK((Sim_Peek(&TIM17->CCMR1) & (TIM_CCMR1_OC1M | TIM_CCMR1_OC1PE)) == (TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1PE));
+	HARNESS_CHECK((Sim_Peek(&TIM15->CCER) & (TIM_CCER_CC1E | TIM_CCER_CC2E)) == (TIM_CCER_CC1E | TIM_CCER_CC2E));
+	HARNESS_CHECK((Sim_Peek(&TIM17->CCER) & TIM_CCER_CC1E) == TIM_CCER_CC1E);
+	HARNESS_CHECK((Sim_Peek(&TIM15->BDTR) & TIM_BDTR_MOE) && (Sim_Peek(&TIM17->BDTR) & TIM_BDTR_MOE));
+	HARNESS_CHECK((Sim_Peek(&TIM15->CR1) & TIM_CR1_CEN) && (Sim_Peek(&TIM17->CR1) & TIM_CR1_CEN));
+}
+
+/*************************************************************
+* ChannelsTest_Frames() - Three trajectories at once, each on its own channel.
+* No inputs.
+* No return value.
+*************************************************************/
+static void ChannelsTest_Frames(void){
+	uint32_t maxAccesses = 0;
+	uint64_t maxSpread = 0;
+
+	RCServo_SetAngle(SERVO_PAN, 0);
+	RCServo_SetAngle(SERVO_TILT, 0);
+	RCServo_SetAngle(SERVO_GRIPPER, 0);
+	Sim_Run(40000);
+	frameCount = 0;
+	inFrame = 0;
+	RCServo_MoveTo(SERVO_PAN, 400, 100);				// +20 us per frame for 20 frames
+	RCServo_MoveTo(SERVO_TILT, -300, 50);				// -10 us per frame for 30 frames
+	RCServo_Sweep(SERVO_GRIPPER, 0, 200, 25);		// +/-5 us per frame, turning after 40 frames
+	Sim_Run(CHANNELS_TEST_FRAMES * 20000ULL);
+
+	HARNESS_CHECK(frameCount == CHANNELS_TEST_FRAMES);
+	for(uint32_t i = 0; i < frameCount; i++){
+		ChannelsTest_Frame *frame = &frames[i];
+		uint16_t pan = (i < 20) ? 1500 + 20 * (i + 1) : 0;
+		uint16_t tilt = (i < 30) ? 1500 - 10 * (i + 1) : 0;
+		uint16_t gripper = (i <= 40) ? 1500 + 5 * i : 1700 - 5 * (i - 40);
+
+		// Servos that have arrived are not rewritten (0), the sweep starts from where the gripper is
+		if(frame->pw[SERVO_PAN] != pan || frame->pw[SERVO_TILT] != tilt || frame->pw[SERVO_GRIPPER] != gripper){
+			Harness_Fail("frame %u wrote %u/%u/%u", i, frame->pw[0], frame->pw[1], frame->pw[2]);
+		}
+		if(i > 0 && frame->startPs - frames[i - 1].startPs != CHANNELS_TEST_FRAME_PS &&
+			frame->startPs - frames[i - 1].startPs - CHANNELS_TEST_FRAME_PS > 1000000ULL){
+			Harness_Fail("frame %u started %llu ps after the last", i, (unsigned long long)(frame->startPs - frames[i - 1].startPs));
+		}
+		maxSpread = (frame->lastWritePs - frame->startPs > maxSpread) ? frame->lastWritePs - frame->startPs : maxSpread;
+		maxAccesses = (frame->accesses > maxAccesses) ? frame->accesses : maxAccesses;
+	}
+	HARNESS_CHECK(!RCServo_IsMoving(SERVO_PAN) && !RCServo_IsMoving(SERVO_TILT) && RCServo_IsMoving(SERVO_GRIPPER));
+	HARNESS_CHECK(RCServo_GetAngle(SERVO_PAN) == 400 && RCServo_GetAngle(SERVO_TILT) == -300);
+
+	// All three pulse widths land well inside the frame, before the next preload
+	printf("frame update: %llu ns from the update flag to the last CCR write, %u register accesses\n",
+		(unsigned long long)(maxSpread / 1000), maxAccesses);
+	HARNESS_CHECK(maxSpread < 100000000ULL);
+	HARNESS_CHECK(maxAccesses <= 40);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(void){
+	System_Clock_Init();
+	RCServo_Init();
+	Sim_SetAccessHook(ChannelsTest_Access);
+
+	ChannelsTest_Pins();
+	ChannelsTest_Frames();
+
+	return(Harness_Result());
+}
@@ -0,0 +1,196 @@
+/********************************************************************************
+* Name: ServoTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Servo pulse width math and trajectory timing. Angles must map to
+*							 CCR pulse widths through the calibration (centre, limits and
+*							 us/degree, with 0.1 degree resolution) and slews and sweeps
+*							 must move one slew increment per 20 ms TIM15 frame.
+********************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Harness.h"
+#include "RCServo.h"
+#include "SysClock.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define SERVO_TEST_FRAME_US		20000ULL
+#define SERVO_TEST_FRAMES			400
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static uint64_t framePs[SERVO_TEST_FRAMES];
+static uint16_t framePw[SERVO_TEST_FRAMES];
+static uint32_t frames = 0;
+static uint16_t lastPw = 0;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* ServoTest_Access() - Record each frame's time and pan pulse width.
+* addr		- Register word address.
+* value		- Value written.
+* write		- Non zero for a write.
+* No return value.
+*************************************************************/
+static void ServoTest_Access(uint32_t addr, uint32_t value, uint8_t write){
+	// The frame interrupt acknowledges the update flag before updating the trajectories
+	if(write && addr == (uint32_t)(uintptr_t)&TIM15->SR && frames < SERVO_TEST_FRAMES){
+		framePs[frames] = Sim_TimePs();
+		framePw[frames] = (frames > 0) ? framePw[frames - 1] : lastPw;		// Unchanged unless written
+		frames++;
+	}
+	else if(write && addr == (uint32_t)(uintptr_t)&TIM15->CCR2){
+		lastPw = (uint16_t)value;
+		if(frames > 0){
+			framePw[frames - 1] = lastPw;
+		}
+	}
+}
+
+/*************************************************************
+* ServoTest_Expected() - Reference pulse width for an angle.
+* cal			- Calibration.
+* angle		- Angle (0.1 degrees).
+* Returns the pulse width (us).
+*************************************************************/
+static int32_t ServoTest_Expected(const RCServo_Calibration *cal, int32_t angle){
+	int32_t pw = cal->centre + (angle * cal->usPerDegreeX10) / 100;
+
+	return((pw > cal->posLimit) ? cal->posLimit : ((pw < cal->negLimit) ? cal->negLimit : pw));
+}
+
+/*************************************************************
+* ServoTest_Math() - Angle to pulse width for the default and a custom calibration.
+* No inputs.
+* No return value.
+*************************************************************/
+static void ServoTest_Math(void){
+	const RCServo_Calibration defaults = {1500, 1050, 1950, 100};
+	const RCServo_Calibration custom = {1520, 1000, 2080, 115};
+	RCServo_Calibration read;
+	int32_t angle;
+	uint32_t wrong = 0;
+
+	// Whole degrees, including past the mechanical limits
+	for(angle = -90; angle <= 90; angle++){
+		int16_t pw = RCServo_SetAngle(SERVO_PAN, angle);
+		if(pw != ServoTest_Expected(&defaults, angle * 10) || Sim_Peek(&TIM15->CCR2) != (uint32_t)pw){
+			wrong++;
+		}
+	}
+	HARNESS_CHECK(wrong == 0);
+	HARNESS_CHECK(RCServo_SetAngle(SERVO_PAN, 0) == 1500);
+	HARNESS_CHECK(RCServo_SetAngle(SERVO_PAN, 45) == 1950);
+	HARNESS_CHECK(RCServo_SetAngle(SERVO_PAN, -60) == 1050);
+
+	// Tenths of a degree through a trimmed calibration
+	RCServo_SetCalibration(SERVO_TILT, &custom);
+	RCServo_GetCalibration(SERVO_TILT, &read);
+	HARNESS_CHECK(read.centre == custom.centre && read.negLimit == custom.negLimit &&
+		read.posLimit == custom.posLimit && read.usPerDegreeX10 == custom.usPerDegreeX10);
+	for(angle = -900, wrong = 0; angle <= 900; angle += 7){
+		int16_t pw = RCServo_SetAngleFine(SERVO_TILT, angle);
+		if(pw != ServoTest_Expected(&custom, angle) || Sim_Peek(&TIM15->CCR1) != (uint32_t)pw){
+			wrong++;
+		}
+	}
+	HARNESS_CHECK(wrong == 0);
+	HARNESS_CHECK(RCServo_SetAngleFine(SERVO_TILT, 123) == 1520 + 123 * 115 / 100);
+	HARNESS_CHECK(RCServo_GetAngle(SERVO_TILT) == 123);
+
+	// 20 ms frames counted in 1 us
+	HARNESS_CHECK(Sim_Peek(&TIM15->PSC) == 71);
+	HARNESS_CHECK(Sim_Peek(&TIM15->ARR) == 19999);
+	HARNESS_CHECK(Sim_Peek(&TIM17->ARR) == 19999);
+}
+
+/*************************************************************
+* ServoTest_Slew() - A 45 degree move at 90 degrees/s takes 25 frames of 18 us each.
+* No inputs.
+* No return value.
+*************************************************************/
+static void ServoTest_Slew(void){
+	uint32_t first, last = 0;
+
+	RCServo_SetAngle(SERVO_PAN, 0);
+	Sim_Run(SERVO_TEST_FRAME_US);
+	frames = 0;
+	RCServo_MoveTo(SERVO_PAN, 450, 90);
+	Sim_Run(30 * SERVO_TEST_FRAME_US);
+	HARNESS_CHECK(!RCServo_IsMoving(SERVO_PAN));
+	HARNESS_CHECK(RCServo_GetAngle(SERVO_PAN) == 450);
+
+	for(first = 0; first < frames && framePw[first] == 1500; first++);
+	for(uint32_t i = first; i < frames; i++){
+		if(framePw[i] != 1500 + 18 * (i - first + 1) && framePw[i] != 1950){
+			Harness_Fail("frame %u pulse width %u", i - first, framePw[i]);
+		}
+		if(framePw[i] < 1950){
+			last = i;
+		}
+		if(i > 0 && llabs((long long)(framePs[i] - framePs[i - 1]) - (long long)(SERVO_TEST_FRAME_US * 1000000ULL)) > 1000000LL){
+			Harness_Fail("frame %u is %llu ps after the last", i, (unsigned long long)(framePs[i] - framePs[i - 1]));
+		}
+	}
+	HARNESS_CHECK(last - first + 2 == 25);
+}
+
+/*************************************************************
+* ServoTest_Sweep() - A -30 to +30 degree sweep at 60 degrees/s turns every second.
+* No inputs.
+* No return value.
+*************************************************************/
+static void ServoTest_Sweep(void){
+	uint64_t ends[8];
+	uint32_t endCount = 0;
+
+	RCServo_SetAngle(SERVO_PAN, -30);
+	Sim_Run(SERVO_TEST_FRAME_US);
+	frames = 0;
+	RCServo_Sweep(SERVO_PAN, -300, 300, 60);
+	Sim_Run(5000000);
+	RCServo_Hold(SERVO_PAN);
+
+	// Times the sweep reaches an end point (the first frame holds -30)
+	for(uint32_t i = 1; i < frames && endCount < 8; i++){
+		if((framePw[i] == 1200 || framePw[i] == 1800) && framePw[i] != framePw[i - 1]){
+			ends[endCount++] = framePs[i];
+		}
+	}
+	HARNESS_CHECK(endCount >= 4);
+	for(uint32_t i = 1; i < endCount; i++){
+		uint64_t half = ends[i] - ends[i - 1];
+		printf("sweep half period %llu us\n", (unsigned long long)(half / 1000000ULL));
+		HARNESS_CHECK(half >= 1000000000000ULL - SERVO_TEST_FRAME_US * 1000000ULL &&
+			half <= 1000000000000ULL + SERVO_TEST_FRAME_US * 1000000ULL);
+	}
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(void){
+	System_Clock_Init();
+	RCServo_Init();
+	Sim_SetAccessHook(ServoTest_Access);
+
+	ServoTest_Math();
+	ServoTest_Slew();
+	ServoTest_Sweep();
+
+	return(Harness_Result());
+}
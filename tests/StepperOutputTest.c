@@ -0,0 +1,165 @@
+/********************************************************************************
+* Name: StepperOutputTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Stepper coil output on PC0-PC3. Each step must be a single
+*							 GPIOC->BSRR write that follows the full and half step sequences,
+*							 never energises both ends of a coil, and never touches the other
+*							 GPIOC pins (DCMotor.c drives PC8/PC9/PC12/PC13 from the same port).
+********************************************************************************/
+
+#include "Harness.h"
+#include "Stepper.h"
+#include "SysClock.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define OUTPUT_TEST_OTHERS		0xB300UL		// PC8, PC9, PC12, PC13 and PC15 held high by "other drivers"
+
+// Coil states (A, A/, B, B/) of the half step sequence, a full step moves two places
+static const uint8_t sequence[8][4] = {
+	{1, 0, 0, 0}, {1, 0, 1, 0}, {0, 0, 1, 0}, {0, 1, 1, 0},
+	{0, 1, 0, 0}, {0, 1, 0, 1}, {0, 0, 0, 1}, {1, 0, 0, 1}
+};
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static uint32_t portWrites = 0;			// GPIOC output writes other than BSRR
+static uint32_t bsrrWrites = 0;
+static uint32_t strayBits = 0;			// BSRR bits outside PC0-PC3
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* OutputTest_Access() - Watch every GPIOC output write.
+* addr		- Register word address.
+* value		- Value written.
+* write		- Non zero for a write.
+* No return value.
+*************************************************************/
+static void OutputTest_Access(uint32_t addr, uint32_t value, uint8_t write){
+	if(!write){
+		return;
+	}
+	if(addr == (uint32_t)(uintptr_t)&GPIOC->BSRR){
+		bsrrWrites++;
+		strayBits |= value & ~0x000F000FUL;
+	}
+	else if(addr == (uint32_t)(uintptr_t)&GPIOC->ODR || addr == (uint32_t)(uintptr_t)&GPIOC->BRR){
+		portWrites++;
+	}
+}
+
+/*************************************************************
+* OutputTest_Coils() - Check PC0-PC3 against a sequence position and the other pins.
+* index		- Position in the half step sequence.
+* No return value.
+*************************************************************/
+static void OutputTest_Coils(uint8_t index){
+	uint32_t odr = Sim_Peek(&GPIOC->ODR);
+	const uint8_t *coils = sequence[index & 0x7];
+
+	HARNESS_CHECK(((odr >> 0) & 1UL) == coils[0]);		// PC0 - A
+	HARNESS_CHECK(((odr >> 1) & 1UL) == coils[1]);		// PC1 - A/
+	HARNESS_CHECK(((odr >> 2) & 1UL) == coils[2]);		// PC2 - B
+	HARNESS_CHECK(((odr >> 3) & 1UL) == coils[3]);		// PC3 - B/
+	HARNESS_CHECK((odr & ~0xFUL) == OUTPUT_TEST_OTHERS);
+}
+
+/*************************************************************
+* OutputTest_Manual() - Manual full and half steps both ways.
+* No inputs.
+* No return value.
+*************************************************************/
+static void OutputTest_Manual(void){
+	uint8_t index;
+	uint32_t writes;
+
+	// Stepper_Step(0) re-outputs the current pattern, which locates the start of the sequence
+	Stepper_Step(0);
+	for(index = 0; index < 8; index++){
+		if(Sim_Peek(&GPIOC->ODR) == (OUTPUT_TEST_OTHERS | (sequence[index][0] << 0) | (sequence[index][1] << 1) |
+			(sequence[index][2] << 2) | (sequence[index][3] << 3))){
+			break;
+		}
+	}
+	HARNESS_CHECK(index < 8);
+
+	for(uint32_t i = 0; i < 10; i++){
+		writes = bsrrWrites;
+		Stepper_Step(1);
+		index += 2;
+		HARNESS_CHECK(bsrrWrites == writes + 1);
+		OutputTest_Coils(index);
+	}
+	for(uint32_t i = 0; i < 10; i++){
+		Stepper_Step(4);
+		index -= 1;
+		OutputTest_Coils(index);
+	}
+	for(uint32_t i = 0; i < 10; i++){
+		Stepper_Step(3);
+		index += 1;
+		OutputTest_Coils(index);
+	}
+	for(uint32_t i = 0; i < 10; i++){
+		Stepper_Step(2);
+		index -= 2;
+		OutputTest_Coils(index);
+	}
+}
+
+/*************************************************************
+* OutputTest_Engine() - Steps from TIM6 follow the same sequence.
+* No inputs.
+* No return value.
+*************************************************************/
+static void OutputTest_Engine(void){
+	int32_t start = Stepper_GetPosition();
+	uint8_t index;
+
+	// Half step sequence position from the absolute position
+	Stepper_Step(0);
+	for(index = 0; index < 8; index++){
+		if((Sim_Peek(&GPIOC->ODR) & 0xFUL) == ((sequence[index][0] << 0) | (sequence[index][1] << 1) |
+			(sequence[index][2] << 2) | (sequence[index][3] << 3))){
+			break;
+		}
+	}
+
+	Stepper_SetStepMode(STEPPER_HALF_STEP);
+	Stepper_MoveTo(start + 13 * (STEPPER_MICROSTEPS / 2));
+	for(uint32_t ms = 0; ms < 2000 && Stepper_IsRunning(); ms++){
+		Sim_Run(1000);
+	}
+	HARNESS_CHECK(!Stepper_IsRunning());
+	OutputTest_Coils(index + 13);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(void){
+	System_Clock_Init();
+	Stepper_Init();
+	Sim_Poke(&GPIOC->ODR, Sim_Peek(&GPIOC->ODR) | OUTPUT_TEST_OTHERS);
+	Sim_SetAccessHook(OutputTest_Access);
+
+	OutputTest_Manual();
+	OutputTest_Engine();
+
+	HARNESS_CHECK(portWrites == 0);
+	HARNESS_CHECK(strayBits == 0);
+	return(Harness_Result());
+}
@@ -0,0 +1,182 @@
+/********************************************************************************
+* Name: StepperTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Step engine timing and position bookkeeping. Every step is one
+*							 GPIOC->BSRR write from TIM6_DAC_IRQHandler, so the write times
+*							 are the step times: at cruise they must be 1/rate apart with no
+*							 more than the 1 us timer resolution of jitter, the ramps must be
+*							 monotonic and the position must match the steps issued.
+********************************************************************************/
+
+#include <stdio.h>
+#include "Harness.h"
+#include "Stepper.h"
+#include "SysClock.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define STEPPER_TEST_MAX_STEPS		4096
+#define STEPPER_TEST_RATE					500UL				// Cruise rate (steps/s)
+#define STEPPER_TEST_ACCEL				2000UL			// Steps/s^2
+#define STEPPER_TEST_JITTER_PS		1000000ULL	// 1 us, the TIM6 tick
+
+
+/******************************************************************
+*												STATIC VARIABLES									  			*
+******************************************************************/
+
+static uint64_t stepPs[STEPPER_TEST_MAX_STEPS];
+static uint32_t steps = 0;
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* StepperTest_Access() - Record the time of every coil write.
+* addr		- Register word address.
+* value		- Value written.
+* write		- Non zero for a write.
+* No return value.
+*************************************************************/
+static void StepperTest_Access(uint32_t addr, uint32_t value, uint8_t write){
+	if(write && addr == (uint32_t)(uintptr_t)&GPIOC->BSRR && steps < STEPPER_TEST_MAX_STEPS){
+		stepPs[steps++] = Sim_TimePs();
+	}
+}
+
+/*************************************************************
+* StepperTest_Settle() - Run until the step engine stops.
+* limitUs	- Most time to wait (us).
+* No return value.
+*************************************************************/
+static void StepperTest_Settle(uint32_t limitUs){
+	for(uint32_t us = 0; us < limitUs && Stepper_IsRunning(); us += 1000){
+		Sim_Run(1000);
+	}
+	HARNESS_CHECK(!Stepper_IsRunning());
+}
+
+/*************************************************************
+* StepperTest_Move() - A trapezoidal move: position, step count, ramps and cruise jitter.
+* No inputs.
+* No return value.
+*************************************************************/
+static void StepperTest_Move(void){
+	const uint64_t cruisePs = 1000000000000ULL / STEPPER_TEST_RATE;
+	uint64_t interval;
+	uint64_t minInterval = UINT64_MAX;
+	uint64_t maxCruise = 0;
+	uint32_t cruiseStart = 0;
+	uint32_t cruiseEnd = 0;
+	uint32_t i;
+
+	Stepper_SetStepMode(STEPPER_FULL_STEP);
+	Stepper_SetPosition(0);
+	steps = 0;
+	Stepper_MoveTo(400 * STEPPER_MICROSTEPS);
+	StepperTest_Settle(5000000);
+
+	// One BSRR write per step (the first write is the mode change output)
+	HARNESS_CHECK(Stepper_GetPosition() == 400 * STEPPER_MICROSTEPS);
+	HARNESS_CHECK(steps == 400);
+
+	// Intervals shrink to the cruise period, hold it, then grow
+	for(i = 1; i < steps; i++){
+		interval = stepPs[i] - stepPs[i - 1];
+		minInterval = (interval < minInterval) ? interval : minInterval;
+	}
+	for(i = 1; i < steps && stepPs[i] - stepPs[i - 1] > minInterval + STEPPER_TEST_JITTER_PS; i++){
+		if(i > 1 && stepPs[i] - stepPs[i - 1] > stepPs[i - 1] - stepPs[i - 2] + STEPPER_TEST_JITTER_PS){
+			Harness_Fail("acceleration step %u longer than the one before", i);
+		}
+	}
+	cruiseStart = i;
+	for(; i < steps && stepPs[i] - stepPs[i - 1] <= minInterval + STEPPER_TEST_JITTER_PS; i++){
+		interval = stepPs[i] - stepPs[i - 1];
+		maxCruise = (interval > maxCruise) ? interval : maxCruise;
+	}
+	cruiseEnd = i;
+	for(i++; i < steps; i++){
+		if(stepPs[i] - stepPs[i - 1] + STEPPER_TEST_JITTER_PS < stepPs[i - 1] - stepPs[i - 2]){
+			Harness_Fail("deceleration step %u shorter than the one before", i);
+		}
+	}
+
+	printf("move: %u steps, ramp up %u, cruise %u, jitter %llu ps\n", steps, cruiseStart, cruiseEnd - cruiseStart,
+		(unsigned long long)(maxCruise - minInterval));
+	HARNESS_CHECK(cruiseEnd - cruiseStart > 100);
+	HARNESS_CHECK(minInterval + STEPPER_TEST_JITTER_PS >= cruisePs && minInterval <= cruisePs + STEPPER_TEST_JITTER_PS);
+	HARNESS_CHECK(maxCruise - minInterval <= STEPPER_TEST_JITTER_PS);
+}
+
+/*************************************************************
+* StepperTest_Bookkeeping() - Moves back and forth, half steps, jog and stop.
+* No inputs.
+* No return value.
+*************************************************************/
+static void StepperTest_Bookkeeping(void){
+	int32_t before;
+
+	// Reverse through zero
+	Stepper_MoveTo(-120 * STEPPER_MICROSTEPS);
+	StepperTest_Settle(5000000);
+	HARNESS_CHECK(Stepper_GetPosition() == -120 * STEPPER_MICROSTEPS);
+
+	// Half steps count half a full step each
+	Stepper_SetStepMode(STEPPER_HALF_STEP);
+	steps = 0;
+	Stepper_MoveTo(-100 * STEPPER_MICROSTEPS);
+	StepperTest_Settle(5000000);
+	HARNESS_CHECK(Stepper_GetPosition() == -100 * STEPPER_MICROSTEPS);
+	HARNESS_CHECK(steps == 40);
+
+	// A new target while moving the other way: slows down, reverses and still lands on it
+	Stepper_SetStepMode(STEPPER_FULL_STEP);
+	Stepper_MoveTo(200 * STEPPER_MICROSTEPS);
+	Sim_Run(100000);
+	Stepper_MoveTo(0);
+	StepperTest_Settle(5000000);
+	HARNESS_CHECK(Stepper_GetPosition() == 0);
+
+	// Jog then stop: every step taken is in the position
+	before = Stepper_GetPosition();
+	steps = 0;
+	Stepper_Jog(STEPPER_CCW);
+	Sim_Run(500000);
+	HARNESS_CHECK(Stepper_IsRunning());
+	Stepper_Stop();
+	StepperTest_Settle(2000000);
+	HARNESS_CHECK(steps > 0);
+	HARNESS_CHECK(Stepper_GetPosition() == before - (int32_t)steps * STEPPER_MICROSTEPS);
+
+	// Manual steps are counted too
+	before = Stepper_GetPosition();
+	Stepper_Step(1);
+	Stepper_Step(1);
+	Stepper_Step(4);
+	HARNESS_CHECK(Stepper_GetPosition() == before + 2 * STEPPER_MICROSTEPS - STEPPER_MICROSTEPS / 2);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(void){
+	System_Clock_Init();
+	Stepper_Init();
+	Stepper_SetMaxRate(STEPPER_TEST_RATE);
+	Stepper_SetAccel(STEPPER_TEST_ACCEL);
+	Sim_SetAccessHook(StepperTest_Access);
+
+	StepperTest_Move();
+	StepperTest_Bookkeeping();
+
+	return(Harness_Result());
+}
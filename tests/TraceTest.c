@@ -0,0 +1,144 @@
+/********************************************************************************
+* Name: TraceTest.c (implementation)
+* Author(s): agent
+* Date: October 19, 2026
+* Description: Event trace rings and their cost. Task events past the ring size
+*							 must overwrite the oldest, encoder ISR events must go to their
+*							 own ring, and Trace_Dump() must print every ring oldest first.
+*							 The register accesses and cycles of one trace write are
+*							 reported. Given a file name, the dump is also written there for
+*							 trace_roundtrip.py to convert with trace_to_json.py.
+********************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "Harness.h"
+#include "Encoder.h"
+#include "Profile.h"
+#include "SysClock.h"
+#include "Trace.h"
+#include "UART.h"
+
+
+/******************************************************************
+*									LOCAL CONSTANTS AND VARIABLES									  *
+******************************************************************/
+
+#define TRACE_TEST_EVENTS			100			// Task events, more than one ring holds
+#define TRACE_TEST_CAPTURES		3				// Encoder edges
+
+
+/******************************************************************
+*												PRIVATE FUNCTIONS													*
+******************************************************************/
+
+/*************************************************************
+* TraceTest_Write() - Task and encoder ISR events, and what one write costs.
+* No inputs.
+* No return value.
+*************************************************************/
+static void TraceTest_Write(void){
+	uint32_t reads, writes, maxReads = 0, maxWrites = 0;
+	uint32_t start, cycles, maxCycles = 0;
+
+	// Step positions either side of 0 exercise the signed payloads
+	for(int32_t i = 0; i < TRACE_TEST_EVENTS; i++){
+		Sim_Run(10);
+		start = DWT->CYCCNT;
+		Sim_ResetCounts();
+		TRACE(TRACE_STEP, i - TRACE_TEST_EVENTS / 2);
+		Sim_GetCounts(&reads, &writes);
+		cycles = DWT->CYCCNT - start - SIM_ACCESS_CYCLES;		// Less the second cycle counter read
+		maxReads = (reads > maxReads) ? reads : maxReads;
+		maxWrites = (writes > maxWrites) ? writes : maxWrites;
+		maxCycles = (cycles > maxCycles) ? cycles : maxCycles;
+	}
+	printf("trace write: %u register reads, %u writes, %u cycles\n", maxReads, maxWrites, maxCycles);
+
+	// The timestamp is the only register access, the interrupt mask is core state
+	HARNESS_CHECK(maxReads == 1 && maxWrites == 0);
+	HARNESS_CHECK(maxCycles <= 2 * SIM_ACCESS_CYCLES);
+
+	for(int i = 0; i < TRACE_TEST_CAPTURES; i++){
+		Sim_Run(1000);
+		Sim_TimerCapture(TIM2, 1);
+	}
+	Sim_Run(10);
+}
+
+/*************************************************************
+* TraceTest_Dump() - Each ring printed oldest first.
+* No inputs.
+* No return value.
+*************************************************************/
+static void TraceTest_Dump(void){
+	const char *line;
+	unsigned long time, lastTime = 0;
+	unsigned context, id, payload;
+	uint32_t tasks = 0, encoder = 0, other = 0;
+	int32_t position = TRACE_TEST_EVENTS - TRACE_RING_SIZE - TRACE_TEST_EVENTS / 2;
+
+	Harness_ClearOutput();
+	Trace_Dump();
+	while(!UART_TxDone()){
+		Sim_Run(1000);
+	}
+
+	line = Harness_Find("TRACE BEGIN 5\n");
+	HARNESS_CHECK(line != NULL && Harness_Find("TRACE END\n") != NULL);
+	for(line = (line != NULL) ? strchr(line, '\n') + 1 : NULL; line != NULL && strncmp(line, "TRACE END", 9) != 0;
+		line = strchr(line, '\n') + 1){
+		if(sscanf(line, "%lx %u %u %x", &time, &context, &id, &payload) != 4){
+			Harness_Fail("bad record %.20s", line);
+			break;
+		}
+		if(context == TRACE_CTX_TASKS){
+			// The newest TRACE_RING_SIZE steps, oldest first
+			if(id != TRACE_STEP || payload != ((uint32_t)position & 0xFFFFUL) || (tasks > 0 && time <= lastTime)){
+				Harness_Fail("task record %u: %08lX %u %04X", tasks, time, id, payload);
+			}
+			position++;
+			tasks++;
+			lastTime = time;
+		}
+		else if(context == TRACE_CTX_ENCODER){
+			HARNESS_CHECK(id == TRACE_ENCODER_LEFT);
+			encoder++;
+		}
+		else{
+			other++;
+		}
+	}
+	HARNESS_CHECK(tasks == TRACE_RING_SIZE);
+	HARNESS_CHECK(encoder == TRACE_TEST_CAPTURES);
+	HARNESS_CHECK(other == 0);
+}
+
+
+/******************************************************************
+*												PUBLIC FUNCTIONS													*
+******************************************************************/
+
+int main(int argc, char **argv){
+	FILE *capture;
+
+	System_Clock_Init();
+	SystemCoreClockUpdate();
+	Profile_Init();
+	UART2_Init();
+	Encoder_Init();
+	Harness_CaptureUart();
+
+	TraceTest_Write();
+	TraceTest_Dump();
+
+	if(argc > 1){
+		capture = fopen(argv[1], "w");
+		HARNESS_CHECK(capture != NULL);
+		if(capture != NULL){
+			fputs(Harness_Output(), capture);
+			fclose(capture);
+		}
+	}
+	return(Harness_Result());
+}
@@ -0,0 +1,77 @@
+###############################################################################
+# Name: board_conflict.cmake
+# Author(s): agent
+# Date: October 19, 2026
+# Description: Board.h must refuse to build with a pin or timer channel assigned
+#              twice. Each case writes a copy of Board.h with one line changed
+#              into WORK_DIR and compiles a file including it; the copy must
+#              fail with its Board.h conflict message. The unchanged Board.h
+#              must compile, so a broken include path cannot pass as a conflict.
+#
+# Usage: cmake -DCC=<compiler> -DSOURCE_DIR=<repo> -DWORK_DIR=<dir> -P board_conflict.cmake
+###############################################################################
+
+# name | line in Board.h | conflicting line | expected message
+set(cases
+	"pushbutton|#define BOARD_USE_PUSHBUTTON 0|#define BOARD_USE_PUSHBUTTON 1|a port C pin is assigned twice"
+	"lcd_on_led|#define BOARD_LCD_RS_PIN						6|#define BOARD_LCD_RS_PIN						5|a port A pin is assigned twice"
+	"echo_on_encoder|#define BOARD_ULTRA_ECHO_TIMER			3|#define BOARD_ULTRA_ECHO_TIMER			2|a TIM1-TIM8 channel is assigned twice"
+	"gripper_on_servo|#define BOARD_SERVO_GRIPPER_TIMER		17|#define BOARD_SERVO_GRIPPER_TIMER		15|a TIM15-TIM17 channel is assigned twice"
+)
+
+file(READ ${SOURCE_DIR}/Board.h board)
+set(failed 0)
+
+# board_compile(<dir> <output var> <result var>) - Compile a file including <dir>/Board.h
+function(board_compile dir output result)
+	file(WRITE ${dir}/board.c "#include \"Board.h\"\n")
+	execute_process(
+		COMMAND ${CC} -fsyntax-only -DSTM32F303xE -I${dir} -I${SOURCE_DIR}/host -I${SOURCE_DIR} ${dir}/board.c
+		RESULT_VARIABLE code
+		OUTPUT_VARIABLE out
+		ERROR_VARIABLE out)
+	set(${output} "${out}" PARENT_SCOPE)
+	set(${result} ${code} PARENT_SCOPE)
+endfunction()
+
+# The board as it is
+file(MAKE_DIRECTORY ${WORK_DIR}/as_is)
+file(WRITE ${WORK_DIR}/as_is/Board.h "${board}")
+board_compile(${WORK_DIR}/as_is out code)
+if(NOT code EQUAL 0)
+	message(SEND_ERROR "Board.h as it is does not build:\n${out}")
+	set(failed 1)
+endif()
+
+foreach(entry IN LISTS cases)
+	string(REPLACE "|" ";" fields "${entry}")
+	list(GET fields 0 name)
+	list(GET fields 1 line)
+	list(GET fields 2 conflict)
+	list(GET fields 3 expect)
+
+	string(FIND "${board}" "${line}" at)
+	if(at EQUAL -1)
+		message(SEND_ERROR "${name}: '${line}' is no longer in Board.h")
+		set(failed 1)
+		continue()
+	endif()
+	string(REPLACE "${line}" "${conflict}" changed "${board}")
+
+	file(MAKE_DIRECTORY ${WORK_DIR}/${name})
+	file(WRITE ${WORK_DIR}/${name}/Board.h "${changed}")
+	board_compile(${WORK_DIR}/${name} out code)
+	if(code EQUAL 0)
+		message(SEND_ERROR "${name}: built with '${conflict}'")
+		set(failed 1)
+	elseif(NOT out MATCHES "${expect}")
+		message(SEND_ERROR "${name}: failed without '${expect}':\n${out}")
+		set(failed 1)
+	else()
+		message(STATUS "${name}: '${conflict}' fails to build: ${expect}")
+	endif()
+endforeach()
+
+if(failed)
+	message(FATAL_ERROR "Board.h conflict detection failed")
+endif()
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+###############################################################################
+# Name: trace_roundtrip.py
+# Author(s): agent
+# Date: October 19, 2026
+# Description: Round trip of a trace dump through trace_to_json.py. Runs
+#              TraceTest to capture a real Trace_Dump(), converts it with
+#              trace_to_json.py and checks every record comes out as one
+#              Chrome trace event with its time, context, name and payload
+#              (step positions signed), in time order.
+#
+# Usage: python3 trace_roundtrip.py <TraceTest> <trace_to_json.py>
+###############################################################################
+
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+
+def records(text):
+    """Returns (time_us, context, id, payload) for each dump line, read independently of trace_to_json.py."""
+    body = text.split("TRACE BEGIN 5\n", 1)[1].split("TRACE END\n", 1)[0]
+    return [tuple(int(field, 16 if i in (0, 3) else 10) for i, field in enumerate(line.split()))
+            for line in body.splitlines()]
+
+
+def main():
+    test, converter = sys.argv[1], sys.argv[2]
+    failures = []
+
+    with tempfile.TemporaryDirectory() as tmp:
+        capture = os.path.join(tmp, "capture.txt")
+        subprocess.run([test, capture], check=True, stdout=subprocess.DEVNULL)
+        text = open(capture).read()
+        converted = subprocess.run([sys.executable, converter, capture], check=True, capture_output=True, text=True)
+    trace = json.loads(converted.stdout)
+
+    expected = sorted(records(text))
+    instants = [e for e in trace["traceEvents"] if e["ph"] == "i"]
+    threads = {e["tid"]: e["args"]["name"] for e in trace["traceEvents"] if e["ph"] == "M"}
+
+    if len(instants) != len(expected):
+        failures.append("%d records but %d events" % (len(expected), len(instants)))
+    for (time, context, event, payload), got in zip(expected, instants):
+        if event == 3 and payload >= 0x8000:
+            payload -= 0x10000
+        want = {"ts": time, "tid": context, "payload": payload}
+        have = {"ts": got["ts"], "tid": got["tid"], "payload": got["args"]["payload"]}
+        if want != have:
+            failures.append("record %s came out as %s" % (want, have))
+    if [e["ts"] for e in instants] != sorted(e["ts"] for e in instants):
+        failures.append("events out of time order")
+    if sorted(threads) != [0, 1, 2, 3, 4]:
+        failures.append("thread names for %s" % sorted(threads))
+
+    # The names come from the event IDs, the steps straddle position 0
+    names = {(e["name"], e["tid"]) for e in instants}
+    if names != {("step", 0), ("encoder left", 1)}:
+        failures.append("event names %s" % sorted(names))
+    steps = [e["args"]["payload"] for e in instants if e["name"] == "step"]
+    if steps != list(range(steps[0], steps[0] + len(steps))) or steps[0] >= 0:
+        failures.append("step payloads %s" % steps)
+
+    for failure in failures:
+        print("failed: " + failure)
+    print("%d records, %d events, %d failed" % (len(expected), len(instants), len(failures)))
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+###############################################################################
+# Name: trace_to_json.py
+# Author(s): Noah Grant, Wyatt Richard
+# Date: October 19, 2026
+# Description: Converts a UART event trace dump (Trace_Dump() in Trace.c) to
+#              Chrome trace JSON for chrome://tracing or ui.perfetto.dev.
+#
+# Usage: python3 trace_to_json.py capture.txt > trace.json
+###############################################################################
+
+import json
+import sys
+
+# Keep in sync with Trace.h
+CONTEXTS = {0: "tasks", 1: "TIM2 encoder ISR", 2: "TIM6 stepper ISR", 3: "TIM15 servo ISR", 4: "other ISRs"}
+EVENTS = {
+    1: "key press",
+    2: "stepper cmd",
+    3: "step",
+    4: "motor dir",
+    5: "motor speed",
+    6: "encoder left",
+    7: "encoder right",
+    8: "ultrasonic ping",
+    9: "ultrasonic echo",
+    10: "servo pan cmd",
+    11: "servo tilt cmd",
+    12: "servo gripper cmd",
+}
+SIGNED_PAYLOAD = {3, 10, 11, 12}   # Step position and servo angles are int16
+
+
+def parse(lines):
+    """Returns (time_us, context, id, payload) for every record between TRACE BEGIN/END."""
+    records = []
+    inside = False
+    for line in lines:
+        line = line.strip()
+        if line.startswith("TRACE BEGIN"):
+            inside = True
+            records = []
+        elif line.startswith("TRACE END"):
+            inside = False
+        elif inside and line:
+            time, context, event, payload = line.split()
+            records.append((int(time, 16), int(context), int(event), int(payload, 16)))
+    return records
+
+
+def to_chrome(records):
+    events = [{"ph": "M", "pid": 0, "tid": ctx, "name": "thread_name", "args": {"name": name}}
+              for ctx, name in CONTEXTS.items()]
+    for time, context, event, payload in sorted(records):
+        if event in SIGNED_PAYLOAD and payload >= 0x8000:
+            payload -= 0x10000
+        events.append({
+            "ph": "i",
+            "s": "t",
+            "pid": 0,
+            "tid": context,
+            "ts": time,
+            "name": EVENTS.get(event, "event %d" % event),
+            "args": {"payload": payload},
+        })
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def main():
+    source = open(sys.argv[1]) if len(sys.argv) > 1 else sys.stdin
+    json.dump(to_chrome(parse(source)), sys.stdout, indent=1)
+    sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()